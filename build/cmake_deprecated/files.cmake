@@ -408,6 +408,7 @@ set(BASE_CMN_SRC
     src/common/file.cpp
     src/common/fileback.cpp
     src/common/fileconf.cpp
+    src/common/filemap.cpp
     src/common/filefn.cpp
     src/common/filename.cpp
     src/common/filesys.cpp
@@ -472,6 +473,7 @@ set(BASE_CMN_SRC
     src/common/fswatchercmn.cpp
     src/generic/fswatcherg.cpp
     src/common/lzmastream.cpp
+    src/common/zstdstream.cpp
 )
 
 set(BASE_AND_GUI_CMN_SRC
@@ -640,6 +642,7 @@ set(BASE_CMN_HDR
     wx/fswatcher.h
     wx/generic/fswatcher.h
     wx/lzmastream.h
+    wx/zstdstream.h
 )
 
 set(NET_UNIX_SRC
@@ -669,6 +672,7 @@ set(NET_CMN_SRC
     src/common/sckstrm.cpp
     src/common/socket.cpp
     src/common/url.cpp
+    src/common/webcache.cpp
     src/common/webrequest.cpp
     src/common/webrequest_curl.cpp
 )
@@ -685,6 +689,7 @@ set(NET_CMN_HDR
     wx/sckstrm.h
     wx/socket.h
     wx/url.h
+    wx/private/webcache.h
     wx/webrequest.h
 )
 
@@ -308,6 +308,14 @@ if(wxUSE_LIBLZMA)
     endif()
 endif()
 
+if(wxUSE_ZSTD)
+    find_package(zstd CONFIG)
+    if(NOT zstd_FOUND)
+        message(WARNING "libzstd not found, Zstandard compression won't be available")
+        wx_option_force_value(wxUSE_ZSTD OFF)
+    endif()
+endif()
+
 if (wxUSE_WEBREQUEST)
     if(wxUSE_WEBREQUEST_CURL)
         find_package(CURL)
@@ -105,6 +105,9 @@ wx_add_thirdparty_library(wxUSE_LIBTIFF TIFF "use libtiff (TIFF file format)")
 wx_option(wxUSE_LIBLZMA "use LZMA compression" OFF)
 set(wxTHIRD_PARTY_LIBRARIES ${wxTHIRD_PARTY_LIBRARIES} wxUSE_LIBLZMA "use liblzma for LZMA compression")
 
+wx_option(wxUSE_ZSTD "use Zstandard compression" OFF)
+set(wxTHIRD_PARTY_LIBRARIES ${wxTHIRD_PARTY_LIBRARIES} wxUSE_ZSTD "use libzstd for Zstandard compression")
+
 wx_option(wxUSE_OPENGL "use OpenGL (or Mesa)")
 
 if(UNIX)
@@ -104,6 +104,9 @@ AddGlobalOption(wxUSE_LIBJPEG "Use libjpeg (JPEG file format)" ON)
 AddGlobalOption(wxUSE_LIBLZMA "use LZMA compression" OFF)
 set(wxTHIRD_PARTY_LIBRARIES ${wxTHIRD_PARTY_LIBRARIES} wxUSE_LIBLZMA "use liblzma for LZMA compression")
 
+AddGlobalOption(wxUSE_ZSTD "use Zstandard compression" OFF)
+set(wxTHIRD_PARTY_LIBRARIES ${wxTHIRD_PARTY_LIBRARIES} wxUSE_ZSTD "use libzstd for Zstandard compression")
+
 AddGlobalOption(wxUSE_OPENGL "use OpenGL (or Mesa)" ON)
 
 if(UNIX)
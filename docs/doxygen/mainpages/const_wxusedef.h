@@ -264,6 +264,7 @@ library:
 @itemdef{wxUSE_XRC, Use XRC XML-based resource system.}
 @itemdef{wxUSE_ZIPSTREAM, Enable streams for Zip files.}
 @itemdef{wxUSE_ZLIB, Use wxZlibInput and wxZlibOutputStream classes, required by wxUSE_LIBPNG.}
+@itemdef{wxUSE_ZSTD, Enables Zstandard compression support, requires libzstd.}
 @endDefList
 
 
@@ -354,6 +354,14 @@
 #   endif
 #endif /* !defined(wxUSE_XLOCALE) */
 
+#ifndef wxUSE_ZSTD
+#   ifdef wxABORT_ON_CONFIG_ERROR
+#       error "wxUSE_ZSTD must be defined, please read comment near the top of this file."
+#   else
+#       define wxUSE_ZSTD 0
+#   endif
+#endif /* !defined(wxUSE_ZSTD) */
+
 /*
    Section 1b: all these tests are for GUI only.
 
@@ -1468,6 +1476,17 @@
 #   endif
 #endif /* wxUSE_TARSTREAM */
 
+#if wxUSE_ZSTD
+#   if !wxUSE_STREAMS
+#       ifdef wxABORT_ON_CONFIG_ERROR
+#           error "wxUSE_ZSTD requires wxUSE_STREAMS"
+#       else
+#           undef wxUSE_ZSTD
+#           define wxUSE_ZSTD 0
+#       endif
+#   endif
+#endif /* wxUSE_ZSTD */
+
 /*
    Section 3b: the tests for the GUI settings only.
  */
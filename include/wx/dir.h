@@ -14,6 +14,7 @@
 #include "wx/longlong.h"
 #include "wx/filefn.h"      // for wxS_DIR_DEFAULT
 
+import <span>;
 import <string>;
 import <vector>;
 
@@ -45,6 +46,13 @@ enum class wxDirTraverseResult
     Continue          // continue into this directory
 };
 
+// order in which wxDir::TraverseParallel() reports the entries
+enum class wxDirTraverseOrder
+{
+    Any,        // as soon as they're found, the fastest
+    Sorted      // same as Traverse() would, with the names sorted
+};
+
 // ----------------------------------------------------------------------------
 // wxDirTraverser: helper class for wxDir::Traverse()
 // ----------------------------------------------------------------------------
@@ -65,6 +73,15 @@ public:
     // return one of the enum elements defined above
     virtual wxDirTraverseResult OnDir(const std::string& dirname) = 0;
 
+    // called by wxDir::TraverseParallel() with all the files found in the
+    // same directory
+    //
+    // return the number of files processed: if it is less than the number of
+    // the files passed to it, the traversal stops
+    //
+    // the base class version calls OnFile() for each of the files
+    virtual size_t OnFiles(std::span<const std::string> filenames);
+
     // called for each directory which we couldn't open during our traversal
     // of the directory tree
     //
@@ -139,12 +156,32 @@ public:
                     const std::string& filespec = {},
                     unsigned int flags = wxDIR_DEFAULT) const;
 
+    // same as Traverse() but reads the directories using several threads
+    //
+    // the sink is still only called from the calling thread, but receives the
+    // files in batches via OnFiles() and, unless the order is Sorted, the
+    // directories in an unspecified order. The directories may be read
+    // before OnDir() is called for them, so this is not appropriate if OnDir()
+    // is used to avoid accessing them at all.
+    //
+    // if threads is 0, a suitable number is chosen automatically
+    size_t TraverseParallel(wxDirTraverser& sink,
+                            const std::string& filespec = {},
+                            unsigned int flags = wxDIR_DEFAULT,
+                            wxDirTraverseOrder order = wxDirTraverseOrder::Any,
+                            unsigned int threads = 0) const;
+
     // simplest version of Traverse(): get the names of all files under this
     // directory into filenames array, return the number of files
+    //
+    // if threads is not 1, TraverseParallel() with the Sorted order is used,
+    // so the files of each directory are sorted by name, unlike with the
+    // default serial traversal
     static size_t GetAllFiles(const std::string& dirname,
                               std::vector<std::string>* files,
                               const std::string& filespec = {},
-                              unsigned int flags = wxDIR_DEFAULT);
+                              unsigned int flags = wxDIR_DEFAULT,
+                              unsigned int threads = 1);
 
     // check if there any files matching the given filespec under the given
     // directory (i.e. searches recursively), return the file path if found or
@@ -38,6 +38,8 @@ import WX.Cfg.Flags;
 import WX.File.Flags;
 
 import <ctime>;
+import <string>;
+import <string_view>;
 import <vector>;
 
 
@@ -383,6 +385,41 @@ bool wxIsWild(const std::string& pattern);
 // `hidden' dot files)
 bool wxMatchWild(const std::string& pattern,  const std::string& text, bool dot_special = true);
 
+// The same pattern as used by wxMatchWild() but compiled once, which makes
+// matching it against many strings, e.g. all files in a directory, faster:
+// for the usual patterns the matching time is linear in the text length.
+class wxWildcardPattern
+{
+public:
+    // Default constructed pattern only matches an empty string.
+    wxWildcardPattern() = default;
+    explicit wxWildcardPattern(std::string_view pattern, bool dot_special = true);
+
+    // Returns the same result as wxMatchWild() with the same parameters.
+    bool Matches(std::string_view text) const;
+
+private:
+    // Part of the pattern between two asterisks.
+    struct Segment
+    {
+        bool MatchesAt(std::string_view text, size_t pos) const;
+        size_t FindIn(std::string_view text, size_t from) const;
+
+        std::string chars;
+
+        // Empty if the segment contains no '?', otherwise has the same length
+        // as chars and is non-NUL at the positions of '?'.
+        std::string any;
+    };
+
+    // There is always at least one segment and one less asterisk.
+    std::vector<Segment> m_segments{1};
+
+    bool m_empty{true};
+    bool m_valid{true};
+    bool m_dotSpecial{true};
+};
+
 // Concatenate two files to form third
 bool wxConcatFiles(const std::string& src1, const std::string& src2, const std::string& dest);
 
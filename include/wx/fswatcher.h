@@ -15,9 +15,12 @@
 #include "wx/log.h"
 #include "wx/event.h"
 #include "wx/evtloop.h"
+#include "wx/filefn.h"          // for wxWildcardPattern
 
 import WX.File.Filename;
 
+import <chrono>;
+import <string_view>;
 import <unordered_map>;
 import <vector>;
 
@@ -216,6 +219,81 @@ typedef void (wxEvtHandler::*wxFileSystemWatcherEventFunction)
 #define EVT_FSWATCHER(winid, func) \
     wx__DECLARE_EVT1(wxEVT_FSWATCHER, winid, wxFileSystemWatcherEventHandler(func))
 
+/**
+ * Event sent when all the directories of a tree added asynchronously by
+ * AddTree() are watched, its GetPath() returns the root of the tree.
+ */
+wxDECLARE_EVENT(wxEVT_FSWATCHER_TREE_ADDED, wxFileSystemWatcherEvent);
+
+#define EVT_FSWATCHER_TREE_ADDED(winid, func) \
+    wx__DECLARE_EVT1(wxEVT_FSWATCHER_TREE_ADDED, winid, wxFileSystemWatcherEventHandler(func))
+
+/**
+ * Single change reported by wxFileSystemWatcherBatchEvent, with the same
+ * meaning of the fields as in wxFileSystemWatcherEvent.
+ */
+struct wxFileSystemWatcherChange
+{
+    int changeType;
+    wxFileName path;
+    wxFileName newPath;
+};
+
+/**
+ * Event containing all the changes detected at once, sent instead of the
+ * individual wxFileSystemWatcherEvents if batch events are enabled.
+ *
+ * Warnings and errors are still sent as wxFileSystemWatcherEvents.
+ */
+class wxFileSystemWatcherBatchEvent;
+wxDECLARE_EVENT(wxEVT_FSWATCHER_BATCH, wxFileSystemWatcherBatchEvent);
+
+class wxFileSystemWatcherBatchEvent : public wxEvent
+{
+public:
+    wxFileSystemWatcherBatchEvent(int watchid = wxID_ANY) :
+        wxEvent(watchid, wxEVT_FSWATCHER_BATCH)
+    {
+    }
+
+    wxFileSystemWatcherBatchEvent(std::vector<wxFileSystemWatcherChange> changes,
+                                  int watchid = wxID_ANY) :
+        wxEvent(watchid, wxEVT_FSWATCHER_BATCH),
+        m_changes(std::move(changes))
+    {
+    }
+
+    /**
+     * Returns all the changes in the order in which they happened.
+     */
+    const std::vector<wxFileSystemWatcherChange>& GetChanges() const
+    {
+        return m_changes;
+    }
+
+    std::unique_ptr<wxEvent> Clone() const override
+    {
+        return std::make_unique<wxFileSystemWatcherBatchEvent>(*this);
+    }
+
+    wxEventCategory GetEventCategory() const override
+    {
+        return wxEVT_CATEGORY_UNKNOWN;
+    }
+
+protected:
+    std::vector<wxFileSystemWatcherChange> m_changes;
+};
+
+typedef void (wxEvtHandler::*wxFileSystemWatcherBatchEventFunction)
+                                                (wxFileSystemWatcherBatchEvent&);
+
+#define wxFileSystemWatcherBatchEventHandler(func) \
+    wxEVENT_HANDLER_CAST(wxFileSystemWatcherBatchEventFunction, func)
+
+#define EVT_FSWATCHER_BATCH(winid, func) \
+    wx__DECLARE_EVT1(wxEVT_FSWATCHER_BATCH, winid, wxFileSystemWatcherBatchEventHandler(func))
+
 // ----------------------------------------------------------------------------
 // wxFileSystemWatcherBase: interface for wxFileSystemWatcher
 // ----------------------------------------------------------------------------
@@ -231,8 +309,8 @@ public:
                   int events,
                   wxFSWPathType type,
                   const std::string& filespec = {}) :
-        m_path(path), m_filespec(filespec), m_events(events), m_type(type),
-        m_refcount(1)
+        m_path(path), m_filespec(filespec), m_filespecPattern(filespec),
+        m_events(events), m_type(type), m_refcount(1)
     {
     }
 
@@ -243,6 +321,12 @@ public:
 
     const std::string& GetFilespec() const { return m_filespec; }
 
+    // Returns true if the filespec is empty or matches the given file name.
+    bool MatchesFilespec(std::string_view name) const
+    {
+        return m_filespec.empty() || m_filespecPattern.Matches(name);
+    }
+
     int GetFlags() const
     {
         return m_events;
@@ -271,6 +355,7 @@ public:
 protected:
     std::string m_path;
     std::string m_filespec;      // For tree watches, holds any filespec to apply
+    wxWildcardPattern m_filespecPattern; // The same filespec compiled once
     int m_events{-1};
     wxFSWPathType m_type{wxFSWPathType::None};
     int m_refcount{-1};
@@ -356,6 +441,51 @@ public:
     }
 
 
+    /**
+     * Options controlling the delivery of the events. They are currently only
+     * implemented by the inotify-based watcher: the read buffer size is
+     * ignored by the others and enabling any other option asserts.
+     */
+
+    // Size of the buffer used for reading the native events, using a bigger
+    // one reduces the risk of overflows when there are many changes at once.
+    void SetReadBufferSize(std::size_t size) { m_readBufferSize = size; }
+    std::size_t GetReadBufferSize() const { return m_readBufferSize; }
+
+    // If non-zero, all modifications of the same path happening during this
+    // interval after the first one are reported as a single event, at the
+    // end of it.
+    void SetCoalesceInterval(std::chrono::milliseconds interval)
+    {
+        CheckOptionSupported(interval.count() != 0);
+        m_coalesceInterval = interval;
+    }
+    std::chrono::milliseconds GetCoalesceInterval() const
+    {
+        return m_coalesceInterval;
+    }
+
+    // Send a single wxFileSystemWatcherBatchEvent for all the changes
+    // detected at once instead of an event for each of them.
+    void EnableBatchEvents(bool enable = true)
+    {
+        CheckOptionSupported(enable);
+        m_batchEvents = enable;
+    }
+    bool AreBatchEventsEnabled() const { return m_batchEvents; }
+
+    // Make AddTree() return immediately, after watching just the root of the
+    // tree, and watch its subdirectories once they are read in a background
+    // thread. wxEVT_FSWATCHER_TREE_ADDED is sent when this is done and the
+    // changes in the subdirectories before it may be missed.
+    void EnableAsyncAddTree(bool enable = true)
+    {
+        CheckOptionSupported(enable);
+        m_asyncAddTree = enable;
+    }
+    bool IsAsyncAddTreeEnabled() const { return m_asyncAddTree; }
+
+
     // This is a semi-private function used by wxWidgets itself only.
     //
     // Delegates the real work of adding the path to wxFSWatcherImpl::Add() and
@@ -365,6 +495,14 @@ public:
 
 protected:
 
+    static void CheckOptionSupported([[maybe_unused]] bool used)
+    {
+#ifndef wxHAS_INOTIFY
+        wxASSERT_MSG( !used,
+                      "This option is only supported by the inotify watcher" );
+#endif
+    }
+
     static std::string GetCanonicalPath(const wxFileName& path)
     {
         wxFileName path_copy = wxFileName(path);
@@ -383,6 +521,11 @@ protected:
     wxFSWatcherImpl* m_service{nullptr};     // file system events service
     wxEvtHandler* m_owner;             // handler for file system events
 
+    std::size_t m_readBufferSize{64 * 1024};
+    std::chrono::milliseconds m_coalesceInterval{0};
+    bool m_batchEvents{false};
+    bool m_asyncAddTree{false};
+
     friend class wxFSWatcherImpl;
 };
 
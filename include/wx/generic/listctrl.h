@@ -16,6 +16,8 @@
 
 import WX.Cfg.Flags;
 
+import <functional>;
+
 #if wxUSE_DRAG_AND_DROP
 class wxDropTarget;
 #endif
@@ -27,6 +29,21 @@ class wxDropTarget;
 class wxListHeaderWindow;
 class wxListMainWindow;
 
+//-----------------------------------------------------------------------------
+// sorting by column
+//-----------------------------------------------------------------------------
+
+// How the items are compared by wxGenericListCtrl::SortItemsByColumn().
+enum class wxListSortKey
+{
+    Text,       // compare the items text, case-sensitively
+    TextNoCase, // compare the items text, ignoring the case
+    Numeric     // compare the items text interpreted as numbers
+};
+
+// Function returning the key to sort the item with the given text and data by.
+using wxListSortKeyFunc = std::function<double (const wxString& text, wxUIntPtr data)>;
+
 //-----------------------------------------------------------------------------
 // wxListCtrl
 //-----------------------------------------------------------------------------
@@ -156,6 +173,30 @@ public:
     bool ScrollList( int dx, int dy );
     bool SortItems( wxListCtrlCompare fn, wxIntPtr data );
 
+    // Sort the items by the values in the given column. The sort keys are
+    // extracted only once per item and, unlike with SortItems(), the
+    // selection and the current item are preserved. The sort is stable, so
+    // sorting by one column and then another one sorts by both of them.
+    bool SortItemsByColumn( int col, wxListSortKey key, bool ascending = true );
+    bool SortItemsByColumn( int col, const wxListSortKeyFunc& key, bool ascending = true );
+
+    // Insert the item at its position in the order established by the last
+    // call to SortItemsByColumn(), which must have been done before. The item
+    // column must be the column the list is sorted by and the index of the
+    // new item is returned. The order is forgotten if the text in this column
+    // is changed or an item is inserted using InsertItem() or SortItems().
+    long InsertItemSorted( wxListItem& info );
+    bool IsSortedByColumn() const;
+
+    // Maintain a secondary index of the first column texts and the items data
+    // making FindItem() and incremental keyboard search logarithmic instead of
+    // linear in the number of items. The index is built on the first search
+    // and then updated when items are inserted, deleted or changed, which
+    // takes linear time, and rebuilt after sorting, so it's only worth using
+    // with big lists that are searched more often than they are modified.
+    void EnableFindIndex( bool enable = true );
+    bool IsFindIndexEnabled() const;
+
     // do we have a header window?
     bool HasHeader() const
         { return InReportView() && !HasFlag(wxLC_NO_HEADER); }
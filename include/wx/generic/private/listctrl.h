@@ -19,6 +19,11 @@
 import WX.Utils.Settings;
 import Utils.Geometry;
 
+import <cstdint>;
+import <set>;
+import <unordered_map>;
+import <vector>;
+
 // ============================================================================
 // private classes
 // ============================================================================
@@ -480,6 +485,128 @@ private:
     wxDECLARE_EVENT_TABLE();
 };
 
+//-----------------------------------------------------------------------------
+//  wxListSortState (internal)
+//-----------------------------------------------------------------------------
+
+// The order established by wxGenericListCtrl::SortItemsByColumn().
+struct wxListSortState
+{
+    // the column the items are sorted by or -1 if they're not sorted
+    int col{-1};
+
+    wxListSortKey key{wxListSortKey::Text};
+
+    // custom key function, used instead of the key above if not empty
+    wxListSortKeyFunc func;
+
+    bool ascending{true};
+
+    bool IsSorted() const { return col != -1; }
+    void Reset() { col = -1; func = nullptr; }
+};
+
+//-----------------------------------------------------------------------------
+//  wxListFindIndex (internal)
+//-----------------------------------------------------------------------------
+
+// Secondary index of the items used by FindItem() and the incremental keyboard
+// search when it is enabled with wxGenericListCtrl::EnableFindIndex(). It is
+// built on the first search and then updated when the items are inserted,
+// deleted or changed, while sorting the items requires rebuilding it.
+class wxListFindIndex
+{
+public:
+    wxListFindIndex() = default;
+
+    wxListFindIndex(const wxListFindIndex&) = delete;
+    wxListFindIndex& operator=(const wxListFindIndex&) = delete;
+
+    bool IsValid() const { return m_valid; }
+    void Invalidate();
+
+    // add the given line, must be called for all lines in order and followed
+    // by Finish()
+    void Add(const wxString& text, wxUIntPtr data);
+    void Finish();
+
+    // update the index after inserting or deleting the given line, which
+    // shifts the indices of all the lines after it, or changing its text or
+    // data; these functions do nothing if the index is not valid
+    void OnInsert(size_t line, const wxString& text, wxUIntPtr data);
+    void OnDelete(size_t line, const wxString& text, wxUIntPtr data);
+    void OnChange(size_t line,
+                  const wxString& oldText, wxUIntPtr oldData,
+                  const wxString& newText, wxUIntPtr newData);
+
+    // return the first line at or after start with the given text, which
+    // must be in upper case, or starting with it if partial is true
+    long FindText(size_t start, const wxString& textUpper, bool partial) const;
+
+    // return the first line at or after start starting with the given prefix,
+    // which must be in lower case
+    long FindPrefix(size_t start, const wxString& prefixLower) const;
+
+    // return the first line at or after start with the given data
+    long FindData(size_t start, wxUIntPtr data) const;
+
+private:
+    // The index doesn't store the line indices, as they change whenever a
+    // line is inserted or deleted before them, but labels which increase with
+    // the line index and don't change when other lines are inserted or
+    // deleted, so that updating the index is logarithmic in the number of
+    // lines.
+    using Label = std::uint64_t;
+
+    struct TextEntry
+    {
+        wxString text;
+
+        // mutable as it can be changed by Relabel(), which preserves order
+        mutable Label label;
+
+        bool operator<(const TextEntry& other) const
+        {
+            const int rc = text.compare(other.text);
+            return rc < 0 || (rc == 0 && label < other.label);
+        }
+    };
+
+    using TextEntries = std::set<TextEntry>;
+
+    // return the label of the line at the given index or the label greater
+    // than the labels of all lines if it's the index past the last one
+    Label GetLabel(size_t line) const;
+
+    // return the index of the line with the given label
+    long GetLine(Label label) const;
+
+    // allocate the label for a new line inserted at the given index
+    Label InsertLabel(size_t line);
+
+    // reassign the labels of all lines when there is no space between them
+    void Relabel();
+
+    long
+    FindPrefixIn(const TextEntries& entries, size_t start, const wxString& prefix) const;
+
+    void InsertLine(Label label, const wxString& text, wxUIntPtr data);
+    void EraseLine(Label label, const wxString& text, wxUIntPtr data);
+
+    // labels of all lines, in increasing order
+    std::vector<Label> m_labels;
+
+    // texts of all lines in upper case, as used by FindItem(), and in lower
+    // case, as used by the keyboard search, sorted by text and then label
+    TextEntries m_upper;
+    TextEntries m_lower;
+
+    // labels of the lines with the given data
+    std::unordered_map<wxUIntPtr, std::set<Label>> m_data;
+
+    bool m_valid{false};
+};
+
 //-----------------------------------------------------------------------------
 //  wxListMainWindow (internal)
 //-----------------------------------------------------------------------------
@@ -715,6 +842,12 @@ public:
     long InsertColumn( long col, const wxListItem &item );
     int GetItemWidthWithImage(wxListItem * item);
     void SortItems( wxListCtrlCompare fn, wxIntPtr data );
+    void SortItemsByColumn( const wxListSortState& state );
+    long InsertItemSorted( wxListItem &item );
+    bool IsSortedByColumn() const { return m_sortState.IsSorted(); }
+
+    void EnableFindIndex( bool enable );
+    bool IsFindIndexEnabled() const { return m_findIndex != NULL; }
 
     size_t GetItemCount() const;
     bool IsEmpty() const { return GetItemCount() == 0; }
@@ -919,6 +1052,36 @@ private:
     // delete all items but don't refresh: called from dtor
     void DoDeleteAllItems();
 
+    // common part of InsertItem() and InsertItemSorted()
+    void DoInsertItem( wxListItem &item );
+
+    // forget the order established by SortItemsByColumn() if setting this
+    // item could break it
+    void InvalidateSortOrder( const wxListItem &item );
+
+    // mark the find index, if any, as needing to be rebuilt
+    void InvalidateFindIndex()
+    {
+        if ( m_findIndex )
+            m_findIndex->Invalidate();
+    }
+
+    // return the find index, rebuilding it if necessary, or NULL if it's not
+    // used
+    const wxListFindIndex *GetFindIndex() const;
+
+    // return the find index if it's used and currently valid, i.e. needs to
+    // be updated when the items change, or NULL otherwise
+    wxListFindIndex *GetValidFindIndex() const
+    {
+        return m_findIndex && m_findIndex->IsValid() ? m_findIndex : NULL;
+    }
+
+    // return the text and data of the first column of the given line
+    static void GetFindIndexKey(const wxListLineData *line,
+                                wxString *text,
+                                wxUIntPtr *data);
+
     // Compute the minimal width needed to fully display the column header.
     int ComputeMinHeaderWidth(const wxListHeaderData* header) const;
 
@@ -951,6 +1114,13 @@ private:
     // rulers on empty rows
     bool m_extendRulesAndAlternateColour;
 
+    // the order the items are currently sorted in, if any
+    wxListSortState m_sortState;
+
+    // the index used by FindItem() or NULL if it's disabled (it's mutable
+    // because it's built on demand from const methods)
+    mutable wxListFindIndex *m_findIndex;
+
     wxDECLARE_EVENT_TABLE();
 
     friend class wxGenericListCtrl;
@@ -246,11 +246,14 @@ protected:
                         *m_select_me;
     unsigned short       m_indent;
     int                  m_lineHeight;
+    int                  m_totalHeight;  // bottom of the last shown item
+    int                  m_maxItemRight; // right edge of the widest item
     wxPen                m_dottedPen;
     wxBrush              m_hilightBrush,
                          m_hilightUnfocusedBrush;
     bool                 m_hasFocus;
     bool                 m_dirty;
+    bool                 m_scrollbarsDirty; // only the virtual size changed
     bool                 m_ownsImageListButtons;
     bool                 m_isDragging; // true between BEGIN/END drag events
     bool                 m_lastOnSame;  // last click on the same item as prev
@@ -339,6 +342,10 @@ protected:
     void CalculateLevel( wxGenericTreeItem *item, wxDC &dc, int level, int &y );
     void CalculatePositions();
 
+    // recalculate the positions of the given item subtree and all the items
+    // below it only, assuming that the positions of the items above are valid
+    void CalculatePositions(wxGenericTreeItem *item);
+
     void RefreshSubtree( wxGenericTreeItem *item );
     void RefreshLine( wxGenericTreeItem *item );
 
@@ -25,6 +25,8 @@ import WX.GDI.Flags;
 
 import Utils.Geometry;
 
+import <functional>;
+import <span>;
 import <string>;
 import <string_view>;
 import <utility>;
@@ -517,6 +519,97 @@ public:
 
 inline const wxGraphicsPath wxNullGraphicsPath;
 
+// ----------------------------------------------------------------------------
+// wxGraphicsBatch: primitives drawn all at once
+// ----------------------------------------------------------------------------
+
+enum class wxGraphicsMarker
+{
+    Square,
+    Circle,
+    Diamond,
+    Triangle,
+    Cross,      // two diagonal lines, can only be stroked
+    Plus        // horizontal and vertical lines, can only be stroked
+};
+
+// Records many rectangles, ellipses, markers and polylines which are drawn
+// together, using the same pen and brush, by wxGraphicsContext::DrawBatch()
+// and related functions. This is much faster than drawing them one by one, as
+// the entire batch is drawn as a single path. Unlike wxGraphicsPath, a batch
+// doesn't depend on the renderer and can be reused with different contexts.
+class wxGraphicsBatch
+{
+public:
+    // A group of markers of the same shape and size.
+    struct MarkerRun
+    {
+        wxGraphicsMarker shape;
+        float size;
+        size_t first;
+        size_t count;
+    };
+
+    // A polyline using the given points of the batch.
+    struct Polyline
+    {
+        size_t first;
+        size_t count;
+        bool closed;
+    };
+
+    void AddRectangle(float x, float y, float w, float h)
+        { m_rects.emplace_back(x, y, w, h); }
+    void AddRectangles(std::span<const wxRectFloat> rects)
+        { m_rects.insert(m_rects.end(), rects.begin(), rects.end()); }
+
+    // appends an ellipse fitting the given rectangle
+    void AddEllipse(float x, float y, float w, float h)
+        { m_ellipses.emplace_back(x, y, w, h); }
+    void AddCircle(float x, float y, float r)
+        { AddEllipse(x - r, y - r, 2*r, 2*r); }
+
+    // appends markers of the given shape and size (i.e. width and height)
+    // centered at each of the points
+    void AddMarkers(std::span<const wxPoint2DFloat> centers,
+                    wxGraphicsMarker shape,
+                    float size);
+
+    // appends lines connecting each of the points
+    void AddLines(std::span<const wxPoint2DFloat> points)
+        { AddPolyline(points, false); }
+
+    // appends a polygon, i.e. closed polyline, with the given vertices
+    void AddPolygon(std::span<const wxPoint2DFloat> points)
+        { AddPolyline(points, true); }
+
+    bool IsEmpty() const
+    {
+        return m_rects.empty() && m_ellipses.empty() &&
+                m_markers.empty() && m_polylines.empty();
+    }
+
+    // removes all primitives, but keeps the allocated memory for reuse
+    void Clear();
+
+    const std::vector<wxRectFloat>& GetRectangles() const { return m_rects; }
+    const std::vector<wxRectFloat>& GetEllipses() const { return m_ellipses; }
+    const std::vector<MarkerRun>& GetMarkers() const { return m_markers; }
+    const std::vector<Polyline>& GetPolylines() const { return m_polylines; }
+    const std::vector<wxPoint2DFloat>& GetPoints() const { return m_points; }
+
+private:
+    void AddPolyline(std::span<const wxPoint2DFloat> points, bool closed);
+
+    std::vector<wxRectFloat> m_rects;
+    std::vector<wxRectFloat> m_ellipses;
+    std::vector<MarkerRun> m_markers;
+    std::vector<Polyline> m_polylines;
+
+    // Centers of all markers and vertices of all polylines.
+    std::vector<wxPoint2DFloat> m_points;
+};
+
 
 class wxGraphicsContext : public wxGraphicsObject
 {
@@ -757,6 +850,17 @@ public:
     // draws a path by first filling and then stroking
     virtual void DrawPath( const wxGraphicsPath& path, wxPolygonFillMode fillStyle = wxPolygonFillMode::OddEven );
 
+    // strokes all primitives of the batch with the current pen
+    virtual void StrokeBatch( const wxGraphicsBatch& batch );
+
+    // fills all primitives of the batch with the current brush, notice that
+    // the default fill mode is different from FillPath() to ensure that the
+    // overlapping primitives are filled
+    virtual void FillBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle = wxPolygonFillMode::WindingRule );
+
+    // draws all primitives of the batch by first filling and then stroking
+    virtual void DrawBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle = wxPolygonFillMode::WindingRule );
+
     // paints a transparent rectangle (only useful for bitmaps or windows)
     virtual void ClearRectangle(float x, float y, float w, float h);
 
@@ -778,6 +882,12 @@ public:
                    float angle, const wxGraphicsBrush& backgroundBrush )
         { DoDrawRotatedFilledText(str, x, y, angle, backgroundBrush); }
 
+    // draws n strings, each one at the corresponding position; the default
+    // implementation simply draws them one by one, but the ports may do it
+    // more efficiently
+    virtual void DrawTexts(size_t n, const std::string_view* texts,
+                           const wxPoint2DFloat* positions);
+
     virtual std::pair<float, float> GetTextExtent(std::string_view text,
         float *descent = nullptr, float *externalLeading = nullptr ) const  = 0;
 
@@ -861,6 +971,10 @@ protected:
     // classes
     virtual wxGraphicsPen DoCreatePen(const wxGraphicsPenInfo& info) const;
 
+    // creates a path containing all primitives of the batch, this is used by
+    // the default implementations of the batch drawing functions
+    wxGraphicsPath CreateBatchPath(const wxGraphicsBatch& batch) const;
+
     virtual void DoDrawText(std::string_view str, float x, float y) = 0;
     virtual void DoDrawRotatedText(std::string_view str, float x, float y,
                                    float angle);
@@ -1025,6 +1139,54 @@ wxImage wxGraphicsBitmap::ConvertToImage() const
 }
 #endif // wxUSE_IMAGE
 
+#if wxUSE_CAIRO && wxUSE_IMAGE
+
+// ----------------------------------------------------------------------------
+// wxGraphicsTiledRenderer: offscreen rendering using several threads
+// ----------------------------------------------------------------------------
+
+// Renders an image by splitting it into tiles drawn concurrently by several
+// threads, each into its own Cairo image surface, and combining them.
+//
+// The paint function is called once for every tile with a context using the
+// coordinates of the entire image, so it must draw the same thing every time
+// and be safe to call from several threads at once. In particular, it must
+// not share pens, brushes, fonts or other reference-counted objects between
+// the calls, but create them using the context it is given.
+//
+// The tile surfaces and the threads are kept and reused by the subsequent
+// Render() calls, so using the same object for rendering several frames is
+// more efficient than creating a new one every time.
+class wxGraphicsTiledRenderer
+{
+public:
+    using PaintFunction = std::function<void (wxGraphicsContext& gc)>;
+
+    // Use the number of threads appropriate for this machine if it is 0.
+    explicit wxGraphicsTiledRenderer(wxSize tileSize = wxSize(256, 256),
+                                     unsigned threads = 0);
+    ~wxGraphicsTiledRenderer();
+
+    wxGraphicsTiledRenderer(const wxGraphicsTiledRenderer&) = delete;
+    wxGraphicsTiledRenderer& operator=(const wxGraphicsTiledRenderer&) = delete;
+
+    wxSize GetTileSize() const;
+    unsigned GetThreadCount() const;
+
+    // Returns an image with alpha channel, transparent where nothing was
+    // drawn, or an invalid image, after logging an error, if rendering
+    // failed.
+    wxImage RenderToImage(wxSize size, const PaintFunction& paint);
+
+    wxBitmap RenderToBitmap(wxSize size, const PaintFunction& paint);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+#endif // wxUSE_CAIRO && wxUSE_IMAGE
+
 #endif // wxUSE_GRAPHICS_CONTEXT
 
 #endif // _WX_GRAPHICS_H_
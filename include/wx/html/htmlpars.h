@@ -175,6 +175,7 @@ protected:
     // DOM tree:
     wxHtmlTag *m_CurTag{nullptr};
     wxHtmlTag *m_Tags{nullptr};
+    wxHtmlTagsArena *m_TagsArena{nullptr};
     wxHtmlTextPieces *m_TextPieces{nullptr};
     size_t m_CurTextPiece{0};
 
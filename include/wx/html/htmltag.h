@@ -135,6 +135,9 @@ public:
     wxString::const_iterator GetEndIter2() const { return m_End2; }
 
 private:
+    // returns the index of the given parameter or -1 if there is none
+    int FindParam(const wxString& par) const;
+
     wxString m_Name;
     bool m_hasEnding;
     wxString::const_iterator m_Begin, m_End1, m_End2;
@@ -151,6 +154,35 @@ private:
 	wxHtmlTag& operator=(const wxHtmlTag&) = delete;
 };
 
+
+//-----------------------------------------------------------------------------
+// wxHtmlTagsArena
+//          - internal wxHTML class, do not use!
+//          Owns all tags of a single DOM tree: they are allocated in blocks
+//          instead of individually and are all destroyed together with it.
+//-----------------------------------------------------------------------------
+
+class wxHtmlTagsArena
+{
+public:
+    wxHtmlTagsArena() = default;
+    ~wxHtmlTagsArena();
+
+    wxHtmlTagsArena(const wxHtmlTagsArena&) = delete;
+	wxHtmlTagsArena& operator=(const wxHtmlTagsArena&) = delete;
+
+    // Returns uninitialized memory for a new tag, which must be constructed
+    // in it immediately.
+    void *Allocate();
+
+private:
+    static constexpr size_t TagsPerBlock = 256;
+
+    std::vector<void*> m_blocks;
+    // number of tags used in the last block
+    size_t m_used{TagsPerBlock};
+};
+
 #endif // wxUSE_HTML
 
 #endif // _WX_HTMLTAG_H_
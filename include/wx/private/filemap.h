@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/filemap.h
+// Purpose:     read-only memory mapping of the files
+// Copyright:   (c) 2021 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_FILEMAP_H_
+#define _WX_PRIVATE_FILEMAP_H_
+
+import WX.File.Flags;
+
+import <cstddef>;
+import <span>;
+import <string>;
+import <vector>;
+
+// ----------------------------------------------------------------------------
+// wxMappedFile: the contents of a file mapped into memory
+// ----------------------------------------------------------------------------
+
+// Maps the whole file into the address space of the process, read-only, and
+// gives access to its contents as a span of bytes.
+//
+// If the platform doesn't support memory mapping, or mapping this particular
+// file failed (which can happen for special files), its contents are read
+// into memory instead, so the caller doesn't need to deal with this case.
+//
+// The contents are never modified, so they can be accessed from several
+// threads at once.
+class wxMappedFile
+{
+public:
+    wxMappedFile() = default;
+    explicit wxMappedFile(const std::string& filename) { Open(filename); }
+
+    wxMappedFile(const wxMappedFile&) = delete;
+    wxMappedFile& operator=(const wxMappedFile&) = delete;
+
+    ~wxMappedFile() { Close(); }
+
+    // Open the file, closing the previously opened one, if any.
+    bool Open(const std::string& filename);
+    void Close();
+
+    bool IsOpened() const { return m_isOpened; }
+
+    // Access the file contents: notice that the data pointer is null for the
+    // empty files.
+    const std::byte* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    std::span<const std::byte> GetSpan() const { return {m_data, m_size}; }
+
+    // Returns true if the file is really mapped and not just read in memory.
+    bool IsMapped() const { return m_isMapped; }
+
+    // Let the system optimize reading the file for the given access pattern.
+    // This is just a hint, which may be ignored, and does nothing if the file
+    // is not mapped.
+    bool Advise(wxFileAccessHint access);
+
+private:
+    const std::byte* m_data{nullptr};
+    size_t m_size{0};
+
+    // Only used if the file couldn't be mapped.
+    std::vector<std::byte> m_buffer;
+
+    bool m_isOpened{false};
+    bool m_isMapped{false};
+};
+
+#endif // _WX_PRIVATE_FILEMAP_H_
@@ -98,10 +98,10 @@ public:
         return ret;
     }
 
-    // Check whether any filespec matches the file's ext (if present)
-    bool MatchesFilespec(const wxFileName& fn, const wxString& filespec) const
+    // Check whether the watch filespec, if any, matches the file name
+    bool MatchesFilespec(const wxFileName& fn, const wxFSWatchInfo& watch) const
     {
-        return filespec.empty() || wxMatchWild(filespec, fn.GetFullName());
+        return watch.MatchesFilespec(fn.GetFullName());
     }
 
 protected:
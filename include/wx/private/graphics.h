@@ -161,6 +161,84 @@ public :
     virtual bool Contains( float x, float y, wxPolygonFillMode fillStyle = wxPolygonFillMode::OddEven) const=0;
 };
 
+// Build the path containing all primitives of the batch using the given sink
+// object, which must have MoveTo(x, y), LineTo(x, y), ClosePath(),
+// AddRectangle(x, y, w, h) and AddEllipse(x, y, w, h) methods. This allows the
+// renderers to construct their native paths directly.
+template <typename Sink>
+void wxBuildGraphicsBatchPath(const wxGraphicsBatch& batch, Sink& sink)
+{
+    for ( const auto& r : batch.GetRectangles() )
+        sink.AddRectangle(r.x, r.y, r.width, r.height);
+
+    for ( const auto& e : batch.GetEllipses() )
+        sink.AddEllipse(e.x, e.y, e.width, e.height);
+
+    const auto& points = batch.GetPoints();
+
+    for ( const auto& run : batch.GetMarkers() )
+    {
+        const float s = run.size;
+        const float h = s / 2;
+
+        for ( size_t n = run.first; n < run.first + run.count; ++n )
+        {
+            const float x = points[n].x;
+            const float y = points[n].y;
+
+            switch ( run.shape )
+            {
+                case wxGraphicsMarker::Square:
+                    sink.AddRectangle(x - h, y - h, s, s);
+                    break;
+
+                case wxGraphicsMarker::Circle:
+                    sink.AddEllipse(x - h, y - h, s, s);
+                    break;
+
+                case wxGraphicsMarker::Diamond:
+                    sink.MoveTo(x, y - h);
+                    sink.LineTo(x + h, y);
+                    sink.LineTo(x, y + h);
+                    sink.LineTo(x - h, y);
+                    sink.ClosePath();
+                    break;
+
+                case wxGraphicsMarker::Triangle:
+                    sink.MoveTo(x, y - h);
+                    sink.LineTo(x + h, y + h);
+                    sink.LineTo(x - h, y + h);
+                    sink.ClosePath();
+                    break;
+
+                case wxGraphicsMarker::Cross:
+                    sink.MoveTo(x - h, y - h);
+                    sink.LineTo(x + h, y + h);
+                    sink.MoveTo(x + h, y - h);
+                    sink.LineTo(x - h, y + h);
+                    break;
+
+                case wxGraphicsMarker::Plus:
+                    sink.MoveTo(x - h, y);
+                    sink.LineTo(x + h, y);
+                    sink.MoveTo(x, y - h);
+                    sink.LineTo(x, y + h);
+                    break;
+            }
+        }
+    }
+
+    for ( const auto& line : batch.GetPolylines() )
+    {
+        sink.MoveTo(points[line.first].x, points[line.first].y);
+        for ( size_t n = line.first + 1; n < line.first + line.count; ++n )
+            sink.LineTo(points[n].x, points[n].y);
+
+        if ( line.closed )
+            sink.ClosePath();
+    }
+}
+
 #endif
 
 #endif // _WX_GRAPHICS_PRIVATE_H_
@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/parallel.h
+// Purpose:     helpers for splitting work between several threads
+// Copyright:   (c) 2021 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_PARALLEL_H_
+#define _WX_PRIVATE_PARALLEL_H_
+
+import <algorithm>;
+import <condition_variable>;
+import <deque>;
+import <functional>;
+import <future>;
+import <memory>;
+import <mutex>;
+import <thread>;
+import <type_traits>;
+import <vector>;
+
+// ----------------------------------------------------------------------------
+// wxGetParallelism: number of threads worth using for CPU-bound work
+// ----------------------------------------------------------------------------
+
+inline unsigned wxGetParallelism(unsigned maxThreads = 8)
+{
+#if wxUSE_THREADS
+    return std::clamp(std::thread::hardware_concurrency(), 1u, maxThreads);
+#else
+    return 1;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// wxParallelStableSort: std::stable_sort() using several threads if possible
+// ----------------------------------------------------------------------------
+
+// Ranges smaller than this are always sorted in the calling thread, as the
+// cost of starting the threads would outweigh any gains.
+inline constexpr std::ptrdiff_t wxPARALLEL_SORT_MIN_SIZE = 32768;
+
+// Sorts the range by splitting it into chunks sorted concurrently and merging
+// them afterwards, which preserves the relative order of the equal elements.
+//
+// The comparator must be safe to call from several threads at once.
+template <typename RandomIt, typename Compare>
+void wxParallelStableSort(RandomIt first, RandomIt last, Compare comp)
+{
+    const auto count = last - first;
+    const unsigned chunks = wxGetParallelism();
+    if ( count < wxPARALLEL_SORT_MIN_SIZE || chunks < 2 )
+    {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+
+#if wxUSE_THREADS
+    std::vector<RandomIt> bounds;
+    bounds.reserve(chunks + 1);
+    for ( unsigned n = 0; n < chunks; n++ )
+        bounds.push_back(first + count * n / chunks);
+    bounds.push_back(last);
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(chunks - 1);
+        for ( unsigned n = 1; n < chunks; n++ )
+        {
+            workers.emplace_back([&bounds, &comp, n]()
+                {
+                    std::stable_sort(bounds[n], bounds[n + 1], comp);
+                });
+        }
+
+        std::stable_sort(bounds[0], bounds[1], comp);
+    } // wait for all the workers to finish
+
+    // Merge the adjacent sorted chunks pairwise, doubling their size on each
+    // pass, until there is only one left.
+    for ( unsigned width = 1; width < chunks; width *= 2 )
+    {
+        for ( unsigned n = 0; n + width < chunks; n += 2 * width )
+        {
+            std::inplace_merge(bounds[n],
+                               bounds[n + width],
+                               bounds[std::min(n + 2 * width, chunks)],
+                               comp);
+        }
+    }
+#endif // wxUSE_THREADS
+}
+
+// ----------------------------------------------------------------------------
+// wxWorkerPool: fixed set of threads executing the submitted tasks
+// ----------------------------------------------------------------------------
+
+// Tasks are started in the order of their submission, but may complete in any
+// order, use the returned futures to retrieve their results in the order
+// needed by the caller.
+//
+// Destroying the pool waits until all the tasks already submitted to it are
+// done. If threads are not available, the tasks are simply executed by
+// Submit() itself.
+class wxWorkerPool
+{
+public:
+    explicit wxWorkerPool(unsigned threads = wxGetParallelism())
+    {
+#if wxUSE_THREADS
+        m_threads.reserve(threads);
+        for ( unsigned n = 0; n < threads; n++ )
+            m_threads.emplace_back([this]() { Run(); });
+#else
+        (void)threads;
+#endif
+    }
+
+    wxWorkerPool(const wxWorkerPool&) = delete;
+    wxWorkerPool& operator=(const wxWorkerPool&) = delete;
+
+    ~wxWorkerPool()
+    {
+#if wxUSE_THREADS
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_cond.notify_all();
+#endif
+    }
+
+    // Returns the number of the threads used, at least 1.
+    unsigned GetThreadCount() const
+    {
+        return m_threads.empty() ? 1 : static_cast<unsigned>(m_threads.size());
+    }
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> Submit(F&& func)
+    {
+        // std::function<> requires a copyable target, so hold the task by
+        // pointer.
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>
+                    (
+                        std::forward<F>(func)
+                    );
+
+        auto result = task->get_future();
+
+#if wxUSE_THREADS
+        if ( !m_threads.empty() )
+        {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_tasks.emplace_back([task]() { (*task)(); });
+            }
+
+            m_cond.notify_one();
+
+            return result;
+        }
+#endif // wxUSE_THREADS
+
+        (*task)();
+
+        return result;
+    }
+
+private:
+#if wxUSE_THREADS
+    void Run()
+    {
+        for ( ;; )
+        {
+            std::function<void ()> task;
+
+            {
+                std::unique_lock lock(m_mutex);
+                m_cond.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+                // Only exit once all the pending tasks have been executed.
+                if ( m_tasks.empty() )
+                    return;
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::function<void ()>> m_tasks;
+    bool m_stopping{false};
+#endif // wxUSE_THREADS
+
+    // This must be the last member to ensure that the threads are joined
+    // before destroying the other ones.
+    std::vector<std::jthread> m_threads;
+};
+
+#endif // _WX_PRIVATE_PARALLEL_H_
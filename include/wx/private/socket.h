@@ -249,6 +249,21 @@ public:
     int Read(void *buffer, int size);
     int Write(const void *buffer, int size);
 
+    // write the data from several buffers, skipping the given number of bytes
+    // at the beginning of the first one, only works for TCP sockets
+    //
+    // returns the total number of bytes written or -1 on error
+    int WriteV(std::span<const wxSocketIOVec> buffers, std::uint32_t offset);
+
+#ifdef __LINUX__
+    // send the data from the given file descriptor using sendfile(),
+    // advancing the offset by the number of bytes written, only works for
+    // TCP sockets
+    //
+    // returns the number of bytes written or -1 on error
+    int SendFile(int fd, off_t *offset, std::uint32_t size);
+#endif // __LINUX__
+
     // basically a wrapper for select(): returns the condition of the socket,
     // blocking for not longer than timeout if it is specified (otherwise just
     // poll without blocking at all)
@@ -355,6 +370,7 @@ private:
     int RecvStream(void *buffer, int size);
     int RecvDgram(void *buffer, int size);
     int SendStream(const void *buffer, int size);
+    int SendStreamV(std::span<const wxSocketIOVec> buffers, std::uint32_t offset);
     int SendDgram(const void *buffer, int size);
 
 
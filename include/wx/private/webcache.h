@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/webcache.h
+// Purpose:     On-disk cache of HTTP responses
+// Created:     2026-10-19
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_WEBCACHE_H_
+#define _WX_PRIVATE_WEBCACHE_H_
+
+#if wxUSE_WEBREQUEST
+
+#include "wx/webrequest.h"
+#include "wx/private/webrequest.h"
+
+import <cstdint>;
+import <ctime>;
+import <functional>;
+import <list>;
+import <memory>;
+import <mutex>;
+import <string>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+
+// ----------------------------------------------------------------------------
+// wxWebCacheEntry: a response stored in wxWebCache
+// ----------------------------------------------------------------------------
+
+// Entries are never modified once they're created, so they can be used
+// without locking, even if the cache itself is updated in the meanwhile.
+class wxWebCacheEntry
+{
+public:
+    const wxString& GetURL() const { return m_url; }
+
+    int GetStatus() const { return m_status; }
+    const wxString& GetStatusText() const { return m_statusText; }
+
+    // Return the value of one of the stored response headers, the name is
+    // case-insensitive.
+    wxString GetHeader(const wxString& name) const;
+
+    // Return true if the entry can be used without asking the server first.
+    bool IsFresh() const { return std::time(nullptr) < m_expires; }
+
+    // Return true if the entry can be revalidated with a conditional request.
+    bool HasValidators() const
+    {
+        return !GetHeader("ETag").empty() || !GetHeader("Last-Modified").empty();
+    }
+
+    // The file containing the response body, which can be mapped into memory.
+    const std::string& GetBodyFile() const { return m_bodyFile; }
+
+    std::uint64_t GetSize() const { return m_size; }
+
+private:
+    friend class wxWebCache;
+
+    wxString m_url;
+
+    // The names and values of the request headers listed in the Vary header
+    // of the response.
+    std::vector<std::pair<wxString, wxString>> m_vary;
+
+    int m_status{0};
+    wxString m_statusText;
+
+    // Response headers, with the names in upper case.
+    wxWebRequestHeaderMap m_headers;
+
+    std::time_t m_expires{0};
+
+    // Base name of the files used by this entry.
+    std::string m_name;
+    std::string m_bodyFile;
+    std::uint64_t m_size{0};
+};
+
+using wxWebCacheEntryPtr = std::shared_ptr<const wxWebCacheEntry>;
+
+// ----------------------------------------------------------------------------
+// wxWebCache: size-limited private HTTP cache
+// ----------------------------------------------------------------------------
+
+// The cache stores the bodies of the responses in separate files, next to
+// small text files with their metadata, in the given directory. The entries
+// are found by their URL and the values of the request headers listed in the
+// Vary header of the response. When the total size of the stored bodies
+// exceeds the limit, the least recently used entries are removed.
+//
+// All methods of this class are thread-safe.
+class wxWebCache
+{
+public:
+    // Function returning the value of the given response header, or an empty
+    // string if there is no such header.
+    using HeaderGetter = std::function<wxString (const wxString& name)>;
+
+    // Function writing the response body to the file with the given name.
+    using BodyWriter = std::function<bool (const std::string& filename)>;
+
+    // Creates the directory if necessary and loads the existing entries.
+    wxWebCache(const std::string& dir, std::uint64_t maxSize);
+
+    wxWebCache(const wxWebCache&) = delete;
+    wxWebCache& operator=(const wxWebCache&) = delete;
+
+    bool IsOk() const { return m_ok; }
+
+    const std::string& GetDir() const { return m_dir; }
+
+    std::uint64_t GetMaxSize() const { return m_maxSize; }
+
+    std::uint64_t GetTotalSize() const;
+
+    // Return true if the response with the given status and headers can be
+    // stored in the cache.
+    static bool IsCacheable(int status, const HeaderGetter& getHeader);
+
+    // Find the entry for the given URL which was stored for a request with the
+    // same values of the headers that the response varies on.
+    wxWebCacheEntryPtr Find(const wxString& url,
+                            const wxWebRequestHeaderMap& requestHeaders);
+
+    // Store a new response, replacing the existing entry, if any. Returns
+    // null if the response can't be cached or writing it failed.
+    wxWebCacheEntryPtr Store(const wxString& url,
+                             const wxWebRequestHeaderMap& requestHeaders,
+                             int status,
+                             const wxString& statusText,
+                             const HeaderGetter& getHeader,
+                             const BodyWriter& writeBody);
+
+    // Update the entry after the server confirmed that it's still valid by
+    // responding with "304 Not Modified" with the given headers.
+    wxWebCacheEntryPtr Revalidated(const wxWebCacheEntryPtr& entry,
+                                   const HeaderGetter& getHeader);
+
+    // Remove the entry, e.g. if the resource doesn't exist any longer.
+    void Remove(const wxWebCacheEntryPtr& entry);
+
+private:
+    using EntryList = std::list<wxWebCacheEntryPtr>;
+
+    std::string GetMetaFile(const std::string& name) const;
+
+    bool WriteMetaFile(const wxWebCacheEntry& entry) const;
+    wxWebCacheEntryPtr ReadMetaFile(const std::string& filename) const;
+
+    // All the functions below must be called with the mutex locked.
+    void Load();
+    void Insert(const wxWebCacheEntryPtr& entry);
+    void Erase(const std::string& name, bool removeFiles);
+    void Evict();
+
+    const std::string m_dir;
+    const std::uint64_t m_maxSize;
+    bool m_ok{false};
+
+    mutable std::mutex m_mutex;
+
+    // All entries, from the most to the least recently used one.
+    EntryList m_lru;
+
+    // Index of the entries by their names.
+    std::unordered_map<std::string, EntryList::iterator> m_entries;
+
+    // Index of the entry names by the URL (there can be more than one for
+    // the same URL if the responses vary on some request headers).
+    std::unordered_multimap<std::string, std::string> m_byURL;
+
+    std::uint64_t m_totalSize{0};
+};
+
+// Return the cache of the default wxWebSession if it was created and has the
+// cache enabled or null otherwise.
+//
+// If the cache is returned, the headers are filled with the common headers of
+// this session: they must be sent with any request whose response is looked
+// up or stored in the cache, as the responses may vary on them.
+std::shared_ptr<wxWebCache>
+wxGetDefaultWebCache(wxWebRequestHeaderMap* headers = nullptr);
+
+#endif // wxUSE_WEBREQUEST
+
+#endif // _WX_PRIVATE_WEBCACHE_H_
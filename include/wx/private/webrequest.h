@@ -15,6 +15,10 @@
 
 import WX.Cmn.FFile;
 
+import <memory>;
+
+class wxWebCacheEntry;
+
 WX_DECLARE_STRING_HASH_MAP(wxString, wxWebRequestHeaderMap);
 
 // Default buffer size when a fixed-size buffer must be used.
@@ -62,6 +66,31 @@ public:
 
     wxWebRequest::Storage GetStorage() const { return m_storage; }
 
+    void SetDataConsumer(const wxWebRequest::DataConsumer& consumer)
+        { m_dataConsumer = consumer; }
+
+    const wxWebRequest::DataConsumer& GetDataConsumer() const
+        { return m_dataConsumer; }
+
+    void SetPriority(int priority) { m_priority = priority; }
+
+    int GetPriority() const { return m_priority; }
+
+    // Use the given cache for the request to the given URL, must be called
+    // before starting the request.
+    void UseCache(const std::shared_ptr<wxWebCache>& cache, const wxString& url)
+        { m_cache = cache; m_cacheURL = url; }
+
+    // Called before Start() and returns true if the request was satisfied from
+    // the cache and so doesn't need to be started at all. Otherwise, may add
+    // the headers needed for revalidating the cached response.
+    bool StartFromCache();
+
+    // Return the response taken from the cache, if any, or the one received
+    // from the server.
+    wxWebResponseImplPtr GetActualResponse() const
+        { return m_cachedResponse ? m_cachedResponse : GetResponse(); }
+
     // Precondition for this method checked by caller: current state is idle.
     virtual void Start() = 0;
 
@@ -114,6 +143,8 @@ protected:
     wxWebRequestHeaderMap m_headers;
     wxFileOffset m_dataSize{0};
     std::unique_ptr<wxInputStream> m_dataStream;
+    wxWebRequest::DataConsumer m_dataConsumer;
+    int m_priority{0};
     bool m_peerVerifyDisabled{false};
 
     wxWebRequestImpl(wxWebSession& session,
@@ -138,8 +169,26 @@ private:
     wxFileOffset m_bytesReceived{0};
     wxCharBuffer m_dataText;
 
+    // Store the response in the cache or use the cached one if the server
+    // reports that it wasn't modified, called when the request completes.
+    // Returns false if the cached response should be used but is not
+    // available any more.
+    bool UpdateCache();
+
     // Initially false, set to true after the first call to Cancel().
     bool m_cancelled{false};
+
+    std::shared_ptr<wxWebCache> m_cache;
+    wxString m_cacheURL;
+
+    // Set if the request is eligible for using the cache when it's started.
+    bool m_useCache{false};
+
+    // The cached entry being revalidated, if any.
+    std::shared_ptr<const wxWebCacheEntry> m_cacheEntry;
+
+    // The response created from m_cacheEntry.
+    wxWebResponseImplPtr m_cachedResponse;
 };
 
 // ----------------------------------------------------------------------------
@@ -171,6 +220,8 @@ public:
 
     virtual wxString GetDataFile() const;
 
+    virtual bool IsFromCache() const { return false; }
+
 protected:
     wxWebRequestImpl& m_request;
     size_t m_readSize;
@@ -237,8 +288,18 @@ public:
 
     const wxWebRequestHeaderMap& GetHeaders() const { return m_headers; }
 
+    // Only the backends which schedule the requests themselves take this
+    // value into account, the others ignore it.
+    virtual void SetMaxConcurrency(int maxActive) { m_maxConcurrency = maxActive; }
+
+    int GetMaxConcurrency() const { return m_maxConcurrency; }
+
     virtual wxWebSessionHandle GetNativeHandle() const = 0;
 
+    void SetCache(const std::shared_ptr<wxWebCache>& cache) { m_cache = cache; }
+
+    const std::shared_ptr<wxWebCache>& GetCache() const { return m_cache; }
+
 protected:
     wxWebSessionImpl();
 
@@ -248,9 +309,15 @@ private:
 
     wxWebRequestHeaderMap m_headers;
     wxString m_tempDir;
+    int m_maxConcurrency{0};
+    std::shared_ptr<wxWebCache> m_cache;
 
     wxWebSessionImpl(const wxWebSessionImpl&) = delete;
 	wxWebSessionImpl& operator=(const wxWebSessionImpl&) = delete;
 };
 
+// Return the implementation of the default session if it was already created
+// or null otherwise.
+wxWebSessionImpl* wxGetDefaultWebSessionImpl();
+
 #endif // _WX_PRIVATE_WEBREQUEST_H_
@@ -20,6 +20,7 @@
 
 #include "curl/curl.h"
 
+import <deque>;
 import <vector>;
 
 class wxWebRequestCURL;
@@ -108,6 +109,8 @@ public:
 
     wxString GetStatusText() const override { return m_statusText; }
 
+    // Return true if the data consumer asked to stop the transfer.
+    bool WasAborted() const { return m_aborted; }
 
     // Methods called from libcurl callbacks
     size_t CURLOnWrite(void *buffer, size_t size);
@@ -118,6 +121,7 @@ private:
     wxWebRequestHeaderMap m_headers;
     wxString m_statusText;
     wxFileOffset m_knownDownloadSize;
+    bool m_aborted;
 
     CURL* GetHandle() const
     { return static_cast<wxWebRequestCURL&>(m_request).GetHandle(); }
@@ -152,6 +156,12 @@ public:
 
     void RequestHasTerminated(wxWebRequestCURL* request);
 
+    void SetMaxConcurrency(int maxActive) override;
+
+    // Get an easy handle, reusing a previously released one if possible, and
+    // set the options common to all requests using this session for it.
+    CURL* AcquireHandle();
+
     static bool CurlRuntimeAtLeastVersion(unsigned int, unsigned int,
                                           unsigned int);
 
@@ -168,6 +178,11 @@ private:
     void FailRequest(CURL*, const wxString&);
     void StopActiveTransfer(CURL*);
     void RemoveActiveSocket(CURL*);
+    void ReleaseHandle(CURL*);
+    bool CanStartTransfer() const;
+    void StartQueuedRequests();
+    void ScheduleQueuedRequests();
+    void RemoveQueuedRequest(wxWebRequestCURL* request);
 
     WX_DECLARE_HASH_MAP(CURL*, wxWebRequestCURL*, wxPointerHash, \
                         wxPointerEqual, TransferSet);
@@ -178,12 +193,25 @@ private:
     TransferSet m_activeTransfers;
     CurlSocketMap m_activeSockets;
 
+    // Requests waiting for a free slot when the maximal number of concurrent
+    // transfers is limited, sorted by decreasing priority.
+    std::deque<wxWebRequestCURL*> m_queuedRequests;
+    bool m_queuedRequestsScheduled;
+
+    // Easy handles of the terminated requests kept for reuse: they preserve
+    // their caches and the connections remain in the multi handle pool.
+    std::vector<CURL*> m_handlePool;
+
     SocketPoller* m_socketPoller;
     wxTimer m_timeoutTimer;
     CURLM* m_handle;
 
+    // Used for sharing TLS sessions and DNS entries between all our handles.
+    CURLSH* m_shareHandle;
+
     static int ms_activeSessions;
     static unsigned int ms_runtimeVersion;
+    static bool ms_runtimeHasHTTP2;
 
     wxWebSessionCURL(const wxWebSessionCURL&) = delete;
 	wxWebSessionCURL& operator=(const wxWebSessionCURL&) = delete;
@@ -802,6 +802,16 @@ public:
                           const wxColour& fgCol = wxNullColour,
                           const wxColour& bgCol = wxNullColour );
 
+    // Sets the function creating the children of a property on demand, when
+    // it is expanded for the first time, instead of creating them upfront.
+    // This is useful for grids with very many properties, most of which are
+    // never shown. The property is shown collapsed, with an expander button,
+    // and must not have any children yet. The provider is called only once
+    // and should add the children using AppendIn().
+    // Pass an empty provider to cancel the creation of the children.
+    void SetPropertyChildrenProvider( wxPGPropArg id,
+                                      wxPGChildrenProvider provider );
+
     // Sets client data (void*) of a property.
     // This untyped client data has to be deleted manually.
     void SetPropertyClientData( wxPGPropArg id, void* clientData )
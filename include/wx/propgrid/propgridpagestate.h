@@ -15,8 +15,16 @@
 
 #include "wx/propgrid/property.h"
 
+import <functional>;
+import <unordered_map>;
+import <vector>;
+
 inline constexpr unsigned int wxPG_DEFAULT_SPLITTERX = 110;
 
+// Function called to create the children of a property when it is expanded
+// for the first time, see wxPropertyGridInterface::SetPropertyChildrenProvider().
+using wxPGChildrenProvider = std::function<void (wxPGProperty* parent)>;
+
 // -----------------------------------------------------------------------
 
 // A return value from wxPropertyGrid::HitTest(),
@@ -346,6 +354,12 @@ public:
 
     wxPGProperty* DoGetItemAtY( int y ) const;
 
+    // Returns all the properties currently shown in the grid, in display
+    // order, so that the row i starts at the y coordinate i * row height.
+    // The returned array is rebuilt lazily when the set of the visible
+    // properties changes and is only valid until then.
+    const std::vector<wxPGProperty*>& GetVisibleRows() const;
+
     // Override this member function to add custom behaviour on property
     // insertion.
     virtual wxPGProperty* DoInsert( wxPGProperty* parent,
@@ -489,10 +503,7 @@ public:
                               bool fromOnResize = false );
 
     // Recalculates m_virtualHeight.
-    void RecalculateVirtualHeight()
-    {
-        m_virtualHeight = GetActualVirtualHeight();
-    }
+    void RecalculateVirtualHeight();
 
     void SetColumnCount( int colCount );
 
@@ -522,6 +533,26 @@ public:
     void VirtualHeightChanged()
     {
         m_vhCalcPending = true;
+        m_visibleRowsValid = false;
+    }
+
+    // Sets the function creating the children of the given property when it
+    // is expanded for the first time. Property can't have children yet.
+    void SetChildrenProvider( wxPGProperty* p, wxPGChildrenProvider provider );
+
+    // Returns true if the children of the property will be created when it
+    // is expanded.
+    bool HasChildrenProvider( const wxPGProperty* p ) const
+    {
+        return !m_childrenProviders.empty() &&
+                    m_childrenProviders.find(p) != m_childrenProviders.end();
+    }
+
+    // Returns true if the property has children or will have them when it
+    // is expanded.
+    bool IsExpandable( const wxPGProperty* p ) const
+    {
+        return p->GetChildCount() || HasChildrenProvider(p);
     }
 
     // Base append.
@@ -577,6 +608,15 @@ protected:
     // so it won't remain in the way of the user code.
     void DoInvalidateChildrenNames(wxPGProperty* p, bool recursive);
 
+    // Appends the visible descendants of the given property, in display
+    // order, to the provided array.
+    static void AppendVisibleRows( const wxPGProperty* parent,
+                                   std::vector<wxPGProperty*>& rows );
+
+    // Returns the index of the given property in the visible rows cache, which
+    // must be valid, or wxNOT_FOUND if it's not shown.
+    int FindVisibleRow( const wxPGProperty* p ) const;
+
     // Check if property contains given sub-category.
     bool IsChildCategory(wxPGProperty* p,
                          wxPropertyCategory* cat, bool recursive);
@@ -630,6 +670,21 @@ protected:
 
     bool                        m_vhCalcPending{false};
 
+    // Cache of the visible properties returned by GetVisibleRows().
+    mutable std::vector<wxPGProperty*> m_visibleRows;
+
+    // True if m_visibleRows is up to date.
+    mutable bool                m_visibleRowsValid{false};
+
+    // Position of the properties in m_visibleRows. Only the positions of the
+    // rows before m_visibleRowIndexEnd are up to date, the others are
+    // renumbered on demand after the rows were inserted or removed.
+    mutable std::unordered_map<const wxPGProperty*, size_t> m_visibleRowIndex;
+    mutable size_t              m_visibleRowIndexEnd{0};
+
+    // Functions creating children of the properties on demand.
+    std::unordered_map<const wxPGProperty*, wxPGChildrenProvider> m_childrenProviders;
+
     // True if splitter has been pre-set by the application.
     bool                        m_isSplitterPreSet{false};
 
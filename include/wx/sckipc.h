@@ -23,6 +23,8 @@
 import WX.Cmn.DataStream;
 import WX.Cmn.IpcBase;
 
+import <cstdint>;
+
 /*
  * Mini-DDE implementation
 
@@ -44,6 +46,10 @@ import WX.Cmn.IpcBase;
 
    Note that this limits the server in the ways it can send data to the
    client, i.e. it can't send unsolicited information.
+
+   Under Unix, if the server name is a path, a Unix domain socket is used
+   and the large data blocks are passed via shared memory instead of being
+   written to the socket, if both sides support it.
  *
  */
 
@@ -73,8 +79,28 @@ public:
     bool StopAdvise(const wxString& item) override;
     bool Disconnect() override;
 
-    // Will be used in the future to enable the compression but does nothing
-    // for now.
+    // Send the request without waiting for the reply, which can be retrieved
+    // later using GetReply(). If the server supports it, many requests can be
+    // outstanding at once, otherwise this just performs the request
+    // synchronously and remembers its result.
+    //
+    // Returns the request ID or 0 on error.
+    std::uint32_t RequestAsync(const wxString& item,
+                               wxIPCFormat format = wxIPC_TEXT);
+
+    // Wait for the reply to the request sent by RequestAsync(), returns null
+    // if the request failed. The returned pointer is only valid until the
+    // next request, as with Request().
+    const void *GetReply(std::uint32_t id, size_t *size = nullptr);
+
+    // All the messages sent between these calls are written to the socket at
+    // once, instead of one by one. The calls can be nested.
+    void BeginBatch();
+    void EndBatch();
+
+    // Enable the compression of the data sent over this connection, if the
+    // peer supports it (which is the case if it uses wxWidgets with zlib
+    // support), otherwise it's just ignored.
     void Compress(bool on);
 
 
@@ -101,6 +127,15 @@ protected:
     wxString m_topic;
 
 private:
+    // Read and process the incoming messages until the reply to this request
+    // arrives, return false if the connection was lost while doing it.
+    bool WaitForReply(std::uint32_t id);
+
+    // Read and process a single incoming message, return false on error or if
+    // the connection was lost.
+    bool ReadMessage();
+
+
     friend class wxTCPServer;
     friend class wxTCPClient;
     friend class wxTCPEventHandler;
@@ -120,14 +155,29 @@ public:
 
     wxConnectionBase *OnAcceptConnection(const wxString& topic) override;
 
+    // Don't support any optional protocol features in the connections
+    // accepted after this call, i.e. behave as the older versions of this
+    // class. This is mostly useful for testing compatibility with them.
+    void DisableFeatures() { m_featuresEnabled = false; }
+
+    // Fail to open the shared memory buffers of the clients connecting after
+    // this call, as if mapping them failed. This is only useful for testing
+    // that both sides fall back to using the socket in this case.
+    void SimulateSharedMemoryFailure() { m_sharedMemoryFails = true; }
+
 protected:
     wxSocketServer *m_server{nullptr};
 
+    bool m_featuresEnabled{true};
+    bool m_sharedMemoryFails{false};
+
 #ifdef __UNIX_LIKE__
     // the name of the file associated to the Unix domain socket, may be empty
     wxString m_filename;
 #endif // __UNIX_LIKE__
 
+    friend class wxTCPEventHandler;
+
     wxDECLARE_DYNAMIC_CLASS(wxTCPServer);
 };
 
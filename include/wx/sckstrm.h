@@ -24,6 +24,8 @@ public:
     wxSocketOutputStream(wxSocketBase& s);
     wxSocketOutputStream& operator=(wxSocketOutputStream&&) = delete;
 
+    wxOutputStream& WriteV(std::span<const wxStreamConstIOVec> buffers) override;
+
 protected:
     wxSocketBase *m_o_socket;
 
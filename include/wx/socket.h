@@ -21,7 +21,11 @@
 #include "wx/sckaddr.h"
 #include "wx/list.h"
 
+import WX.File.File;
+
 import <cstdint>;
+import <span>;
+import <vector>;
 #include <memory>
 
 class wxSocketImpl;
@@ -91,11 +95,25 @@ enum
     wxSOCKET_BLOCK          = 0x0010,
     wxSOCKET_REUSEADDR      = 0x0020,
     wxSOCKET_BROADCAST      = 0x0040,
-    wxSOCKET_NOBIND         = 0x0080
+    wxSOCKET_NOBIND         = 0x0080,
+
+    // read more data than requested from a stream socket and keep it in an
+    // internal buffer: this is much more efficient for the protocols reading
+    // many small pieces of data, but no wxSOCKET_INPUT events are generated
+    // for the data already in this buffer, so IsData() must be checked to see
+    // if there is any more of it before waiting for the next event
+    wxSOCKET_READAHEAD      = 0x0100
 };
 
 using wxSocketFlags = int;
 
+// element of the buffer list used by wxSocketBase::WriteV()
+struct wxSocketIOVec
+{
+    const void *data;
+    std::uint32_t size;
+};
+
 // socket kind values (badly defined, don't use)
 enum wxSocketType
 {
@@ -159,6 +177,15 @@ public:
     wxSocketBase& Write(const void *buffer, std::uint32_t nbytes);
     wxSocketBase& WriteMsg(const void *buffer, std::uint32_t nbytes);
 
+    // write the data from all the buffers, in order, as if Write() were called
+    // for each of them, but using as few system calls as possible
+    wxSocketBase& WriteV(std::span<const wxSocketIOVec> buffers);
+
+    // write the given number of bytes from the file, starting at its current
+    // position, which is advanced by the number of bytes written; this avoids
+    // copying the data into the process memory when possible
+    wxSocketBase& SendFile(wxFile& file, std::uint32_t nbytes);
+
     // all Wait() functions wait until their condition is satisfied or the
     // timeout expires; if seconds == -1 (default) then m_timeout value is used
     //
@@ -244,6 +271,11 @@ private:
     // low level IO
     std::uint32_t DoRead(void* buffer, std::uint32_t nbytes);
     std::uint32_t DoWrite(const void *buffer, std::uint32_t nbytes);
+    std::uint32_t DoWriteV(std::span<const wxSocketIOVec> buffers);
+    std::uint32_t DoSendFile(wxFile& file, std::uint32_t nbytes);
+
+    // read from the socket itself, using the read-ahead buffer if enabled
+    int ReadFromImpl(char *buffer, std::uint32_t nbytes);
 
     // wait until the given flags are set for this socket or the given timeout
     // (or m_timeout) expires
@@ -268,6 +300,7 @@ private:
     // pushback buffer
     void     Pushback(const void *buffer, std::uint32_t size);
     std::uint32_t GetPushback(void *buffer, std::uint32_t size, bool peek);
+    bool HasPushback() const { return m_unrd_cur < m_unrd_size; }
 
     // store the given error as the LastError()
     void SetError(wxSocketError error);
@@ -294,10 +327,11 @@ private:
     bool          m_beingDeleted;     // marked for delayed deletion?
     wxIPV4address m_localAddress;     // bind to local address?
 
-    // pushback buffer
-    void         *m_unread;           // pushback buffer
-    std::uint32_t      m_unrd_size;        // pushback buffer size
+    // pushback buffer, also used for the data read ahead
+    std::vector<char> m_unread;       // pushback buffer
+    std::uint32_t      m_unrd_size;        // end of the data in the buffer
     std::uint32_t      m_unrd_cur;         // pushback pointer (index into buffer)
+    bool          m_readAheadNotified; // input event sent for read-ahead data?
 
     // events
     int           m_id;               // socket id
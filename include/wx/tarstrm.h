@@ -15,7 +15,9 @@ import WX.File.Flags;
 import WX.Cmn.ArchStream;
 
 import <cstdint>;
+import <unordered_map>;
 import <utility>;
+import <vector>;
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -73,6 +75,7 @@ public:
     int          GetGroupId() const             { return m_GroupId; }
     wxFileOffset GetSize() const override                { return m_Size; }
     wxFileOffset GetOffset() const override              { return m_Offset; }
+    wxFileOffset GetHeaderOffset() const        { return m_HeaderOffset; }
     wxDateTime   GetDateTime() const override            { return m_ModifyTime; }
     wxDateTime   GetAccessTime() const          { return m_AccessTime; }
     wxDateTime   GetCreateTime() const          { return m_CreateTime; }
@@ -127,6 +130,7 @@ private:
     int          m_GroupId;
     wxFileOffset m_Size;
     wxFileOffset m_Offset;
+    wxFileOffset m_HeaderOffset{wxInvalidOffset};
     wxDateTime   m_ModifyTime;
     wxDateTime   m_AccessTime;
     wxDateTime   m_CreateTime;
@@ -164,6 +168,10 @@ public:
 
     wxTarEntry *GetNextEntry();
 
+    // Read the entry whose headers start at the given offset, as returned by
+    // wxTarEntry::GetHeaderOffset(), and open it. Requires a seekable stream.
+    wxTarEntry *GetEntryAt(wxFileOffset headerOffset);
+
     wxFileOffset GetLength() const override      { return m_size; }
     bool IsSeekable() const override { return m_parent_i_stream->IsSeekable(); }
 
@@ -179,6 +187,7 @@ private:
 
     wxStreamError ReadHeaders();
     bool ReadExtendedHeader(wxTarHeaderRecords*& recs);
+    bool ReadGnuLongName(const wxString& key);
 
     wxString GetExtendedHeader(const wxString& key) const;
     wxString GetHeaderPath() const;
@@ -189,6 +198,7 @@ private:
     wxFileOffset m_pos;     // position within the current entry
     wxFileOffset m_offset;  // offset to the start of the entry's data
     wxFileOffset m_size;    // size of the current entry's data
+    wxFileOffset m_headeroffset; // offset to the current entry's headers
 
     int m_sumType;
     int m_tarType;
@@ -198,6 +208,62 @@ private:
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxTarIndex
+//
+// The positions of the entries in a tar archive, built by reading all of its
+// headers once, which allows to open any entry directly afterwards instead of
+// reading the archive sequentially up to it. The index can be saved to a
+// separate file and loaded back to avoid rebuilding it later, it is the
+// caller's responsibility to ensure that it still corresponds to the archive.
+//
+// The const methods can be called from several threads at once, so each of
+// them can extract different entries using its own wxTarInputStream.
+
+class wxTarIndex
+{
+public:
+    struct Entry
+    {
+        wxString     name;          // internal name, see wxTarEntry
+        wxFileOffset headerOffset;  // see wxTarEntry::GetHeaderOffset()
+        wxFileOffset dataOffset;    // see wxTarEntry::GetOffset()
+        wxFileOffset size;
+        int          typeFlag;
+    };
+
+    // Read all the headers of the archive from the current position, the
+    // stream should be seekable for this to be fast, as the entries data is
+    // skipped then.
+    bool Build(wxTarInputStream& stream);
+
+    bool Save(wxOutputStream& stream) const;
+    bool Load(wxInputStream& stream);
+
+    void Clear();
+
+    size_t GetCount() const                     { return m_entries.size(); }
+    const Entry& GetEntry(size_t n) const       { return m_entries[n]; }
+
+    // Find the entry with the given name, the last one if there are several
+    // entries with the same name, as it replaces all the previous ones when
+    // extracting the archive. Returns NULL if not found.
+    const Entry *FindEntry(const wxString& name,
+                           wxPathFormat format = wxPATH_NATIVE) const;
+
+    // Position the stream, which must be seekable, at the start of the data
+    // of the given entry and return its full meta data, or NULL on error.
+    wxTarEntry *OpenEntry(wxTarInputStream& stream, const Entry& entry) const
+        { return stream.GetEntryAt(entry.headerOffset); }
+
+private:
+    void AddEntry(Entry&& entry);
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<wxString, size_t> m_byName;
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // wxTarOutputStream
 
@@ -485,6 +485,17 @@
 // Recommended setting: 1 if you need LZMA compression.
 #define wxUSE_LIBLZMA       0
 
+// Set to 1 if libzstd is available to enable wxZstd{Input,Output}Stream
+// classes.
+//
+// As for wxUSE_LIBLZMA above, libzstd headers and libraries must be available
+// when enabling this option without using CMake.
+//
+// Default is 0, auto-detected by CMake.
+//
+// Recommended setting: 1 if you need Zstandard compression.
+#define wxUSE_ZSTD          0
+
 // Joystick support class
 #define wxUSE_JOYSTICK            1
 
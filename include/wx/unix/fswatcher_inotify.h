@@ -25,10 +25,26 @@ public:
 
     virtual ~wxInotifyFileSystemWatcher();
 
+    bool AddTree(const wxFileName& path, int events = wxFSW_EVENT_ALL,
+                 const std::string& filespec = {}) override;
+
+    bool RemoveTree(const wxFileName& path) override;
+
+    bool RemoveAll() override;
+
     void OnDirDeleted(const wxString& path);
 
 protected:
     bool Init();
+
+private:
+    // Called in the main thread with the subdirectories of the tree added
+    // asynchronously with the given id.
+    void OnTreeScanned(unsigned id, const std::vector<std::string>& dirs);
+
+    // State of the asynchronous AddTree() calls, only created when needed.
+    struct AsyncTrees;
+    std::unique_ptr<AsyncTrees> m_asyncTrees;
 };
 
 #endif
@@ -38,6 +38,10 @@ private:
 #include "wx/object.h"
 import WX.Cmn.Stream;
 
+import <cstdint>;
+import <functional>;
+import <memory>;
+
 import WX.Utils.VersionInfo;
 
 class wxWebResponse;
@@ -48,6 +52,7 @@ typedef struct wxWebRequestHandleOpaque* wxWebRequestHandle;
 typedef struct wxWebSessionHandleOpaque* wxWebSessionHandle;
 
 class wxWebAuthChallengeImpl;
+class wxWebCache;
 class wxWebRequestImpl;
 class wxWebResponseImpl;
 class wxWebSessionImpl;
@@ -115,6 +120,10 @@ public:
 
     wxString GetDataFile() const;
 
+    // Return true if the response was taken from the session cache, either
+    // directly or after the server confirmed that it was still valid.
+    bool IsFromCache() const;
+
 protected:
     // Ctor is used by wxWebRequest and wxWebRequestImpl.
     friend class wxWebRequest;
@@ -144,6 +153,12 @@ public:
         Storage_None
     };
 
+    // Function receiving the response data as it arrives when using
+    // Storage_None, instead of wxEVT_WEBREQUEST_DATA events. Returning false
+    // from it aborts the transfer with the backends supporting this (only
+    // libcurl currently), which also call it without copying the data.
+    using DataConsumer = std::function<bool (const void* data, size_t size)>;
+
     wxWebRequest();
     wxWebRequest(const wxWebRequest& other);
     wxWebRequest& operator=(const wxWebRequest& other);
@@ -163,6 +178,14 @@ public:
 
     Storage GetStorage() const;
 
+    void SetDataConsumer(const DataConsumer& consumer);
+
+    // Requests with higher priority are started first when the session limits
+    // the number of concurrently active requests.
+    void SetPriority(int priority);
+
+    int GetPriority() const;
+
     void Start();
 
     void Cancel();
@@ -234,6 +257,21 @@ public:
     void SetTempDir(const wxString& dir);
     wxString GetTempDir() const;
 
+    // Limit the number of simultaneously active requests, the others are
+    // queued until one of them terminates. 0 means no limit.
+    void SetMaxConcurrency(int maxActive);
+    int GetMaxConcurrency() const;
+
+    // Store the responses to GET requests in the given directory and reuse
+    // them when allowed by their Cache-Control, Expires, ETag and
+    // Last-Modified headers, removing the least recently used ones when their
+    // total size exceeds the given limit. The cache of the default session is
+    // also used by wxInternetFSHandler.
+    bool EnableCache(const std::string& dir,
+                     std::uint64_t maxSize = 256 * 1024 * 1024);
+    void DisableCache();
+    bool IsCacheEnabled() const;
+
     bool IsOpened() const;
 
     void Close();
@@ -248,6 +286,8 @@ private:
 
     explicit wxWebSession(const wxWebSessionImplPtr& impl);
 
+    friend wxWebSessionImpl* wxGetDefaultWebSessionImpl();
+
     wxWebSessionImplPtr m_impl;
 };
 
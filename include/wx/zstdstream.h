@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/zstdstream.h
+// Purpose:     Filters streams using Zstandard compression
+// Copyright:   (c) 2021 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_ZSTDSTREAM_H_
+#define _WX_ZSTDSTREAM_H_
+
+#if wxUSE_ZSTD && wxUSE_STREAMS
+
+import WX.Cmn.Stream;
+
+import WX.Utils.VersionInfo;
+
+import <cstdint>;
+import <vector>;
+
+namespace wxPrivate
+{
+
+// Private wrapper for the zstd contexts and buffers.
+struct wxZstdStream;
+
+// Common part of input and output Zstandard streams: this is just an
+// implementation detail and is not part of the public API.
+class wxZstdData
+{
+public:
+    wxZstdData& operator=(wxZstdData&&) = delete;
+
+protected:
+    wxZstdData();
+    ~wxZstdData();
+
+    wxZstdStream* m_stream;
+    wxFileOffset m_pos;
+};
+
+} // namespace wxPrivate
+
+// ----------------------------------------------------------------------------
+// Decompression context which can be shared by several input streams
+// ----------------------------------------------------------------------------
+
+// Creating the decompression state is relatively expensive, so when many
+// streams are read one after another, e.g. many small files compressed with
+// the same dictionary, it is faster to create it, and load the dictionary into
+// it, only once.
+//
+// The context can only be used by one stream at a time.
+class wxZstdDecompressionContext
+{
+public:
+    wxZstdDecompressionContext();
+    ~wxZstdDecompressionContext();
+
+    wxZstdDecompressionContext(const wxZstdDecompressionContext&) = delete;
+    wxZstdDecompressionContext& operator=(const wxZstdDecompressionContext&) = delete;
+
+    bool IsOk() const { return m_dctx != nullptr; }
+
+    // Use the given dictionary, which is copied, for all the streams using
+    // this context.
+    bool LoadDictionary(const void* data, size_t size);
+
+private:
+    struct ZSTD_DCtx_s* m_dctx;
+
+    friend class wxZstdInputStream;
+};
+
+// ----------------------------------------------------------------------------
+// Filter for decompressing data compressed using Zstandard
+// ----------------------------------------------------------------------------
+
+class wxZstdInputStream : public wxFilterInputStream,
+                          private wxPrivate::wxZstdData
+{
+public:
+    // If the context is specified, it is used instead of creating a new one
+    // and must remain alive for the lifetime of this stream.
+    explicit wxZstdInputStream(wxInputStream& stream,
+                               wxZstdDecompressionContext* context = nullptr)
+        : wxFilterInputStream(stream)
+    {
+        Init(context);
+    }
+
+    explicit wxZstdInputStream(wxInputStream* stream,
+                               wxZstdDecompressionContext* context = nullptr)
+        : wxFilterInputStream(stream)
+    {
+        Init(context);
+    }
+
+    char Peek() override { return wxInputStream::Peek(); }
+    wxFileOffset GetLength() const override { return wxInputStream::GetLength(); }
+
+    // Must be called before reading anything from the stream. If the stream
+    // uses a shared context, the dictionary is loaded into it.
+    bool SetDictionary(const void* data, size_t size);
+
+protected:
+    size_t OnSysRead(void *buffer, size_t size) override;
+    wxFileOffset OnSysTell() const override { return m_pos; }
+
+private:
+    void Init(wxZstdDecompressionContext* context);
+};
+
+// ----------------------------------------------------------------------------
+// Filter for compressing data using Zstandard algorithm
+// ----------------------------------------------------------------------------
+
+class wxZstdOutputStream : public wxFilterOutputStream,
+                           private wxPrivate::wxZstdData
+{
+public:
+    // If threads is not 0, the data is compressed by this many worker threads
+    // instead of the calling one, if libzstd was built with threads support.
+    explicit wxZstdOutputStream(wxOutputStream& stream,
+                                int level = -1,
+                                unsigned threads = 0)
+        : wxFilterOutputStream(stream)
+    {
+        Init(level, threads);
+    }
+
+    explicit wxZstdOutputStream(wxOutputStream* stream,
+                                int level = -1,
+                                unsigned threads = 0)
+        : wxFilterOutputStream(stream)
+    {
+        Init(level, threads);
+    }
+
+    virtual ~wxZstdOutputStream() { Close(); }
+
+    void Sync() override { DoFlush(false); }
+    bool Close() override;
+    wxFileOffset GetLength() const override { return m_pos; }
+
+    // Must be called before writing anything to the stream.
+    bool SetDictionary(const void* data, size_t size);
+
+protected:
+    size_t OnSysWrite(const void *buffer, size_t size) override;
+    wxFileOffset OnSysTell() const override { return m_pos; }
+
+private:
+    void Init(int level, unsigned threads);
+
+    // Write the given part of the internal buffer to the output stream.
+    bool WriteOutput(size_t size);
+
+    // End the frame (if argument is true) or just flush the data compressed so
+    // far, return true on success or false on error.
+    bool DoFlush(bool finish);
+};
+
+// ----------------------------------------------------------------------------
+// Support for creating Zstandard streams from extension/MIME type
+// ----------------------------------------------------------------------------
+
+class wxZstdClassFactory: public wxFilterClassFactory
+{
+public:
+    wxZstdClassFactory();
+
+    wxFilterInputStream *NewStream(wxInputStream& stream) const override
+        { return new wxZstdInputStream(stream); }
+    wxFilterOutputStream *NewStream(wxOutputStream& stream) const override
+        { return new wxZstdOutputStream(stream, -1); }
+    wxFilterInputStream *NewStream(wxInputStream *stream) const override
+        { return new wxZstdInputStream(stream); }
+    wxFilterOutputStream *NewStream(wxOutputStream *stream) const override
+        { return new wxZstdOutputStream(stream, -1); }
+
+    const wxChar * const *GetProtocols(wxStreamProtocolType type
+                                       = wxSTREAM_PROTOCOL) const override;
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxZstdClassFactory);
+};
+
+// Create a dictionary of at most the given size from the samples of the data
+// to compress, returns an empty vector on error.
+std::vector<std::uint8_t>
+wxZstdTrainDictionary(const std::vector<std::vector<std::uint8_t>>& samples,
+                      size_t maxSize = 110 * 1024);
+
+wxVersionInfo wxGetLibZstdVersionInfo();
+
+#endif // wxUSE_ZSTD && wxUSE_STREAMS
+
+#endif // _WX_ZSTDSTREAM_H_
@@ -236,6 +236,14 @@ public:
         subdirectories (both flags are included in the value by default).
         See ::wxDirFlags for the list of the possible flags.
 
+        By default the directories are read by the calling thread only and
+        the files are appended in the order in which the system returns them.
+        If @a threads is different from 1, the directories are read using this
+        many threads, or a number chosen automatically if it is 0, which is
+        faster for big directory trees. In this case the directories are still
+        processed in the same order, but the files found in each of them are
+        sorted by name.
+
         @return Returns the total number of files found while traversing
                 the directory @a dirname (i.e. the number of entries appended
                 to the @a files array).
@@ -244,7 +252,8 @@ public:
     */
     static size_t GetAllFiles(const wxString& dirname, wxArrayString* files,
                               const wxString& filespec = wxEmptyString,
-                              int flags = wxDIR_DEFAULT);
+                              int flags = wxDIR_DEFAULT,
+                              unsigned int threads = 1);
 
     /**
         Start enumerating all files matching @a filespec (or all files if it is
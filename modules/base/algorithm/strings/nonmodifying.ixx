@@ -386,30 +386,43 @@ template<typename... Cs>
     return std::ranges::search(strView, strToFind, {}, ToLowerCh, ToLowerCh).begin() != strView.end();
 }
 
-[[nodiscard]] inline bool IsMatch(std::string_view input,
-                                  std::string_view pattern) {
-  if (std::empty(pattern)) {
-    return std::empty(input);
-  }
-
-  if (std::empty(input)) {
-    return pattern[0] == '*' ? IsMatch(input, pattern.substr(1)) : false;
-  }
-
-  if (pattern[0] != '?' && pattern[0] != '*' && pattern[0] != input[0]) {
-    return false;
+// Match the input against the pattern containing '*' and '?' wildcards.
+//
+// Only the position of the last '*' seen needs to be remembered: if the rest
+// of the pattern fails to match, letting this '*' consume one more character
+// is the only thing worth trying, as any earlier '*' could only make it match
+// a suffix of the same input. So this is O(n*m) in the worst case and O(n)
+// for the usual patterns.
+[[nodiscard]] constexpr bool IsMatch(std::string_view input,
+                                     std::string_view pattern) {
+  constexpr auto npos = std::string_view::npos;
+
+  std::size_t i = 0u;
+  std::size_t p = 0u;
+  std::size_t starP = npos;
+  std::size_t starI = 0u;
+
+  while (i < std::size(input)) {
+    if (p < std::size(pattern) && pattern[p] == '*') {
+      starP = p++;
+      starI = i;
+    } else if (p < std::size(pattern) &&
+               (pattern[p] == '?' || pattern[p] == input[i])) {
+      ++p;
+      ++i;
+    } else if (starP != npos) {
+      p = starP + 1;
+      i = ++starI;
+    } else {
+      return false;
+    }
   }
 
-  if (pattern[0] == '*') {
-    for (decltype(std::size(input)) i = 0u; i <= std::size(input); ++i) {
-      if (IsMatch(input.substr(i), pattern.substr(1))) {
-        return true;
-      }
-    }
-    return false;
+  while (p < std::size(pattern) && pattern[p] == '*') {
+    ++p;
   }
 
-  return IsMatch(input.substr(1), pattern.substr(1));
+  return p == std::size(pattern);
 }
 
 template <class TPattern, class TStr>
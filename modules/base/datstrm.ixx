@@ -15,6 +15,7 @@ module;
 export module WX.Cmn.DataStream;
 
 import <cstdint>;
+import <span>;
 
 #if wxUSE_STREAMS
 
@@ -44,6 +45,15 @@ public:
     void SetConv( const wxMBConv &conv );
     wxMBConv *GetConv() const { return m_conv; }
 
+    // Convert the values between the byte order used by this stream and the
+    // native one in place. This allows reading the data into a buffer, or
+    // mapping it into memory, by other means and converting it afterwards.
+    void ConvertByteOrder(std::span<std::uint16_t> data) const;
+    void ConvertByteOrder(std::span<std::uint32_t> data) const;
+    void ConvertByteOrder(std::span<std::uint64_t> data) const;
+    void ConvertByteOrder(std::span<float> data) const;
+    void ConvertByteOrder(std::span<double> data) const;
+
 protected:
     // Ctor and dtor are both protected, this class is never used directly but
     // only by its derived classes.
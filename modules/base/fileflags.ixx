@@ -29,6 +29,16 @@ enum class wxFileKind
   Pipe      // a pipe
 };
 
+// Expected pattern of accesses to the file contents, used as a hint by the
+// classes reading the files mapped into memory.
+enum class wxFileAccessHint
+{
+  Normal,
+  Sequential,     // read from the beginning to the end
+  Random,         // read in random order, read-ahead is not useful
+  WillNeed        // will be accessed soon, so start reading it now
+};
+
 // we redefine these constants here because S_IREAD &c are _not_ standard
 // however, we do assume that the values correspond to the Unix umask bits
 enum wxPosixPermissions
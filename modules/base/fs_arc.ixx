@@ -8,6 +8,7 @@
 
 module;
 
+#include "wx/filefn.h"
 #include "wx/filesys.h"
 
 export module WX.FileSys.Arc;
@@ -49,7 +50,7 @@ private:
     class wxArchiveFSCacheData *m_Archive{nullptr};
     struct wxArchiveFSEntry *m_FindEntry{nullptr};
 
-    std::string m_Pattern;
+    wxWildcardPattern m_Pattern;
     std::string m_BaseDir;
     std::string m_ZipFile;
 
@@ -18,6 +18,9 @@ export module WX.Cmn.Stream;
 import WX.File.Flags;
 import WX.Cfg.Flags;
 
+import <span>;
+import <typeinfo>;
+
 #if wxUSE_STREAMS
 
 export
@@ -46,6 +49,20 @@ enum wxStreamError
 
 inline constexpr auto wxEOF = wx::narrow_cast<unsigned int>(-1);
 
+// elements of the buffer lists used by wxInputStream::ReadV() and
+// wxOutputStream::WriteV()
+struct wxStreamIOVec
+{
+    void *data;
+    size_t size;
+};
+
+struct wxStreamConstIOVec
+{
+    const void *data;
+    size_t size;
+};
+
 // ============================================================================
 // base stream classes: wxInputStream and wxOutputStream
 // ============================================================================
@@ -76,13 +93,36 @@ public:
     // returns true if the streams supports seeking to arbitrary offsets
     virtual bool IsSeekable() const { return false; }
 
+    // returns the OS file descriptor used for all input or output by this
+    // stream, if any, or -1: this is used to transfer the data between the
+    // streams without copying it, i.e. bypassing OnSysRead() and OnSysWrite()
+    int GetNativeDescriptor() const
+    {
+        return m_nativeDescriptorType && *m_nativeDescriptorType == typeid(*this)
+                ? m_nativeDescriptor
+                : -1;
+    }
+
 protected:
     virtual wxFileOffset OnSysSeek(wxFileOffset seek, wxSeekMode mode);
     virtual wxFileOffset OnSysTell() const;
 
+    // let GetNativeDescriptor() return the given descriptor, but only for the
+    // objects of exactly the given class: the classes deriving from it may
+    // override OnSysRead() or OnSysWrite() and so must opt in themselves
+    void SetNativeDescriptor(int fd, const std::type_info& type)
+    {
+        m_nativeDescriptor = fd;
+        m_nativeDescriptorType = &type;
+    }
+
     size_t m_lastcount{0};
     wxStreamError m_lasterror{wxSTREAM_NO_ERROR};
 
+private:
+    int m_nativeDescriptor{-1};
+    const std::type_info* m_nativeDescriptorType{nullptr};
+
     friend class wxStreamBuffer;
 };
 
@@ -132,6 +172,12 @@ public:
     // method either reads all the data or returns false.
     bool ReadAll(void *buffer, size_t size);
 
+    // read data into several buffers in order, stopping at the first one
+    // which couldn't be filled completely, as Read() would
+    //
+    // LastRead() returns the total number of bytes read into all buffers
+    virtual wxInputStream& ReadV(std::span<const wxStreamIOVec> buffers);
+
     // copy the entire contents of this stream into streamOut, stopping only
     // when EOF is reached or an error occurs
     wxInputStream& Read(wxOutputStream& streamOut);
@@ -239,6 +285,12 @@ public:
     // less data than requested but still return without error.
     bool WriteAll(const void *buffer, size_t size);
 
+    // write the data from several buffers in order, as if Write() had been
+    // called for each of them, but possibly using a single system call
+    //
+    // LastWrite() returns the total number of bytes written
+    virtual wxOutputStream& WriteV(std::span<const wxStreamConstIOVec> buffers);
+
     wxOutputStream& Write(wxInputStream& stream_in);
 
     virtual wxFileOffset SeekO(wxFileOffset pos, wxSeekMode mode = wxSeekMode::FromStart);
@@ -489,6 +541,10 @@ protected:
     void GetFromBuffer(void *buffer, size_t size);
     void PutToBuffer(const void *buffer, size_t size);
 
+    // read data from the stream bypassing the buffer, which only keeps the
+    // last part of it, return the number of bytes read
+    size_t ReadDirectly(void *buffer, size_t size);
+
     // set the last error to the specified value if we didn't have it before
     void SetError(wxStreamError err);
 
@@ -12,6 +12,7 @@ module;
 
 #include "wx/filefn.h"
 #include "wx/string.h"
+#include "wx/private/filemap.h"
 
 export module WX.Cmn.WFStream;
 
@@ -21,6 +22,10 @@ import WX.File.File;
 
 import WX.File.Flags;
 
+import <cstddef>;
+import <span>;
+import <string>;
+
 #if wxUSE_STREAMS
 
 export
@@ -47,6 +52,8 @@ public:
     bool IsOk() const override;
     bool IsSeekable() const override { return m_file->GetKind() == wxFileKind::Disk; }
 
+    wxInputStream& ReadV(std::span<const wxStreamIOVec> buffers) override;
+
     wxFile* GetFile() const { return m_file; }
 
 protected:
@@ -78,6 +85,8 @@ public:
     bool IsOk() const override;
     bool IsSeekable() const override { return m_file->GetKind() == wxFileKind::Disk; }
 
+    wxOutputStream& WriteV(std::span<const wxStreamConstIOVec> buffers) override;
+
     wxFile* GetFile() const { return m_file; }
 
 protected:
@@ -161,6 +170,11 @@ public:
         return wxFileInputStream::IsSeekable();
     }
 
+    int GetNativeDescriptor() const
+    {
+        return wxFileInputStream::GetNativeDescriptor();
+    }
+
     wxFileOffset GetLength() const override
     {
         return wxFileInputStream::GetLength();
@@ -178,6 +192,55 @@ protected:
     }
 };
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream: reads the file mapped into memory
+// ----------------------------------------------------------------------------
+
+// Unlike wxFileInputStream, this stream doesn't read the data from the file
+// but accesses it directly in memory, which avoids the copies done by the
+// file and stream buffers. Code which can work with the data in memory can
+// avoid copying it at all by using GetDirectBuffer().
+//
+// If the file can't be mapped, it's read into memory entirely, so this stream
+// should be only used for the regular files.
+class wxMappedFileInputStream : public wxInputStream
+{
+public:
+    explicit wxMappedFileInputStream(const std::string& fileName);
+
+    wxMappedFileInputStream& operator=(wxMappedFileInputStream&&) = delete;
+
+    wxFileOffset GetLength() const override;
+
+    bool IsOk() const override;
+    bool IsSeekable() const override { return true; }
+
+    // The whole contents of the file, valid for the lifetime of the stream.
+    std::span<const std::byte> GetDirectBuffer() const { return m_file.GetSpan(); }
+
+    // The part of the contents not read yet. Notice that it doesn't include
+    // the data put back into the stream by Ungetch(), if any, so it's empty
+    // unless there is no such data.
+    std::span<const std::byte> GetRemainingBuffer() const;
+
+    // Advance the current position after consuming the data returned by
+    // GetRemainingBuffer() directly, as if it were read by Read(), so that
+    // LastRead() returns the consumed size.
+    void Consume(size_t size);
+
+    // Let the system optimize the file access for the given pattern.
+    bool Advise(wxFileAccessHint hint) { return m_file.Advise(hint); }
+
+protected:
+    size_t OnSysRead(void *buffer, size_t size) override;
+    wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) override;
+    wxFileOffset OnSysTell() const override { return m_pos; }
+
+private:
+    wxMappedFile m_file;
+    size_t m_pos{0};
+};
+
 #endif //wxUSE_FILE
 
 #if wxUSE_FFILE
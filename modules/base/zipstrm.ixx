@@ -13,7 +13,11 @@ export module WX.Cmn.ZipStream;
 import WX.Cmn.ArchStream;
 import WX.File.Filename;
 
+import <cstddef>;
 import <cstdint>;
+import <memory>;
+import <span>;
+import <string>;
 
 #if wxUSE_ZIPSTREAM
 
@@ -336,6 +340,14 @@ public:
     void SetFormat(wxZipArchiveFormat format)   { m_format = format; }
     wxZipArchiveFormat GetFormat() const        { return m_format; }
 
+    // When enabled, the entries are compressed in memory concurrently and
+    // written out in order once they are done. This is only done for the
+    // entries small enough to be buffered and using the default compression
+    // methods, the other ones are written after all the preceding entries,
+    // as usual.
+    void WXZIPFIX EnableParallelCompression(bool enable = true);
+    bool IsParallelCompressionEnabled() const   { return m_parallel != nullptr; }
+
 protected:
     size_t WXZIPFIX OnSysWrite(const void *buffer, size_t size) override;
     wxFileOffset OnSysTell() const override      { return m_entrySize; }
@@ -358,9 +370,15 @@ private:
     bool IsOpened() const { return m_comp || m_pending; }
 
     bool DoCreate(wxZipEntry *entry, bool raw = false);
+    bool DoCreateStreamed(wxZipEntry *entry, bool raw);
+    void CheckParentSeekable();
     void CreatePendingEntry(const void *buffer, size_t size);
     void CreatePendingEntry();
 
+    // Helpers for the parallel compression mode.
+    void StreamParallelEntry();
+    bool WriteParallelEntries(size_t maxPending);
+
     class wxStoredOutputStream *m_store;
     class wxZlibOutputStream2 *m_deflate{nullptr};
     class wxZipStreamLink *m_backlink{nullptr};
@@ -379,6 +397,7 @@ private:
     wxString m_Comment;
     bool m_endrecWritten{false};
     wxZipArchiveFormat m_format{wxZIP_FORMAT_DEFAULT};
+    class wxZipParallelWriter *m_parallel{nullptr};
 };
 
 
@@ -463,6 +482,51 @@ private:
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxZipReader
+//
+// Random access to the entries of a zip file on disk. The file is mapped in
+// memory and its central directory is read once, when it is opened, so that
+// the entries can then be found by name in constant time and opened in any
+// order. All the const methods can be called from several threads at once.
+
+class wxZipReader
+{
+public:
+    explicit wxZipReader(const std::string& filename,
+                         wxMBConv& conv = wxConvLocal);
+    ~wxZipReader();
+
+    wxZipReader(const wxZipReader&) = delete;
+    wxZipReader& operator=(const wxZipReader&) = delete;
+
+    bool IsOk() const;
+
+    size_t GetCount() const;
+    const wxZipEntry *GetEntry(size_t n) const;
+
+    // Find the entry by its name in Unix format, i.e. as returned by
+    // wxZipEntry::GetName(wxPATH_UNIX), returns NULL if not found.
+    const wxZipEntry *FindEntry(const std::string& name) const;
+
+    // Returns a new stream reading the uncompressed data of the entry, which
+    // must be deleted by the caller, or NULL if the entry can't be read,
+    // e.g. because it uses an unsupported compression method or encryption.
+    wxInputStream *OpenEntry(const wxZipEntry& entry) const;
+
+    // Returns the data of an entry which is stored without compression
+    // directly, without copying it, or an empty span for all other entries.
+    // The span remains valid for as long as this object exists.
+    std::span<const std::byte> GetStoredData(const wxZipEntry& entry) const;
+
+private:
+    // Returns the span of the (possibly compressed) entry data in the file.
+    std::span<const std::byte> GetRawData(const wxZipEntry& entry) const;
+
+    std::unique_ptr<class wxZipReaderImpl> m_impl;
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
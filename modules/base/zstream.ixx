@@ -34,7 +34,13 @@ enum wxZLibFlags {
     wxZLIB_NO_HEADER = 0,    // raw deflate stream, no header or checksum
     wxZLIB_ZLIB = 1,         // zlib header and checksum
     wxZLIB_GZIP = 2,         // gzip header and checksum, requires zlib 1.2.1+
-    wxZLIB_AUTO = 3          // autodetect header zlib or gzip
+    wxZLIB_AUTO = 3,         // autodetect header zlib or gzip
+
+    // May be combined with wxZLIB_NO_HEADER, wxZLIB_ZLIB or wxZLIB_GZIP for
+    // wxZlibOutputStream only: the input is split in blocks compressed
+    // concurrently, producing a single standard stream, slightly bigger than
+    // the one produced without this flag.
+    wxZLIB_PARALLEL = 0x100
 };
 
 class wxZlibInputStream: public wxFilterInputStream {
@@ -82,6 +88,7 @@ class wxZlibOutputStream: public wxFilterOutputStream {
 
   static bool CanHandleGZip();
 
+  // Not supported when using wxZLIB_PARALLEL.
   bool SetDictionary(const char *data, size_t datalen);
   bool SetDictionary(const wxMemoryBuffer &buf);
 
@@ -99,6 +106,9 @@ class wxZlibOutputStream: public wxFilterOutputStream {
   unsigned char *m_z_buffer;
   struct z_stream_s *m_deflate;
   wxFileOffset m_pos;
+
+  // Only used, instead of m_deflate, with wxZLIB_PARALLEL.
+  class wxZlibParallelDeflater *m_parallel;
 };
 
 class wxZlibClassFactory: public wxFilterClassFactory
@@ -125,21 +135,28 @@ private:
 class wxGzipClassFactory: public wxFilterClassFactory
 {
 public:
-    wxGzipClassFactory();
+    // Only the default factory is registered, a factory created with
+    // wxZLIB_PARALLEL in outputFlags can be used to create output streams
+    // using parallel compression without affecting the other gzip streams.
+    explicit wxGzipClassFactory(int outputFlags = 0);
 
     wxFilterInputStream *NewStream(wxInputStream& stream) const override
         { return new wxZlibInputStream(stream); }
     wxFilterOutputStream *NewStream(wxOutputStream& stream) const override
-        { return new wxZlibOutputStream(stream, -1); }
+        { return new wxZlibOutputStream(stream, -1, GetOutputFlags()); }
     wxFilterInputStream *NewStream(wxInputStream *stream) const override
         { return new wxZlibInputStream(stream); }
     wxFilterOutputStream *NewStream(wxOutputStream *stream) const override
-        { return new wxZlibOutputStream(stream, -1); }
+        { return new wxZlibOutputStream(stream, -1, GetOutputFlags()); }
 
     const wxChar * const *GetProtocols(wxStreamProtocolType type
                                        = wxSTREAM_PROTOCOL) const override;
 
 private:
+    int GetOutputFlags() const { return wxZLIB_GZIP | m_outputFlags; }
+
+    int m_outputFlags;
+
     wxDECLARE_DYNAMIC_CLASS(wxGzipClassFactory);
 };
 
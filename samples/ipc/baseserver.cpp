@@ -83,6 +83,10 @@ public:
                         const void *data,
                         size_t size,
                         wxIPCFormat format) override;
+    const void *OnRequest(const wxString& topic,
+                          const wxString& item,
+                          size_t *size,
+                          wxIPCFormat format) override;
     bool OnStartAdvise(const wxString& topic, const wxString& item) override;
     bool OnStopAdvise(const wxString& topic, const wxString& item) override;
 
@@ -96,6 +100,9 @@ private:
     // the item which can be manipulated by the client via Poke() calls
     wxString m_item;
 
+    // the buffer containing the data returned from OnRequest()
+    wxCharBuffer m_requestData;
+
     // should we notify the client about changes to m_item?
     bool m_advise;
 
@@ -379,6 +386,20 @@ bool BenchConnection::OnPoke(const wxString& topic,
     return true;
 }
 
+const void *BenchConnection::OnRequest(const wxString& topic,
+                                       const wxString& item,
+                                       size_t *size,
+                                       [[maybe_unused]] wxIPCFormat format)
+{
+    if ( !IsSupportedTopicAndItem("OnRequest", topic, item) )
+        return NULL;
+
+    m_requestData = m_item.utf8_str();
+    *size = m_requestData.length() + 1;
+
+    return m_requestData.data();
+}
+
 bool BenchConnection::OnStartAdvise(const wxString& topic, const wxString& item)
 {
     if ( !IsSupportedTopicAndItem("OnStartAdvise", topic, item) )
@@ -13,15 +13,150 @@ module;
 #include "wx/defs.h"
 #include "wx/longlong.h"
 
+#if defined(__SSSE3__) || defined(__AVX__)
+    #include <tmmintrin.h>
+
+    #define wxHAS_SSSE3_BYTE_SWAP
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+
+    #define wxHAS_NEON_BYTE_SWAP
+#endif
+
 module WX.Cmn.DataStream;
 
 import WX.Cmn.Stream;
 
+import <algorithm>;
+import <array>;
+import <bit>;
+import <cstdint>;
+import <cstring>;
+
 #if wxUSE_STREAMS
 
 namespace
 {
 
+// size of the buffer used for converting the data before writing it
+constexpr size_t SWAP_CHUNK_SIZE = 4096;
+
+// returns true if the data in the stream with the given byte order must be
+// swapped to convert it to the native byte order, or vice versa
+constexpr bool NeedsSwap(bool be_order)
+{
+    return be_order != (wxBYTE_ORDER == wxBIG_ENDIAN);
+}
+
+template <size_t N> struct SwapTraits;
+template <> struct SwapTraits<2> { using Type = std::uint16_t; };
+template <> struct SwapTraits<4> { using Type = std::uint32_t; };
+template <> struct SwapTraits<8> { using Type = std::uint64_t; };
+
+// reverse the order of bytes in each of count N-byte values stored at the
+// given, not necessarily aligned, address
+template <size_t N>
+void SwapBytes(void* data, size_t count)
+{
+    auto p = static_cast<unsigned char*>(data);
+    const unsigned char* const end = p + count * N;
+
+#if defined(wxHAS_SSSE3_BYTE_SWAP)
+    // shuffle mask reversing the bytes inside each N-byte group
+    constexpr auto indices = []()
+    {
+        std::array<char, 16> a{};
+        for ( size_t i = 0; i < a.size(); i++ )
+            a[i] = static_cast<char>(i - i % N + N - 1 - i % N);
+        return a;
+    }();
+
+    const __m128i mask = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(indices.data()));
+
+    for ( ; end - p >= 64; p += 64 )
+    {
+        const auto v = reinterpret_cast<__m128i*>(p);
+        const __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128(v), mask);
+        const __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128(v + 1), mask);
+        const __m128i v2 = _mm_shuffle_epi8(_mm_loadu_si128(v + 2), mask);
+        const __m128i v3 = _mm_shuffle_epi8(_mm_loadu_si128(v + 3), mask);
+        _mm_storeu_si128(v, v0);
+        _mm_storeu_si128(v + 1, v1);
+        _mm_storeu_si128(v + 2, v2);
+        _mm_storeu_si128(v + 3, v3);
+    }
+
+    for ( ; end - p >= 16; p += 16 )
+    {
+        const auto v = reinterpret_cast<__m128i*>(p);
+        _mm_storeu_si128(v, _mm_shuffle_epi8(_mm_loadu_si128(v), mask));
+    }
+#elif defined(wxHAS_NEON_BYTE_SWAP)
+    for ( ; end - p >= 16; p += 16 )
+    {
+        const uint8x16_t v = vld1q_u8(p);
+        if constexpr ( N == 2 )
+            vst1q_u8(p, vrev16q_u8(v));
+        else if constexpr ( N == 4 )
+            vst1q_u8(p, vrev32q_u8(v));
+        else
+            vst1q_u8(p, vrev64q_u8(v));
+    }
+#endif // SIMD
+
+    using Type = typename SwapTraits<N>::Type;
+    for ( ; p != end; p += N )
+    {
+        Type v;
+        memcpy(&v, p, N);
+        v = std::byteswap(v);
+        memcpy(p, &v, N);
+    }
+}
+
+// convert the data to the stream byte order and write it
+template <size_t N>
+void DoWriteSwapped(const void* data, size_t count,
+                    wxOutputStream* output, bool be_order)
+{
+    wxCHECK_RET( count <= SIZE_MAX / N, "too many elements to write" );
+
+    if ( !NeedsSwap(be_order) )
+    {
+        output->Write(data, count * N);
+        return;
+    }
+
+    unsigned char chunk[SWAP_CHUNK_SIZE];
+    auto p = static_cast<const unsigned char*>(data);
+    while ( count )
+    {
+        const size_t n = std::min(count, SWAP_CHUNK_SIZE / N);
+        memcpy(chunk, p, n * N);
+        SwapBytes<N>(chunk, n);
+
+        if ( output->Write(chunk, n * N).LastWrite() != n * N )
+            break;
+
+        p += n * N;
+        count -= n;
+    }
+}
+
+// read the data and convert it from the stream byte order
+template <size_t N>
+void DoReadSwapped(void* data, size_t count,
+                   wxInputStream* input, bool be_order)
+{
+    wxCHECK_RET( count <= SIZE_MAX / N, "too many elements to read" );
+
+    input->Read(data, count * N);
+
+    if ( NeedsSwap(be_order) )
+        SwapBytes<N>(data, count);
+}
+
 // helper unions used to swap bytes of floats and doubles
 union Float32Data
 {
@@ -60,6 +195,36 @@ wxDataStreamBase::~wxDataStreamBase()
     delete m_conv;
 }
 
+void wxDataStreamBase::ConvertByteOrder(std::span<std::uint16_t> data) const
+{
+    if ( NeedsSwap(m_be_order) )
+        SwapBytes<2>(data.data(), data.size());
+}
+
+void wxDataStreamBase::ConvertByteOrder(std::span<std::uint32_t> data) const
+{
+    if ( NeedsSwap(m_be_order) )
+        SwapBytes<4>(data.data(), data.size());
+}
+
+void wxDataStreamBase::ConvertByteOrder(std::span<std::uint64_t> data) const
+{
+    if ( NeedsSwap(m_be_order) )
+        SwapBytes<8>(data.data(), data.size());
+}
+
+void wxDataStreamBase::ConvertByteOrder(std::span<float> data) const
+{
+    if ( NeedsSwap(m_be_order) )
+        SwapBytes<4>(data.data(), data.size());
+}
+
+void wxDataStreamBase::ConvertByteOrder(std::span<double> data) const
+{
+    if ( NeedsSwap(m_be_order) )
+        SwapBytes<8>(data.data(), data.size());
+}
+
 // ---------------------------------------------------------------------------
 // wxDataInputStream
 // ---------------------------------------------------------------------------
@@ -162,13 +327,61 @@ wxString wxDataInputStream::ReadString()
 
 #if wxUSE_LONGLONG
 
+#if wxUSE_LONGLONG_NATIVE && !wxUSE_LONGLONG_WX
+
+// wxLongLong is just a wrapper around the native type in this case, so read
+// and write the values in bulk and only convert them from/to wxLongLong.
+template <class T>
+static
+void DoReadLL(T *buffer, size_t size, wxInputStream *input, bool be_order)
+{
+    using ValueType = decltype(buffer->GetValue());
+
+    std::uint64_t chunk[SWAP_CHUNK_SIZE / 8];
+    while ( size )
+    {
+        const size_t n = std::min(size, WXSIZEOF(chunk));
+        DoReadSwapped<8>(chunk, n, input, be_order);
+
+        for ( size_t i = 0; i < n; i++ )
+            buffer[i] = T(static_cast<ValueType>(chunk[i]));
+
+        buffer += n;
+        size -= n;
+    }
+}
+
+template <class T>
+static void DoWriteLL(const T *buffer, size_t size, wxOutputStream *output, bool be_order)
+{
+    std::uint64_t chunk[SWAP_CHUNK_SIZE / 8];
+    while ( size )
+    {
+        const size_t n = std::min(size, WXSIZEOF(chunk));
+        for ( size_t i = 0; i < n; i++ )
+            chunk[i] = static_cast<std::uint64_t>(buffer[i].GetValue());
+
+        if ( NeedsSwap(be_order) )
+            SwapBytes<8>(chunk, n);
+
+        if ( output->Write(chunk, n * 8).LastWrite() != n * 8 )
+            break;
+
+        buffer += n;
+        size -= n;
+    }
+}
+
+#else // !wxUSE_LONGLONG_NATIVE
+
 template <class T>
 static
 void DoReadLL(T *buffer, size_t size, wxInputStream *input, bool be_order)
 {
     using DataType = T;
+    wxCHECK_RET( size <= SIZE_MAX / 8, "too many elements to read" );
+
     unsigned char *pchBuffer = new unsigned char[size * 8];
-    // TODO: Check for overflow when size is of type uint and is > than 512m
     input->Read(pchBuffer, size * 8);
     size_t idx_base = 0;
     if ( be_order )
@@ -203,6 +416,8 @@ template <class T>
 static void DoWriteLL(const T *buffer, size_t size, wxOutputStream *output, bool be_order)
 {
     using DataType = T;
+    wxCHECK_RET( size <= SIZE_MAX / 8, "too many elements to write" );
+
     unsigned char *pchBuffer = new unsigned char[size * 8];
     size_t idx_base = 0;
     if ( be_order )
@@ -236,67 +451,14 @@ static void DoWriteLL(const T *buffer, size_t size, wxOutputStream *output, bool
         }
     }
 
-    // TODO: Check for overflow when size is of type uint and is > than 512m
     output->Write(pchBuffer, size * 8);
     delete[] pchBuffer;
 }
 
-#endif // wxUSE_LONGLONG
-
-#ifdef wxLongLong_t
+#endif // wxUSE_LONGLONG_NATIVE/!wxUSE_LONGLONG_NATIVE
 
-template <class T>
-static
-void DoReadI64(T *buffer, size_t size, wxInputStream *input, bool be_order)
-{
-    using DataType = T;
-    unsigned char *pchBuffer = (unsigned char*) buffer;
-    // TODO: Check for overflow when size is of type uint and is > than 512m
-    input->Read(pchBuffer, size * 8);
-    if ( be_order )
-    {
-        for ( std::uint32_t i = 0; i < size; i++ )
-        {
-            DataType v = wxUINT64_SWAP_ON_LE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-    else // little endian
-    {
-        for ( std::uint32_t i=0; i<size; i++ )
-        {
-            DataType v = wxUINT64_SWAP_ON_BE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-}
-
-template <class T>
-static
-void DoWriteI64(const T *buffer, size_t size, wxOutputStream *output, bool be_order)
-{
-  using DataType = T;
-  if ( be_order )
-  {
-    for ( size_t i = 0; i < size; i++ )
-    {
-      DataType i64 = wxUINT64_SWAP_ON_LE(*buffer);
-      buffer++;
-      output->Write(&i64, 8);
-    }
-  }
-  else // little endian
-  {
-    for ( size_t i=0; i < size; i++ )
-    {
-      DataType i64 = wxUINT64_SWAP_ON_BE(*buffer);
-      buffer++;
-      output->Write(&i64, 8);
-    }
-  }
-}
+#endif // wxUSE_LONGLONG
 
-#endif // wxLongLong_t
 
 
 #if wxHAS_INT64
@@ -305,7 +467,7 @@ void wxDataInputStream::Read64(std::uint64_t *buffer, size_t size)
 #ifndef wxLongLong_t
     DoReadLL(buffer, size, m_input, m_be_order);
 #else
-    DoReadI64(buffer, size, m_input, m_be_order);
+    DoReadSwapped<8>(buffer, size, m_input, m_be_order);
 #endif
 }
 
@@ -314,7 +476,7 @@ void wxDataInputStream::Read64(std::int64_t *buffer, size_t size)
 #ifndef wxLongLong_t
     DoReadLL(buffer, size, m_input, m_be_order);
 #else
-    DoReadI64(buffer, size, m_input, m_be_order);
+    DoReadSwapped<8>(buffer, size, m_input, m_be_order);
 #endif
 }
 #endif // wxHAS_INT64
@@ -352,46 +514,12 @@ wxLongLong wxDataInputStream::ReadLL()
 
 void wxDataInputStream::Read32(std::uint32_t *buffer, size_t size)
 {
-    m_input->Read(buffer, size * 4);
-
-    if (m_be_order)
-    {
-        for (std::uint32_t i=0; i<size; i++)
-        {
-            std::uint32_t v = wxUINT32_SWAP_ON_LE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-    else
-    {
-        for (std::uint32_t i=0; i<size; i++)
-        {
-            std::uint32_t v = wxUINT32_SWAP_ON_BE(*buffer);
-            *(buffer++) = v;
-        }
-    }
+    DoReadSwapped<4>(buffer, size, m_input, m_be_order);
 }
 
 void wxDataInputStream::Read16(std::uint16_t *buffer, size_t size)
 {
-  m_input->Read(buffer, size * 2);
-
-  if (m_be_order)
-  {
-    for (std::uint32_t i=0; i<size; i++)
-    {
-      std::uint16_t v = wxUINT16_SWAP_ON_LE(*buffer);
-      *(buffer++) = v;
-    }
-  }
-  else
-  {
-    for (std::uint32_t i=0; i<size; i++)
-    {
-      std::uint16_t v = wxUINT16_SWAP_ON_BE(*buffer);
-      *(buffer++) = v;
-    }
-  }
+    DoReadSwapped<2>(buffer, size, m_input, m_be_order);
 }
 
 void wxDataInputStream::Read8(std::uint8_t *buffer, size_t size)
@@ -401,18 +529,14 @@ void wxDataInputStream::Read8(std::uint8_t *buffer, size_t size)
 
 void wxDataInputStream::ReadDouble(double *buffer, size_t size)
 {
-  for (std::uint32_t i=0; i<size; i++)
-  {
-    *(buffer++) = ReadDouble();
-  }
+    // this is equivalent to calling ReadDouble() for each element as the
+    // values are stored in IEEE 754 format in the stream too
+    DoReadSwapped<8>(buffer, size, m_input, m_be_order);
 }
 
 void wxDataInputStream::ReadFloat(float *buffer, size_t size)
 {
-  for (std::uint32_t i=0; i<size; i++)
-  {
-    *(buffer++) = ReadFloat();
-  }
+    DoReadSwapped<4>(buffer, size, m_input, m_be_order);
 }
 
 wxDataInputStream& wxDataInputStream::operator>>(wxString& s)
@@ -592,7 +716,7 @@ void wxDataOutputStream::Write64(const std::uint64_t *buffer, size_t size)
 #ifndef wxLongLong_t
     DoWriteLL(buffer, size, m_output, m_be_order);
 #else
-    DoWriteI64(buffer, size, m_output, m_be_order);
+    DoWriteSwapped<8>(buffer, size, m_output, m_be_order);
 #endif
 }
 
@@ -601,7 +725,7 @@ void wxDataOutputStream::Write64(const std::int64_t *buffer, size_t size)
 #ifndef wxLongLong_t
     DoWriteLL(buffer, size, m_output, m_be_order);
 #else
-    DoWriteI64(buffer, size, m_output, m_be_order);
+    DoWriteSwapped<8>(buffer, size, m_output, m_be_order);
 #endif
 }
 #endif // wxHAS_INT64
@@ -642,46 +766,12 @@ void wxDataOutputStream::WriteLL(const wxULongLong &ll)
 
 void wxDataOutputStream::Write32(const std::uint32_t *buffer, size_t size)
 {
-  if (m_be_order)
-  {
-    for (std::uint32_t i=0; i<size ;i++)
-    {
-      const std::uint32_t i32 = wxUINT32_SWAP_ON_LE(*buffer);
-      buffer++;
-      m_output->Write(&i32, 4);
-    }
-  }
-  else
-  {
-    for (std::uint32_t i=0; i<size ;i++)
-    {
-      const std::uint32_t i32 = wxUINT32_SWAP_ON_BE(*buffer);
-      buffer++;
-      m_output->Write(&i32, 4);
-    }
-  }
+    DoWriteSwapped<4>(buffer, size, m_output, m_be_order);
 }
 
 void wxDataOutputStream::Write16(const std::uint16_t *buffer, size_t size)
 {
-  if (m_be_order)
-  {
-    for (std::uint32_t i=0; i<size ;i++)
-    {
-      const std::uint16_t i16 = wxUINT16_SWAP_ON_LE(*buffer);
-      buffer++;
-      m_output->Write(&i16, 2);
-    }
-  }
-  else
-  {
-    for (std::uint32_t i=0; i<size ;i++)
-    {
-      const std::uint16_t i16 = wxUINT16_SWAP_ON_BE(*buffer);
-      buffer++;
-      m_output->Write(&i16, 2);
-    }
-  }
+    DoWriteSwapped<2>(buffer, size, m_output, m_be_order);
 }
 
 void wxDataOutputStream::Write8(const std::uint8_t *buffer, size_t size)
@@ -691,18 +781,12 @@ void wxDataOutputStream::Write8(const std::uint8_t *buffer, size_t size)
 
 void wxDataOutputStream::WriteDouble(const double *buffer, size_t size)
 {
-  for (std::uint32_t i=0; i<size; i++)
-  {
-    WriteDouble(*(buffer++));
-  }
+    DoWriteSwapped<8>(buffer, size, m_output, m_be_order);
 }
 
 void wxDataOutputStream::WriteFloat(const float *buffer, size_t size)
 {
-  for (std::uint32_t i=0; i<size; i++)
-  {
-    WriteFloat(*(buffer++));
-  }
+    DoWriteSwapped<4>(buffer, size, m_output, m_be_order);
 }
 
 wxDataOutputStream& wxDataOutputStream::operator<<(const wxString& string)
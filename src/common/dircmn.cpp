@@ -13,9 +13,28 @@
 #include "wx/filefn.h"
 #include "wx/dir.h"
 
+#include "wx/private/parallel.h"
+
+#ifdef __UNIX_LIKE__
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 import WX.File.Filename;
 
+import <algorithm>;
+import <atomic>;
+import <condition_variable>;
+import <deque>;
+import <future>;
+import <memory>;
+import <mutex>;
+import <span>;
 import <string>;
+import <string_view>;
+import <vector>;
 
 // ============================================================================
 // implementation
@@ -31,6 +50,24 @@ wxDirTraverser::OnOpenError([[maybe_unused]] const std::string& dirname)
     return wxDirTraverseResult::Ignore;
 }
 
+size_t wxDirTraverser::OnFiles(std::span<const std::string> filenames)
+{
+    size_t n = 0;
+    for ( const auto& filename : filenames )
+    {
+        const wxDirTraverseResult res = OnFile(filename);
+        if ( res == wxDirTraverseResult::Stop )
+            break;
+
+        wxASSERT_MSG( res == wxDirTraverseResult::Continue,
+                      "unexpected OnFile() return value" );
+
+        n++;
+    }
+
+    return n;
+}
+
 // ----------------------------------------------------------------------------
 // wxDir::HasFiles() and HasSubDirs()
 // ----------------------------------------------------------------------------
@@ -196,6 +233,530 @@ size_t wxDir::Traverse(wxDirTraverser& sink,
     return nFiles;
 }
 
+// ----------------------------------------------------------------------------
+// wxDir::TraverseParallel()
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Descriptor of an already read directory which is kept open to open its
+// subdirectories relative to it, which avoids resolving the full path again.
+class wxDirDescriptor
+{
+public:
+#ifdef __UNIX_LIKE__
+    wxDirDescriptor(int fd, std::atomic<int>& count)
+        : m_fd(fd), m_count(count)
+    {
+    }
+
+    ~wxDirDescriptor()
+    {
+        ::close(m_fd);
+        m_count--;
+    }
+
+    wxDirDescriptor(const wxDirDescriptor&) = delete;
+    wxDirDescriptor& operator=(const wxDirDescriptor&) = delete;
+
+    int Get() const { return m_fd; }
+
+private:
+    const int m_fd;
+    std::atomic<int>& m_count;
+#endif // __UNIX_LIKE__
+};
+
+using wxDirDescriptorPtr = std::shared_ptr<wxDirDescriptor>;
+
+// Contents of a single directory.
+struct wxDirScanResult
+{
+    // Full path of this directory, as passed to OnDir().
+    std::string path;
+
+    // Full paths of the entries.
+    std::vector<std::string> dirs;
+    std::vector<std::string> files;
+
+    // May be null even if the directory was read successfully.
+    wxDirDescriptorPtr descriptor;
+
+    bool ok{false};
+};
+
+// Reads the directories, this is used from the worker threads.
+class wxDirScanner
+{
+public:
+    wxDirScanner(const std::string& filespec,
+                 unsigned int flags,
+                 wxDirTraverseOrder order)
+        : m_filespec(filespec),
+          m_pattern(filespec, !(flags & wxDIR_HIDDEN)),
+          m_flags(flags),
+          m_order(order)
+    {
+    }
+
+    // The parent, if specified, must be the descriptor of the directory
+    // containing this one.
+    wxDirScanResult Scan(const std::string& path,
+                         const wxDirDescriptorPtr& parent) const;
+
+    void Stop() { m_stop = true; }
+    bool IsStopped() const { return m_stop; }
+
+private:
+    bool MatchesSpec(std::string_view name) const
+    {
+        return m_filespec.empty() || m_pattern.Matches(name);
+    }
+
+    void Finish(wxDirScanResult& result) const
+    {
+        if ( m_order == wxDirTraverseOrder::Sorted )
+        {
+            std::ranges::sort(result.dirs);
+            std::ranges::sort(result.files);
+        }
+    }
+
+    // Don't use more than this many descriptors for keeping the directories
+    // open, the rest are opened using their full paths.
+    static constexpr int MAX_DESCRIPTORS = 128;
+
+    const std::string m_filespec;
+    const wxWildcardPattern m_pattern;
+    const unsigned int m_flags;
+    const wxDirTraverseOrder m_order;
+
+    mutable std::atomic<int> m_descriptors{0};
+    std::atomic<bool> m_stop{false};
+};
+
+#ifdef __UNIX_LIKE__
+
+// Check if the given entry is a directory, following the symlinks unless
+// NO_FOLLOW is specified, without using wxFileName to avoid building the full
+// path and, most of the time, even calling stat().
+bool IsDirEntry(int dirfd, const dirent* de, unsigned int flags)
+{
+#ifdef DT_DIR
+    switch ( de->d_type )
+    {
+        case DT_DIR:
+            return true;
+
+        case DT_LNK:
+            if ( flags & wxDIR_NO_FOLLOW )
+                return false;
+            break;
+
+        case DT_UNKNOWN:
+            break;
+
+        default:
+            return false;
+    }
+#endif // DT_DIR
+
+    struct stat st;
+    if ( ::fstatat(dirfd, de->d_name, &st,
+                   flags & wxDIR_NO_FOLLOW ? AT_SYMLINK_NOFOLLOW : 0) != 0 )
+        return false;
+
+    return S_ISDIR(st.st_mode);
+}
+
+wxDirScanResult
+wxDirScanner::Scan(const std::string& path,
+                   const wxDirDescriptorPtr& parent) const
+{
+    wxDirScanResult result;
+    result.path = path;
+
+    if ( m_stop )
+        return result;
+
+    constexpr int openFlags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+
+    int fd;
+    if ( parent )
+    {
+        const std::string name = path.substr(path.rfind('/') + 1);
+        fd = ::openat(parent->Get(), name.c_str(), openFlags);
+    }
+    else
+    {
+        fd = ::open(path.c_str(), openFlags);
+    }
+
+    if ( fd == -1 )
+        return result;
+
+    // Keep a copy of the descriptor, as fdopendir() takes ownership of it, if
+    // we're going to open the subdirectories.
+    if ( m_flags & wxDIR_DIRS )
+    {
+        if ( m_descriptors++ < MAX_DESCRIPTORS )
+        {
+            const int fdCopy = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            if ( fdCopy != -1 )
+                result.descriptor = std::make_shared<wxDirDescriptor>(fdCopy, m_descriptors);
+            else
+                m_descriptors--;
+        }
+        else
+        {
+            m_descriptors--;
+        }
+    }
+
+    DIR* const dir = ::fdopendir(fd);
+    if ( !dir )
+    {
+        ::close(fd);
+        result.descriptor.reset();
+        return result;
+    }
+
+    result.ok = true;
+
+    std::string prefix = path;
+    if ( prefix.empty() || prefix.back() != '/' )
+        prefix += '/';
+
+    while ( const dirent* const de = ::readdir(dir) )
+    {
+        const char* const name = de->d_name;
+
+        // "." and ".." are never useful here.
+        if ( name[0] == '.' )
+        {
+            if ( name[1] == '\0' || (name[1] == '.' && name[2] == '\0') )
+                continue;
+
+            if ( !(m_flags & wxDIR_HIDDEN) )
+                continue;
+        }
+
+        if ( IsDirEntry(::dirfd(dir), de, m_flags) )
+        {
+            if ( m_flags & wxDIR_DIRS )
+                result.dirs.push_back(prefix + name);
+        }
+        else if ( (m_flags & wxDIR_FILES) && MatchesSpec(name) )
+        {
+            result.files.push_back(prefix + name);
+        }
+
+        if ( m_stop )
+            break;
+    }
+
+    ::closedir(dir);
+
+    Finish(result);
+
+    return result;
+}
+
+#else // !__UNIX_LIKE__
+
+wxDirScanResult
+wxDirScanner::Scan(const std::string& path,
+                   [[maybe_unused]] const wxDirDescriptorPtr& parent) const
+{
+    wxDirScanResult result;
+    result.path = path;
+
+    if ( m_stop )
+        return result;
+
+    wxLogNull noLog;
+
+    wxDir dir;
+    if ( !dir.Open(path) )
+        return result;
+
+    result.ok = true;
+
+    const std::string prefix = dir.GetNameWithSep();
+
+    std::string name;
+    if ( m_flags & wxDIR_DIRS )
+    {
+        for ( bool cont = dir.GetFirst(&name, {},
+                                       (m_flags & ~(wxDIR_FILES | wxDIR_DOTDOT))
+                                       | wxDIR_DIRS);
+              cont && !m_stop;
+              cont = dir.GetNext(&name) )
+        {
+            result.dirs.push_back(prefix + name);
+        }
+    }
+
+    if ( m_flags & wxDIR_FILES )
+    {
+        for ( bool cont = dir.GetFirst(&name, m_filespec,
+                                       m_flags & ~(wxDIR_DIRS | wxDIR_DOTDOT));
+              cont && !m_stop;
+              cont = dir.GetNext(&name) )
+        {
+            result.files.push_back(prefix + name);
+        }
+    }
+
+    Finish(result);
+
+    return result;
+}
+
+#endif // __UNIX_LIKE__/!__UNIX_LIKE__
+
+// Common part of both traversal orders: calls the sink and keeps track of the
+// number of the files found.
+class wxDirParallelTraverser
+{
+public:
+    wxDirParallelTraverser(wxDirTraverser& sink,
+                           const std::string& filespec,
+                           unsigned int flags,
+                           wxDirTraverseOrder order,
+                           unsigned int threads)
+        : m_sink(sink),
+          m_scanner(filespec, flags, order),
+          m_pool(threads ? threads : wxGetParallelism(16))
+    {
+    }
+
+    ~wxDirParallelTraverser()
+    {
+        // Don't waste time on reading the directories nobody needs any more,
+        // the pool waits for all the tasks to finish when it's destroyed.
+        m_scanner.Stop();
+    }
+
+    // Traverse the tree starting at the given directory.
+    size_t TraverseAny(const std::string& path);
+    size_t TraverseSorted(const std::string& path);
+
+private:
+    std::future<wxDirScanResult>
+    SubmitScan(const std::string& path, const wxDirDescriptorPtr& parent)
+    {
+        return m_pool.Submit([this, path, parent]()
+            {
+                return m_scanner.Scan(path, parent);
+            });
+    }
+
+    // Asks the sink what to do about the directory which couldn't be read,
+    // returns true if it should be retried.
+    bool ShouldRetry(const std::string& path);
+
+    // Calls OnDir() and returns true if we should descend into it.
+    bool ShouldEnter(const std::string& path);
+
+    // Passes the files to the sink.
+    void ReportFiles(const std::vector<std::string>& files);
+
+    // Recursive helper of TraverseSorted().
+    void DoTraverseSorted(wxDirScanResult& result);
+
+    bool IsStopped() const { return m_scanner.IsStopped(); }
+
+
+    wxDirTraverser& m_sink;
+    wxDirScanner m_scanner;
+
+    size_t m_nFiles{0};
+
+    // Last, as the scans use the other members.
+    wxWorkerPool m_pool;
+};
+
+bool wxDirParallelTraverser::ShouldRetry(const std::string& path)
+{
+    switch ( m_sink.OnOpenError(path) )
+    {
+        default:
+            wxFAIL_MSG("unexpected OnOpenError() return value" );
+            [[fallthrough]];
+
+        case wxDirTraverseResult::Stop:
+            m_scanner.Stop();
+            [[fallthrough]];
+
+        case wxDirTraverseResult::Ignore:
+            return false;
+
+        case wxDirTraverseResult::Continue:
+            return true;
+    }
+}
+
+bool wxDirParallelTraverser::ShouldEnter(const std::string& path)
+{
+    switch ( m_sink.OnDir(path) )
+    {
+        default:
+            wxFAIL_MSG("unexpected OnDir() return value" );
+            [[fallthrough]];
+
+        case wxDirTraverseResult::Stop:
+            m_scanner.Stop();
+            [[fallthrough]];
+
+        case wxDirTraverseResult::Ignore:
+            return false;
+
+        case wxDirTraverseResult::Continue:
+            return true;
+    }
+}
+
+void wxDirParallelTraverser::ReportFiles(const std::vector<std::string>& files)
+{
+    if ( files.empty() || IsStopped() )
+        return;
+
+    const size_t n = m_sink.OnFiles(files);
+    m_nFiles += n;
+
+    if ( n < files.size() )
+        m_scanner.Stop();
+}
+
+size_t wxDirParallelTraverser::TraverseAny(const std::string& path)
+{
+    // The results of the tasks are collected here instead of using their
+    // futures, to process them as soon as any of them is ready.
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<wxDirScanResult> done;
+
+    size_t pending = 0;
+
+    const auto submit = [&](const std::string& dirname,
+                            const wxDirDescriptorPtr& parent)
+    {
+        pending++;
+
+        m_pool.Submit([&, dirname, parent]()
+            {
+                wxDirScanResult result = m_scanner.Scan(dirname, parent);
+
+                // Notify while still holding the lock as the condition may be
+                // destroyed as soon as the last result is taken from the queue.
+                std::scoped_lock lock(mutex);
+                done.push_back(std::move(result));
+                cond.notify_one();
+            });
+    };
+
+    submit(path, {});
+
+    while ( pending )
+    {
+        wxDirScanResult result;
+        {
+            std::unique_lock lock(mutex);
+            cond.wait(lock, [&done]() { return !done.empty(); });
+
+            result = std::move(done.front());
+            done.pop_front();
+        }
+
+        pending--;
+
+        // Still wait for all the tasks to finish, as they refer to the local
+        // variables of this function.
+        if ( IsStopped() )
+            continue;
+
+        if ( !result.ok )
+        {
+            if ( ShouldRetry(result.path) )
+                submit(result.path, {});
+
+            continue;
+        }
+
+        for ( const auto& dirname : result.dirs )
+        {
+            if ( ShouldEnter(dirname) )
+                submit(dirname, result.descriptor);
+
+            if ( IsStopped() )
+                break;
+        }
+
+        ReportFiles(result.files);
+    }
+
+    return m_nFiles;
+}
+
+void wxDirParallelTraverser::DoTraverseSorted(wxDirScanResult& result)
+{
+    // Start reading all the subdirectories immediately, even though we don't
+    // know yet if we're going to need them, as otherwise we'd read them one
+    // by one, just as Traverse() does.
+    std::vector<std::future<wxDirScanResult>> subdirs;
+    subdirs.reserve(result.dirs.size());
+    for ( const auto& dirname : result.dirs )
+        subdirs.push_back(SubmitScan(dirname, result.descriptor));
+
+    // We don't need it any longer and the subdirectories keep it alive for
+    // as long as they need it.
+    result.descriptor.reset();
+
+    for ( size_t n = 0; n < subdirs.size() && !IsStopped(); n++ )
+    {
+        if ( !ShouldEnter(result.dirs[n]) )
+            continue;
+
+        wxDirScanResult sub = subdirs[n].get();
+        while ( !sub.ok && ShouldRetry(sub.path) )
+            sub = SubmitScan(sub.path, {}).get();
+
+        if ( sub.ok )
+            DoTraverseSorted(sub);
+    }
+
+    ReportFiles(result.files);
+}
+
+size_t wxDirParallelTraverser::TraverseSorted(const std::string& path)
+{
+    wxDirScanResult result = SubmitScan(path, {}).get();
+    if ( result.ok )
+        DoTraverseSorted(result);
+
+    return m_nFiles;
+}
+
+} // anonymous namespace
+
+size_t wxDir::TraverseParallel(wxDirTraverser& sink,
+                               const std::string& filespec,
+                               unsigned int flags,
+                               wxDirTraverseOrder order,
+                               unsigned int threads) const
+{
+    wxCHECK_MSG( IsOpened(), (size_t)-1,
+                 "dir must be opened before traversing it" );
+
+    wxDirParallelTraverser traverser(sink, filespec, flags, order, threads);
+
+    return order == wxDirTraverseOrder::Sorted
+            ? traverser.TraverseSorted(GetName())
+            : traverser.TraverseAny(GetName());
+}
+
 // ----------------------------------------------------------------------------
 // wxDir::GetAllFiles()
 // ----------------------------------------------------------------------------
@@ -214,6 +775,12 @@ public:
         return wxDirTraverseResult::Continue;
     }
 
+    size_t OnFiles(std::span<const std::string> filenames) override
+    {
+        m_files.insert(m_files.end(), filenames.begin(), filenames.end());
+        return filenames.size();
+    }
+
     wxDirTraverseResult OnDir([[maybe_unused]] const std::string& dirname) override
     {
         return wxDirTraverseResult::Continue;
@@ -227,7 +794,8 @@ private:
 size_t wxDir::GetAllFiles(const std::string& dirname,
                           std::vector<std::string>* files,
                           const std::string& filespec,
-                          unsigned int flags)
+                          unsigned int flags,
+                          unsigned int threads)
 {
     wxCHECK_MSG( files, (size_t)-1, "NULL pointer in wxDir::GetAllFiles" );
 
@@ -238,7 +806,11 @@ size_t wxDir::GetAllFiles(const std::string& dirname,
     {
         wxDirTraverserSimple traverser(*files);
 
-        nFiles += dir.Traverse(traverser, filespec, flags);
+        if ( threads == 1 )
+            nFiles += dir.Traverse(traverser, filespec, flags);
+        else
+            nFiles += dir.TraverseParallel(traverser, filespec, flags,
+                                           wxDirTraverseOrder::Sorted, threads);
     }
 
     return nFiles;
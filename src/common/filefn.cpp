@@ -1134,6 +1134,127 @@ bool wxIsWild( const std::string& pattern )
     return false;
 }
 
+// ----------------------------------------------------------------------------
+// wxWildcardPattern
+// ----------------------------------------------------------------------------
+
+wxWildcardPattern::wxWildcardPattern(std::string_view pattern, bool dot_special)
+    : m_empty(pattern.empty()),
+      m_dotSpecial(dot_special)
+{
+    for ( size_t n = 0; n < pattern.size(); n++ )
+    {
+        Segment& seg = m_segments.back();
+
+        switch ( pattern[n] )
+        {
+            case '*':
+                m_segments.emplace_back();
+                break;
+
+            case '?':
+                if ( seg.any.empty() )
+                    seg.any.assign(seg.chars.size(), '\0');
+
+                seg.chars += '?';
+                seg.any += '\1';
+                break;
+
+            case '\\':
+                // Quoting nothing never matches anything, as in wxMatchWild().
+                if ( ++n == pattern.size() )
+                {
+                    m_valid = false;
+                    return;
+                }
+                [[fallthrough]];
+
+            default:
+                seg.chars += pattern[n];
+                if ( !seg.any.empty() )
+                    seg.any += '\0';
+        }
+    }
+}
+
+bool
+wxWildcardPattern::Segment::MatchesAt(std::string_view text, size_t pos) const
+{
+    if ( text.size() - pos < chars.size() )
+        return false;
+
+    if ( any.empty() )
+        return text.compare(pos, chars.size(), chars) == 0;
+
+    for ( size_t n = 0; n < chars.size(); n++ )
+    {
+        if ( !any[n] && text[pos + n] != chars[n] )
+            return false;
+    }
+
+    return true;
+}
+
+size_t
+wxWildcardPattern::Segment::FindIn(std::string_view text, size_t from) const
+{
+    if ( any.empty() )
+        return text.find(chars, from);
+
+    for ( size_t pos = from; pos + chars.size() <= text.size(); pos++ )
+    {
+        if ( MatchesAt(text, pos) )
+            return pos;
+    }
+
+    return std::string_view::npos;
+}
+
+bool wxWildcardPattern::Matches(std::string_view text) const
+{
+    // Match if both are empty.
+    if ( text.empty() )
+        return m_empty;
+
+    if ( !m_valid )
+        return false;
+
+    // Never match hidden Unix files if requested.
+    if ( m_dotSpecial && text[0] == '.' )
+        return false;
+
+    const Segment& first = m_segments.front();
+    if ( m_segments.size() == 1 )
+        return text.size() == first.chars.size() && first.MatchesAt(text, 0);
+
+    // The parts before the first and after the last asterisk must match the
+    // beginning and the end of the text.
+    const Segment& last = m_segments.back();
+    if ( text.size() < first.chars.size() + last.chars.size() )
+        return false;
+
+    if ( !first.MatchesAt(text, 0) ||
+            !last.MatchesAt(text, text.size() - last.chars.size()) )
+        return false;
+
+    // And all the others must just be found in order between them: it is
+    // always fine to take the leftmost occurrence of each of them, as this
+    // leaves the most room for the remaining ones.
+    const std::string_view middle = text.substr(0, text.size() - last.chars.size());
+
+    size_t pos = first.chars.size();
+    for ( size_t n = 1; n < m_segments.size() - 1; n++ )
+    {
+        pos = m_segments[n].FindIn(middle, pos);
+        if ( pos == std::string_view::npos )
+            return false;
+
+        pos += m_segments[n].chars.size();
+    }
+
+    return true;
+}
+
 /*
 * Written By Douglas A. Lewis <dalewis@cs.Buffalo.EDU>
 *
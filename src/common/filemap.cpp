@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/filemap.cpp
+// Purpose:     read-only memory mapping of the files
+// Copyright:   (c) 2021 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wx/private/filemap.h"
+
+#ifdef WX_WINDOWS
+    #include "wx/msw/private.h"
+
+    #include <boost/nowide/convert.hpp>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+
+    #include <cerrno>
+#endif
+
+import <algorithm>;
+import <cstdint>;
+
+// ============================================================================
+// wxMappedFile implementation
+// ============================================================================
+
+#ifdef WX_WINDOWS
+
+bool wxMappedFile::Open(const std::string& filename)
+{
+    Close();
+
+    HANDLE hFile = ::CreateFileW(boost::nowide::widen(filename).c_str(),
+                                 GENERIC_READ,
+                                 FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                 nullptr,
+                                 OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL,
+                                 nullptr);
+    if ( hFile == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER size;
+    if ( !::GetFileSizeEx(hFile, &size) ||
+            static_cast<unsigned long long>(size.QuadPart) > SIZE_MAX )
+    {
+        ::CloseHandle(hFile);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    if ( m_size )
+    {
+        // The view keeps the mapping alive, so both handles can be closed
+        // immediately after creating it.
+        HANDLE hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY,
+                                               0, 0, nullptr);
+        if ( hMapping )
+        {
+            m_data = static_cast<const std::byte*>(
+                        ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+            ::CloseHandle(hMapping);
+        }
+
+        if ( m_data )
+        {
+            m_isMapped = true;
+        }
+        else // fall back to reading the file
+        {
+            m_buffer.resize(m_size);
+
+            size_t total = 0;
+            while ( total < m_size )
+            {
+                DWORD chunk = static_cast<DWORD>(
+                                std::min<size_t>(m_size - total, 0x40000000));
+                DWORD read = 0;
+                if ( !::ReadFile(hFile, m_buffer.data() + total, chunk,
+                                 &read, nullptr) || !read )
+                    break;
+
+                total += read;
+            }
+
+            if ( total != m_size )
+            {
+                ::CloseHandle(hFile);
+                Close();
+                return false;
+            }
+
+            m_data = m_buffer.data();
+        }
+    }
+
+    ::CloseHandle(hFile);
+
+    m_isOpened = true;
+
+    return true;
+}
+
+bool wxMappedFile::Advise(wxFileAccessHint access)
+{
+    if ( !m_isMapped )
+        return true;
+
+    // Only prefetching is supported under Windows, the system detects
+    // sequential access on its own.
+    if ( access != wxFileAccessHint::WillNeed )
+        return true;
+
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<std::byte*>(m_data);
+    range.NumberOfBytes = m_size;
+
+    return ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0) != FALSE;
+}
+
+void wxMappedFile::Close()
+{
+    if ( m_isMapped )
+        ::UnmapViewOfFile(m_data);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+    m_isOpened =
+    m_isMapped = false;
+}
+
+#else // !WX_WINDOWS
+
+bool wxMappedFile::Open(const std::string& filename)
+{
+    Close();
+
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if ( fd == -1 )
+        return false;
+
+    struct stat st;
+    if ( ::fstat(fd, &st) != 0 ||
+            static_cast<unsigned long long>(st.st_size) > SIZE_MAX )
+    {
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+
+    if ( m_size )
+    {
+        // The mapping stays valid after closing the descriptor.
+        void* const data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if ( data != MAP_FAILED )
+        {
+            m_data = static_cast<const std::byte*>(data);
+            m_isMapped = true;
+        }
+        else // fall back to reading the file
+        {
+            m_buffer.resize(m_size);
+
+            size_t total = 0;
+            while ( total < m_size )
+            {
+                const ssize_t read = ::read(fd, m_buffer.data() + total,
+                                            m_size - total);
+                if ( read < 0 && errno == EINTR )
+                    continue;
+
+                if ( read <= 0 )
+                    break;
+
+                total += read;
+            }
+
+            if ( total != m_size )
+            {
+                ::close(fd);
+                Close();
+                return false;
+            }
+
+            m_data = m_buffer.data();
+        }
+    }
+
+    ::close(fd);
+
+    m_isOpened = true;
+
+    return true;
+}
+
+bool wxMappedFile::Advise(wxFileAccessHint access)
+{
+    if ( !m_isMapped )
+        return true;
+
+    int advice = MADV_NORMAL;
+    switch ( access )
+    {
+        case wxFileAccessHint::Normal:
+            break;
+
+        case wxFileAccessHint::Sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+
+        case wxFileAccessHint::Random:
+            advice = MADV_RANDOM;
+            break;
+
+        case wxFileAccessHint::WillNeed:
+            advice = MADV_WILLNEED;
+            break;
+    }
+
+    return ::madvise(const_cast<std::byte*>(m_data), m_size, advice) == 0;
+}
+
+void wxMappedFile::Close()
+{
+    if ( m_isMapped )
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+    m_isOpened =
+    m_isMapped = false;
+}
+
+#endif // WX_WINDOWS/!WX_WINDOWS
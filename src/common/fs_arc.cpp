@@ -17,8 +17,12 @@ module;
 module WX.FileSys.Arc;
 
 import WX.Cmn.ArchStream;
+import WX.Cmn.ZipStream;
 import WX.File.Filename;
 
+import <memory>;
+import <unordered_map>;
+
 //---------------------------------------------------------------------------
 // wxArchiveFSCacheDataImpl
 //
@@ -265,8 +269,22 @@ public:
 
     wxArchiveFSCacheData *Get(const std::string& name);
 
+#if wxUSE_ZIPSTREAM
+    // Returns the reader for the given local zip file, opening it if
+    // necessary, or NULL if it couldn't be read.
+    wxZipReader *GetZipReader(const std::string& name,
+                              const std::string& filename,
+                              wxMBConv& conv);
+#endif // wxUSE_ZIPSTREAM
+
 private:
     wxArchiveFSCacheDataHash m_hash;
+
+#if wxUSE_ZIPSTREAM
+    // Null pointers are stored for the files which couldn't be read, to
+    // avoid trying to open them again.
+    std::unordered_map<std::string, std::unique_ptr<wxZipReader>> m_zipReaders;
+#endif // wxUSE_ZIPSTREAM
 };
 
 wxArchiveFSCacheData* wxArchiveFSCache::Add(
@@ -294,6 +312,28 @@ wxArchiveFSCacheData *wxArchiveFSCache::Get(const std::string& name)
     return nullptr;
 }
 
+#if wxUSE_ZIPSTREAM
+
+wxZipReader *wxArchiveFSCache::GetZipReader(const std::string& name,
+                                            const std::string& filename,
+                                            wxMBConv& conv)
+{
+    auto it = m_zipReaders.find(name);
+
+    if (it == m_zipReaders.end())
+    {
+        auto reader = std::make_unique<wxZipReader>(filename, conv);
+        if (!reader->IsOk())
+            reader.reset();
+
+        it = m_zipReaders.emplace(name, std::move(reader)).first;
+    }
+
+    return it->second.get();
+}
+
+#endif // wxUSE_ZIPSTREAM
+
 //----------------------------------------------------------------------------
 // wxArchiveFSHandler
 //----------------------------------------------------------------------------
@@ -331,6 +371,37 @@ wxFSFile* wxArchiveFSHandler::OpenFile(
     if (!factory)
         return nullptr;
 
+#if wxUSE_ZIPSTREAM
+    // Local zip files are mapped in memory and indexed using their central
+    // directory, so that any entry can be opened directly instead of going
+    // through all the preceding ones.
+    if (protocol == "zip" && GetProtocol(left) == "file")
+    {
+        wxZipReader *reader = m_cache->GetZipReader(key,
+                                wxFileSystem::URLToFileName(left).GetFullPath(),
+                                factory->GetConv());
+        if (reader)
+        {
+            const wxZipEntry *entry = reader->FindEntry(right);
+            if (!entry)
+                return nullptr;
+
+            wxInputStream *s = reader->OpenEntry(*entry);
+            if (!s)
+                return nullptr;
+
+            return new wxFSFile(s,
+                                key + right,
+                                {},
+                                GetAnchor(location)
+#if wxUSE_DATETIME
+                                , entry->GetDateTime()
+#endif // wxUSE_DATETIME
+                                );
+        }
+    }
+#endif // wxUSE_ZIPSTREAM
+
     wxArchiveFSCacheData *cached = m_cache->Get(key);
     if (!cached)
     {
@@ -418,7 +489,7 @@ std::string wxArchiveFSHandler::FindFirst(const std::string& spec, unsigned int
 
     m_ZipFile = key;
 
-    m_Pattern = wx::utils::AfterLast(right, '/');
+    m_Pattern = wxWildcardPattern(wx::utils::AfterLast(right, '/'), false);
     m_BaseDir = wx::utils::BeforeLast(right, '/');
     if (m_BaseDir.starts_with('/'))
         m_BaseDir = m_BaseDir.substr(1);
@@ -471,7 +542,7 @@ std::string wxArchiveFSHandler::DoFind()
                     filename = wx::utils::AfterLast(dir, '/');
                     dir = wx::utils::BeforeLast(dir, '/');
                     if (!filename.empty() && m_BaseDir == dir &&
-                                wxMatchWild(m_Pattern, filename, false))
+                                m_Pattern.Matches(filename))
                         match = m_ZipFile + dir + "/" + filename;
                 }
                 else
@@ -482,7 +553,7 @@ std::string wxArchiveFSHandler::DoFind()
         filename = wx::utils::AfterLast(namestr, '/');
         dir = wx::utils::BeforeLast(namestr, '/');
         if (m_AllowFiles && !filename.empty() && m_BaseDir == dir &&
-                            wxMatchWild(m_Pattern, filename, false))
+                            m_Pattern.Matches(filename))
             match = m_ZipFile + namestr;
     }
 
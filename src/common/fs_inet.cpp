@@ -18,6 +18,14 @@
 #include "wx/filesys.h"
 #include "wx/fs_inet.h"
 
+// The cache of the default wxWebSession, if enabled, is used for HTTP.
+#if wxUSE_WEBREQUEST && wxUSE_PROTOCOL_HTTP
+    #define wxHAS_FS_INET_CACHE
+
+    #include "wx/protocol/http.h"
+    #include "wx/private/webcache.h"
+#endif
+
 import WX.Cmn.WFStream;
 
 import Utils.Strings;
@@ -65,6 +73,42 @@ std::string StripProtocolAnchor(const std::string& location)
     return myloc;
 }
 
+// Extract just the MIME type from Content-Type header, which, as defined by
+// RFC 2045, has the form of "type/subtype" optionally followed by (multiple)
+// "; parameter".
+wxString GetMimeType(const wxString& contentType)
+{
+    wxString mimetype = contentType.BeforeFirst(';');
+    mimetype.Trim();
+
+    return mimetype;
+}
+
+#ifdef wxHAS_FS_INET_CACHE
+
+wxFSFile* CreateFromCache(const wxWebCacheEntry& entry,
+                          const wxString& right,
+                          const wxString& anchor)
+{
+    std::unique_ptr<wxMappedFileInputStream>
+        stream(new wxMappedFileInputStream(entry.GetBodyFile()));
+
+    // The entry could have been evicted from the cache in the meanwhile.
+    if ( !stream->IsOk() )
+        return nullptr;
+
+    return new wxFSFile(stream.release(),
+                        right,
+                        GetMimeType(entry.GetHeader("Content-Type")),
+                        anchor
+#if wxUSE_DATETIME
+                        , wxDateTime::Now()
+#endif // wxUSE_DATETIME
+                );
+}
+
+#endif // wxHAS_FS_INET_CACHE
+
 class wxFileSystemInternetModule : public wxModule
 {
     wxDECLARE_DYNAMIC_CLASS(wxFileSystemInternetModule);
@@ -114,12 +158,75 @@ wxFSFile* wxInternetFSHandler::OpenFile([[maybe_unused]] wxFileSystem& fs,
     std::string right =
         GetProtocol(location) + ":" + StripProtocolAnchor(location);
 
+#ifdef wxHAS_FS_INET_CACHE
+    // The headers of the default session are sent with our request too, as
+    // the responses stored in the cache may vary on them.
+    std::shared_ptr<wxWebCache> cache;
+    wxWebRequestHeaderMap headers;
+    if ( GetProtocol(location) == "http" )
+        cache = wxGetDefaultWebCache(&headers);
+
+    wxWebCacheEntryPtr entry;
+    if ( cache )
+    {
+        entry = cache->Find(right, headers);
+        if ( entry && entry->IsFresh() )
+        {
+            if ( wxFSFile* file = CreateFromCache(*entry, right, GetAnchor(location)) )
+                return file;
+        }
+
+        if ( entry && !entry->HasValidators() )
+            entry.reset();
+    }
+#endif // wxHAS_FS_INET_CACHE
+
     wxURL url(right);
     if (url.GetError() == wxURLError::None)
     {
+#ifdef wxHAS_FS_INET_CACHE
+        wxHTTP* const http = cache ? static_cast<wxHTTP*>(&url.GetProtocol())
+                                   : nullptr;
+        if ( http )
+        {
+            for ( const auto& header : headers )
+                http->SetHeader(header.first, header.second);
+        }
+
+        if ( entry )
+        {
+            // Ask the server to send the response only if it changed.
+            const wxString etag = entry->GetHeader("ETag");
+            if ( !etag.empty() )
+                http->SetHeader("If-None-Match", etag);
+
+            const wxString lastModified = entry->GetHeader("Last-Modified");
+            if ( !lastModified.empty() )
+                http->SetHeader("If-Modified-Since", lastModified);
+        }
+#endif // wxHAS_FS_INET_CACHE
+
         wxInputStream *s = url.GetInputStream();
         if (s)
         {
+#ifdef wxHAS_FS_INET_CACHE
+            const auto getHeader = [http](const wxString& name)
+            {
+                return http->GetHeader(name);
+            };
+
+            if ( entry && http->GetResponse() == 304 )
+            {
+                delete s;
+
+                entry = cache->Revalidated(entry, getHeader);
+                if ( !entry )
+                    return nullptr;
+
+                return CreateFromCache(*entry, right, GetAnchor(location));
+            }
+#endif // wxHAS_FS_INET_CACHE
+
             wxString tmpfile =
                 wxFileName::CreateTempFileName("wxhtml");
 
@@ -127,18 +234,30 @@ wxFSFile* wxInternetFSHandler::OpenFile([[maybe_unused]] wxFileSystem& fs,
                 wxFileOutputStream sout(tmpfile);
                 s->Read(sout);
             }
+
+            // Don't cache the response if we didn't read all of it.
+            [[maybe_unused]] const bool complete =
+                s->GetLastError() == wxSTREAM_EOF;
             delete s;
 
-            // Content-Type header, as defined by the RFC 2045, has the form of
-            // "type/subtype" optionally followed by (multiple) "; parameter"
-            // and we need just the MIME type here.
+#ifdef wxHAS_FS_INET_CACHE
+            if ( cache && complete )
+            {
+                // Store a copy of the file in the cache, as we still need to
+                // use the original one if this fails.
+                cache->Store(right, headers, http->GetResponse(), {}, getHeader,
+                             [&tmpfile](const std::string& filename)
+                             {
+                                return wxCopyFile(tmpfile, filename);
+                             });
+            }
+#endif // wxHAS_FS_INET_CACHE
+
             const wxString& content = url.GetProtocol().GetContentType();
-            wxString mimetype = content.BeforeFirst(';');
-            mimetype.Trim();
 
             return new wxFSFile(new wxTemporaryFileInputStream(tmpfile),
                                 right,
-                                mimetype,
+                                GetMimeType(content),
                                 GetAnchor(location)
 #if wxUSE_DATETIME
                                 , wxDateTime::Now()
@@ -18,6 +18,8 @@
 // ============================================================================
 
 wxDEFINE_EVENT(wxEVT_FSWATCHER, wxFileSystemWatcherEvent);
+wxDEFINE_EVENT(wxEVT_FSWATCHER_BATCH, wxFileSystemWatcherBatchEvent);
+wxDEFINE_EVENT(wxEVT_FSWATCHER_TREE_ADDED, wxFileSystemWatcherEvent);
 
 namespace
 {
@@ -216,7 +218,10 @@ bool wxFileSystemWatcherBase::AddTree(const wxFileName& path, int events,
         flags |= wxDIR_NO_FOLLOW;
     }
     AddTraverser traverser(this, events, filespec);
-    dir.Traverse(traverser, filespec, flags);
+
+    // Read the directories in the background threads, only adding the watches
+    // for them, which must be done in this thread, is done here.
+    dir.TraverseParallel(traverser, filespec, flags);
 
     // Add the path itself explicitly as Traverse() doesn't return it.
     AddAny(path.GetFullPath(), events, wxFSWPathType::Tree, filespec);
@@ -287,7 +292,7 @@ bool wxFileSystemWatcherBase::RemoveTree(const wxFileName& path)
         flags |= wxDIR_NO_FOLLOW;
     }
     RemoveTraverser traverser(this, filespec);
-    dir.Traverse(traverser, filespec, flags);
+    dir.TraverseParallel(traverser, filespec, flags);
 
     // As in AddTree() above, handle the path itself explicitly.
     Remove(path);
@@ -487,6 +487,53 @@ void wxGraphicsPathData::AddArcToPoint( float x1, float y1 , float x2, float y2,
     AddArc(c.x, c.y, r, wx::narrow_cast<float>(wxDegToRad(a1)), wx::narrow_cast<float>(wxDegToRad(a2)), drawClockwiseArc);
 }
 
+//-----------------------------------------------------------------------------
+// wxGraphicsBatch
+//-----------------------------------------------------------------------------
+
+void wxGraphicsBatch::AddMarkers(std::span<const wxPoint2DFloat> centers,
+                                 wxGraphicsMarker shape,
+                                 float size)
+{
+    if ( centers.empty() )
+        return;
+
+    // Extend the last run if possible to keep the number of runs small when
+    // the markers are added one by one.
+    if ( !m_markers.empty() )
+    {
+        MarkerRun& last = m_markers.back();
+        if ( last.shape == shape && last.size == size &&
+                last.first + last.count == m_points.size() )
+        {
+            last.count += centers.size();
+            m_points.insert(m_points.end(), centers.begin(), centers.end());
+            return;
+        }
+    }
+
+    m_markers.push_back({shape, size, m_points.size(), centers.size()});
+    m_points.insert(m_points.end(), centers.begin(), centers.end());
+}
+
+void wxGraphicsBatch::AddPolyline(std::span<const wxPoint2DFloat> points,
+                                  bool closed)
+{
+    wxCHECK_RET( points.size() > 1, "polyline must have at least 2 points" );
+
+    m_polylines.push_back({m_points.size(), points.size(), closed});
+    m_points.insert(m_points.end(), points.begin(), points.end());
+}
+
+void wxGraphicsBatch::Clear()
+{
+    m_rects.clear();
+    m_ellipses.clear();
+    m_markers.clear();
+    m_polylines.clear();
+    m_points.clear();
+}
+
 //-----------------------------------------------------------------------------
 // wxGraphicsGradientStops
 //-----------------------------------------------------------------------------
@@ -662,6 +709,56 @@ void wxGraphicsContext::DrawPath( const wxGraphicsPath& path, wxPolygonFillMode
     StrokePath( path );
 }
 
+namespace
+{
+
+// Sink for wxBuildGraphicsBatchPath() creating a generic wxGraphicsPath.
+class wxGraphicsPathBatchSink
+{
+public:
+    explicit wxGraphicsPathBatchSink(wxGraphicsPath& path) : m_path(path) { }
+
+    void MoveTo(float x, float y) { m_path.MoveToPoint(x, y); }
+    void LineTo(float x, float y) { m_path.AddLineToPoint(x, y); }
+    void ClosePath() { m_path.CloseSubpath(); }
+
+    void AddRectangle(float x, float y, float w, float h)
+        { m_path.AddRectangle(x, y, w, h); }
+    void AddEllipse(float x, float y, float w, float h)
+        { m_path.AddEllipse(x, y, w, h); }
+
+private:
+    wxGraphicsPath& m_path;
+};
+
+} // anonymous namespace
+
+wxGraphicsPath wxGraphicsContext::CreateBatchPath(const wxGraphicsBatch& batch) const
+{
+    wxGraphicsPath path = CreatePath();
+    wxGraphicsPathBatchSink sink(path);
+    wxBuildGraphicsBatchPath(batch, sink);
+    return path;
+}
+
+void wxGraphicsContext::StrokeBatch( const wxGraphicsBatch& batch )
+{
+    if ( !batch.IsEmpty() )
+        StrokePath( CreateBatchPath(batch) );
+}
+
+void wxGraphicsContext::FillBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle )
+{
+    if ( !batch.IsEmpty() )
+        FillPath( CreateBatchPath(batch), fillStyle );
+}
+
+void wxGraphicsContext::DrawBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle )
+{
+    if ( !batch.IsEmpty() )
+        DrawPath( CreateBatchPath(batch), fillStyle );
+}
+
 void
 wxGraphicsContext::DoDrawRotatedText(std::string_view str,
                                      float x,
@@ -794,6 +891,13 @@ void wxGraphicsContext::StrokeLines( size_t n, const wxPoint2DFloat *beginPoints
     StrokePath( path );
 }
 
+void wxGraphicsContext::DrawTexts(size_t n, const std::string_view* texts,
+                                  const wxPoint2DFloat* positions)
+{
+    for ( size_t i = 0; i < n; ++i )
+        DoDrawText(texts[i], positions[i].x, positions[i].y);
+}
+
 // create a 'native' matrix corresponding to these values
 wxGraphicsMatrix wxGraphicsContext::CreateMatrix( float a, float b, float c, float d,
     float tx, float ty) const
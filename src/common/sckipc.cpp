@@ -33,6 +33,32 @@
 #include "wx/module.h"
 #include "wx/socket.h"
 
+#if wxUSE_ZLIB
+    #if defined(WX_WINDOWS) && !defined(__WX_SETUP_H__) && !defined(wxUSE_ZLIB_H_IN_PATH)
+        #include "../zlib/zlib.h"
+    #else
+        #include "zlib.h"
+    #endif
+#endif
+
+// shared memory is used for the connections over Unix domain sockets
+#if defined(__UNIX__) && !defined(WX_WINDOWS) && !defined(__WINE__)
+    #define wxHAS_IPC_SHARED_MEMORY
+
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+import <atomic>;
+import <cstdint>;
+import <memory>;
+import <string>;
+import <unordered_map>;
+import <vector>;
+
 // --------------------------------------------------------------------------
 // macros and constants
 // --------------------------------------------------------------------------
@@ -55,9 +81,62 @@ enum IPCCode
     IPC_FAIL            = 9,
     IPC_CONNECT         = 10,
     IPC_DISCONNECT      = 11,
+
+    // The messages below are only used if the peer replied with IPC_FEATURES
+    // to IPC_FEATURES sent by the client after connecting, older versions
+    // just reply with IPC_FAIL to it.
+    IPC_FEATURES        = 12,   // followed by the 32 bit mask in the reply
+    IPC_FEATURES_SET    = 13,   // followed by the mask of features to use
+    IPC_REQUEST_ID      = 14,   // IPC_REQUEST preceded by 32 bit ID
+    IPC_REPLY_ID        = 15,   // ID, IPC_REQUEST_REPLY or IPC_FAIL, data
+    IPC_SHARED_OPEN     = 16,   // name of the shared memory to use
+    IPC_SHARED_ACK      = 17,   // followed by 1 if it was opened, 0 if not
     IPC_MAX
 };
 
+// Optional protocol features, must be supported by both peers to be used.
+enum IPCFeature : std::uint32_t
+{
+    IPC_FEATURE_REQUEST_ID  = 0x0001,   // requests can be pipelined
+    IPC_FEATURE_COMPRESSION = 0x0002,   // data blocks may be compressed
+    IPC_FEATURE_SHARED_MEMORY = 0x0004  // data blocks may be in shared memory
+};
+
+constexpr std::uint32_t IPC_SUPPORTED_FEATURES = IPC_FEATURE_REQUEST_ID
+#if wxUSE_ZLIB
+                                               | IPC_FEATURE_COMPRESSION
+#endif
+                                               ;
+
+// Set in the size of the compressed data blocks, which is followed by the
+// size of the uncompressed data.
+constexpr std::uint32_t IPC_COMPRESSED_FLAG = 0x80000000;
+
+// Smaller data blocks are never compressed, this wouldn't gain anything.
+constexpr size_t IPC_COMPRESS_MIN_SIZE = 256;
+
+// Maximal number of requests sent by RequestAsync() whose replies haven't
+// been received yet: if we kept sending the requests without reading the
+// replies, the peer could block writing them to the socket and stop reading
+// our requests, while we would block writing them, resulting in a deadlock.
+constexpr size_t IPC_MAX_PENDING_REQUESTS = 64;
+
+#ifdef wxHAS_IPC_SHARED_MEMORY
+
+// Used instead of the size of the data blocks passed via shared memory, this
+// value is followed by the 64 bit position of the block and its 32 bit size.
+constexpr std::uint32_t IPC_SHARED_MARKER = 0xffffffff;
+
+// Only the data blocks at least this big are passed via shared memory, for
+// the smaller ones writing them to the socket directly is just as fast.
+constexpr size_t IPC_SHARED_MIN_SIZE = 64*1024;
+
+// Size of the shared memory buffer used for each direction. The memory is
+// only really allocated when it's used.
+constexpr size_t IPC_SHARED_SIZE = 64*1024*1024;
+
+#endif // wxHAS_IPC_SHARED_MEMORY
+
 } // anonymous namespace
 
 // headers needed for umask()
@@ -114,8 +193,24 @@ public:
     void Client_OnRequest(wxSocketEvent& event);
     void Server_OnRequest(wxSocketEvent& event);
 
+    enum class HandleResult
+    {
+        Ok,
+        Error,
+        Disconnected    // the connection object may have been deleted
+    };
+
+    // process a single message with the given code which was just read
+    static HandleResult HandleMessage(wxTCPConnection *connection, int msg);
+
 private:
-    void HandleDisconnect(wxTCPConnection *connection);
+    static void HandleDisconnect(wxTCPConnection *connection);
+
+    // return the data to send in reply to the request or NULL on failure
+    static const void *GetRequestData(wxTCPConnection *connection,
+                                      const wxString& item,
+                                      wxIPCFormat format,
+                                      size_t *size);
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -158,6 +253,207 @@ private:
 
 wxIMPLEMENT_DYNAMIC_CLASS(wxTCPEventHandlerModule, wxModule);
 
+#ifdef wxHAS_IPC_SHARED_MEMORY
+
+// --------------------------------------------------------------------------
+// wxIPCSharedBuffer (private class)
+// --------------------------------------------------------------------------
+
+// A ring buffer in the memory shared by both peers: each side creates one for
+// the data it sends and the other side maps it too. The blocks are allocated
+// by the sender, in order, and released by the receiver once it doesn't need
+// them any more, so the only state that has to be shared is the position up
+// to which the data was released.
+class wxIPCSharedBuffer
+{
+public:
+    wxIPCSharedBuffer() = default;
+    wxIPCSharedBuffer(const wxIPCSharedBuffer&) = delete;
+    wxIPCSharedBuffer& operator=(const wxIPCSharedBuffer&) = delete;
+
+    ~wxIPCSharedBuffer()
+    {
+        Unlink();
+
+        if ( m_header )
+            munmap(m_header, sizeof(Header) + m_capacity);
+    }
+
+    // create a new buffer of the given size, with a unique name
+    bool Create(size_t capacity)
+    {
+        static std::atomic<unsigned> s_counter{0};
+
+        for ( int attempt = 0; attempt < 10; attempt++ )
+        {
+            // Notice that the name must be short enough for macOS, which
+            // limits it to 31 characters. It can still exist if it was left
+            // by a process with the same PID which crashed, so just try the
+            // next one then.
+            char name[32];
+            snprintf(name, sizeof(name), "/wxipc-%ld-%x",
+                     static_cast<long>(getpid()), s_counter++);
+
+            const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+            if ( fd == -1 )
+            {
+                if ( errno == EEXIST )
+                    continue;
+
+                wxLogDebug("Failed to create shared memory: %s",
+                           wxSysErrorMsgStr());
+                return false;
+            }
+
+            m_name = name;
+
+            const bool ok = ftruncate(fd, sizeof(Header) + capacity) == 0 &&
+                                Map(fd, capacity);
+            close(fd);
+
+            if ( !ok )
+            {
+                Unlink();
+                return false;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // open the buffer created by the peer
+    bool Open(const std::string& name)
+    {
+        // Check that the name is what Create() would use to avoid mapping
+        // some other object.
+        if ( name.compare(0, 7, "/wxipc-") != 0 ||
+                name.find('/', 1) != std::string::npos )
+            return false;
+
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if ( fd == -1 )
+            return false;
+
+        bool ok = false;
+
+        struct stat st;
+        if ( fstat(fd, &st) == 0 &&
+                static_cast<size_t>(st.st_size) > sizeof(Header) )
+        {
+            ok = Map(fd, st.st_size - sizeof(Header));
+        }
+
+        close(fd);
+
+        return ok;
+    }
+
+    // remove the name of the buffer created by Create(), this must be done
+    // once the peer has opened it (or failed to do it)
+    void Unlink()
+    {
+        if ( !m_name.empty() )
+        {
+            shm_unlink(m_name.c_str());
+            m_name.clear();
+        }
+    }
+
+    const std::string& GetName() const { return m_name; }
+
+
+    // allocate a contiguous block in the buffer, return nullptr if there is
+    // not enough space in it, this is only used by the sending side
+    void *Allocate(size_t size, std::uint64_t *pos)
+    {
+        if ( size > m_capacity )
+            return nullptr;
+
+        std::uint64_t start = m_head;
+
+        // Don't wrap the block around the end of the buffer, skip the space
+        // remaining in it instead.
+        size_t offset = start % m_capacity;
+        if ( offset + size > m_capacity )
+        {
+            start += m_capacity - offset;
+            offset = 0;
+        }
+
+        const std::uint64_t
+            tail = m_header->tail.load(std::memory_order_acquire);
+        if ( start + size - tail > m_capacity )
+            return nullptr;
+
+        m_head = start + size;
+        *pos = start;
+
+        return m_data + offset;
+    }
+
+    // get the block allocated by the peer, return nullptr if the position is
+    // invalid, this is only used by the receiving side
+    void *GetData(std::uint64_t pos, size_t size) const
+    {
+        const size_t offset = pos % m_capacity;
+        if ( size > m_capacity - offset )
+            return nullptr;
+
+        return m_data + offset;
+    }
+
+    // indicate that all the data up to the given position may be reused
+    void Release(std::uint64_t end)
+    {
+        m_header->tail.store(end, std::memory_order_release);
+    }
+
+private:
+    struct Header
+    {
+        std::atomic<std::uint64_t> tail;
+
+        // pad it to make the data aligned
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "atomics must be lock-free to be used in shared memory");
+
+    bool Map(int fd, size_t capacity)
+    {
+        void * const
+            p = mmap(nullptr, sizeof(Header) + capacity,
+                     PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if ( p == MAP_FAILED )
+        {
+            wxLogDebug("Failed to map shared memory: %s", wxSysErrorMsgStr());
+            return false;
+        }
+
+        m_header = static_cast<Header *>(p);
+        m_data = static_cast<char *>(p) + sizeof(Header);
+        m_capacity = capacity;
+
+        return true;
+    }
+
+    // the name of the buffer we created, empty after it was unlinked
+    std::string m_name;
+
+    Header *m_header{nullptr};
+    char *m_data{nullptr};
+    size_t m_capacity{0};
+
+    // the position of the end of the last allocated block, only used by the
+    // sending side
+    std::uint64_t m_head{0};
+};
+
+#endif // wxHAS_IPC_SHARED_MEMORY
+
 // --------------------------------------------------------------------------
 // wxIPCSocketStreams
 // --------------------------------------------------------------------------
@@ -198,6 +494,193 @@ public:
 #endif
     }
 
+    // flush output unless we're inside a batch, in which case it will be done
+    // at its end
+    void FlushUnlessBatching()
+    {
+        if ( !m_batchDepth )
+            Flush();
+    }
+
+    void BeginBatch()
+    {
+        m_batchDepth++;
+    }
+
+    void EndBatch()
+    {
+        wxCHECK_RET( m_batchDepth > 0, "EndBatch() without BeginBatch()" );
+
+        if ( !--m_batchDepth )
+            Flush();
+    }
+
+
+    // protocol features negotiated with the peer
+    void SetFeatures(std::uint32_t features) { m_features = features; }
+
+    // if disabled, behave as the old versions not knowing about features
+    void DisableFeatures() { m_featuresEnabled = false; }
+    bool AreFeaturesEnabled() const { return m_featuresEnabled; }
+
+    std::uint32_t GetSupportedFeatures() const
+    {
+        std::uint32_t features = IPC_SUPPORTED_FEATURES;
+#ifdef wxHAS_IPC_SHARED_MEMORY
+        if ( m_local )
+            features |= IPC_FEATURE_SHARED_MEMORY;
+#endif
+        return features;
+    }
+    bool HasFeature(IPCFeature feature) const
+        { return (m_features & feature) != 0; }
+
+    void SetCompress(bool compress) { m_compress = compress; }
+
+    // indicate that the peer is on the same machine, this allows using shared
+    // memory for communicating with it
+    void SetLocal() { m_local = true; }
+
+#ifdef wxHAS_IPC_SHARED_MEMORY
+    // client side: create our shared buffer and exchange it with the server
+    void SetupSharedMemory()
+    {
+        auto shared = std::make_unique<wxIPCSharedBuffer>();
+        if ( !shared->Create(IPC_SHARED_SIZE) )
+            return;
+
+        m_dataOut.Write8(IPC_SHARED_OPEN);
+        m_dataOut.WriteString(shared->GetName());
+
+        const int msg = Read8();
+
+        // The server has either opened our buffer or failed to do it by now,
+        // so we don't need its name any longer in any case.
+        shared->Unlink();
+
+        if ( msg != IPC_SHARED_OPEN )
+            return;
+
+        m_sharedOut = std::move(shared);
+
+        const std::string name = ReadString().ToStdString();
+
+        auto sharedIn = std::make_unique<wxIPCSharedBuffer>();
+        const bool ok = sharedIn->Open(name);
+        if ( ok )
+            m_sharedIn = std::move(sharedIn);
+
+        m_dataOut.Write8(IPC_SHARED_ACK);
+        m_dataOut.Write8(ok);
+        Flush();
+    }
+
+    // server side: make opening the client buffer always fail
+    void SimulateSharedMemoryFailure() { m_sharedMemoryFails = true; }
+
+    // server side: open the client buffer and create ours, return its name
+    // or empty string on failure
+    std::string AcceptSharedMemory(const std::string& name)
+    {
+        if ( !HasFeature(IPC_FEATURE_SHARED_MEMORY) )
+            return {};
+
+        auto sharedIn = std::make_unique<wxIPCSharedBuffer>();
+        if ( m_sharedMemoryFails || !sharedIn->Open(name) )
+            return {};
+
+        auto shared = std::make_unique<wxIPCSharedBuffer>();
+        if ( !shared->Create(IPC_SHARED_SIZE) )
+            return {};
+
+        m_sharedIn = std::move(sharedIn);
+        m_sharedPending = std::move(shared);
+
+        return m_sharedPending->GetName();
+    }
+
+    // server side: called when the client confirms opening our buffer
+    void ConfirmSharedMemory(bool ok)
+    {
+        if ( !m_sharedPending )
+            return;
+
+        m_sharedPending->Unlink();
+        if ( ok )
+            m_sharedOut = std::move(m_sharedPending);
+        else
+            m_sharedPending.reset();
+    }
+
+    // let the peer reuse the shared memory used by the last data block read
+    void ReleaseSharedData()
+    {
+        if ( m_sharedReleasePos )
+        {
+            m_sharedIn->Release(m_sharedReleasePos);
+            m_sharedReleasePos = 0;
+        }
+    }
+#else // !wxHAS_IPC_SHARED_MEMORY
+    void ReleaseSharedData() { }
+#endif // wxHAS_IPC_SHARED_MEMORY/!wxHAS_IPC_SHARED_MEMORY
+
+
+    // the replies to the requests made by RequestAsync() which were received
+    // but not retrieved by GetReply() yet
+    std::uint32_t NewRequestId()
+    {
+        if ( !++m_lastRequestId )
+            ++m_lastRequestId;
+
+        return m_lastRequestId;
+    }
+
+    // the number of requests sent with an ID whose replies weren't read yet
+    void OnRequestSent() { ++m_pendingRequests; }
+    void OnReplyReceived()
+    {
+        if ( m_pendingRequests )
+            --m_pendingRequests;
+    }
+    size_t GetPendingRequests() const { return m_pendingRequests; }
+
+    void StoreReply(std::uint32_t id, const void *data, size_t size)
+    {
+        IPCReply& reply = m_replies[id];
+        if ( data )
+        {
+            const auto p = static_cast<const char *>(data);
+            reply.data.assign(p, p + size);
+            reply.ok = true;
+        }
+    }
+
+    bool HasReply(std::uint32_t id) const
+    {
+        return m_replies.find(id) != m_replies.end();
+    }
+
+    // copy the reply into the connection buffer and forget about it
+    void *TakeReply(wxConnectionBase *conn, std::uint32_t id, size_t *size)
+    {
+        const auto it = m_replies.find(id);
+        wxCHECK_MSG( it != m_replies.end(), nullptr, "no reply to take" );
+
+        void *data = nullptr;
+        if ( it->second.ok )
+        {
+            *size = it->second.data.size();
+            data = conn->GetBufferAtLeast(*size);
+            if ( data && *size )
+                memcpy(data, it->second.data.data(), *size);
+        }
+
+        m_replies.erase(it);
+
+        return data;
+    }
+
     // simple wrappers around the functions with the same name in
     // wxDataInputStream
     std::uint8_t Read8()
@@ -228,7 +711,22 @@ public:
         wxCHECK_MSG( conn, nullptr, "NULL connection parameter" );
         wxCHECK_MSG( size, nullptr, "NULL size parameter" );
 
-        *size = Read32();
+        // The data returned by the previous call is not used any more.
+        ReleaseSharedData();
+
+        const std::uint32_t size32 = Read32();
+#ifdef wxHAS_IPC_SHARED_MEMORY
+        if ( size32 == IPC_SHARED_MARKER && m_sharedIn )
+            return ReadSharedData(size);
+#endif // wxHAS_IPC_SHARED_MEMORY
+
+        if ( (size32 & IPC_COMPRESSED_FLAG) &&
+                HasFeature(IPC_FEATURE_COMPRESSION) )
+        {
+            return ReadCompressedData(conn, size32 & ~IPC_COMPRESSED_FLAG, size);
+        }
+
+        *size = size32;
 
         void * const data = conn->GetBufferAtLeast(*size);
         wxCHECK_MSG( data, nullptr, "IPC buffer allocation failed" );
@@ -250,11 +748,119 @@ public:
     }
 
 
+    // write arbitrary data, compressing it if possible and enabled
+    void WriteData(const void *data, size_t size)
+    {
+#ifdef wxHAS_IPC_SHARED_MEMORY
+        // Big blocks are copied into the shared memory, if we have it and
+        // there is enough space in it, and only their position is sent.
+        if ( m_sharedOut && size >= IPC_SHARED_MIN_SIZE &&
+                size < IPC_SHARED_MARKER )
+        {
+            std::uint64_t pos;
+            if ( void * const shared = m_sharedOut->Allocate(size, &pos) )
+            {
+                memcpy(shared, data, size);
+
+                m_dataOut.Write32(IPC_SHARED_MARKER);
+                m_dataOut.Write64(pos);
+                m_dataOut.Write32(size);
+                return;
+            }
+        }
+#endif // wxHAS_IPC_SHARED_MEMORY
+
+#if wxUSE_ZLIB
+        if ( m_compress && HasFeature(IPC_FEATURE_COMPRESSION) &&
+                size >= IPC_COMPRESS_MIN_SIZE && size < IPC_COMPRESSED_FLAG )
+        {
+            uLongf len = compressBound(size);
+            m_compressBuf.resize(len);
+
+            // Favour speed, as the data is sent over the network immediately,
+            // and only use the result if it's really smaller.
+            if ( compress2(m_compressBuf.data(), &len,
+                           static_cast<const Bytef *>(data), size,
+                           Z_BEST_SPEED) == Z_OK && len < size )
+            {
+                m_dataOut.Write32(IPC_COMPRESSED_FLAG | len);
+                m_dataOut.Write32(size);
+                m_bufferedOut.Write(m_compressBuf.data(), len);
+                return;
+            }
+        }
+#endif // wxUSE_ZLIB
+
+        m_dataOut.Write32(size);
+        m_bufferedOut.Write(data, size);
+    }
+
     // these methods are only used by IPCOutput and not directly
     wxDataOutputStream& GetDataOut() { return m_dataOut; }
-    wxOutputStream& GetUnformattedOut() { return m_bufferedOut; }
 
 private:
+#ifdef wxHAS_IPC_SHARED_MEMORY
+    // return the pointer to the data in the shared memory directly, without
+    // copying it, it remains valid until the next call to ReadData()
+    void *ReadSharedData(size_t *size)
+    {
+        const std::uint64_t pos = m_dataIn.Read64();
+        *size = Read32();
+
+        void * const data = m_sharedIn->GetData(pos, *size);
+        if ( !data )
+        {
+            wxLogDebug("Invalid shared IPC data position.");
+            return nullptr;
+        }
+
+        m_sharedReleasePos = pos + *size;
+
+        return data;
+    }
+#endif // wxHAS_IPC_SHARED_MEMORY
+
+    void *
+    ReadCompressedData(wxConnectionBase *conn, size_t compressedSize, size_t *size)
+    {
+#if wxUSE_ZLIB
+        *size = Read32();
+
+        m_compressBuf.resize(compressedSize);
+        m_socketStream.Read(m_compressBuf.data(), compressedSize);
+
+        void * const data = conn->GetBufferAtLeast(*size);
+        wxCHECK_MSG( data, nullptr, "IPC buffer allocation failed" );
+
+        uLongf len = *size;
+        if ( uncompress(static_cast<Bytef *>(data), &len,
+                        m_compressBuf.data(), compressedSize) != Z_OK ||
+                len != *size )
+        {
+            wxLogDebug("Failed to decompress IPC data.");
+            return nullptr;
+        }
+
+        return data;
+#else // !wxUSE_ZLIB
+        // We never advertise the support for compression in this case, so
+        // the peer shouldn't send us any compressed data.
+        wxUnusedVar(conn);
+        wxUnusedVar(compressedSize);
+        wxUnusedVar(size);
+
+        wxFAIL_MSG("Unexpected compressed data");
+        return nullptr;
+#endif // wxUSE_ZLIB/!wxUSE_ZLIB
+    }
+
+    struct IPCReply
+    {
+        std::vector<char> data;
+        bool ok{false};
+    };
+
+
     // this is the low-level underlying stream using the connection socket
     wxSocketStream m_socketStream;
 
@@ -271,6 +877,45 @@ private:
     // the above streams easily
     wxDataInputStream  m_dataIn;
     wxDataOutputStream m_dataOut;
+
+    // the replies received for the pipelined requests
+    std::unordered_map<std::uint32_t, IPCReply> m_replies;
+
+    // buffer used for compressing or decompressing the data
+    std::vector<unsigned char> m_compressBuf;
+
+    // mask of IPCFeature values supported by both sides
+    std::uint32_t m_features{0};
+
+    std::uint32_t m_lastRequestId{0};
+
+    size_t m_pendingRequests{0};
+
+    int m_batchDepth{0};
+
+#ifdef wxHAS_IPC_SHARED_MEMORY
+    // the buffers for the data received from the peer and sent to it
+    std::unique_ptr<wxIPCSharedBuffer> m_sharedIn,
+                                       m_sharedOut;
+
+    // the buffer created by the server until the client confirms opening it
+    std::unique_ptr<wxIPCSharedBuffer> m_sharedPending;
+
+    // if non-zero, the end of the last block read from m_sharedIn
+    std::uint64_t m_sharedReleasePos{0};
+
+    // true if opening the client buffer must fail, for testing only
+    bool m_sharedMemoryFails{false};
+#endif // wxHAS_IPC_SHARED_MEMORY
+
+    // true if compression was requested for the data we send
+    bool m_compress{false};
+
+    // true if the peer is on the same machine
+    bool m_local{false};
+
+    // false if the server was told not to support any optional features
+    bool m_featuresEnabled{true};
 };
 
 namespace
@@ -292,8 +937,9 @@ public:
         wxASSERT_MSG( streams, "NULL streams pointer" );
     }
 
-    // dtor calls Flush() really sending the IPC data to the network
-    ~IPCOutput() { m_streams.Flush(); }
+    // dtor calls Flush() really sending the IPC data to the network, unless
+    // this is a part of a batch
+    ~IPCOutput() { m_streams.FlushUnlessBatching(); }
 
     // write a byte
     void Write8(std::uint8_t i)
@@ -301,11 +947,21 @@ public:
         m_streams.GetDataOut().Write8(i);
     }
 
+    void Write32(std::uint32_t i)
+    {
+        m_streams.GetDataOut().Write32(i);
+    }
+
+    void WriteString(const wxString& str)
+    {
+        m_streams.GetDataOut().WriteString(str);
+    }
+
     // write the reply code and a string
     void Write(IPCCode code, const wxString& str)
     {
         Write8(code);
-        m_streams.GetDataOut().WriteString(str);
+        WriteString(str);
     }
 
     // write the reply code, a string and a format in this order
@@ -318,8 +974,7 @@ public:
     // write arbitrary data
     void WriteData(const void *data, size_t size)
     {
-        m_streams.GetDataOut().Write32(size);
-        m_streams.GetUnformattedOut().Write(data, size);
+        m_streams.WriteData(data, size);
     }
 
 
@@ -349,10 +1004,13 @@ wxConnectionBase *wxTCPClient::MakeConnection(const wxString& host,
     if ( !addr )
         return nullptr;
 
-    wxSocketClient * const client = new wxSocketClient(wxSOCKET_WAITALL);
+    wxSocketClient * const
+        client = new wxSocketClient(wxSOCKET_WAITALL | wxSOCKET_READAHEAD);
     wxIPCSocketStreams * const streams = new wxIPCSocketStreams(*client);
 
     bool ok = client->Connect(*addr);
+    if ( addr->Type() == wxSockAddress::UNIX )
+        streams->SetLocal();
     delete addr;
 
     if ( ok )
@@ -365,6 +1023,29 @@ wxConnectionBase *wxTCPClient::MakeConnection(const wxString& host,
         // OK! Confirmation.
         if (msg == IPC_CONNECT)
         {
+            // Find out if the server supports any of the optional features:
+            // the old versions reply with IPC_FAIL to this message, but as
+            // it has no parameters, they don't get confused by it.
+            IPCOutput(streams).Write8(IPC_FEATURES);
+            if ( streams->Read8() == IPC_FEATURES )
+            {
+                const std::uint32_t
+                    features = streams->Read32() & streams->GetSupportedFeatures();
+
+                {
+                    IPCOutput out(streams);
+                    out.Write8(IPC_FEATURES_SET);
+                    out.Write32(features);
+                }
+
+                streams->SetFeatures(features);
+
+#ifdef wxHAS_IPC_SHARED_MEMORY
+                if ( streams->HasFeature(IPC_FEATURE_SHARED_MEMORY) )
+                    streams->SetupSharedMemory();
+#endif // wxHAS_IPC_SHARED_MEMORY
+            }
+
             wxTCPConnection *
                 connection = (wxTCPConnection *)OnMakeConnection ();
 
@@ -523,9 +1204,25 @@ wxTCPConnection::~wxTCPConnection()
     delete m_streams;
 }
 
-void wxTCPConnection::Compress([[maybe_unused]] bool on)
+void wxTCPConnection::Compress(bool on)
 {
-    // TODO
+    wxCHECK_RET( m_streams, "can't be called before connecting" );
+
+    m_streams->SetCompress(on);
+}
+
+void wxTCPConnection::BeginBatch()
+{
+    wxCHECK_RET( m_streams, "can't be called before connecting" );
+
+    m_streams->BeginBatch();
+}
+
+void wxTCPConnection::EndBatch()
+{
+    wxCHECK_RET( m_streams, "can't be called before connecting" );
+
+    m_streams->EndBatch();
 }
 
 // Calls that CLIENT can make.
@@ -534,8 +1231,10 @@ bool wxTCPConnection::Disconnect()
     if ( !GetConnected() )
         return true;
 
-    // Send the disconnect message to the peer.
+    // Send the disconnect message to the peer, together with anything else
+    // still pending if we're inside a batch.
     IPCOutput(m_streams).Write8(IPC_DISCONNECT);
+    m_streams->Flush();
 
     if ( m_sock )
     {
@@ -572,6 +1271,17 @@ const void *wxTCPConnection::Request(const wxString& item,
     if ( !m_sock->IsConnected() )
         return nullptr;
 
+    // Using the request ID allows to handle the other messages, e.g. advise
+    // notifications, which may arrive before the reply, correctly.
+    if ( m_streams->HasFeature(IPC_FEATURE_REQUEST_ID) )
+    {
+        const std::uint32_t id = RequestAsync(item, format);
+        if ( !id )
+            return nullptr;
+
+        return GetReply(id, size);
+    }
+
     IPCOutput(m_streams).Write(IPC_REQUEST, item, format);
 
     const int ret = m_streams->Read8();
@@ -585,6 +1295,83 @@ const void *wxTCPConnection::Request(const wxString& item,
     return m_streams->ReadData(this, size ? size : &sizeFallback);
 }
 
+std::uint32_t wxTCPConnection::RequestAsync(const wxString& item,
+                                            wxIPCFormat format)
+{
+    if ( !m_sock->IsConnected() )
+        return 0;
+
+    if ( !m_streams->HasFeature(IPC_FEATURE_REQUEST_ID) )
+    {
+        // The server can only handle one request at a time, so just do it
+        // now and keep the result until it's asked for.
+        size_t size = 0;
+        const void * const data = Request(item, &size, format);
+
+        const std::uint32_t id = m_streams->NewRequestId();
+        m_streams->StoreReply(id, data, size);
+
+        return id;
+    }
+
+    // Don't let too many replies accumulate, read some of them first if
+    // necessary, see IPC_MAX_PENDING_REQUESTS.
+    while ( m_streams->GetPendingRequests() >= IPC_MAX_PENDING_REQUESTS )
+    {
+        if ( !ReadMessage() )
+            return 0;
+    }
+
+    const std::uint32_t id = m_streams->NewRequestId();
+
+    IPCOutput out(m_streams);
+    out.Write8(IPC_REQUEST_ID);
+    out.Write32(id);
+    out.WriteString(item);
+    out.Write8(format);
+
+    m_streams->OnRequestSent();
+
+    return id;
+}
+
+const void *wxTCPConnection::GetReply(std::uint32_t id, size_t *size)
+{
+    wxCHECK_MSG( id, nullptr, "invalid request ID" );
+
+    if ( !WaitForReply(id) )
+        return nullptr;
+
+    size_t sizeFallback;
+    return m_streams->TakeReply(this, id, size ? size : &sizeFallback);
+}
+
+bool wxTCPConnection::WaitForReply(std::uint32_t id)
+{
+    while ( !m_streams->HasReply(id) )
+    {
+        if ( !ReadMessage() )
+            return false;
+    }
+
+    return true;
+}
+
+bool wxTCPConnection::ReadMessage()
+{
+    if ( !m_sock->IsConnected() )
+        return false;
+
+    const int msg = m_streams->Read8();
+    if ( m_sock->Error() )
+        return false;
+
+    // Notice that we can't use this object any more if it was deleted as
+    // part of handling the disconnection.
+    return wxTCPEventHandler::HandleMessage(this, msg) ==
+                wxTCPEventHandler::HandleResult::Ok;
+}
+
 bool wxTCPConnection::DoPoke(const wxString& item,
                              const void *data,
                              size_t size,
@@ -684,7 +1471,58 @@ void wxTCPEventHandler::Client_OnRequest(wxSocketEvent &event)
         return;
     }
 
-    // Receive message number.
+    // Process all the messages already received and not just the first one,
+    // as the peer may send many of them at once. Notice that there may be no
+    // data at all if it had been already read while waiting for a reply.
+    wxIPCSocketStreams * const streams = connection->m_streams;
+    while ( sock->IsData() && !sock->Error() )
+    {
+        const int msg = streams->Read8();
+        if ( HandleMessage(connection, msg) != HandleResult::Ok )
+            break;
+    }
+}
+
+/* static */
+const void *
+wxTCPEventHandler::GetRequestData(wxTCPConnection *connection,
+                                  const wxString& item,
+                                  wxIPCFormat format,
+                                  size_t *size)
+{
+    size_t user_size = wxNO_LEN;
+    const void *user_data = connection->OnRequest(connection->m_topic,
+                                                  item,
+                                                  &user_size,
+                                                  format);
+    if ( !user_data )
+        return nullptr;
+
+    if ( user_size == wxNO_LEN )
+    {
+        switch ( format )
+        {
+            case wxIPC_TEXT:
+            case wxIPC_UTF8TEXT:
+                user_size = strlen((const char *)user_data) + 1;  // includes final NUL
+                break;
+            case wxIPC_UNICODETEXT:
+                user_size = (wcslen((const wchar_t *)user_data) + 1) * sizeof(wchar_t);  // includes final NUL
+                break;
+            default:
+                user_size = 0;
+        }
+    }
+
+    *size = user_size;
+
+    return user_data;
+}
+
+/* static */
+wxTCPEventHandler::HandleResult
+wxTCPEventHandler::HandleMessage(wxTCPConnection *connection, int msg)
+{
     wxIPCSocketStreams * const streams = connection->m_streams;
 
     const wxString topic = connection->m_topic;
@@ -692,7 +1530,6 @@ void wxTCPEventHandler::Client_OnRequest(wxSocketEvent &event)
 
     bool error = false;
 
-    const int msg = streams->Read8();
     switch ( msg )
     {
         case IPC_EXECUTE:
@@ -765,13 +1602,10 @@ void wxTCPEventHandler::Client_OnRequest(wxSocketEvent &event)
 
                 wxIPCFormat format = (wxIPCFormat)streams->Read8();
 
-                size_t user_size = wxNO_LEN;
-                const void *user_data = connection->OnRequest(topic,
-                                                              item,
-                                                              &user_size,
-                                                              format);
-
-                if ( !user_data )
+                size_t size = 0;
+                const void * const
+                    data = GetRequestData(connection, item, format, &size);
+                if ( !data )
                 {
                     IPCOutput(streams).Write8(IPC_FAIL);
                     break;
@@ -779,30 +1613,95 @@ void wxTCPEventHandler::Client_OnRequest(wxSocketEvent &event)
 
                 IPCOutput out(streams);
                 out.Write8(IPC_REQUEST_REPLY);
+                out.WriteData(data, size);
+            }
+            break;
+
+        case IPC_REQUEST_ID:
+            {
+                const std::uint32_t id = streams->Read32();
+
+                item = streams->ReadString();
+
+                wxIPCFormat format = (wxIPCFormat)streams->Read8();
+
+                size_t size = 0;
+                const void * const
+                    data = GetRequestData(connection, item, format, &size);
+
+                IPCOutput out(streams);
+                out.Write8(IPC_REPLY_ID);
+                out.Write32(id);
+                out.Write8(data ? IPC_REQUEST_REPLY : IPC_FAIL);
+                if ( data )
+                    out.WriteData(data, size);
+            }
+            break;
 
-                if ( user_size == wxNO_LEN )
+        case IPC_REPLY_ID:
+            {
+                const std::uint32_t id = streams->Read32();
+
+                const void *data = nullptr;
+                size_t size = 0;
+                if ( streams->Read8() == IPC_REQUEST_REPLY )
                 {
-                    switch ( format )
-                    {
-                        case wxIPC_TEXT:
-                        case wxIPC_UTF8TEXT:
-                            user_size = strlen((const char *)user_data) + 1;  // includes final NUL
-                            break;
-                        case wxIPC_UNICODETEXT:
-                            user_size = (wcslen((const wchar_t *)user_data) + 1) * sizeof(wchar_t);  // includes final NUL
-                            break;
-                        default:
-                            user_size = 0;
-                    }
+                    data = streams->ReadData(connection, &size);
+                    if ( !data )
+                        error = true;
                 }
 
-                out.WriteData(user_data, user_size);
+                // Remember it even if it failed, GetReply() will return NULL
+                // for it then.
+                streams->StoreReply(id, data, size);
+                streams->OnReplyReceived();
             }
             break;
 
+        case IPC_FEATURES:
+            if ( !streams->AreFeaturesEnabled() )
+            {
+                // Reply in the same way as the old versions did.
+                wxLogDebug("Unknown message code %d received.", msg);
+                error = true;
+                break;
+            }
+
+            {
+                IPCOutput out(streams);
+                out.Write8(IPC_FEATURES);
+                out.Write32(streams->GetSupportedFeatures());
+            }
+            break;
+
+        case IPC_FEATURES_SET:
+            streams->SetFeatures(streams->Read32() &
+                                    streams->GetSupportedFeatures());
+            break;
+
+#ifdef wxHAS_IPC_SHARED_MEMORY
+        case IPC_SHARED_OPEN:
+            {
+                const std::string
+                    name = streams->AcceptSharedMemory(
+                                streams->ReadString().ToStdString());
+
+                IPCOutput out(streams);
+                if ( name.empty() )
+                    out.Write8(IPC_FAIL);
+                else
+                    out.Write(IPC_SHARED_OPEN, name);
+            }
+            break;
+
+        case IPC_SHARED_ACK:
+            streams->ConfirmSharedMemory(streams->Read8() != 0);
+            break;
+#endif // wxHAS_IPC_SHARED_MEMORY
+
         case IPC_DISCONNECT:
             HandleDisconnect(connection);
-            break;
+            return HandleResult::Disconnected;
 
         case IPC_FAIL:
             wxLogDebug("Unexpected IPC_FAIL received");
@@ -815,8 +1714,17 @@ void wxTCPEventHandler::Client_OnRequest(wxSocketEvent &event)
             break;
     }
 
+    // The handlers can't use the data after returning, so the shared memory
+    // used by it can be reused by the peer now.
+    streams->ReleaseSharedData();
+
     if ( error )
+    {
         IPCOutput(streams).Write8(IPC_FAIL);
+        return HandleResult::Error;
+    }
+
+    return HandleResult::Ok;
 }
 
 void wxTCPEventHandler::Server_OnRequest(wxSocketEvent &event)
@@ -843,8 +1751,26 @@ void wxTCPEventHandler::Server_OnRequest(wxSocketEvent &event)
         return;
     }
 
+    // We read the messages field by field, so avoid doing a system call for
+    // each of them.
+    sock->SetFlags(sock->GetFlags() | wxSOCKET_READAHEAD);
+
     wxIPCSocketStreams *streams = new wxIPCSocketStreams(*sock);
 
+#ifdef __UNIX_LIKE__
+    // the server name is a file name only when using Unix domain sockets
+    if ( !ipcserv->m_filename.empty() )
+        streams->SetLocal();
+#endif // __UNIX_LIKE__
+
+    if ( !ipcserv->m_featuresEnabled )
+        streams->DisableFeatures();
+
+#ifdef wxHAS_IPC_SHARED_MEMORY
+    if ( ipcserv->m_sharedMemoryFails )
+        streams->SimulateSharedMemoryFailure();
+#endif // wxHAS_IPC_SHARED_MEMORY
+
     {
         IPCOutput out(streams);
 
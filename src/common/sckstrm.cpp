@@ -15,6 +15,9 @@
 
 import WX.Cmn.Stream;
 
+import <algorithm>;
+import <limits>;
+
 // ---------------------------------------------------------------------------
 // wxSocketOutputStream
 // ---------------------------------------------------------------------------
@@ -34,6 +37,54 @@ size_t wxSocketOutputStream::OnSysWrite(const void *buffer, size_t size)
     return ret;
 }
 
+wxOutputStream&
+wxSocketOutputStream::WriteV(std::span<const wxStreamConstIOVec> buffers)
+{
+    // Convert the buffers in small batches to avoid allocating memory.
+    wxSocketIOVec iov[16];
+
+    // The total size of a batch must fit in 32 bits, let the base class deal
+    // with the huge buffers for which this is not the case.
+    constexpr size_t
+        maxSize = std::numeric_limits<std::uint32_t>::max() / WXSIZEOF(iov);
+    for ( const auto& buf : buffers )
+    {
+        if ( buf.size > maxSize )
+            return wxOutputStream::WriteV(buffers);
+    }
+
+    m_lastcount = 0;
+
+    while ( !buffers.empty() )
+    {
+        const size_t count = std::min(buffers.size(), WXSIZEOF(iov));
+
+        std::uint32_t total = 0;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            iov[n].data = buffers[n].data;
+            iov[n].size = static_cast<std::uint32_t>(buffers[n].size);
+            total += iov[n].size;
+        }
+
+        const std::uint32_t
+            ret = m_o_socket->WriteV(std::span(iov, count)).LastWriteCount();
+        m_lasterror = m_o_socket->Error()
+                        ? m_o_socket->IsClosed() ? wxSTREAM_EOF
+                                                 : wxSTREAM_WRITE_ERROR
+                        : wxSTREAM_NO_ERROR;
+
+        m_lastcount += ret;
+
+        if ( ret != total )
+            break;
+
+        buffers = buffers.subspan(count);
+    }
+
+    return *this;
+}
+
 // ---------------------------------------------------------------------------
 // wxSocketInputStream
 // ---------------------------------------------------------------------------
@@ -43,10 +43,20 @@
 import WX.Utils.Cast;
 import WX.Cmn.Stopwatch;
 
+import <algorithm>;
 import <string>;
 
 #ifdef __UNIX__
     #include <cerrno>
+    #include <climits>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+#endif
+
+#ifdef __LINUX__
+    #include <csignal>
+    #include <pthread.h>
+    #include <sys/sendfile.h>
 #endif
 
 // we use MSG_NOSIGNAL to avoid getting SIGPIPE when sending data to a remote
@@ -114,6 +124,16 @@ wxDEFINE_EVENT(wxEVT_SOCKET, wxSocketEvent);
 // discard buffer
 constexpr int MAX_DISCARD_SIZE = (10 * 1024);
 
+// the amount of data read at once if wxSOCKET_READAHEAD is used
+constexpr std::uint32_t READAHEAD_SIZE = 16 * 1024;
+
+// the maximal number of buffers passed to a single sendmsg() call
+#ifdef IOV_MAX
+constexpr size_t MAX_IOVECS = std::min<size_t>(IOV_MAX, 64);
+#else
+constexpr size_t MAX_IOVECS = 16;
+#endif
+
 constexpr wxChar wxTRACE_Socket[] = "wxSocket";
 
 // --------------------------------------------------------------------------
@@ -218,6 +238,16 @@ public:
         wxSocketImpl * const impl = m_socket->m_impl.get();
         if ( impl && impl->m_fd != INVALID_SOCKET )
             impl->ReenableEvents(wxSOCKET_INPUT_FLAG);
+
+        // there are no notifications for the data already read ahead, so
+        // generate one ourselves, but only once until all of it is consumed
+        if ( (m_socket->m_flags & wxSOCKET_READAHEAD) &&
+                m_socket->HasPushback() &&
+                    !m_socket->m_readAheadNotified )
+        {
+            m_socket->m_readAheadNotified = true;
+            m_socket->OnRequest(wxSOCKET_INPUT);
+        }
     }
 
     wxSocketReadGuard(const wxSocketReadGuard&) = delete;
@@ -669,6 +699,76 @@ int wxSocketImpl::SendStream(const void *buffer, int size)
     return ret;
 }
 
+int wxSocketImpl::SendStreamV(std::span<const wxSocketIOVec> buffers,
+                              std::uint32_t offset)
+{
+    // Don't overflow the return value.
+    constexpr std::uint32_t MAX_TOTAL = INT_MAX;
+
+#if defined(WX_WINDOWS) && wxUSE_WINSOCK2
+    WSABUF bufs[MAX_IOVECS];
+#elif !defined(WX_WINDOWS)
+    iovec bufs[MAX_IOVECS];
+#endif
+
+    size_t count = 0;
+    std::uint32_t total = 0;
+    for ( const auto& buf : buffers )
+    {
+        if ( count == MAX_IOVECS || total == MAX_TOTAL )
+            break;
+
+        const char *data = static_cast<const char *>(buf.data) + offset;
+        std::uint32_t size = std::min(buf.size - offset, MAX_TOTAL - total);
+        offset = 0;
+
+        if ( !size )
+            continue;
+
+#if defined(WX_WINDOWS) && wxUSE_WINSOCK2
+        bufs[count].buf = const_cast<char *>(data);
+        bufs[count].len = size;
+#elif !defined(WX_WINDOWS)
+        bufs[count].iov_base = const_cast<char *>(data);
+        bufs[count].iov_len = size;
+#else
+        // Without WSASend() we can only send a single buffer at once, the
+        // caller will call us again for the rest of the data if needed.
+        return SendStream(data, size);
+#endif
+
+        total += size;
+        count++;
+    }
+
+    if ( !count )
+        return 0;
+
+#if defined(WX_WINDOWS) && wxUSE_WINSOCK2
+    DWORD sent = 0;
+    if ( WSASend(m_fd, bufs, count, &sent, 0, nullptr, nullptr) == SOCKET_ERROR )
+        return SOCKET_ERROR;
+
+    return sent;
+#elif !defined(WX_WINDOWS)
+#ifdef wxNEEDS_IGNORE_SIGPIPE
+    IgnoreSignal ignore(SIGPIPE);
+#endif
+
+    msghdr msg{};
+    msg.msg_iov = bufs;
+    msg.msg_iovlen = count;
+
+    int ret;
+    DO_WHILE_EINTR( ret, sendmsg(m_fd, &msg, wxSOCKET_MSG_NOSIGNAL) );
+
+    return ret;
+#else
+    // We must have returned from the loop above.
+    return 0;
+#endif
+}
+
 int wxSocketImpl::RecvDgram(void *buffer, int size)
 {
     wxSockAddressStorage from;
@@ -736,6 +836,59 @@ int wxSocketImpl::Write(const void *buffer, int size)
     return ret;
 }
 
+int wxSocketImpl::WriteV(std::span<const wxSocketIOVec> buffers,
+                         std::uint32_t offset)
+{
+    if ( m_fd == INVALID_SOCKET || m_server || !m_stream )
+    {
+        m_error = wxSocketError::InvSock;
+        return -1;
+    }
+
+    int ret = SendStreamV(buffers, offset);
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSocketError::None;
+
+    return ret;
+}
+
+#ifdef __LINUX__
+
+int wxSocketImpl::SendFile(int fd, off_t *offset, std::uint32_t size)
+{
+    if ( m_fd == INVALID_SOCKET || m_server || !m_stream )
+    {
+        m_error = wxSocketError::InvSock;
+        return -1;
+    }
+
+    // Unlike send(), sendfile() has no flag to avoid raising SIGPIPE if the
+    // peer has closed the connection, so block it while calling it and
+    // discard it if it was generated.
+    sigset_t sigpipe, sigmaskOld;
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipe, &sigmaskOld);
+
+    ssize_t ret;
+    DO_WHILE_EINTR( ret, sendfile(m_fd, fd, offset,
+                                  std::min<std::uint32_t>(size, INT_MAX)) );
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSocketError::None;
+
+    if ( ret == -1 && errno == EPIPE && !sigismember(&sigmaskOld, SIGPIPE) )
+    {
+        const timespec noWait{};
+        sigtimedwait(&sigpipe, nullptr, &noWait);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &sigmaskOld, nullptr);
+
+    return static_cast<int>(ret);
+}
+
+#endif // __LINUX__
+
 // ==========================================================================
 // wxSocketBase
 // ==========================================================================
@@ -813,9 +966,9 @@ void wxSocketBase::Init()
     m_beingDeleted = false;
 
     // pushback buffer
-    m_unread       = nullptr;
     m_unrd_size    = 0;
     m_unrd_cur     = 0;
+    m_readAheadNotified = false;
 
     // events
     m_id           = wxID_ANY;
@@ -856,9 +1009,6 @@ wxSocketBase::~wxSocketBase()
     // Shutdown and close the socket
     if (!m_beingDeleted)
         Close();
-
-    // Free the pushback buffer
-    free(m_unread);
 }
 
 bool wxSocketBase::Destroy()
@@ -973,7 +1123,7 @@ std::uint32_t wxSocketBase::DoRead(void* buffer_, std::uint32_t nbytes)
         // where we're not going to get notifications about socket being ready
         // for reading before we read all the existing data from it
         const int ret = !m_impl->m_stream || m_connected
-                            ? m_impl->Read(buffer, nbytes)
+                            ? ReadFromImpl(buffer, nbytes)
                             : 0;
         if ( ret == -1 )
         {
@@ -1035,6 +1185,30 @@ std::uint32_t wxSocketBase::DoRead(void* buffer_, std::uint32_t nbytes)
     return total;
 }
 
+int wxSocketBase::ReadFromImpl(char *buffer, std::uint32_t nbytes)
+{
+    if ( !(m_flags & wxSOCKET_READAHEAD) ||
+            !m_impl->m_stream ||
+                nbytes >= READAHEAD_SIZE )
+        return m_impl->Read(buffer, nbytes);
+
+    // We're only called when the pushback buffer is empty, so we can reuse it
+    // for reading as much data as is available, instead of just what we need.
+    wxASSERT( !HasPushback() );
+
+    if ( m_unread.size() < READAHEAD_SIZE )
+        m_unread.resize(READAHEAD_SIZE);
+
+    const int ret = m_impl->Read(m_unread.data(), READAHEAD_SIZE);
+    if ( ret <= 0 )
+        return ret;
+
+    m_unrd_cur = 0;
+    m_unrd_size = ret;
+
+    return GetPushback(buffer, nbytes, false);
+}
+
 wxSocketBase& wxSocketBase::ReadMsg(void* buffer, std::uint32_t nbytes)
 {
     struct
@@ -1190,6 +1364,207 @@ std::uint32_t wxSocketBase::DoWrite(const void *buffer_, std::uint32_t nbytes)
     return total;
 }
 
+wxSocketBase& wxSocketBase::WriteV(std::span<const wxSocketIOVec> buffers)
+{
+    wxSocketWriteGuard write(this);
+
+    m_lcount_write = DoWriteV(buffers);
+    m_lcount = m_lcount_write;
+
+    return *this;
+}
+
+// This is the same as DoWrite() but for several buffers.
+std::uint32_t wxSocketBase::DoWriteV(std::span<const wxSocketIOVec> buffers)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+
+    // Datagram sockets can't combine several buffers in a single message.
+    if ( !m_impl->m_stream )
+    {
+        std::uint32_t total = 0;
+        for ( const auto& buf : buffers )
+        {
+            const std::uint32_t written = DoWrite(buf.data, buf.size);
+            total += written;
+            if ( written != buf.size )
+                break;
+        }
+
+        return total;
+    }
+
+    // offset of the first byte not written yet in the first buffer
+    std::uint32_t offset = 0;
+
+    std::uint32_t total = 0;
+    while ( !buffers.empty() )
+    {
+        if ( !m_connected )
+        {
+            if ( (m_flags & wxSOCKET_WAITALL_WRITE) || !total )
+                SetError(wxSocketError::IOErr);
+            break;
+        }
+
+        const int ret = m_impl->WriteV(buffers, offset);
+        if ( ret == -1 )
+        {
+            if ( m_impl->GetLastError() == wxSocketError::WouldBlock )
+            {
+                if ( m_flags & wxSOCKET_NOWAIT_WRITE )
+                    break;
+
+                if ( !DoWaitWithTimeout(wxSOCKET_OUTPUT_FLAG) )
+                {
+                    SetError(wxSocketError::Timeout);
+                    break;
+                }
+
+                continue;
+            }
+            else // "real" error
+            {
+                SetError(wxSocketError::IOErr);
+                break;
+            }
+        }
+
+        total += ret;
+
+        if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
+            break;
+
+        // Skip all the buffers which were completely written.
+        std::uint32_t written = ret;
+        while ( !buffers.empty() && written >= buffers.front().size - offset )
+        {
+            written -= buffers.front().size - offset;
+            offset = 0;
+            buffers = buffers.subspan(1);
+        }
+
+        offset += written;
+    }
+
+    return total;
+}
+
+wxSocketBase& wxSocketBase::SendFile(wxFile& file, std::uint32_t nbytes)
+{
+    wxSocketWriteGuard write(this);
+
+    m_lcount_write = DoSendFile(file, nbytes);
+    m_lcount = m_lcount_write;
+
+    return *this;
+}
+
+std::uint32_t wxSocketBase::DoSendFile(wxFile& file, std::uint32_t nbytes)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxCHECK_MSG( file.IsOpened(), 0, "file must be opened" );
+
+    std::uint32_t total = 0;
+
+#ifdef __LINUX__
+    if ( m_impl->m_stream )
+    {
+        const wxFileOffset start = file.Tell();
+        off_t offset = start;
+
+        bool supported = true;
+        while ( nbytes )
+        {
+            if ( !m_connected )
+            {
+                if ( (m_flags & wxSOCKET_WAITALL_WRITE) || !total )
+                    SetError(wxSocketError::IOErr);
+                break;
+            }
+
+            const int ret = m_impl->SendFile(file.fd(), &offset, nbytes);
+            if ( ret == -1 )
+            {
+                // The file may not support mmap-like operations, e.g. if it's
+                // a pipe, fall back to the generic code below then.
+                if ( !total && (errno == EINVAL || errno == ENOSYS) )
+                {
+                    supported = false;
+                    break;
+                }
+
+                if ( m_impl->GetLastError() == wxSocketError::WouldBlock )
+                {
+                    if ( m_flags & wxSOCKET_NOWAIT_WRITE )
+                        break;
+
+                    if ( !DoWaitWithTimeout(wxSOCKET_OUTPUT_FLAG) )
+                    {
+                        SetError(wxSocketError::Timeout);
+                        break;
+                    }
+
+                    continue;
+                }
+
+                SetError(wxSocketError::IOErr);
+                break;
+            }
+
+            // We reached the end of the file.
+            if ( !ret )
+                break;
+
+            total += ret;
+
+            if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
+                break;
+
+            nbytes -= ret;
+        }
+
+        if ( supported )
+        {
+            // sendfile() doesn't change the file offset, do it ourselves.
+            file.Seek(start + total);
+
+            return total;
+        }
+
+        SetError(wxSocketError::None);
+    }
+#endif // __LINUX__
+
+    // Generic version: just read the data in chunks and write it.
+    std::vector<char> buf(std::min<std::uint32_t>(nbytes, 64*1024));
+    while ( nbytes )
+    {
+        const ssize_t count = file.Read(buf.data(),
+                                        std::min<size_t>(nbytes, buf.size()));
+        if ( count <= 0 )
+            break;
+
+        const std::uint32_t written = DoWrite(buf.data(), count);
+        total += written;
+
+        if ( written != static_cast<std::uint32_t>(count) )
+        {
+            // Don't lose the data which couldn't be written.
+            file.Seek(static_cast<wxFileOffset>(written) - count,
+                      wxSeekMode::FromCurrent);
+            break;
+        }
+
+        if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
+            break;
+
+        nbytes -= written;
+    }
+
+    return total;
+}
+
 wxSocketBase& wxSocketBase::WriteMsg(const void *buffer, std::uint32_t nbytes)
 {
     struct
@@ -1212,26 +1587,40 @@ wxSocketBase& wxSocketBase::WriteMsg(const void *buffer, std::uint32_t nbytes)
     msg.len[2] = (unsigned char) ((nbytes >> 16) & 0xff);
     msg.len[3] = (unsigned char) ((nbytes >> 24) & 0xff);
 
+    decltype(msg) trailer;
+    trailer.sig[0] = (unsigned char) 0xed;
+    trailer.sig[1] = (unsigned char) 0xfe;
+    trailer.sig[2] = (unsigned char) 0xad;
+    trailer.sig[3] = (unsigned char) 0xde;
+    trailer.len[0] =
+    trailer.len[1] =
+    trailer.len[2] =
+    trailer.len[3] = (char) 0;
+
+    // Send the header, the data and the trailer all at once.
+    const wxSocketIOVec buffers[] =
+    {
+        { &msg, sizeof(msg) },
+        { buffer, nbytes },
+        { &trailer, sizeof(trailer) },
+    };
+
+    const std::uint32_t total = DoWriteV(buffers);
+
     bool ok = false;
-    if ( DoWrite(&msg, sizeof(msg)) == sizeof(msg) )
+    if ( total == sizeof(msg) + nbytes + sizeof(trailer) )
     {
-        m_lcount_write = DoWrite(buffer, nbytes);
-        m_lcount = m_lcount_write;
-        if ( m_lcount_write == nbytes )
-        {
-            msg.sig[0] = (unsigned char) 0xed;
-            msg.sig[1] = (unsigned char) 0xfe;
-            msg.sig[2] = (unsigned char) 0xad;
-            msg.sig[3] = (unsigned char) 0xde;
-            msg.len[0] =
-            msg.len[1] =
-            msg.len[2] =
-            msg.len[3] = (char) 0;
-
-            if ( DoWrite(&msg, sizeof(msg)) == sizeof(msg))
-                ok = true;
-        }
+        m_lcount_write = nbytes;
+        ok = true;
     }
+    else
+    {
+        m_lcount_write = total > sizeof(msg)
+                            ? std::min<std::uint32_t>(total - sizeof(msg), nbytes)
+                            : 0;
+    }
+
+    m_lcount = m_lcount_write;
 
     if ( !ok )
         SetError(wxSocketError::IOErr);
@@ -1533,7 +1922,7 @@ bool wxSocketBase::Wait(long seconds, long milliseconds)
 bool wxSocketBase::WaitForRead(long seconds, long milliseconds)
 {
     // Check pushback buffer before entering DoWait
-    if ( m_unread )
+    if ( HasPushback() )
         return true;
 
     // Check if the socket is not already ready for input, if it is, there is
@@ -1756,43 +2145,50 @@ void wxSocketBase::Pushback(const void *buffer, std::uint32_t size)
 {
     if (!size) return;
 
-    if (m_unread == nullptr)
-        m_unread = malloc(size);
+    const char * const data = static_cast<const char *>(buffer);
+
+    // Reuse the space before the unread data if possible, this is always the
+    // case for Peek() when using read-ahead, as it has just taken the data
+    // from this buffer.
+    if ( size <= m_unrd_cur )
+    {
+        m_unrd_cur -= size;
+        memcpy(&m_unread[m_unrd_cur], data, size);
+    }
     else
     {
-        void* tmp = malloc(m_unrd_size + size);
-        memcpy((char *)tmp + size, m_unread, m_unrd_size);
-        free(m_unread);
-
-        m_unread = tmp;
+        m_unread.resize(m_unrd_size);
+        m_unread.insert(m_unread.begin() + m_unrd_cur, data, data + size);
+        m_unrd_size += size;
     }
-
-    m_unrd_size += size;
-
-    memcpy(m_unread, buffer, size);
 }
 
 std::uint32_t wxSocketBase::GetPushback(void *buffer, std::uint32_t size, bool peek)
 {
     wxCHECK_MSG( buffer, 0, "NULL buffer" );
 
-    if (!m_unrd_size)
+    if ( !HasPushback() )
         return 0;
 
-    if (size > (m_unrd_size-m_unrd_cur))
-        size = m_unrd_size-m_unrd_cur;
+    const std::uint32_t available = m_unrd_size - m_unrd_cur;
+    if (size > available)
+        size = available;
 
-    memcpy(buffer, (char *)m_unread + m_unrd_cur, size);
+    memcpy(buffer, &m_unread[m_unrd_cur], size);
 
     if (!peek)
     {
         m_unrd_cur += size;
-        if (m_unrd_size == m_unrd_cur)
+        if ( m_unrd_cur == m_unrd_size )
         {
-            free(m_unread);
-            m_unread = nullptr;
+            // Keep the memory for reading ahead, but not if a lot of data was
+            // pushed back.
+            if ( m_unread.capacity() > READAHEAD_SIZE )
+                m_unread = {};
+
             m_unrd_size = 0;
             m_unrd_cur  = 0;
+            m_readAheadNotified = false;
         }
     }
 
@@ -33,8 +33,19 @@
 #include "wx/osx/core/private/strconv_cf.h"
 #endif //def __DARWIN__
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+
+    #define wxHAS_SSE2_ASCII
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+
+    #define wxHAS_NEON_ASCII
+#endif
+
 import WX.Cmn.EncConv;
 
+import <algorithm>;
 import <unordered_map>;
 
 #if defined(WX_WINDOWS)
@@ -389,6 +400,42 @@ size_t wxMBConv::WC2MB(char *outBuff, const wchar_t *inBuff, size_t outLen) cons
 wxWCharBuffer
 wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 {
+    // UTF-8 never produces more wide characters than there are bytes in the
+    // input, so we can convert it in a single pass into a buffer of this size
+    // instead of first computing the exact size needed
+    if ( IsUTF8() )
+    {
+        const size_t maxLen = inLen == wxNO_LEN ? strlen(inBuff) + 1 : inLen;
+
+        wxWCharBuffer wbuf(maxLen);
+        const size_t dstLen = ToWChar(wbuf.data(), maxLen, inBuff, inLen);
+        if ( dstLen != wxCONV_FAILED )
+        {
+            // don't waste too much memory if the input was mostly non-ASCII,
+            // notice that extend() also works for reducing the buffer size
+            if ( dstLen < maxLen / 2 )
+                wbuf.extend(dstLen);
+            else
+                wbuf.shrink(dstLen);
+
+            if ( outLen )
+            {
+                *outLen = dstLen;
+
+                // see the comment below
+                if ( inLen == wxNO_LEN )
+                    (*outLen)--;
+            }
+
+            return wbuf;
+        }
+
+        if ( outLen )
+            *outLen = 0;
+
+        return {};
+    }
+
     const size_t dstLen = ToWChar(nullptr, 0, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
@@ -909,6 +956,144 @@ constexpr std::uint32_t utf8_max[]=
 constexpr std::uint32_t wxUnicodePUA = 0x100000;
 constexpr std::uint32_t wxUnicodePUAEnd = wxUnicodePUA + 256;
 
+namespace
+{
+
+// Copy the leading ASCII characters of src, of at most len bytes, to dst, if
+// it's not null, and return their number. Most of the text is ASCII, so doing
+// it in bulk, 16 bytes at once if possible, is much faster than decoding it.
+size_t CopyASCII(wchar_t *dst, const char *src, size_t len)
+{
+    size_t n = 0;
+
+#if defined(wxHAS_SSE2_ASCII)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; len - n >= 16; n += 16 )
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n));
+        if ( _mm_movemask_epi8(v) )
+            break;
+
+        if ( !dst )
+            continue;
+
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        const auto out = reinterpret_cast<__m128i*>(dst + n);
+        if constexpr ( sizeof(wchar_t) == 2 )
+        {
+            _mm_storeu_si128(out, lo);
+            _mm_storeu_si128(out + 1, hi);
+        }
+        else
+        {
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+#elif defined(wxHAS_NEON_ASCII)
+    for ( ; len - n >= 16; n += 16 )
+    {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + n));
+        if ( vmaxvq_u8(v) >= 0x80 )
+            break;
+
+        if ( !dst )
+            continue;
+
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        if constexpr ( sizeof(wchar_t) == 2 )
+        {
+            const auto out = reinterpret_cast<std::uint16_t*>(dst + n);
+            vst1q_u16(out, lo);
+            vst1q_u16(out + 8, hi);
+        }
+        else
+        {
+            const auto out = reinterpret_cast<std::uint32_t*>(dst + n);
+            vst1q_u32(out, vmovl_u16(vget_low_u16(lo)));
+            vst1q_u32(out + 4, vmovl_u16(vget_high_u16(lo)));
+            vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+            vst1q_u32(out + 12, vmovl_u16(vget_high_u16(hi)));
+        }
+    }
+#endif // SIMD
+
+    for ( ; n < len; n++ )
+    {
+        const unsigned char c = src[n];
+        if ( c >= 0x80 )
+            break;
+
+        if ( dst )
+            dst[n] = c;
+    }
+
+    return n;
+}
+
+// The reverse of CopyASCII(): copy the leading characters of src which are in
+// ASCII range to dst, if it's not null, and return their number.
+size_t CopyASCII(char *dst, const wchar_t *src, size_t len)
+{
+    size_t n = 0;
+
+#if defined(wxHAS_SSE2_ASCII)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; len - n >= 16; n += 16 )
+    {
+        const auto in = reinterpret_cast<const __m128i*>(src + n);
+
+        // combine the wide characters into 16 bytes, checking that all of
+        // them are in ASCII range, i.e. have no bits set above the 7th one
+        __m128i bytes, high;
+        if constexpr ( sizeof(wchar_t) == 2 )
+        {
+            const __m128i v0 = _mm_loadu_si128(in);
+            const __m128i v1 = _mm_loadu_si128(in + 1);
+            high = _mm_and_si128(_mm_or_si128(v0, v1),
+                                 _mm_set1_epi16(static_cast<short>(0xff80)));
+            bytes = _mm_packus_epi16(v0, v1);
+        }
+        else
+        {
+            const __m128i v0 = _mm_loadu_si128(in);
+            const __m128i v1 = _mm_loadu_si128(in + 1);
+            const __m128i v2 = _mm_loadu_si128(in + 2);
+            const __m128i v3 = _mm_loadu_si128(in + 3);
+            high = _mm_and_si128(_mm_or_si128(_mm_or_si128(v0, v1),
+                                              _mm_or_si128(v2, v3)),
+                                 _mm_set1_epi32(static_cast<int>(0xffffff80)));
+            bytes = _mm_packus_epi16(_mm_packs_epi32(v0, v1),
+                                     _mm_packs_epi32(v2, v3));
+        }
+
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)) != 0xffff )
+            break;
+
+        if ( dst )
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n), bytes);
+    }
+#endif // wxHAS_SSE2_ASCII
+
+    for ( ; n < len; n++ )
+    {
+        const auto c = static_cast<std::uint32_t>(src[n]);
+        if ( c >= 0x80 )
+            break;
+
+        if ( dst )
+            dst[n] = static_cast<char>(c);
+    }
+
+    return n;
+}
+
+} // anonymous namespace
+
 size_t
 wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
                             const char *src, size_t srcLen) const
@@ -919,7 +1104,7 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
     if ( srcLen == wxNO_LEN )
         srcLen = strlen(src) + 1;
 
-    for ( const char *p = src; ; p++ )
+    for ( const char *p = src; ; )
     {
         if ( (srcLen == wxNO_LEN ? !*p : !srcLen) )
         {
@@ -941,6 +1126,22 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
             return written;
         }
 
+        const size_t ascii = CopyASCII(out, p, out ? std::min(srcLen, dstLen)
+                                                   : srcLen);
+        if ( ascii )
+        {
+            p += ascii;
+            srcLen -= ascii;
+            written += ascii;
+            if ( out )
+            {
+                out += ascii;
+                dstLen -= ascii;
+            }
+
+            continue;
+        }
+
         if ( out && !dstLen-- )
             break;
 
@@ -1019,6 +1220,7 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
             out++;
 
         written++;
+        p++;
     }
 
     return wxCONV_FAILED;
@@ -1031,10 +1233,11 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     char *out = dstLen ? dst : nullptr;
     size_t written = 0;
 
-    const wchar_t* const end = srcLen == wxNO_LEN ? nullptr : src + srcLen;
+    const wchar_t* const end = src + (srcLen == wxNO_LEN ? wxWcslen(src)
+                                                         : srcLen);
     for ( const wchar_t *wp = src; ; )
     {
-        if ( end ? wp == end : !*wp )
+        if ( wp == end )
         {
             // all done successfully, just add the trailing NULL if we are not
             // using explicit length
@@ -1054,6 +1257,22 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
             return written;
         }
 
+        const size_t remaining = end - wp;
+        const size_t ascii = CopyASCII(out, wp, out ? std::min(remaining, dstLen)
+                                                    : remaining);
+        if ( ascii )
+        {
+            wp += ascii;
+            written += ascii;
+            if ( out )
+            {
+                out += ascii;
+                dstLen -= ascii;
+            }
+
+            continue;
+        }
+
         std::uint32_t code;
 #ifdef WC_UTF16
         code = wxDecodeSurrogate(&wp, end);
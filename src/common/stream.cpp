@@ -15,6 +15,14 @@ module;
 #include "wx/log.h"
 #include "wx/scopeguard.h"
 
+#ifdef __LINUX__
+    #include <poll.h>
+    #include <sys/sendfile.h>
+    #include <unistd.h>
+
+    #include <cerrno>
+#endif
+
 module WX.Cmn.Stream;
 
 import WX.Cmn.DataStream;
@@ -22,6 +30,8 @@ import WX.Cmn.TextFile;
 import WX.Utils.Cast;
 import WX.File.Flags;
 
+import <algorithm>;
+import <memory>;
 import <string>;
 
 #if wxUSE_STREAMS
@@ -30,9 +40,12 @@ import <string>;
 // constants
 // ----------------------------------------------------------------------------
 
-// the temporary buffer size used when copying from stream to stream
+// the temporary buffer size used when seeking forward in a stream
 constexpr int BUF_TEMP_SIZE = 4096;
 
+// the buffer size used when copying from stream to stream
+constexpr size_t BUF_COPY_SIZE = 65536;
+
 // ============================================================================
 // implementation
 // ============================================================================
@@ -376,8 +389,8 @@ size_t wxStreamBuffer::Read(void *buffer, size_t size)
 {
     wxCHECK_MSG( buffer, 0, "NULL data pointer" );
 
-    /* Clear buffer first */
-    memset(buffer, 0x00, size);
+    void * const bufferStart = buffer;
+    const size_t sizeRequested = size;
 
     // lasterror is reset before all new IO calls
     if ( m_stream )
@@ -398,6 +411,22 @@ size_t wxStreamBuffer::Read(void *buffer, size_t size)
 
         while ( size > 0 )
         {
+            // if the buffer is empty and the remaining data wouldn't fit into
+            // it anyhow, read it directly into the caller buffer
+            if ( m_flushable && !GetBytesLeft() && size >= GetBufferSize() )
+            {
+                const size_t count = ReadDirectly(buffer, size);
+                if ( !count )
+                {
+                    SetError(wxSTREAM_EOF);
+                    break;
+                }
+
+                size -= count;
+                buffer = (char *)buffer + count;
+                continue;
+            }
+
             size_t left = GetDataLeft();
 
             // if the requested number of bytes if greater than the buffer
@@ -408,6 +437,10 @@ size_t wxStreamBuffer::Read(void *buffer, size_t size)
                 size -= left;
                 buffer = (char *)buffer + left;
 
+                // the rest will be read directly
+                if ( m_flushable && size >= GetBufferSize() )
+                    continue;
+
                 if ( !FillBuffer() )
                 {
                     SetError(wxSTREAM_EOF);
@@ -424,12 +457,36 @@ size_t wxStreamBuffer::Read(void *buffer, size_t size)
         readBytes = orig_size - size;
     }
 
+    // don't leave garbage in the part of the buffer which wasn't read
+    memset(static_cast<char*>(bufferStart) + readBytes, 0,
+           sizeRequested - readBytes);
+
     if ( m_stream )
         m_stream->m_lastcount = readBytes;
 
     return readBytes;
 }
 
+size_t wxStreamBuffer::ReadDirectly(void *buffer, size_t size)
+{
+    wxInputStream *inStream = GetInputStream();
+
+    wxCHECK_MSG( inStream, 0, "should have a stream in wxStreamBuffer" );
+
+    const size_t count = inStream->OnSysRead(buffer, size);
+    if ( !count )
+        return 0;
+
+    // keep the tail of the data in our buffer, as if we had read it in the
+    // usual way, so that seeking back into it still works
+    const size_t kept = std::min(count, GetBufferSize());
+    memcpy(m_buffer_start, static_cast<char*>(buffer) + count - kept, kept);
+    m_buffer_end = m_buffer_start + kept;
+    m_buffer_pos = m_buffer_end;
+
+    return count;
+}
+
 // this should really be called "Copy()"
 size_t wxStreamBuffer::Read(wxStreamBuffer *dbuf)
 {
@@ -480,6 +537,22 @@ size_t wxStreamBuffer::Write(const void *buffer, size_t size)
 
         while ( size > 0 )
         {
+            // if the buffer is empty and the data wouldn't fit into it anyhow,
+            // write it directly instead of copying it into the buffer first
+            if ( m_fixed && m_flushable &&
+                    m_buffer_pos == m_buffer_start && size >= GetBufferSize() )
+            {
+                wxOutputStream *outStream = GetOutputStream();
+
+                wxCHECK_MSG( outStream, 0, "should have a stream in wxStreamBuffer" );
+
+                size -= outStream->OnSysWrite(buffer, size);
+                if ( size )
+                    SetError(wxSTREAM_WRITE_ERROR);
+
+                break;
+            }
+
             std::size_t left = GetBytesLeft();
 
             // if the buffer is too large to fit in the stream buffer, split
@@ -853,18 +926,180 @@ char wxInputStream::Peek()
     return 0;
 }
 
+wxInputStream& wxInputStream::ReadV(std::span<const wxStreamIOVec> buffers)
+{
+    size_t total = 0;
+    for ( const auto& iov : buffers )
+    {
+        if ( !iov.size )
+            continue;
+
+        const size_t count = Read(iov.data, iov.size).LastRead();
+        total += count;
+
+        if ( count != iov.size )
+            break;
+    }
+
+    m_lastcount = total;
+
+    return *this;
+}
+
+#ifdef __LINUX__
+
+namespace
+{
+
+// wait until the descriptor becomes ready for the given events, this is only
+// needed for the non-blocking descriptors
+bool WaitForDescriptor(int fd, short events)
+{
+    pollfd pfd{fd, events, 0};
+    for ( ;; )
+    {
+        const int rc = ::poll(&pfd, 1, -1);
+        if ( rc > 0 )
+            return true;
+
+        if ( rc < 0 && errno != EINTR )
+            return false;
+    }
+}
+
+enum class CopyResult
+{
+    NotSupported,   // nothing was copied, use the generic code
+    Done,           // all data copied
+    ReadError,      // error reading the input after copying some data
+    WriteError      // error writing the output after copying some data
+};
+
+// return the stream whose descriptor is the likely cause of the given error
+CopyResult GetCopyError(int err)
+{
+    switch ( err )
+    {
+        case EFBIG:
+        case ENOSPC:
+        case EDQUOT:
+        case EPIPE:
+        case EROFS:
+        case ETXTBSY:
+            return CopyResult::WriteError;
+    }
+
+    return CopyResult::ReadError;
+}
+
+// copy all the remaining data between two descriptors without passing it
+// through user space, using copy_file_range() or, if it isn't supported for
+// these descriptors, sendfile()
+CopyResult CopyDescriptorData(int fdIn, int fdOut, size_t& copied)
+{
+    // the maximal amount of data to transfer in one call, this is limited
+    // anyhow to slightly less than 2GiB by Linux
+    constexpr size_t CHUNK_SIZE = 0x40000000;
+
+    bool useCopyFileRange = true;
+    for ( ;; )
+    {
+        const ssize_t rc = useCopyFileRange
+            ? ::copy_file_range(fdIn, nullptr, fdOut, nullptr, CHUNK_SIZE, 0)
+            : ::sendfile(fdOut, fdIn, nullptr, CHUNK_SIZE);
+
+        if ( rc > 0 )
+        {
+            copied += rc;
+            continue;
+        }
+
+        if ( rc == 0 )
+            return CopyResult::Done;
+
+        switch ( errno )
+        {
+            case EINTR:
+                continue;
+
+            case EAGAIN:
+                if ( !WaitForDescriptor(fdIn, POLLIN) )
+                    return CopyResult::ReadError;
+                if ( !WaitForDescriptor(fdOut, POLLOUT) )
+                    return CopyResult::WriteError;
+                continue;
+
+            case EXDEV:
+            case EINVAL:
+            case ENOSYS:
+            case EBADF:
+            case EOPNOTSUPP:
+                // these errors are only returned if the call is not supported
+                // for these descriptors, which is detected before copying
+                // anything, so just try the next way of doing it
+                if ( useCopyFileRange )
+                {
+                    useCopyFileRange = false;
+                    continue;
+                }
+
+                if ( !copied )
+                    return CopyResult::NotSupported;
+                break;
+        }
+
+        return GetCopyError(errno);
+    }
+}
+
+} // anonymous namespace
+
+#endif // __LINUX__
+
 wxInputStream& wxInputStream::Read(wxOutputStream& stream_out)
 {
     size_t lastcount = 0;
-    char buf[BUF_TEMP_SIZE];
+
+#ifdef __LINUX__
+    // if both streams are just wrappers for the OS descriptors, let the
+    // kernel copy the data directly between them, but only if there is no
+    // data put back into this stream which must be copied first
+    const int fdIn = GetNativeDescriptor();
+    const int fdOut = stream_out.GetNativeDescriptor();
+    if ( fdIn != -1 && fdOut != -1 && m_wbackcur == m_wbacksize )
+    {
+        switch ( CopyDescriptorData(fdIn, fdOut, lastcount) )
+        {
+            case CopyResult::NotSupported:
+                break;
+
+            case CopyResult::Done:
+                m_lasterror = wxSTREAM_EOF;
+                m_lastcount = lastcount;
+                return *this;
+
+            case CopyResult::ReadError:
+                m_lasterror = wxSTREAM_READ_ERROR;
+                m_lastcount = lastcount;
+                return *this;
+
+            case CopyResult::WriteError:
+                stream_out.Reset(wxSTREAM_WRITE_ERROR);
+                m_lastcount = lastcount;
+                return *this;
+        }
+    }
+#endif // __LINUX__
+
+    const auto buf = std::make_unique_for_overwrite<char[]>(BUF_COPY_SIZE);
 
     for ( ;; )
     {
-        size_t bytes_read = Read(buf, WXSIZEOF(buf)).LastRead();
+        size_t bytes_read = Read(buf.get(), BUF_COPY_SIZE).LastRead();
         if ( !bytes_read )
             break;
 
-        if ( stream_out.Write(buf, bytes_read).LastWrite() != bytes_read )
+        if ( stream_out.Write(buf.get(), bytes_read).LastWrite() != bytes_read )
             break;
 
         lastcount += bytes_read;
@@ -1017,6 +1252,26 @@ wxOutputStream& wxOutputStream::Write(const void *buffer, size_t size)
     return *this;
 }
 
+wxOutputStream& wxOutputStream::WriteV(std::span<const wxStreamConstIOVec> buffers)
+{
+    size_t total = 0;
+    for ( const auto& iov : buffers )
+    {
+        if ( !iov.size )
+            continue;
+
+        const size_t count = Write(iov.data, iov.size).LastWrite();
+        total += count;
+
+        if ( count != iov.size )
+            break;
+    }
+
+    m_lastcount = total;
+
+    return *this;
+}
+
 wxOutputStream& wxOutputStream::Write(wxInputStream& stream_in)
 {
     stream_in.Read(*this);
@@ -22,9 +22,12 @@
 #include <grp.h>
 #endif
 
+import WX.Cmn.DataStream;
 import WX.File.Flags;
 import WX.File.Filename;
 
+import <cstring>;
+
 /////////////////////////////////////////////////////////////////////////////
 // constants
 
@@ -576,6 +579,7 @@ wxTarInputStream::wxTarInputStream(wxInputStream& stream,
     m_pos = wxInvalidOffset;
     m_offset = 0;
     m_size = wxInvalidOffset;
+    m_headeroffset = wxInvalidOffset;
     m_sumType = SUM_UNKNOWN;
     m_tarType = TYPE_USTAR;
     m_hdr = new wxTarHeaderBlock;
@@ -593,6 +597,7 @@ wxTarInputStream::wxTarInputStream(wxInputStream *stream,
     m_pos = wxInvalidOffset;
     m_offset = 0;
     m_size = wxInvalidOffset;
+    m_headeroffset = wxInvalidOffset;
     m_sumType = SUM_UNKNOWN;
     m_tarType = TYPE_USTAR;
     m_hdr = new wxTarHeaderBlock;
@@ -626,6 +631,7 @@ wxTarEntry *wxTarInputStream::GetNextEntry()
     entry->SetSize(GetHeaderNumber(TAR_SIZE));
 
     entry->SetOffset(m_offset);
+    entry->m_HeaderOffset = m_headeroffset;
 
     entry->SetDateTime(GetHeaderDate("mtime"));
     entry->SetAccessTime(GetHeaderDate("atime"));
@@ -657,6 +663,25 @@ wxTarEntry *wxTarInputStream::GetNextEntry()
     return entry.release();
 }
 
+wxTarEntry *wxTarInputStream::GetEntryAt(wxFileOffset headerOffset)
+{
+    // abandon the current entry, there is no need to skip its data
+    m_pos = wxInvalidOffset;
+
+    if (GetLastError() == wxSTREAM_READ_ERROR
+            || !m_parent_i_stream->IsSeekable()
+            || m_parent_i_stream->SeekI(headerOffset) != headerOffset)
+    {
+        m_lasterror = wxSTREAM_READ_ERROR;
+        return nullptr;
+    }
+
+    m_offset = headerOffset;
+    m_lasterror = wxSTREAM_NO_ERROR;
+
+    return GetNextEntry();
+}
+
 bool wxTarInputStream::OpenEntry(wxTarEntry& entry)
 {
     wxFileOffset offset = entry.GetOffset();
@@ -720,6 +745,8 @@ wxStreamError wxTarInputStream::ReadHeaders()
     if (!CloseEntry())
         return wxSTREAM_READ_ERROR;
 
+    m_headeroffset = m_offset;
+
     bool done = false;
 
     while (!done) {
@@ -762,6 +789,14 @@ wxStreamError wxTarInputStream::ReadHeaders()
         else
             m_tarType = TYPE_OLDTAR;
 
+        // GNU tar stores long names in pseudo-entries preceding the entry
+        if (m_tarType == TYPE_GNUTAR) {
+            switch (*m_hdr->Get(TAR_TYPEFLAG)) {
+                case 'L': ReadGnuLongName("path"); continue;
+                case 'K': ReadGnuLongName("linkname"); continue;
+            }
+        }
+
         if (m_tarType != TYPE_USTAR)
             break;
 
@@ -931,6 +966,32 @@ bool wxTarInputStream::ReadExtendedHeader(wxTarHeaderRecords*& recs)
     return true;
 }
 
+// A GNU long name is stored as the data of a pseudo-entry, nul terminated
+// and in the same encoding as the names in the header blocks
+
+bool wxTarInputStream::ReadGnuLongName(const wxString& key)
+{
+    if (!m_HeaderRecs)
+        m_HeaderRecs = new wxTarHeaderRecords;
+
+    const size_t len = m_hdr->GetOctal(TAR_SIZE);
+    const size_t size = RoundUpSize(len);
+
+    wxCharBuffer buf(size);
+    const size_t lastread = m_parent_i_stream->Read(buf.data(), size).LastRead();
+    m_offset += lastread;
+
+    if (lastread != size) {
+        wxLogWarning(_("invalid data in GNU tar long name header"));
+        return false;
+    }
+
+    buf.data()[len] = 0;
+    (*m_HeaderRecs)[key] = wxString(buf.data(), GetConv());
+
+    return true;
+}
+
 wxFileOffset wxTarInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
 {
     if (!IsOpened()) {
@@ -985,6 +1046,111 @@ size_t wxTarInputStream::OnSysRead(void *buffer, size_t size)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// Index
+
+// identifies the files written by wxTarIndex::Save()
+constexpr char TAR_INDEX_MAGIC[] = "wxTarIdx";
+constexpr std::uint32_t TAR_INDEX_VERSION = 1;
+
+void wxTarIndex::Clear()
+{
+    m_entries.clear();
+    m_byName.clear();
+}
+
+void wxTarIndex::AddEntry(Entry&& entry)
+{
+    m_byName[entry.name] = m_entries.size();
+    m_entries.push_back(std::move(entry));
+}
+
+bool wxTarIndex::Build(wxTarInputStream& stream)
+{
+    Clear();
+
+    for (;;) {
+        wxTarEntryPtr entry(stream.GetNextEntry());
+        if (!entry)
+            break;
+
+        AddEntry({
+            entry->GetInternalName(),
+            entry->GetHeaderOffset(),
+            entry->GetOffset(),
+            entry->GetSize(),
+            entry->GetTypeFlag()
+        });
+    }
+
+    return stream.GetLastError() == wxSTREAM_EOF;
+}
+
+bool wxTarIndex::Save(wxOutputStream& stream) const
+{
+    if (!stream.WriteAll(TAR_INDEX_MAGIC, strlen(TAR_INDEX_MAGIC)))
+        return false;
+
+    wxDataOutputStream data(stream);
+
+    data.Write32(TAR_INDEX_VERSION);
+    data.Write64(static_cast<std::uint64_t>(m_entries.size()));
+
+    for (const Entry& entry : m_entries) {
+        data.WriteString(entry.name);
+        data.Write64(static_cast<std::uint64_t>(entry.headerOffset));
+        data.Write64(static_cast<std::uint64_t>(entry.dataOffset));
+        data.Write64(static_cast<std::uint64_t>(entry.size));
+        data.Write8(static_cast<std::uint8_t>(entry.typeFlag));
+    }
+
+    return data.IsOk();
+}
+
+bool wxTarIndex::Load(wxInputStream& stream)
+{
+    Clear();
+
+    char magic[sizeof(TAR_INDEX_MAGIC) - 1];
+    if (!stream.ReadAll(magic, sizeof(magic))
+            || memcmp(magic, TAR_INDEX_MAGIC, sizeof(magic)) != 0)
+        return false;
+
+    wxDataInputStream data(stream);
+
+    if (data.Read32() != TAR_INDEX_VERSION)
+        return false;
+
+    // don't trust the count to preallocate anything, the file may be corrupt
+    const std::uint64_t count = data.Read64();
+
+    for (std::uint64_t n = 0; n < count && data.IsOk(); n++) {
+        Entry entry;
+        entry.name = data.ReadString();
+        entry.headerOffset = static_cast<wxFileOffset>(data.Read64());
+        entry.dataOffset = static_cast<wxFileOffset>(data.Read64());
+        entry.size = static_cast<wxFileOffset>(data.Read64());
+        entry.typeFlag = data.Read8();
+
+        AddEntry(std::move(entry));
+    }
+
+    if (!data.IsOk()) {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+const wxTarIndex::Entry *wxTarIndex::FindEntry(const wxString& name,
+                                               wxPathFormat format) const
+{
+    const auto it = m_byName.find(wxTarEntry::GetInternalName(name, format));
+    return it != m_byName.end() ? &m_entries[it->second] : nullptr;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Output stream
 
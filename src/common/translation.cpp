@@ -22,6 +22,7 @@ module;
 #include "wx/stdpaths.h"
 #include "wx/version.h"
 #include "wx/private/threadinfo.h"
+#include "wx/private/filemap.h"
 
 #ifdef WX_WINDOWS
     #include "wx/dynlib.h"
@@ -1043,6 +1044,9 @@ private:
                   ofsHashTable;   //        +18:  offset of hash table start
     };
 
+    // the file the data comes from, if loaded from a file
+    wxMappedFile m_file;
+
     // all data is stored here
     DataBuffer m_data;
 
@@ -1088,29 +1092,20 @@ private:
 bool wxMsgCatalogFile::LoadFile(const std::string& filename,
                                 wxPluralFormsCalculatorPtr& rPluralFormsCalculator)
 {
-    wxFile fileMsg(filename);
-    if ( !fileMsg.IsOpened() )
-        return false;
-
-    // get the file size (assume it is less than 4GB...)
-    wxFileOffset lenFile = fileMsg.Length();
-    if ( lenFile == wxInvalidOffset )
-        return false;
-
-    auto nSize = wx::narrow_cast<size_t>(lenFile);
-    wxASSERT_MSG( nSize == lenFile + size_t(0), "message catalog bigger than 4GB?" );
-
-    wxMemoryBuffer filedata;
-
-    // read the whole file in memory
-    if ( fileMsg.Read(filedata.GetWriteBuf(nSize), nSize) != lenFile )
+    // map the file instead of reading it, the data only needs to remain
+    // valid for as long as this object exists
+    if ( !m_file.Open(filename) )
         return false;
 
-    filedata.UngetWriteBuf(nSize);
+    m_file.Advise(wxFileAccessHint::WillNeed);
 
     bool ok = LoadData
               (
-                  DataBuffer::CreateOwned((char*)filedata.release(), nSize),
+                  DataBuffer::CreateNonOwned
+                  (
+                      reinterpret_cast<const char*>(m_file.GetData()),
+                      m_file.GetSize()
+                  ),
                   rPluralFormsCalculator
               );
     if ( !ok )
@@ -0,0 +1,616 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/webcache.cpp
+// Purpose:     On-disk cache of HTTP responses
+// Created:     2026-10-19
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#if wxUSE_WEBREQUEST
+
+#include "wx/private/webcache.h"
+
+#include "wx/datetime.h"
+#include "wx/dir.h"
+#include "wx/filefn.h"
+#include "wx/log.h"
+
+#include <fmt/core.h>
+
+import WX.Cmn.FFile;
+import WX.File.Filename;
+
+import <algorithm>;
+
+namespace
+{
+
+// Response headers which are stored in the cache entries: we don't store all
+// of them as the others are either not useful or must not be reused.
+const char* const gs_storedHeaders[] =
+{
+    "Age",
+    "Cache-Control",
+    "Content-Disposition",
+    "Content-Language",
+    "Content-Type",
+    "Date",
+    "ETag",
+    "Expires",
+    "Last-Modified",
+    "Pragma",
+    "Vary",
+};
+
+// Signature on the first line of the metadata files.
+constexpr char META_SIGNATURE[] = "wxWebCache 1";
+
+// Upper bound on the freshness lifetime computed from Last-Modified.
+constexpr std::time_t MAX_HEURISTIC_LIFETIME = 24*60*60;
+
+std::time_t ParseHTTPDate(const wxString& str)
+{
+#if wxUSE_DATETIME
+    wxDateTime dt;
+    wxString::const_iterator end;
+    if ( !str.empty() && dt.ParseRfc822Date(str, &end) )
+        return dt.GetTicks();
+#endif // wxUSE_DATETIME
+
+    return 0;
+}
+
+// Check if the comma-separated list of Cache-Control directives contains the
+// given one and return its value, if any, in the output parameter.
+bool HasDirective(const wxString& cacheControl,
+                  const wxString& name,
+                  long* value = nullptr)
+{
+    wxString rest = cacheControl;
+    while ( !rest.empty() )
+    {
+        wxString arg;
+        wxString directive = rest.BeforeFirst(',', &rest).BeforeFirst('=', &arg);
+        directive.Trim(true).Trim(false);
+        if ( directive.CmpNoCase(name) != 0 )
+            continue;
+
+        if ( value )
+        {
+            arg.Trim(true).Trim(false);
+            if ( arg.StartsWith("\"") && arg.EndsWith("\"") )
+                arg = arg.Mid(1, arg.length() - 2);
+
+            if ( !arg.ToLong(value) || *value < 0 )
+                return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// Return the time until which the response remains fresh, or 0 if it must
+// always be revalidated before being used.
+std::time_t ComputeExpiry(const wxWebCache::HeaderGetter& getHeader)
+{
+    const std::time_t now = std::time(nullptr);
+
+    const wxString cacheControl = getHeader("Cache-Control");
+    if ( HasDirective(cacheControl, "no-cache") )
+        return 0;
+
+    if ( cacheControl.empty() &&
+            getHeader("Pragma").Lower().Contains("no-cache") )
+        return 0;
+
+    long maxAge;
+    if ( HasDirective(cacheControl, "max-age", &maxAge) )
+    {
+        long age = 0;
+        getHeader("Age").ToLong(&age);
+
+        return maxAge > age ? now + maxAge - age : 0;
+    }
+
+    // Use the server time as base to avoid problems with clock differences.
+    std::time_t serverNow = ParseHTTPDate(getHeader("Date"));
+    if ( !serverNow )
+        serverNow = now;
+
+    const wxString expires = getHeader("Expires");
+    if ( !expires.empty() )
+    {
+        // Invalid dates, including "0", mean that the response has expired.
+        const std::time_t expiresTime = ParseHTTPDate(expires);
+        return expiresTime > serverNow ? now + (expiresTime - serverNow) : 0;
+    }
+
+    // Use the usual heuristic of considering the response fresh for 10% of
+    // the time since its last modification.
+    const std::time_t lastModified = ParseHTTPDate(getHeader("Last-Modified"));
+    if ( lastModified && lastModified < serverNow )
+    {
+        return now + std::min((serverNow - lastModified) / 10,
+                              MAX_HEURISTIC_LIFETIME);
+    }
+
+    return 0;
+}
+
+wxString
+FindRequestHeader(const wxWebRequestHeaderMap& headers, const wxString& name)
+{
+    for ( const auto& header : headers )
+    {
+        if ( name.CmpNoCase(header.first) == 0 )
+            return header.second;
+    }
+
+    return {};
+}
+
+// Return the names of the request headers in the Vary header.
+std::vector<wxString> ParseVary(const wxString& vary)
+{
+    std::vector<wxString> names;
+
+    wxString rest = vary;
+    while ( !rest.empty() )
+    {
+        wxString name = rest.BeforeFirst(',', &rest);
+        name.Trim(true).Trim(false);
+        if ( !name.empty() )
+            names.push_back(name);
+    }
+
+    return names;
+}
+
+// Compute the name of the entry files from everything identifying it, the
+// full key is also stored in the metadata file and checked when loading it.
+std::string
+MakeEntryName(const wxString& url,
+              const std::vector<std::pair<wxString, wxString>>& vary)
+{
+    // Use 64-bit FNV-1a hash.
+    std::uint64_t hash = 14695981039346656037ULL;
+    const auto update = [&hash](const wxString& s)
+    {
+        for ( unsigned char ch : std::string(s.utf8_str()) )
+        {
+            hash ^= ch;
+            hash *= 1099511628211ULL;
+        }
+
+        hash ^= '\n';
+        hash *= 1099511628211ULL;
+    };
+
+    update(url);
+    for ( const auto& header : vary )
+    {
+        update(header.first.Upper());
+        update(header.second);
+    }
+
+    return fmt::format("{:016x}", hash);
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxWebCacheEntry
+// ----------------------------------------------------------------------------
+
+wxString wxWebCacheEntry::GetHeader(const wxString& name) const
+{
+    const auto it = m_headers.find(name.Upper());
+
+    return it != m_headers.end() ? it->second : wxString();
+}
+
+// ----------------------------------------------------------------------------
+// wxWebCache
+// ----------------------------------------------------------------------------
+
+wxWebCache::wxWebCache(const std::string& dir, std::uint64_t maxSize)
+    : m_dir(dir),
+      m_maxSize(maxSize)
+{
+    if ( !wxFileName::Mkdir(m_dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL) )
+    {
+        wxLogDebug("Failed to create web cache directory \"%s\".", m_dir);
+        return;
+    }
+
+    m_ok = true;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Load();
+}
+
+std::uint64_t wxWebCache::GetTotalSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_totalSize;
+}
+
+std::string wxWebCache::GetMetaFile(const std::string& name) const
+{
+    return m_dir + wxFILE_SEP_PATH + name + ".meta";
+}
+
+bool wxWebCache::WriteMetaFile(const wxWebCacheEntry& entry) const
+{
+    wxString meta;
+    meta << META_SIGNATURE << '\n'
+         << "URL " << entry.m_url << '\n'
+         << "Status " << entry.m_status << ' ' << entry.m_statusText << '\n'
+         << "Expires " << static_cast<std::int64_t>(entry.m_expires) << '\n';
+
+    for ( const auto& header : entry.m_vary )
+        meta << "Vary " << header.first << ": " << header.second << '\n';
+
+    for ( const auto& header : entry.m_headers )
+        meta << "Header " << header.first << ": " << header.second << '\n';
+
+    // Write to a temporary file first to avoid leaving a partially written
+    // file if we're interrupted.
+    const std::string filename = GetMetaFile(entry.m_name);
+    const std::string tmpname = filename + ".tmp";
+
+    {
+        wxFFile file(tmpname, "wb");
+        if ( !file.IsOpened() || !file.Write(meta, wxConvUTF8) || !file.Close() )
+        {
+            wxRemoveFile(tmpname);
+            return false;
+        }
+    }
+
+    return wxRenameFile(tmpname, filename);
+}
+
+wxWebCacheEntryPtr wxWebCache::ReadMetaFile(const std::string& filename) const
+{
+    wxFFile file(filename, "rb");
+    wxString meta;
+    if ( !file.IsOpened() || !file.ReadAll(&meta, wxConvUTF8) )
+        return {};
+
+    wxString line = meta.BeforeFirst('\n', &meta);
+    if ( line != META_SIGNATURE )
+        return {};
+
+    auto entry = std::make_shared<wxWebCacheEntry>();
+
+    while ( !meta.empty() )
+    {
+        wxString value;
+        const wxString field = meta.BeforeFirst('\n', &meta).BeforeFirst(' ', &value);
+
+        if ( field == "URL" )
+        {
+            entry->m_url = value;
+        }
+        else if ( field == "Status" )
+        {
+            long status;
+            if ( !value.BeforeFirst(' ', &entry->m_statusText).ToLong(&status) )
+                return {};
+
+            entry->m_status = status;
+        }
+        else if ( field == "Expires" )
+        {
+            std::int64_t expires;
+            if ( !value.ToLongLong(&expires) )
+                return {};
+
+            entry->m_expires = static_cast<std::time_t>(expires);
+        }
+        else if ( field == "Vary" || field == "Header" )
+        {
+            wxString headerValue;
+            const wxString name = value.BeforeFirst(':', &headerValue);
+            headerValue.Trim(false);
+
+            if ( field == "Vary" )
+                entry->m_vary.emplace_back(name, headerValue);
+            else
+                entry->m_headers[name.Upper()] = headerValue;
+        }
+    }
+
+    if ( entry->m_url.empty() || !entry->m_status )
+        return {};
+
+    // Check that the file really corresponds to this entry and not to another
+    // one with a colliding hash: it's not a problem, but it can't be used.
+    // Notice that only the names are compared, as the directory part of the
+    // file name may be spelled differently from m_dir.
+    entry->m_name = MakeEntryName(entry->m_url, entry->m_vary);
+    const std::string name = wxFileName(filename).GetName();
+    if ( name != entry->m_name )
+        return {};
+
+    entry->m_bodyFile = m_dir + wxFILE_SEP_PATH + entry->m_name + ".body";
+
+    const wxULongLong size = wxFileName::GetSize(entry->m_bodyFile);
+    if ( size == wxInvalidSize )
+        return {};
+
+    entry->m_size = size.GetValue();
+
+    return entry;
+}
+
+void wxWebCache::Load()
+{
+    std::vector<std::string> files;
+    wxDir::GetAllFiles(m_dir, &files, "*.meta", wxDIR_FILES);
+
+    // Order the entries by their last use, which is reflected in the
+    // modification time of their metadata files.
+    std::vector<std::pair<std::time_t, wxWebCacheEntryPtr>> entries;
+    for ( const auto& filename : files )
+    {
+        wxWebCacheEntryPtr entry = ReadMetaFile(filename);
+        if ( !entry )
+        {
+            wxLogDebug("Removing invalid web cache entry \"%s\".", filename);
+
+            wxRemoveFile(filename);
+            continue;
+        }
+
+        entries.emplace_back(wxFileModificationTime(filename), entry);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for ( const auto& entry : entries )
+        Insert(entry.second);
+
+    // Remove the bodies without metadata and the temporary metadata files,
+    // which could be left if we were interrupted while storing them.
+    files.clear();
+    wxDir::GetAllFiles(m_dir, &files, "*.body*", wxDIR_FILES);
+    for ( const auto& filename : files )
+    {
+        const std::string name = wxFileName(filename).GetName();
+        if ( m_entries.find(name) == m_entries.end() )
+            wxRemoveFile(filename);
+    }
+
+    files.clear();
+    wxDir::GetAllFiles(m_dir, &files, "*.meta.tmp", wxDIR_FILES);
+    for ( const auto& filename : files )
+        wxRemoveFile(filename);
+
+    Evict();
+}
+
+void wxWebCache::Insert(const wxWebCacheEntryPtr& entry)
+{
+    Erase(entry->m_name, false);
+
+    m_lru.push_front(entry);
+    m_entries[entry->m_name] = m_lru.begin();
+    m_byURL.emplace(entry->m_url.utf8_string(), entry->m_name);
+    m_totalSize += entry->m_size;
+}
+
+void wxWebCache::Erase(const std::string& name, bool removeFiles)
+{
+    const auto it = m_entries.find(name);
+    if ( it == m_entries.end() )
+        return;
+
+    const wxWebCacheEntryPtr entry = *it->second;
+
+    auto range = m_byURL.equal_range(entry->m_url.utf8_string());
+    for ( auto itURL = range.first; itURL != range.second; ++itURL )
+    {
+        if ( itURL->second == name )
+        {
+            m_byURL.erase(itURL);
+            break;
+        }
+    }
+
+    m_totalSize -= entry->m_size;
+    m_lru.erase(it->second);
+    m_entries.erase(it);
+
+    if ( removeFiles )
+    {
+        // Note that under Unix this works even if the body is still being
+        // used, while under MSW it fails if it's mapped and will be retried
+        // when the cache is loaded the next time.
+        wxRemoveFile(GetMetaFile(name));
+        wxRemoveFile(entry->m_bodyFile);
+    }
+}
+
+void wxWebCache::Evict()
+{
+    // Never remove the most recently used entry, even if it's bigger than the
+    // maximal size on its own, as it's going to be used immediately.
+    while ( m_totalSize > m_maxSize && m_lru.size() > 1 )
+        Erase(m_lru.back()->m_name, true);
+}
+
+/* static */
+bool wxWebCache::IsCacheable(int status, const HeaderGetter& getHeader)
+{
+    if ( status != 200 )
+        return false;
+
+    if ( HasDirective(getHeader("Cache-Control"), "no-store") )
+        return false;
+
+    // The response can't be reused for any other request.
+    if ( getHeader("Vary").Contains("*") )
+        return false;
+
+    // There is no point in storing the responses which can be neither used
+    // directly nor revalidated.
+    return ComputeExpiry(getHeader) ||
+            !getHeader("ETag").empty() ||
+                !getHeader("Last-Modified").empty();
+}
+
+wxWebCacheEntryPtr
+wxWebCache::Find(const wxString& url,
+                 const wxWebRequestHeaderMap& requestHeaders)
+{
+    if ( !m_ok )
+        return {};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto range = m_byURL.equal_range(url.utf8_string());
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+        const auto itEntry = m_entries.find(it->second);
+        if ( itEntry == m_entries.end() )
+            continue;
+
+        const wxWebCacheEntryPtr entry = *itEntry->second;
+
+        const bool matches = std::all_of
+            (
+                entry->m_vary.begin(), entry->m_vary.end(),
+                [&requestHeaders](const auto& header)
+                {
+                    return FindRequestHeader(requestHeaders, header.first)
+                            == header.second;
+                }
+            );
+
+        if ( !matches )
+            continue;
+
+        // Mark the entry as used, both in memory and on disk.
+        m_lru.splice(m_lru.begin(), m_lru, itEntry->second);
+        wxFileName(GetMetaFile(entry->m_name)).Touch();
+
+        return entry;
+    }
+
+    return {};
+}
+
+wxWebCacheEntryPtr
+wxWebCache::Store(const wxString& url,
+                  const wxWebRequestHeaderMap& requestHeaders,
+                  int status,
+                  const wxString& statusText,
+                  const HeaderGetter& getHeader,
+                  const BodyWriter& writeBody)
+{
+    if ( !m_ok || !IsCacheable(status, getHeader) )
+        return {};
+
+    auto entry = std::make_shared<wxWebCacheEntry>();
+    entry->m_url = url;
+    entry->m_status = status;
+    entry->m_statusText = statusText;
+    entry->m_expires = ComputeExpiry(getHeader);
+
+    for ( const char* name : gs_storedHeaders )
+    {
+        const wxString value = getHeader(name);
+        if ( !value.empty() )
+            entry->m_headers[wxString(name).Upper()] = value;
+    }
+
+    for ( const wxString& name : ParseVary(getHeader("Vary")) )
+        entry->m_vary.emplace_back(name, FindRequestHeader(requestHeaders, name));
+
+    entry->m_name = MakeEntryName(url, entry->m_vary);
+    entry->m_bodyFile = m_dir + wxFILE_SEP_PATH + entry->m_name + ".body";
+
+    // Write the body without holding the lock, as this may take a long time,
+    // but to a temporary file to avoid overwriting the body of the existing
+    // entry which could be in use.
+    const std::string tmpname = entry->m_bodyFile + ".tmp";
+    if ( !writeBody(tmpname) )
+    {
+        wxRemoveFile(tmpname);
+        return {};
+    }
+
+    const wxULongLong size = wxFileName::GetSize(tmpname);
+    if ( size == wxInvalidSize )
+    {
+        wxRemoveFile(tmpname);
+        return {};
+    }
+
+    entry->m_size = size.GetValue();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ( !wxRenameFile(tmpname, entry->m_bodyFile) || !WriteMetaFile(*entry) )
+    {
+        wxRemoveFile(tmpname);
+        Erase(entry->m_name, true);
+        return {};
+    }
+
+    Insert(entry);
+    Evict();
+
+    return entry;
+}
+
+wxWebCacheEntryPtr
+wxWebCache::Revalidated(const wxWebCacheEntryPtr& entry,
+                        const HeaderGetter& getHeader)
+{
+    wxCHECK_MSG( entry, {}, "invalid entry" );
+
+    auto updated = std::make_shared<wxWebCacheEntry>(*entry);
+
+    // The headers of 304 response replace the stored ones.
+    for ( const char* name : gs_storedHeaders )
+    {
+        const wxString value = getHeader(name);
+        if ( !value.empty() )
+            updated->m_headers[wxString(name).Upper()] = value;
+    }
+
+    updated->m_expires = ComputeExpiry([&updated](const wxString& name)
+                                       {
+                                           return updated->GetHeader(name);
+                                       });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Check that the entry is still in the cache, it could have been evicted
+    // together with its body in the meanwhile.
+    if ( m_entries.find(updated->m_name) == m_entries.end() ||
+            !WriteMetaFile(*updated) )
+        return {};
+
+    Insert(updated);
+
+    return updated;
+}
+
+void wxWebCache::Remove(const wxWebCacheEntryPtr& entry)
+{
+    wxCHECK_RET( entry, "invalid entry" );
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Erase(entry->m_name, true);
+}
+
+#endif // wxUSE_WEBREQUEST
@@ -19,6 +19,7 @@
 #include "wx/utils.h"
 
 #include "wx/private/webrequest.h"
+#include "wx/private/webcache.h"
 
 #if wxUSE_WEBREQUEST_WINHTTP
 #include "wx/msw/private/webrequest_winhttp.h"
@@ -34,10 +35,13 @@ import WX.Cmn.WFStream;
 import WX.Cmn.MemStream;
 import WX.Cmn.Uri;
 
+import WX.File.File;
 import WX.File.Flags;
 import WX.File.Filename;
 
+import <algorithm>;
 import <filesystem>;
+import <span>;
 
 extern const char wxWebSessionBackendWinHTTP[] = "WinHTTP";
 extern const char wxWebSessionBackendURLSession[] = "URLSession";
@@ -53,6 +57,88 @@ constexpr std::string_view wxNO_IMPL_MSG = "can't be used with an invalid/uninit
 #define wxCHECK_IMPL(rc) wxCHECK_MSG( m_impl, (rc), wxNO_IMPL_MSG )
 #define wxCHECK_IMPL_VOID() wxCHECK_RET( m_impl, wxNO_IMPL_MSG )
 
+namespace
+{
+
+//
+// wxWebResponseCached: response created from a wxWebCache entry
+//
+
+class wxWebResponseCached : public wxWebResponseImpl
+{
+public:
+    wxWebResponseCached(wxWebRequestImpl& request,
+                        const wxWebCacheEntryPtr& entry)
+        : wxWebResponseImpl(request),
+          m_entry(entry),
+          m_body(entry->GetBodyFile())
+    {
+        Init();
+    }
+
+    // The entry body could have been removed since it was found.
+    bool IsOk() const { return m_body.IsOk(); }
+
+    wxFileOffset GetContentLength() const override
+        { return static_cast<wxFileOffset>(m_entry->GetSize()); }
+
+    wxString GetURL() const override { return m_entry->GetURL(); }
+
+    wxString GetHeader(const wxString& name) const override
+        { return m_entry->GetHeader(name); }
+
+    int GetStatus() const override { return m_entry->GetStatus(); }
+
+    wxString GetStatusText() const override { return m_entry->GetStatusText(); }
+
+    bool IsFromCache() const override { return true; }
+
+    // Pass the cached body to the request as if it had been received from the
+    // network, returns false if the data consumer didn't accept it.
+    bool ReportData();
+
+private:
+    const wxWebCacheEntryPtr m_entry;
+    wxMappedFileInputStream m_body;
+};
+
+bool wxWebResponseCached::ReportData()
+{
+    m_body.Advise(wxFileAccessHint::Sequential);
+
+    std::span<const std::byte> data = m_body.GetDirectBuffer();
+
+    if ( m_request.GetStorage() == wxWebRequest::Storage_None )
+    {
+        // The consumer can use the mapped data directly.
+        if ( const auto& consumer = m_request.GetDataConsumer() )
+        {
+            if ( !consumer(data.data(), data.size()) )
+                return false;
+
+            m_request.ReportDataReceived(data.size());
+            return true;
+        }
+    }
+    else if ( m_request.GetStorage() == wxWebRequest::Storage_Memory )
+    {
+        PreAllocBuffer(data.size());
+    }
+
+    while ( !data.empty() )
+    {
+        const size_t size = std::min<size_t>(data.size(), wxWEBREQUEST_BUFFER_SIZE);
+        memcpy(GetDataBuffer(size), data.data(), size);
+        ReportDataReceived(size);
+
+        data = data.subspan(size);
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
 //
 // wxWebRequestImpl
 //
@@ -82,6 +168,153 @@ void wxWebRequestImpl::Cancel()
     DoCancel();
 }
 
+bool wxWebRequestImpl::StartFromCache()
+{
+    if ( !m_cache )
+        return false;
+
+    // Only the responses to simple GET requests are cached.
+    if ( !(m_method.empty() || m_method.CmpNoCase("GET") == 0) || m_dataSize )
+        return false;
+
+    // Don't interfere with the conditional requests made by the application.
+    for ( const auto& header : m_headers )
+    {
+        const wxString name = header.first;
+        if ( name.CmpNoCase("If-None-Match") == 0 ||
+                name.CmpNoCase("If-Modified-Since") == 0 )
+            return false;
+    }
+
+    m_useCache = true;
+
+    m_cacheEntry = m_cache->Find(m_cacheURL, m_headers);
+    if ( !m_cacheEntry )
+        return false;
+
+    if ( m_cacheEntry->IsFresh() )
+    {
+        wxObjectDataPtr<wxWebResponseCached>
+            response(new wxWebResponseCached(*this, m_cacheEntry));
+        if ( response->IsOk() )
+        {
+            wxLogTrace(wxTRACE_WEBREQUEST, "Request %p: using cached response",
+                       this);
+
+            m_cachedResponse = response;
+
+            SetState(wxWebRequest::State_Active);
+            if ( response->ReportData() )
+                SetState(wxWebRequest::State_Completed);
+            else
+                SetState(wxWebRequest::State_Failed,
+                         _("Transfer aborted by the data consumer."));
+
+            return true;
+        }
+    }
+
+    if ( !m_cacheEntry->HasValidators() )
+    {
+        m_cacheEntry.reset();
+        return false;
+    }
+
+    // Ask the server to send the response only if it changed.
+    const wxString etag = m_cacheEntry->GetHeader("ETag");
+    if ( !etag.empty() )
+        SetHeader("If-None-Match", etag);
+
+    const wxString lastModified = m_cacheEntry->GetHeader("Last-Modified");
+    if ( !lastModified.empty() )
+        SetHeader("If-Modified-Since", lastModified);
+
+    return false;
+}
+
+bool wxWebRequestImpl::UpdateCache()
+{
+    // Nothing to do if the response was already taken from the cache.
+    if ( !m_useCache || m_cachedResponse )
+        return true;
+
+    const wxWebResponseImplPtr response = GetResponse();
+    if ( !response )
+        return true;
+
+    const auto getHeader = [&response](const wxString& name)
+    {
+        return response->GetHeader(name);
+    };
+
+    if ( response->GetStatus() == 304 && m_cacheEntry )
+    {
+        // The entry could have been evicted from the cache since the request
+        // was sent, in which case we don't have any body to return.
+        const wxWebCacheEntryPtr entry = m_cache->Revalidated(m_cacheEntry, getHeader);
+        if ( !entry )
+        {
+            wxLogTrace(wxTRACE_WEBREQUEST,
+                       "Request %p: revalidated response is not cached any more",
+                       this);
+            return false;
+        }
+
+        wxObjectDataPtr<wxWebResponseCached>
+            cached(new wxWebResponseCached(*this, entry));
+        if ( !cached->IsOk() )
+            return false;
+
+        m_cachedResponse = cached;
+        cached->ReportData();
+
+        return true;
+    }
+
+    if ( !wxWebCache::IsCacheable(response->GetStatus(), getHeader) )
+    {
+        // The old response must not be used any longer neither.
+        if ( m_cacheEntry )
+            m_cache->Remove(m_cacheEntry);
+        return true;
+    }
+
+    wxWebResponseImpl& resp = *response;
+    wxWebCache::BodyWriter writeBody;
+    switch ( m_storage )
+    {
+        case wxWebRequest::Storage_Memory:
+            writeBody = [&resp](const std::string& filename)
+            {
+                const wxMemoryBuffer& buf = resp.m_readBuffer;
+
+                wxFile file;
+                return file.Create(filename, true) &&
+                        file.Write(buf.GetData(), buf.GetDataLen()) == buf.GetDataLen() &&
+                            file.Close();
+            };
+            break;
+
+        case wxWebRequest::Storage_File:
+            writeBody = [&resp](const std::string& filename)
+            {
+                return resp.m_file.Flush() &&
+                        wxCopyFile(resp.m_file.GetName(), filename);
+            };
+            break;
+
+        case wxWebRequest::Storage_None:
+            // The data was passed to the application and not kept.
+            return true;
+    }
+
+    m_cache->Store(m_cacheURL, m_headers,
+                   response->GetStatus(), response->GetStatusText(),
+                   getHeader, writeBody);
+
+    return true;
+}
+
 void wxWebRequestImpl::SetFinalStateFromStatus()
 {
     const wxWebResponseImplPtr& resp = GetResponse();
@@ -149,8 +382,8 @@ wxFileOffset wxWebRequestImpl::GetBytesReceived() const
 
 wxFileOffset wxWebRequestImpl::GetBytesExpectedToReceive() const
 {
-    if ( GetResponse() )
-        return GetResponse()->GetContentLength();
+    if ( const wxWebResponseImplPtr response = GetActualResponse() )
+        return response->GetContentLength();
     else
         return -1;
 }
@@ -206,6 +439,15 @@ void wxWebRequestImpl::SetState(wxWebRequest::State state, const wxString & fail
 {
     wxCHECK_RET( state != m_state, "shouldn't switch to the same state" );
 
+    if ( state == wxWebRequest::State_Completed && m_cache && !UpdateCache() )
+    {
+        // Don't complete the request with the bodyless "304 Not Modified"
+        // response if we don't have the cached one to use instead of it.
+        SetState(wxWebRequest::State_Failed,
+                 _("Cached response is not available any more."));
+        return;
+    }
+
     wxLogTrace(wxTRACE_WEBREQUEST, "Request %p: state %s => %s",
                this, StateName(m_state), StateName(state));
 
@@ -328,7 +570,7 @@ void wxWebRequestImpl::ProcessStateEvent(wxWebRequest::State state, const wxStri
 {
     wxString dataFile;
 
-    const wxWebResponseImplPtr& response = GetResponse();
+    const wxWebResponseImplPtr response = GetActualResponse();
 
     wxWebRequestEvent evt(wxEVT_WEBREQUEST_STATE, GetId(), state,
                           wxWebResponse(response), failMsg);
@@ -448,6 +690,30 @@ wxWebRequest::Storage wxWebRequest::GetStorage() const
     return m_impl->GetStorage();
 }
 
+void wxWebRequest::SetDataConsumer(const DataConsumer& consumer)
+{
+    wxCHECK_IMPL_VOID();
+
+    m_impl->SetDataConsumer(consumer);
+}
+
+void wxWebRequest::SetPriority(int priority)
+{
+    wxCHECK_IMPL_VOID();
+
+    wxCHECK_RET( m_impl->GetState() == wxWebRequest::State_Idle,
+                 "Priority must be set before starting the request" );
+
+    m_impl->SetPriority(priority);
+}
+
+int wxWebRequest::GetPriority() const
+{
+    wxCHECK_IMPL( 0 );
+
+    return m_impl->GetPriority();
+}
+
 void wxWebRequest::Start()
 {
     wxCHECK_IMPL_VOID();
@@ -455,6 +721,9 @@ void wxWebRequest::Start()
     wxCHECK_RET( m_impl->GetState() == wxWebRequest::State_Idle,
                  "Completed requests can not be restarted" );
 
+    if ( m_impl->StartFromCache() )
+        return;
+
     m_impl->Start();
 }
 
@@ -472,7 +741,7 @@ wxWebResponse wxWebRequest::GetResponse() const
 {
     wxCHECK_IMPL( wxWebResponse() );
 
-    return wxWebResponse(m_impl->GetResponse());
+    return wxWebResponse(m_impl->GetActualResponse());
 }
 
 wxWebAuthChallenge wxWebRequest::GetAuthChallenge() const
@@ -723,6 +992,15 @@ void wxWebResponseImpl::ReportDataReceived(size_t sizeReceived)
             break;
 
         case wxWebRequest::Storage_None:
+            if ( const auto& consumer = m_request.GetDataConsumer() )
+            {
+                // The backend had to buffer the data anyhow, so just pass it
+                // on and reuse the same buffer for the next chunk.
+                consumer(m_readBuffer.GetData(), m_readBuffer.GetDataLen());
+                m_readBuffer.Clear();
+                break;
+            }
+
             wxWebRequestEvent* const evt = new wxWebRequestEvent
                                                (
                                                 wxEVT_WEBREQUEST_DATA,
@@ -844,6 +1122,13 @@ wxString wxWebResponse::GetDataFile() const
     return m_impl->GetDataFile();
 }
 
+bool wxWebResponse::IsFromCache() const
+{
+    wxCHECK_IMPL( false );
+
+    return m_impl->IsFromCache();
+}
+
 
 //
 // wxWebSessionImpl
@@ -984,7 +1269,11 @@ wxWebSession::CreateRequest(wxEvtHandler* handler, const wxString& url, int id)
 {
     wxCHECK_IMPL( wxWebRequest() );
 
-    return wxWebRequest(m_impl->CreateRequest(*this, handler, url, id));
+    wxWebRequestImplPtr impl = m_impl->CreateRequest(*this, handler, url, id);
+    if ( impl && m_impl->GetCache() )
+        impl->UseCache(m_impl->GetCache(), url);
+
+    return wxWebRequest(impl);
 }
 
 wxVersionInfo wxWebSession::GetLibraryVersionInfo()
@@ -1015,6 +1304,67 @@ wxString wxWebSession::GetTempDir() const
     return m_impl->GetTempDir();
 }
 
+void wxWebSession::SetMaxConcurrency(int maxActive)
+{
+    wxCHECK_IMPL_VOID();
+
+    wxCHECK_RET( maxActive >= 0, "invalid maximal number of requests" );
+
+    m_impl->SetMaxConcurrency(maxActive);
+}
+
+int wxWebSession::GetMaxConcurrency() const
+{
+    wxCHECK_IMPL( 0 );
+
+    return m_impl->GetMaxConcurrency();
+}
+
+bool wxWebSession::EnableCache(const std::string& dir, std::uint64_t maxSize)
+{
+    wxCHECK_IMPL( false );
+
+    auto cache = std::make_shared<wxWebCache>(dir, maxSize);
+    if ( !cache->IsOk() )
+        return false;
+
+    m_impl->SetCache(cache);
+
+    return true;
+}
+
+void wxWebSession::DisableCache()
+{
+    wxCHECK_IMPL_VOID();
+
+    m_impl->SetCache(nullptr);
+}
+
+bool wxWebSession::IsCacheEnabled() const
+{
+    return m_impl && m_impl->GetCache();
+}
+
+wxWebSessionImpl* wxGetDefaultWebSessionImpl()
+{
+    return gs_defaultSession.m_impl.get();
+}
+
+std::shared_ptr<wxWebCache> wxGetDefaultWebCache(wxWebRequestHeaderMap* headers)
+{
+    // Don't create the default session if it doesn't exist yet, it wouldn't
+    // have any cache anyhow.
+    const wxWebSessionImpl* const impl = wxGetDefaultWebSessionImpl();
+    if ( !impl )
+        return {};
+
+    const std::shared_ptr<wxWebCache>& cache = impl->GetCache();
+    if ( cache && headers )
+        *headers = impl->GetHeaders();
+
+    return cache;
+}
+
 bool wxWebSession::IsOpened() const
 {
     return m_impl.get() != nullptr;
@@ -28,6 +28,8 @@
 
 import WX.Cmn.Uri;
 
+import <algorithm>;
+
 // Define symbols that might be missing from older libcurl headers
 #ifndef CURL_AT_LEAST_VERSION
 #define CURL_VERSION_BITS(x,y,z) ((x)<<16|(y)<<8|z)
@@ -40,6 +42,9 @@ import WX.Cmn.Uri;
     #define CURLOPT_ACCEPT_ENCODING CURLOPT_ENCODING
 #endif
 
+// Maximal number of easy handles kept by wxWebSessionCURL for reuse.
+constexpr size_t wxCURL_MAX_POOLED_HANDLES = 16;
+
 //
 // wxWebResponseCURL
 //
@@ -82,6 +87,7 @@ wxWebResponseCURL::wxWebResponseCURL(wxWebRequestCURL& request) :
     wxWebResponseImpl(request)
 {
     m_knownDownloadSize = 0;
+    m_aborted = false;
 
     curl_easy_setopt(GetHandle(), CURLOPT_WRITEDATA, static_cast<void*>(this));
     curl_easy_setopt(GetHandle(), CURLOPT_HEADERDATA, static_cast<void*>(this));
@@ -112,6 +118,24 @@ wxWebResponseCURL::wxWebResponseCURL(wxWebRequestCURL& request) :
 
 size_t wxWebResponseCURL::CURLOnWrite(void* buffer, size_t size)
 {
+    if ( m_request.GetStorage() == wxWebRequest::Storage_None )
+    {
+        // Pass the data to the consumer directly from curl buffer, if we have
+        // one, instead of copying it to our own buffer first.
+        if ( const auto& consumer = m_request.GetDataConsumer() )
+        {
+            if ( !consumer(buffer, size) )
+            {
+                // Returning a different size makes curl abort the transfer.
+                m_aborted = true;
+                return 0;
+            }
+
+            m_request.ReportDataReceived(size);
+            return size;
+        }
+    }
+
     void* buf = GetDataBuffer(size);
     memcpy(buf, buffer, size);
     ReportDataReceived(size);
@@ -221,7 +245,7 @@ wxWebRequestCURL::wxWebRequestCURL(wxWebSession & session,
 {
     m_headerList = NULL;
 
-    m_handle = curl_easy_init();
+    m_handle = m_sessionImpl.AcquireHandle();
     if ( !m_handle )
     {
         wxStrlcpy(m_errorBuffer, "libcurl initialization failed", CURL_ERROR_SIZE);
@@ -332,7 +356,12 @@ void wxWebRequestCURL::HandleCompletion()
 {
     int status = m_response ? m_response->GetStatus() : 0;
 
-    if ( status == 0 )
+    if ( m_response && m_response->WasAborted() )
+    {
+        SetState(wxWebRequest::State_Failed,
+                 _("Transfer aborted by the data consumer."));
+    }
+    else if ( status == 0 )
     {
         SetState(wxWebRequest::State_Failed, GetError());
     }
@@ -865,9 +894,12 @@ SocketPollerImpl* SocketPollerImpl::Create(wxEvtHandler* hndlr)
 
 int wxWebSessionCURL::ms_activeSessions = 0;
 unsigned int wxWebSessionCURL::ms_runtimeVersion = 0;
+bool wxWebSessionCURL::ms_runtimeHasHTTP2 = false;
 
 wxWebSessionCURL::wxWebSessionCURL() :
-    m_handle(NULL)
+    m_queuedRequestsScheduled(false),
+    m_handle(NULL),
+    m_shareHandle(NULL)
 {
     // Initialize CURL globally if no sessions are active
     if ( ms_activeSessions == 0 )
@@ -880,6 +912,9 @@ wxWebSessionCURL::wxWebSessionCURL() :
         {
             curl_version_info_data* data = curl_version_info(CURLVERSION_NOW);
             ms_runtimeVersion = data->version_num;
+#ifdef CURL_VERSION_HTTP2
+            ms_runtimeHasHTTP2 = (data->features & CURL_VERSION_HTTP2) != 0;
+#endif
         }
     }
 
@@ -896,9 +931,18 @@ wxWebSessionCURL::~wxWebSessionCURL()
 {
     delete m_socketPoller;
 
+    m_queuedRequests.clear();
+
+    for ( CURL* curl : m_handlePool )
+        curl_easy_cleanup(curl);
+
     if ( m_handle )
         curl_multi_cleanup(m_handle);
 
+    // This must be done after destroying all the handles using it.
+    if ( m_shareHandle )
+        curl_share_cleanup(m_shareHandle);
+
     // Global CURL cleanup if this is the last session
     --ms_activeSessions;
     if ( ms_activeSessions == 0 )
@@ -926,14 +970,129 @@ wxWebSessionCURL::CreateRequest(wxWebSession& session,
             curl_multi_setopt(m_handle, CURLMOPT_SOCKETFUNCTION, SocketCallback);
             curl_multi_setopt(m_handle, CURLMOPT_TIMERDATA, this);
             curl_multi_setopt(m_handle, CURLMOPT_TIMERFUNCTION, TimerCallback);
+
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+            // Allow running several transfers over the same HTTP/2 connection.
+            curl_multi_setopt(m_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+        }
+
+#if CURL_AT_LEAST_VERSION(7, 23, 0)
+        // Connections (and hence keep-alive) and DNS cache are already shared
+        // by all easy handles added to the multi one, but TLS sessions are
+        // cached per easy handle unless they use a share object, so use one
+        // to allow resuming them when opening new connections.
+        m_shareHandle = curl_share_init();
+        if ( m_shareHandle )
+        {
+            curl_share_setopt(m_shareHandle, CURLSHOPT_SHARE,
+                              CURL_LOCK_DATA_SSL_SESSION);
         }
+#endif
     }
 
     return wxWebRequestImplPtr(new wxWebRequestCURL(session, *this, handler, url, id));
 }
 
+CURL* wxWebSessionCURL::AcquireHandle()
+{
+    CURL* curl;
+    if ( !m_handlePool.empty() )
+    {
+        // Note that the handle was reset when it was returned to the pool.
+        curl = m_handlePool.back();
+        m_handlePool.pop_back();
+    }
+    else
+    {
+        curl = curl_easy_init();
+        if ( !curl )
+            return NULL;
+    }
+
+    if ( m_shareHandle )
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_shareHandle);
+
+#if CURL_AT_LEAST_VERSION(7, 25, 0)
+    // Keep the idle connections in the pool alive.
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+
+#if CURL_AT_LEAST_VERSION(7, 47, 0)
+    // This is the default since curl 7.62, but enable HTTP/2 for HTTPS
+    // connections with the older versions too.
+    if ( ms_runtimeHasHTTP2 )
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+    // Prefer waiting for a connection to the same host being established to
+    // opening a new one, as it may be used for multiplexing.
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+#endif
+
+    return curl;
+}
+
+void wxWebSessionCURL::ReleaseHandle(CURL* curl)
+{
+    if ( !curl )
+        return;
+
+    if ( m_handlePool.size() < wxCURL_MAX_POOLED_HANDLES )
+    {
+        // Resetting the handle keeps its caches but ensures that no options
+        // set for the previous request are reused by the next one.
+        curl_easy_reset(curl);
+        m_handlePool.push_back(curl);
+    }
+    else
+    {
+        curl_easy_cleanup(curl);
+    }
+}
+
+void wxWebSessionCURL::SetMaxConcurrency(int maxActive)
+{
+    wxWebSessionImpl::SetMaxConcurrency(maxActive);
+
+    // The limit might have been increased, allowing more requests to run.
+    ScheduleQueuedRequests();
+}
+
+bool wxWebSessionCURL::CanStartTransfer() const
+{
+    const int maxActive = GetMaxConcurrency();
+
+    return maxActive == 0 ||
+            m_activeTransfers.size() < static_cast<size_t>(maxActive);
+}
+
 bool wxWebSessionCURL::StartRequest(wxWebRequestCURL & request)
 {
+    if ( !m_queuedRequests.empty() || !CanStartTransfer() )
+    {
+        // Insert the request after all the others with the same or higher
+        // priority, the request is considered to be active from now on even
+        // if its transfer will only start later.
+        const int priority = request.GetPriority();
+        m_queuedRequests.insert
+        (
+            std::find_if(m_queuedRequests.begin(), m_queuedRequests.end(),
+                         [priority](const wxWebRequestCURL* other)
+                         {
+                            return other->GetPriority() < priority;
+                         }),
+            &request
+        );
+
+        request.SetState(wxWebRequest::State_Active);
+
+        ScheduleQueuedRequests();
+
+        return true;
+    }
+
     // Add request easy handle to multi handle
     CURL* curl = request.GetHandle();
     int code = curl_multi_add_handle(m_handle, curl);
@@ -956,8 +1115,55 @@ bool wxWebSessionCURL::StartRequest(wxWebRequestCURL & request)
     }
 }
 
+void wxWebSessionCURL::StartQueuedRequests()
+{
+    m_queuedRequestsScheduled = false;
+
+    bool started = false;
+    while ( !m_queuedRequests.empty() && CanStartTransfer() )
+    {
+        wxWebRequestCURL* request = m_queuedRequests.front();
+        m_queuedRequests.pop_front();
+
+        CURL* curl = request->GetHandle();
+        if ( curl_multi_add_handle(m_handle, curl) != CURLM_OK )
+        {
+            request->SetState(wxWebRequest::State_Failed);
+            continue;
+        }
+
+        m_activeTransfers[curl] = request;
+        started = true;
+    }
+
+    if ( started )
+    {
+        int runningHandles;
+        curl_multi_socket_action(m_handle, CURL_SOCKET_TIMEOUT, 0,
+                                 &runningHandles);
+    }
+}
+
+void wxWebSessionCURL::ScheduleQueuedRequests()
+{
+    // We can't start new transfers from inside curl callbacks, so always do
+    // it later.
+    if ( m_queuedRequests.empty() || m_queuedRequestsScheduled )
+        return;
+
+    m_queuedRequestsScheduled = true;
+    CallAfter(&wxWebSessionCURL::StartQueuedRequests);
+}
+
+void wxWebSessionCURL::RemoveQueuedRequest(wxWebRequestCURL* request)
+{
+    std::erase(m_queuedRequests, request);
+}
+
 void wxWebSessionCURL::CancelRequest(wxWebRequestCURL* request)
 {
+    RemoveQueuedRequest(request);
+
     // If this transfer is currently active, stop it.
     CURL* curl = request->GetHandle();
     StopActiveTransfer(curl);
@@ -967,11 +1173,13 @@ void wxWebSessionCURL::CancelRequest(wxWebRequestCURL* request)
 
 void wxWebSessionCURL::RequestHasTerminated(wxWebRequestCURL* request)
 {
+    RemoveQueuedRequest(request);
+
     // If this transfer is currently active, stop it.
     CURL* curl = request->GetHandle();
     StopActiveTransfer(curl);
 
-    curl_easy_cleanup(curl);
+    ReleaseHandle(curl);
 }
 
 wxVersionInfo  wxWebSessionCURL::GetLibraryVersionInfo()
@@ -1180,6 +1388,10 @@ void wxWebSessionCURL::CheckForCompletedTransfers()
             }
         }
     }
+
+    // We're not called from a curl callback, so there is no need to delay
+    // starting the transfers which can run now.
+    StartQueuedRequests();
 }
 
 void wxWebSessionCURL::FailRequest(CURL* curl,const wxString& msg)
@@ -1214,15 +1426,23 @@ void wxWebSessionCURL::StopActiveTransfer(CURL* curl)
         // Remove the CURL easy handle from the CURLM multi handle.
         curl_multi_remove_handle(m_handle, curl);
 
-        // If the transfer was active, close its socket.
-        if ( activeSocket != CURL_SOCKET_BAD )
+        // Clean up the maps.
+        RemoveActiveSocket(curl);
+        m_activeTransfers.erase(it);
+
+        // If the transfer was active, close its socket, unless it is still
+        // used by other transfers multiplexed over the same connection.
+        if ( activeSocket != CURL_SOCKET_BAD &&
+                std::none_of(m_activeSockets.begin(), m_activeSockets.end(),
+                             [activeSocket](const CurlSocketMap::value_type& v)
+                             {
+                                return v.second == activeSocket;
+                             }) )
         {
             wxCloseSocket(activeSocket);
         }
 
-        // Clean up the maps.
-        RemoveActiveSocket(curl);
-        m_activeTransfers.erase(it);
+        ScheduleQueuedRequests();
     }
 }
 
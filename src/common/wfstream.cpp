@@ -12,17 +12,38 @@ module;
 
 #include "wx/filefn.h"
 
+#ifndef WX_WINDOWS
+    #include <sys/uio.h>
+
+    #include <cerrno>
+    #include <climits>
+#endif
+
 module WX.Cmn.WFStream;
 
 import WX.Cmn.Stream;
 import WX.File.Flags;
 
+import <algorithm>;
 import <cstdint>;
+import <cstring>;
+import <typeinfo>;
 
 #if wxUSE_STREAMS
 
 #if wxUSE_FILE
 
+#ifndef WX_WINDOWS
+
+// the number of buffers passed to a single readv() or writev() call
+#ifdef IOV_MAX
+constexpr size_t MAX_IOVECS = std::min<size_t>(IOV_MAX, 64);
+#else
+constexpr size_t MAX_IOVECS = 16;
+#endif
+
+#endif // !WX_WINDOWS
+
 // ----------------------------------------------------------------------------
 // wxFileInputStream
 // ----------------------------------------------------------------------------
@@ -33,17 +54,21 @@ wxFileInputStream::wxFileInputStream(const wxString& fileName)
 {
     if ( !m_file->IsOpened() )
         m_lasterror = wxSTREAM_READ_ERROR;
+
+    SetNativeDescriptor(m_file->fd(), typeid(wxFileInputStream));
 }
 
 wxFileInputStream::wxFileInputStream(wxFile& file)
     : m_file(&file)
 {
+    SetNativeDescriptor(m_file->fd(), typeid(wxFileInputStream));
 }
 
 wxFileInputStream::wxFileInputStream(int fd)
     : m_file(new wxFile(fd)),
       m_file_destroy(true)
 {
+    SetNativeDescriptor(fd, typeid(wxFileInputStream));
 }
 
 wxFileInputStream::~wxFileInputStream()
@@ -83,6 +108,58 @@ size_t wxFileInputStream::OnSysRead(void *buffer, size_t size)
     return ret;
 }
 
+wxInputStream& wxFileInputStream::ReadV(std::span<const wxStreamIOVec> buffers)
+{
+#ifdef WX_WINDOWS
+    return wxInputStream::ReadV(buffers);
+#else
+    // the data put back into the stream must be returned first
+    if ( m_wbackcur != m_wbacksize )
+        return wxInputStream::ReadV(buffers);
+
+    m_lastcount = 0;
+
+    iovec iov[MAX_IOVECS];
+    while ( !buffers.empty() )
+    {
+        const size_t count = std::min(buffers.size(), MAX_IOVECS);
+
+        size_t total = 0;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            iov[n].iov_base = buffers[n].data;
+            iov[n].iov_len = buffers[n].size;
+            total += buffers[n].size;
+        }
+
+        ssize_t ret;
+        do
+        {
+            ret = ::readv(m_file->fd(), iov, static_cast<int>(count));
+        } while ( ret == -1 && errno == EINTR );
+
+        if ( ret == -1 )
+        {
+            m_lasterror = wxSTREAM_READ_ERROR;
+            break;
+        }
+
+        m_lastcount += ret;
+
+        if ( static_cast<size_t>(ret) != total )
+        {
+            if ( !ret )
+                m_lasterror = wxSTREAM_EOF;
+            break;
+        }
+
+        buffers = buffers.subspan(count);
+    }
+
+    return *this;
+#endif // WX_WINDOWS/!WX_WINDOWS
+}
+
 wxFileOffset wxFileInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
 {
     return m_file->Seek(pos, mode);
@@ -98,6 +175,88 @@ bool wxFileInputStream::IsOk() const
     return wxInputStream::IsOk() && m_file->IsOpened();
 }
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+wxMappedFileInputStream::wxMappedFileInputStream(const std::string& fileName)
+{
+    if ( !m_file.Open(fileName) )
+        m_lasterror = wxSTREAM_READ_ERROR;
+}
+
+wxFileOffset wxMappedFileInputStream::GetLength() const
+{
+    return m_file.IsOpened() ? static_cast<wxFileOffset>(m_file.GetSize())
+                             : wxInvalidOffset;
+}
+
+bool wxMappedFileInputStream::IsOk() const
+{
+    return wxInputStream::IsOk() && m_file.IsOpened();
+}
+
+std::span<const std::byte> wxMappedFileInputStream::GetRemainingBuffer() const
+{
+    // The data put back into the stream must be read before the data in the
+    // file, so don't give access to the latter until it's done.
+    if ( m_wbacksize > m_wbackcur )
+        return {};
+
+    return GetDirectBuffer().subspan(m_pos);
+}
+
+void wxMappedFileInputStream::Consume(size_t size)
+{
+    wxCHECK_RET( m_wbacksize <= m_wbackcur,
+                 "must read the data put back into the stream first" );
+    wxCHECK_RET( size <= m_file.GetSize() - m_pos, "consuming past the end" );
+
+    m_pos += size;
+    m_lastcount = size;
+    m_lasterror = size || m_pos < m_file.GetSize() ? wxSTREAM_NO_ERROR
+                                                   : wxSTREAM_EOF;
+}
+
+size_t wxMappedFileInputStream::OnSysRead(void *buffer, size_t size)
+{
+    const size_t count = std::min(size, m_file.GetSize() - m_pos);
+    if ( !count )
+    {
+        m_lasterror = wxSTREAM_EOF;
+        return 0;
+    }
+
+    memcpy(buffer, m_file.GetData() + m_pos, count);
+    m_pos += count;
+
+    return count;
+}
+
+wxFileOffset wxMappedFileInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
+{
+    switch ( mode )
+    {
+        case wxSeekMode::FromStart:
+            break;
+
+        case wxSeekMode::FromCurrent:
+            pos += m_pos;
+            break;
+
+        case wxSeekMode::FromEnd:
+            pos += m_file.GetSize();
+            break;
+    }
+
+    if ( pos < 0 || static_cast<std::uint64_t>(pos) > m_file.GetSize() )
+        return wxInvalidOffset;
+
+    m_pos = static_cast<size_t>(pos);
+
+    return pos;
+}
+
 // ----------------------------------------------------------------------------
 // wxFileOutputStream
 // ----------------------------------------------------------------------------
@@ -108,17 +267,21 @@ wxFileOutputStream::wxFileOutputStream(const wxString& fileName)
 {
     if (!m_file->IsOpened())
         m_lasterror = wxSTREAM_WRITE_ERROR;
+
+    SetNativeDescriptor(m_file->fd(), typeid(wxFileOutputStream));
 }
 
 wxFileOutputStream::wxFileOutputStream(wxFile& file)
     : m_file(&file)
 {
+    SetNativeDescriptor(m_file->fd(), typeid(wxFileOutputStream));
 }
 
 wxFileOutputStream::wxFileOutputStream(int fd)
     : m_file(new wxFile(fd)),
       m_file_destroy(true)
 {
+    SetNativeDescriptor(fd, typeid(wxFileOutputStream));
 }
 
 wxFileOutputStream::~wxFileOutputStream()
@@ -139,6 +302,55 @@ size_t wxFileOutputStream::OnSysWrite(const void *buffer, size_t size)
     return ret;
 }
 
+wxOutputStream& wxFileOutputStream::WriteV(std::span<const wxStreamConstIOVec> buffers)
+{
+#ifdef WX_WINDOWS
+    return wxOutputStream::WriteV(buffers);
+#else
+    m_lastcount = 0;
+
+    iovec iov[MAX_IOVECS];
+    while ( !buffers.empty() )
+    {
+        const size_t count = std::min(buffers.size(), MAX_IOVECS);
+
+        size_t total = 0;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            iov[n].iov_base = const_cast<void*>(buffers[n].data);
+            iov[n].iov_len = buffers[n].size;
+            total += buffers[n].size;
+        }
+
+        ssize_t ret;
+        do
+        {
+            ret = ::writev(m_file->fd(), iov, static_cast<int>(count));
+        } while ( ret == -1 && errno == EINTR );
+
+        if ( ret == -1 )
+        {
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            break;
+        }
+
+        m_lastcount += ret;
+
+        // As with wxFile::Write() used by OnSysWrite(), not writing all the
+        // data is an error, e.g. because the disk is full.
+        if ( static_cast<size_t>(ret) != total )
+        {
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            break;
+        }
+
+        buffers = buffers.subspan(count);
+    }
+
+    return *this;
+#endif // WX_WINDOWS/!WX_WINDOWS
+}
+
 wxFileOffset wxFileOutputStream::OnSysTell() const
 {
     return m_file->Tell();
@@ -230,6 +442,10 @@ wxFileStream::wxFileStream(const wxString& fileName)
     // the file we created above exactly once so we decide to (arbitrarily) do
     // it in wxFileInputStream
     wxFileInputStream::m_file_destroy = true;
+
+    const int fd = wxFileInputStream::m_file->fd();
+    wxFileInputStream::SetNativeDescriptor(fd, typeid(wxFileStream));
+    wxFileOutputStream::SetNativeDescriptor(fd, typeid(wxFileStream));
 }
 
 bool wxFileStream::IsOk() const
@@ -13,6 +13,8 @@ module;
 #include "wx/log.h"
 #include "wx/utils.h"
 #include "wx/scopedptr.h"
+#include "wx/private/filemap.h"
+#include "wx/private/parallel.h"
 
 #include "zlib.h"
 
@@ -25,6 +27,13 @@ import WX.Cmn.MemStream;
 import WX.Cmn.DataStream;
 import WX.Cmn.ZStream;
 
+import <chrono>;
+import <deque>;
+import <future>;
+import <memory>;
+import <unordered_map>;
+import <vector>;
+
 #if wxUSE_ZIPSTREAM
 
 // signatures for the various records (PKxx)
@@ -63,6 +72,12 @@ enum {
     OUTPUT_LATENCY = 4096
 };
 
+// The biggest entry compressed in memory by wxZipOutputStream when parallel
+// compression is enabled, the bigger ones are written out directly.
+enum {
+    PARALLEL_MAX_ENTRY_SIZE = 4 * 1024 * 1024
+};
+
 // Some offsets into the local header
 enum {
     SUMS_OFFSET  = 14
@@ -2143,6 +2158,174 @@ size_t wxZipInputStream::OnSysRead(void *buffer, size_t size)
     return count;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Deflate flags of the general purpose bit field for the compression level
+
+static int GetDeflateFlags(int level)
+{
+    switch (level) {
+        case 0: case 1:
+            return wxZIP_DEFLATE_SUPERFAST;
+        case 2: case 3: case 4:
+            return wxZIP_DEFLATE_FAST;
+        case 8: case 9:
+            return wxZIP_DEFLATE_EXTRA;
+    }
+
+    return wxZIP_DEFLATE_NORMAL;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// wxZipParallelWriter
+//
+// Used by wxZipOutputStream when parallel compression is enabled: the data of
+// the current entry is accumulated in memory and, when the entry is closed,
+// compressed by one of the worker threads. wxZipOutputStream then writes the
+// compressed entries in order, with their crc and sizes already known, so
+// that the archive is exactly the same as if they had been written directly
+// to a seekable stream.
+
+class wxZipParallelWriter
+{
+public:
+    struct Block
+    {
+        std::vector<char> m_data;
+        std::uint32_t m_crc{0};
+        wxFileOffset m_size{0};
+        int m_method{wxZIP_METHOD_STORE};
+        bool m_ok{false};
+    };
+
+    struct Pending
+    {
+        std::unique_ptr<wxZipEntry> m_entry;
+        std::future<Block> m_block;
+    };
+
+    static bool CanCompress(const wxZipEntry& entry)
+    {
+        switch (entry.GetMethod()) {
+            case wxZIP_METHOD_DEFAULT:
+            case wxZIP_METHOD_STORE:
+            case wxZIP_METHOD_DEFLATE:
+                break;
+
+            default:
+                return false;
+        }
+
+        return entry.GetSize() == wxInvalidOffset ||
+               entry.GetSize() <= PARALLEL_MAX_ENTRY_SIZE;
+    }
+
+    bool IsBuffering() const { return m_entry != nullptr; }
+
+    // Returns false if the entry grows too big to be buffered, without
+    // appending anything.
+    bool Buffer(const void *buffer, size_t size)
+    {
+        if (m_data.size() + size > PARALLEL_MAX_ENTRY_SIZE)
+            return false;
+
+        const char *p = static_cast<const char*>(buffer);
+        m_data.insert(m_data.end(), p, p + size);
+        return true;
+    }
+
+    // Start compressing the current entry.
+    void Submit(int level);
+
+    // The entries currently being compressed, in order.
+    std::deque<Pending> m_pending;
+
+    // The entry currently being written and its data.
+    std::unique_ptr<wxZipEntry> m_entry;
+    std::vector<char> m_data;
+
+    // This must be the last member, as its destructor waits for the tasks
+    // still running.
+    wxWorkerPool m_pool;
+
+private:
+    static Block Compress(const std::vector<char>& input, int level, int method);
+};
+
+/* static */ wxZipParallelWriter::Block
+wxZipParallelWriter::Compress(const std::vector<char>& input, int level, int method)
+{
+    Block block;
+    block.m_size = input.size();
+    block.m_crc = crc32(crc32(0, Z_NULL, 0),
+                        reinterpret_cast<const Bytef*>(input.data()), input.size());
+
+    const bool isDefault = method == wxZIP_METHOD_DEFAULT;
+
+    // Same choice as made by wxZipOutputStream::OpenCompressor().
+    if (isDefault)
+        method = level == 0 || input.size() <= 6 ? wxZIP_METHOD_STORE
+                                                 : wxZIP_METHOD_DEFLATE;
+
+    if (method == wxZIP_METHOD_DEFLATE) {
+        z_stream_s z;
+        memset(&z, 0, sizeof(z));
+
+        if (deflateInit2(&z, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return block;
+
+        block.m_data.resize(deflateBound(&z, input.size()));
+
+        z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        z.avail_in = input.size();
+        z.next_out = reinterpret_cast<Bytef*>(block.m_data.data());
+        z.avail_out = block.m_data.size();
+
+        // The output buffer is big enough for the whole data to be
+        // compressed in a single call.
+        const int err = deflate(&z, Z_FINISH);
+        block.m_data.resize(z.total_out);
+        deflateEnd(&z);
+
+        if (err != Z_STREAM_END)
+            return block;
+
+        // As in wxZipOutputStream::CreatePendingEntry(), store the data if
+        // compressing it didn't make it smaller.
+        if (block.m_data.size() < input.size() || !isDefault) {
+            block.m_method = method;
+            block.m_ok = true;
+            return block;
+        }
+    }
+
+    block.m_data = input;
+    block.m_method = wxZIP_METHOD_STORE;
+    block.m_ok = true;
+
+    return block;
+}
+
+void wxZipParallelWriter::Submit(int level)
+{
+    if (m_entry->GetMethod() != wxZIP_METHOD_STORE)
+        m_entry->SetFlags((m_entry->GetFlags() & ~wxZIP_DEFLATE_MASK) |
+                          GetDeflateFlags(level));
+
+    const int method = m_entry->GetMethod();
+
+    m_pending.push_back({
+        std::move(m_entry),
+        m_pool.Submit([input = std::move(m_data), level, method]()
+            {
+                return Compress(input, level, method);
+            })
+    });
+
+    m_data.clear();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Output stream
 
@@ -2178,6 +2361,7 @@ wxZipOutputStream::~wxZipOutputStream()
     delete m_store;
     delete m_deflate;
     delete m_pending;
+    delete m_parallel;
     delete [] m_initialData;
     if (m_backlink)
         m_backlink->Release(this);
@@ -2246,6 +2430,21 @@ bool wxZipOutputStream::CopyArchiveMetaData(wxArchiveInputStream& stream)
     return CopyArchiveMetaData(static_cast<wxZipInputStream&>(stream));
 }
 
+void wxZipOutputStream::EnableParallelCompression(bool enable /*=true*/)
+{
+    if (enable == IsParallelCompressionEnabled())
+        return;
+
+    if (enable) {
+        m_parallel = new wxZipParallelWriter;
+    } else {
+        if (m_parallel->IsBuffering())
+            StreamParallelEntry();
+        WriteParallelEntries(0);
+        wxDELETE(m_parallel);
+    }
+}
+
 void wxZipOutputStream::SetLevel(int level)
 {
     if (level != m_level) {
@@ -2260,6 +2459,23 @@ bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
 {
     CloseEntry();
 
+    if (m_parallel && entry) {
+        if (!raw && wxZipParallelWriter::CanCompress(*entry)) {
+            m_parallel->m_entry.reset(entry);
+            m_lasterror = wxSTREAM_NO_ERROR;
+            return true;
+        }
+
+        // Any other entries are written directly, so all the preceding ones
+        // must be written first.
+        WriteParallelEntries(0);
+    }
+
+    return DoCreateStreamed(entry, raw);
+}
+
+bool wxZipOutputStream::DoCreateStreamed(wxZipEntry *entry, bool raw)
+{
     m_pending = entry;
     if (!m_pending)
         return false;
@@ -2269,7 +2485,26 @@ bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
     ds << LOCAL_MAGIC;
 
     // and if this is the first entry test for seekability
-    if (m_headerOffset == 0 && m_parent_o_stream->IsSeekable()) {
+    if (m_headerOffset == 0)
+        CheckParentSeekable();
+
+    m_pending->SetOffset(m_headerOffset);
+
+    m_crcAccumulator = crc32(0, Z_NULL, 0);
+
+    if (raw)
+        m_raw = true;
+
+    m_lasterror = wxSTREAM_NO_ERROR;
+    return true;
+}
+
+// Called just after writing the signature of the first entry to determine
+// whether the local headers can be fixed up after writing the data.
+//
+void wxZipOutputStream::CheckParentSeekable()
+{
+    if (m_parent_o_stream->IsSeekable()) {
 #if wxUSE_LOG
         bool logging = wxLog::IsEnabled();
         wxLogNull nolog;
@@ -2286,16 +2521,6 @@ bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
             }
         }
     }
-
-    m_pending->SetOffset(m_headerOffset);
-
-    m_crcAccumulator = crc32(0, Z_NULL, 0);
-
-    if (raw)
-        m_raw = true;
-
-    m_lasterror = wxSTREAM_NO_ERROR;
-    return true;
 }
 
 // Can be overridden to add support for additional compression methods
@@ -2328,20 +2553,8 @@ wxOutputStream *wxZipOutputStream::OpenCompressor(
 
         case wxZIP_METHOD_DEFLATE:
         {
-            int defbits = wxZIP_DEFLATE_NORMAL;
-            switch (GetLevel()) {
-                case 0: case 1:
-                    defbits = wxZIP_DEFLATE_SUPERFAST;
-                    break;
-                case 2: case 3: case 4:
-                    defbits = wxZIP_DEFLATE_FAST;
-                    break;
-                case 8: case 9:
-                    defbits = wxZIP_DEFLATE_EXTRA;
-                    break;
-            }
             entry.SetFlags((entry.GetFlags() & ~wxZIP_DEFLATE_MASK) |
-                            defbits | wxZIP_SUMS_FOLLOW);
+                            GetDeflateFlags(GetLevel()) | wxZIP_SUMS_FOLLOW);
 
             if (!m_deflate)
                 m_deflate = new wxZlibOutputStream2(stream, GetLevel());
@@ -2462,12 +2675,87 @@ void wxZipOutputStream::CreatePendingEntry()
     m_lasterror = m_parent_o_stream->GetLastError();
 }
 
+// Called when the entry being buffered for parallel compression turns out to
+// be too big for it: write it directly instead, after the preceding entries.
+//
+void wxZipOutputStream::StreamParallelEntry()
+{
+    wxZipEntry *entry = m_parallel->m_entry.release();
+    const std::vector<char> data = std::move(m_parallel->m_data);
+    m_parallel->m_data.clear();
+    m_entrySize = 0;
+
+    if (!WriteParallelEntries(0)) {
+        delete entry;
+        return;
+    }
+
+    if (DoCreateStreamed(entry, false))
+        OnSysWrite(data.data(), data.size());
+}
+
+// Write out the entries compressed by the worker threads in order, waiting
+// for them until no more than maxPending ones remain.
+//
+bool wxZipOutputStream::WriteParallelEntries(size_t maxPending)
+{
+    auto& pending = m_parallel->m_pending;
+
+    while (!pending.empty()) {
+        wxZipParallelWriter::Pending& next = pending.front();
+        if (pending.size() <= maxPending &&
+            next.m_block.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            break;
+
+        std::unique_ptr<wxZipEntry> entry = std::move(next.m_entry);
+        const wxZipParallelWriter::Block block = next.m_block.get();
+        pending.pop_front();
+
+        // Discard all the remaining entries after an error.
+        if (!IsOk())
+            continue;
+
+        if (!block.m_ok) {
+            wxLogError(_("error writing zip entry '%s': can't compress"),
+                       entry->GetName().c_str());
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            continue;
+        }
+
+        wxDataOutputStream ds(*m_parent_o_stream);
+        ds << LOCAL_MAGIC;
+
+        if (m_headerOffset == 0)
+            CheckParentSeekable();
+
+        entry->SetOffset(m_headerOffset);
+        entry->SetMethod(block.m_method);
+        entry->SetCrc(block.m_crc);
+        entry->SetSize(block.m_size);
+        entry->SetCompressedSize(block.m_data.size());
+        entry->m_Flags &= ~wxZIP_SUMS_FOLLOW;
+
+        const size_t headerSize =
+            entry->WriteLocal(*m_parent_o_stream, GetConv(), m_format);
+        m_parent_o_stream->Write(block.m_data.data(), block.m_data.size());
+        m_lasterror = m_parent_o_stream->GetLastError();
+
+        m_headerOffset += headerSize + block.m_data.size();
+        m_entries.push_back(entry.release());
+    }
+
+    return IsOk();
+}
+
 // Write the 'central directory' and the 'end-central-directory' records.
 //
 bool wxZipOutputStream::Close()
 {
     CloseEntry();
 
+    if (m_parallel)
+        WriteParallelEntries(0);
+
     if (m_lasterror == wxSTREAM_WRITE_ERROR
         || (m_entries.size() == 0 && m_endrecWritten))
     {
@@ -2507,6 +2795,20 @@ bool wxZipOutputStream::Close()
 //
 bool wxZipOutputStream::CloseEntry()
 {
+    if (m_parallel && m_parallel->IsBuffering()) {
+        if (IsOk())
+            m_parallel->Submit(GetLevel());
+        else
+            m_parallel->m_entry.reset();
+
+        m_parallel->m_data.clear();
+        m_entrySize = 0;
+
+        // Limit the memory used by the entries in flight by waiting for them
+        // if the output can't keep up.
+        return WriteParallelEntries(4 * m_parallel->m_pool.GetThreadCount());
+    }
+
     if (IsOk() && m_pending)
         CreatePendingEntry();
     if (!IsOk())
@@ -2584,6 +2886,8 @@ bool wxZipOutputStream::CloseEntry()
 
 void wxZipOutputStream::Sync()
 {
+    if (m_parallel && m_parallel->IsBuffering())
+        StreamParallelEntry();
     if (IsOk() && m_pending)
         CreatePendingEntry(nullptr, 0);
     if (!m_comp)
@@ -2596,6 +2900,18 @@ void wxZipOutputStream::Sync()
 
 size_t wxZipOutputStream::OnSysWrite(const void *buffer, size_t size)
 {
+    if (m_parallel && m_parallel->IsBuffering()) {
+        if (!IsOk())
+            return 0;
+
+        if (m_parallel->Buffer(buffer, size)) {
+            m_entrySize += size;
+            return size;
+        }
+
+        StreamParallelEntry();
+    }
+
     if (IsOk() && m_pending) {
         if (m_initialSize + size < OUTPUT_LATENCY) {
             memcpy(m_initialData + m_initialSize, buffer, size);
@@ -2619,4 +2935,137 @@ size_t wxZipOutputStream::OnSysWrite(const void *buffer, size_t size)
     return m_comp->LastWrite();
 }
 
+
+
+/////////////////////////////////////////////////////////////////////////////
+// wxZipReader
+
+class wxZipReaderImpl
+{
+public:
+    wxMappedFile m_file;
+
+    // All the entries, in the order of the central directory.
+    std::vector<std::unique_ptr<wxZipEntry>> m_entries;
+
+    // Index of the entries by their names in Unix format.
+    std::unordered_map<std::string, const wxZipEntry*> m_index;
+
+    bool m_ok{false};
+};
+
+wxZipReader::wxZipReader(const std::string& filename, wxMBConv& conv)
+    : m_impl(std::make_unique<wxZipReaderImpl>())
+{
+    if ( !m_impl->m_file.Open(filename) )
+        return;
+
+    // Reading the archive from a seekable stream makes wxZipInputStream use
+    // the central directory, so the local headers are not visited at all.
+    const auto data = m_impl->m_file.GetSpan();
+    wxMemoryInputStream stream(data.data(), data.size());
+    wxZipInputStream zip(stream, conv);
+
+    const int total = zip.GetTotalEntries();
+    if ( total > 0 )
+    {
+        m_impl->m_entries.reserve(total);
+        m_impl->m_index.reserve(total);
+    }
+
+    while ( wxZipEntry *entry = zip.GetNextEntry() )
+    {
+        m_impl->m_entries.emplace_back(entry);
+
+        // If there are several entries with the same name, the first one
+        // wins, as with the sequential search.
+        m_impl->m_index.emplace(entry->GetName(wxPATH_UNIX).ToStdString(),
+                                entry);
+    }
+
+    m_impl->m_ok = zip.GetLastError() == wxSTREAM_EOF;
+}
+
+wxZipReader::~wxZipReader() = default;
+
+bool wxZipReader::IsOk() const
+{
+    return m_impl->m_ok;
+}
+
+size_t wxZipReader::GetCount() const
+{
+    return m_impl->m_entries.size();
+}
+
+const wxZipEntry *wxZipReader::GetEntry(size_t n) const
+{
+    wxCHECK_MSG( n < GetCount(), nullptr, "invalid zip entry index" );
+
+    return m_impl->m_entries[n].get();
+}
+
+const wxZipEntry *wxZipReader::FindEntry(const std::string& name) const
+{
+    const auto it = m_impl->m_index.find(name);
+
+    return it != m_impl->m_index.end() ? it->second : nullptr;
+}
+
+std::span<const std::byte> wxZipReader::GetRawData(const wxZipEntry& entry) const
+{
+    const auto data = m_impl->m_file.GetSpan();
+
+    // The central directory doesn't give the length of the local header,
+    // as its extra field may be different, so it must be read here.
+    const std::uint64_t offset = entry.GetOffset();
+    if ( offset > data.size() || data.size() - offset < LOCAL_SIZE )
+        return {};
+
+    const char *local = reinterpret_cast<const char*>(data.data() + offset);
+    if ( CrackUint32(local) != LOCAL_MAGIC )
+        return {};
+
+    const std::uint64_t start = offset + LOCAL_SIZE
+                                + CrackUint16(local + 26)   // name length
+                                + CrackUint16(local + 28);  // extra length
+    const std::uint64_t size = entry.GetCompressedSize();
+    if ( start > data.size() || data.size() - start < size )
+        return {};
+
+    return data.subspan(start, size);
+}
+
+std::span<const std::byte> wxZipReader::GetStoredData(const wxZipEntry& entry) const
+{
+    if ( entry.GetMethod() != wxZIP_METHOD_STORE ||
+            (entry.GetFlags() & wxZIP_ENCRYPTED) )
+        return {};
+
+    return GetRawData(entry);
+}
+
+wxInputStream *wxZipReader::OpenEntry(const wxZipEntry& entry) const
+{
+    if ( entry.GetFlags() & wxZIP_ENCRYPTED )
+        return nullptr;
+
+    const auto raw = GetRawData(entry);
+    if ( raw.empty() && entry.GetCompressedSize() != 0 )
+        return nullptr;
+
+    switch ( entry.GetMethod() )
+    {
+        case wxZIP_METHOD_STORE:
+            return new wxMemoryInputStream(raw.data(), raw.size());
+
+        case wxZIP_METHOD_DEFLATE:
+            return new wxZlibInputStream(
+                            new wxMemoryInputStream(raw.data(), raw.size()),
+                            wxZLIB_NO_HEADER);
+    }
+
+    return nullptr;
+}
+
 #endif // wxUSE_ZIPSTREAM
@@ -0,0 +1,451 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/zstdstream.cpp
+// Purpose:     Implementation of Zstandard stream classes
+// Copyright:   (c) 2021 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#if wxUSE_ZSTD && wxUSE_STREAMS
+
+#include "wx/zstdstream.h"
+#include "wx/log.h"
+#include "wx/translation.h"
+
+#include <zstd.h>
+#include <zdict.h>
+
+namespace wxPrivate
+{
+
+// ----------------------------------------------------------------------------
+// Private helpers
+// ----------------------------------------------------------------------------
+
+// Holds either the compression or the decompression context, together with
+// the buffer used for the data read from or written to the underlying stream.
+struct wxZstdStream
+{
+    ~wxZstdStream()
+    {
+        ZSTD_freeCCtx(cctx);
+
+        if ( ownsDCtx )
+            ZSTD_freeDCtx(dctx);
+    }
+
+    ZSTD_CCtx* cctx{nullptr};
+
+    ZSTD_DCtx* dctx{nullptr};
+    bool ownsDCtx{false};
+
+    std::vector<std::uint8_t> buf;
+
+    // The part of the buffer not consumed by the decompressor yet.
+    ZSTD_inBuffer in{nullptr, 0, 0};
+
+    // True if the decompressor may still have some output to flush even if
+    // it doesn't need any more input.
+    bool needsFlush{false};
+
+    // True if the last decompressed frame was complete.
+    bool frameDone{false};
+};
+
+} // namespace wxPrivate
+
+using namespace wxPrivate;
+
+// ============================================================================
+// implementation
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Functions
+// ----------------------------------------------------------------------------
+
+wxVersionInfo wxGetLibZstdVersionInfo()
+{
+    const unsigned ver = ZSTD_versionNumber();
+
+    return {"libzstd",
+            VersionNumbering{static_cast<int>(ver / 10000),
+                             static_cast<int>((ver % 10000) / 100),
+                             static_cast<int>(ver % 100)}};
+}
+
+std::vector<std::uint8_t>
+wxZstdTrainDictionary(const std::vector<std::vector<std::uint8_t>>& samples,
+                      size_t maxSize)
+{
+    // The samples must be passed to the trainer as a single buffer.
+    std::vector<std::uint8_t> data;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for ( const auto& sample : samples )
+    {
+        data.insert(data.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    std::vector<std::uint8_t> dict(maxSize);
+    const size_t rc = ZDICT_trainFromBuffer(dict.data(), dict.size(),
+                                            data.data(), sizes.data(),
+                                            static_cast<unsigned>(sizes.size()));
+    if ( ZDICT_isError(rc) )
+    {
+        wxLogError(_("Failed to create Zstandard dictionary: %s"),
+                   ZDICT_getErrorName(rc));
+        return {};
+    }
+
+    dict.resize(rc);
+    return dict;
+}
+
+// ----------------------------------------------------------------------------
+// wxZstdData: common helpers for compression and decompression
+// ----------------------------------------------------------------------------
+
+wxZstdData::wxZstdData()
+{
+    m_stream = new wxZstdStream;
+    m_pos = 0;
+}
+
+wxZstdData::~wxZstdData()
+{
+    delete m_stream;
+}
+
+// ----------------------------------------------------------------------------
+// wxZstdDecompressionContext
+// ----------------------------------------------------------------------------
+
+wxZstdDecompressionContext::wxZstdDecompressionContext()
+    : m_dctx(ZSTD_createDCtx())
+{
+    if ( !m_dctx )
+        wxLogError(_("Failed to allocate memory for Zstandard decompression."));
+}
+
+wxZstdDecompressionContext::~wxZstdDecompressionContext()
+{
+    ZSTD_freeDCtx(m_dctx);
+}
+
+bool wxZstdDecompressionContext::LoadDictionary(const void* data, size_t size)
+{
+    wxCHECK_MSG( m_dctx, false, "invalid decompression context" );
+
+    const size_t rc = ZSTD_DCtx_loadDictionary(m_dctx, data, size);
+    if ( ZSTD_isError(rc) )
+    {
+        wxLogError(_("Failed to load Zstandard dictionary: %s"),
+                   ZSTD_getErrorName(rc));
+        return false;
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// wxZstdInputStream: decompression
+// ----------------------------------------------------------------------------
+
+void wxZstdInputStream::Init(wxZstdDecompressionContext* context)
+{
+    if ( context )
+    {
+        m_stream->dctx = context->m_dctx;
+
+        // Forget about the previous stream, but keep the parameters and the
+        // dictionary, if any.
+        if ( m_stream->dctx )
+            ZSTD_DCtx_reset(m_stream->dctx, ZSTD_reset_session_only);
+    }
+    else
+    {
+        m_stream->dctx = ZSTD_createDCtx();
+        m_stream->ownsDCtx = true;
+    }
+
+    if ( !m_stream->dctx )
+    {
+        wxLogError(_("Failed to allocate memory for Zstandard decompression."));
+        m_lasterror = wxSTREAM_READ_ERROR;
+        return;
+    }
+
+    m_stream->buf.resize(ZSTD_DStreamInSize());
+}
+
+bool wxZstdInputStream::SetDictionary(const void* data, size_t size)
+{
+    wxCHECK_MSG( m_stream->dctx, false, "invalid decompression stream" );
+    wxCHECK_MSG( !m_pos, false, "must be called before reading" );
+
+    const size_t rc = ZSTD_DCtx_loadDictionary(m_stream->dctx, data, size);
+    if ( ZSTD_isError(rc) )
+    {
+        wxLogError(_("Failed to load Zstandard dictionary: %s"),
+                   ZSTD_getErrorName(rc));
+        return false;
+    }
+
+    return true;
+}
+
+size_t wxZstdInputStream::OnSysRead(void* outbuf, size_t size)
+{
+    ZSTD_outBuffer out = { outbuf, size, 0 };
+    ZSTD_inBuffer& in = m_stream->in;
+
+    // Decompress input as long as we don't have any errors (including EOF, as
+    // it doesn't make sense to continue after it neither) and have space to
+    // decompress it to.
+    while ( m_lasterror == wxSTREAM_NO_ERROR && out.pos < out.size )
+    {
+        // Get more input data if needed.
+        if ( in.pos == in.size && !m_stream->needsFlush )
+        {
+            m_parent_i_stream->Read(m_stream->buf.data(), m_stream->buf.size());
+            in.src = m_stream->buf.data();
+            in.size = m_parent_i_stream->LastRead();
+            in.pos = 0;
+
+            if ( !in.size )
+            {
+                if ( m_parent_i_stream->GetLastError() != wxSTREAM_EOF )
+                {
+                    m_lasterror = wxSTREAM_READ_ERROR;
+                    return 0;
+                }
+
+                // We have reached end of the underlying stream, which is only
+                // fine if it didn't happen in the middle of a frame.
+                if ( !m_stream->frameDone )
+                {
+                    wxLogError(_("Zstandard decompression error: %s"),
+                               _("input is truncated"));
+                    m_lasterror = wxSTREAM_READ_ERROR;
+                    return 0;
+                }
+
+                m_lasterror = wxSTREAM_EOF;
+                break;
+            }
+        }
+
+        // Do decompress: notice that several concatenated frames are
+        // decompressed one after another transparently.
+        const size_t rc = ZSTD_decompressStream(m_stream->dctx, &out, &in);
+        if ( ZSTD_isError(rc) )
+        {
+            wxLogError(_("Zstandard decompression error: %s"),
+                       ZSTD_getErrorName(rc));
+
+            m_lasterror = wxSTREAM_READ_ERROR;
+            return 0;
+        }
+
+        m_stream->frameDone = rc == 0;
+        m_stream->needsFlush = out.pos == out.size;
+    }
+
+    // Return the number of bytes actually read, this may be less than the
+    // requested size if we hit EOF.
+    m_pos += out.pos;
+    return out.pos;
+}
+
+// ----------------------------------------------------------------------------
+// wxZstdOutputStream: compression
+// ----------------------------------------------------------------------------
+
+void wxZstdOutputStream::Init(int level, unsigned threads)
+{
+    m_stream->cctx = ZSTD_createCCtx();
+    if ( !m_stream->cctx )
+    {
+        wxLogError(_("Failed to allocate memory for Zstandard compression."));
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+        return;
+    }
+
+    if ( level == -1 )
+        level = ZSTD_CLEVEL_DEFAULT;
+
+    size_t rc = ZSTD_CCtx_setParameter(m_stream->cctx,
+                                       ZSTD_c_compressionLevel, level);
+    if ( !ZSTD_isError(rc) )
+        rc = ZSTD_CCtx_setParameter(m_stream->cctx, ZSTD_c_checksumFlag, 1);
+
+    if ( ZSTD_isError(rc) )
+    {
+        wxLogError(_("Failed to initialize Zstandard compression: %s"),
+                   ZSTD_getErrorName(rc));
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+        return;
+    }
+
+    if ( threads )
+    {
+        // This fails if the library was built without threads support, but
+        // compressing in the current thread works as well, just slower.
+        rc = ZSTD_CCtx_setParameter(m_stream->cctx, ZSTD_c_nbWorkers, threads);
+        if ( ZSTD_isError(rc) )
+        {
+            wxLogDebug("Multithreaded Zstandard compression not available: %s",
+                       ZSTD_getErrorName(rc));
+        }
+    }
+
+    m_stream->buf.resize(ZSTD_CStreamOutSize());
+}
+
+bool wxZstdOutputStream::SetDictionary(const void* data, size_t size)
+{
+    wxCHECK_MSG( m_stream->cctx, false, "invalid compression stream" );
+    wxCHECK_MSG( !m_pos, false, "must be called before writing" );
+
+    const size_t rc = ZSTD_CCtx_loadDictionary(m_stream->cctx, data, size);
+    if ( ZSTD_isError(rc) )
+    {
+        wxLogError(_("Failed to load Zstandard dictionary: %s"),
+                   ZSTD_getErrorName(rc));
+        return false;
+    }
+
+    return true;
+}
+
+size_t wxZstdOutputStream::OnSysWrite(const void *inbuf, size_t size)
+{
+    if ( !m_stream->cctx )
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+
+    ZSTD_inBuffer in = { inbuf, size, 0 };
+
+    // Compress as long as we have any input data, but stop at first error as
+    // it's useless to try to continue after it (or even starting if the stream
+    // had already been in an error state).
+    while ( m_lasterror == wxSTREAM_NO_ERROR && in.pos < in.size )
+    {
+        ZSTD_outBuffer out = { m_stream->buf.data(), m_stream->buf.size(), 0 };
+
+        const size_t rc = ZSTD_compressStream2(m_stream->cctx, &out, &in,
+                                               ZSTD_e_continue);
+        if ( ZSTD_isError(rc) )
+        {
+            wxLogError(_("Zstandard compression error: %s"),
+                       ZSTD_getErrorName(rc));
+
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            return 0;
+        }
+
+        if ( !WriteOutput(out.pos) )
+            return 0;
+    }
+
+    if ( m_lasterror != wxSTREAM_NO_ERROR )
+        return 0;
+
+    m_pos += size;
+    return size;
+}
+
+bool wxZstdOutputStream::WriteOutput(size_t size)
+{
+    m_parent_o_stream->Write(m_stream->buf.data(), size);
+    if ( m_parent_o_stream->LastWrite() != size )
+    {
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+        return false;
+    }
+
+    return true;
+}
+
+bool wxZstdOutputStream::DoFlush(bool finish)
+{
+    if ( !m_stream->cctx )
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+
+    ZSTD_inBuffer in = { nullptr, 0, 0 };
+
+    while ( m_lasterror == wxSTREAM_NO_ERROR )
+    {
+        ZSTD_outBuffer out = { m_stream->buf.data(), m_stream->buf.size(), 0 };
+
+        // The return value is the amount of data remaining to be flushed.
+        const size_t rc = ZSTD_compressStream2(m_stream->cctx, &out, &in,
+                                               finish ? ZSTD_e_end
+                                                      : ZSTD_e_flush);
+        if ( ZSTD_isError(rc) )
+        {
+            wxLogError(_("Zstandard compression error when flushing output: %s"),
+                       ZSTD_getErrorName(rc));
+
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+            break;
+        }
+
+        if ( !WriteOutput(out.pos) )
+            break;
+
+        if ( !rc )
+            return true;
+    }
+
+    return false;
+}
+
+bool wxZstdOutputStream::Close()
+{
+    // Don't write another, empty, frame if we had been already closed.
+    if ( !m_stream->cctx )
+        return IsOk();
+
+    const bool ok = DoFlush(true);
+
+    ZSTD_freeCCtx(m_stream->cctx);
+    m_stream->cctx = nullptr;
+
+    return ok && wxFilterOutputStream::Close() && IsOk();
+}
+
+// ----------------------------------------------------------------------------
+// wxZstdClassFactory: allow creating streams from extension/MIME type
+// ----------------------------------------------------------------------------
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxZstdClassFactory, wxFilterClassFactory);
+
+static wxZstdClassFactory g_wxZstdClassFactory;
+
+wxZstdClassFactory::wxZstdClassFactory()
+{
+    if ( this == &g_wxZstdClassFactory )
+        PushFront();
+}
+
+const wxChar * const *
+wxZstdClassFactory::GetProtocols(wxStreamProtocolType type) const
+{
+    static const wxChar *mime[] = { "application/zstd", nullptr };
+    static const wxChar *encs[] = { "zstd", nullptr };
+    static const wxChar *exts[] = { ".zst", nullptr };
+
+    const wxChar* const* ret = nullptr;
+    switch ( type )
+    {
+        case wxSTREAM_PROTOCOL: ret = encs; break;
+        case wxSTREAM_MIMETYPE: ret = mime; break;
+        case wxSTREAM_ENCODING: ret = encs; break;
+        case wxSTREAM_FILEEXT:  ret = exts; break;
+    }
+
+    return ret;
+}
+
+#endif // wxUSE_ZSTD && wxUSE_STREAMS
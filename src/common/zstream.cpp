@@ -13,6 +13,7 @@ module;
 #include "wx/intl.h"
 #include "wx/log.h"
 #include "wx/utils.h"
+#include "wx/private/parallel.h"
 
 // normally, the compiler options should contain -I../zlib, but it is
 // apparently not the case for all MSW makefiles and so, unless we use
@@ -30,6 +31,12 @@ module WX.Cmn.ZStream;
 
 import WX.Utils.VersionInfo;
 
+import <algorithm>;
+import <chrono>;
+import <deque>;
+import <future>;
+import <vector>;
+
 #if wxUSE_ZLIB && wxUSE_STREAMS
 
 enum {
@@ -82,8 +89,12 @@ wxZlibClassFactory::GetProtocols(wxStreamProtocolType type) const
 
 static wxGzipClassFactory g_wxGzipClassFactory;
 
-wxGzipClassFactory::wxGzipClassFactory()
+wxGzipClassFactory::wxGzipClassFactory(int outputFlags)
+    : m_outputFlags(outputFlags)
 {
+    wxASSERT_MSG( (outputFlags & ~wxZLIB_PARALLEL) == 0,
+                  "only wxZLIB_PARALLEL can be used with the gzip factory" );
+
     if (this == &g_wxGzipClassFactory && wxZlibInputStream::CanHandleGZip())
         PushFront();
 }
@@ -264,6 +275,301 @@ bool wxZlibInputStream::SetDictionary(const wxMemoryBuffer &buf)
 }
 
 
+//////////////////////////
+// wxZlibParallelDeflater
+//////////////////////////
+
+// The input is compressed in blocks of this size, which is big enough for the
+// loss of compression at the block boundaries to be negligible.
+constexpr size_t ZSTREAM_PARALLEL_BLOCK_SIZE = 128 * 1024;
+
+// Each block is compressed using the end of the preceding input, up to the
+// maximal deflate window size, as dictionary, so that the matches crossing
+// the block boundaries are still found.
+constexpr size_t ZSTREAM_PARALLEL_DICT_SIZE = 32 * 1024;
+
+namespace
+{
+
+bool WriteAll(wxOutputStream& out, const void *data, size_t len)
+{
+  return out.Write(data, len).LastWrite() == len;
+}
+
+} // anonymous namespace
+
+// Produces a single deflate stream by compressing the blocks independently,
+// each of them but the last one ending with a sync flush to align it on a byte
+// boundary, and concatenating the results. The header and the trailer, whose
+// checksum is combined from the checksums of the individual blocks, are
+// written separately.
+class wxZlibParallelDeflater
+{
+public:
+  wxZlibParallelDeflater(int level, int flags)
+    : m_level(level),
+      m_flags(flags),
+      m_check(flags == wxZLIB_GZIP ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0))
+  {
+    m_input.reserve(ZSTREAM_PARALLEL_BLOCK_SIZE);
+  }
+
+  // Consume all the data, writing the compressed output already available.
+  bool Write(wxOutputStream& out, const unsigned char *data, size_t size);
+
+  // Write out all the data consumed so far, terminating the stream if final.
+  bool Flush(wxOutputStream& out, bool final);
+
+private:
+  struct Block
+  {
+    std::vector<unsigned char> output;
+    uLong check{0};
+    size_t size{0};
+    bool ok{false};
+  };
+
+  static Block Compress(int level,
+                        int flags,
+                        const std::vector<unsigned char>& input,
+                        const std::vector<unsigned char>& dict,
+                        bool last);
+
+  // Start compressing the data accumulated in m_input.
+  void SubmitBlock(bool last);
+
+  // Write out the compressed blocks in order, waiting for them until no more
+  // than maxPending ones remain.
+  bool WriteBlocks(wxOutputStream& out, size_t maxPending);
+
+  bool WriteHeader(wxOutputStream& out) const;
+  bool WriteTrailer(wxOutputStream& out) const;
+
+  const int m_level;
+  const int m_flags;
+
+  std::vector<unsigned char> m_input;
+  std::vector<unsigned char> m_dict;
+
+  std::deque<std::future<Block>> m_pending;
+
+  uLong m_check;
+  uLong m_totalSize{0};
+  bool m_headerWritten{false};
+
+  // This must be the last member, as its destructor waits for the tasks
+  // still running.
+  wxWorkerPool m_pool;
+};
+
+/* static */ wxZlibParallelDeflater::Block
+wxZlibParallelDeflater::Compress(int level,
+                                 int flags,
+                                 const std::vector<unsigned char>& input,
+                                 const std::vector<unsigned char>& dict,
+                                 bool last)
+{
+  Block block;
+  block.size = input.size();
+
+  switch (flags) {
+    case wxZLIB_ZLIB:
+      block.check = adler32(adler32(0, Z_NULL, 0), input.data(), input.size());
+      break;
+
+    case wxZLIB_GZIP:
+      block.check = crc32(crc32(0, Z_NULL, 0), input.data(), input.size());
+      break;
+  }
+
+  z_stream_s z;
+  memset(&z, 0, sizeof(z));
+
+  if (deflateInit2(&z, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return block;
+
+  if (!dict.empty())
+    deflateSetDictionary(&z, dict.data(), dict.size());
+
+  z.next_in = const_cast<unsigned char*>(input.data());
+  z.avail_in = input.size();
+
+  // The sync flush marker is not accounted for by deflateBound(), but it's
+  // simpler to just grow the buffer if it turns out to be too small anyhow.
+  block.output.resize(deflateBound(&z, input.size()) + 16);
+
+  int err;
+  for (;;) {
+    z.next_out = block.output.data() + z.total_out;
+    z.avail_out = block.output.size() - z.total_out;
+
+    err = deflate(&z, last ? Z_FINISH : Z_SYNC_FLUSH);
+    if (err != Z_OK || z.avail_out != 0)
+      break;
+
+    block.output.resize(2 * block.output.size());
+  }
+
+  block.output.resize(z.total_out);
+  block.ok = err == (last ? Z_STREAM_END : Z_OK);
+
+  deflateEnd(&z);
+
+  return block;
+}
+
+void wxZlibParallelDeflater::SubmitBlock(bool last)
+{
+  std::vector<unsigned char> dict = m_dict;
+
+  // Remember the end of the input to use it as dictionary for the next block.
+  m_dict.insert(m_dict.end(), m_input.begin() + (m_input.size() -
+                std::min(m_input.size(), ZSTREAM_PARALLEL_DICT_SIZE)), m_input.end());
+  if (m_dict.size() > ZSTREAM_PARALLEL_DICT_SIZE)
+    m_dict.erase(m_dict.begin(), m_dict.end() - ZSTREAM_PARALLEL_DICT_SIZE);
+
+  m_pending.push_back(m_pool.Submit(
+    [level = m_level, flags = m_flags, input = std::move(m_input),
+     dict = std::move(dict), last]()
+    {
+      return Compress(level, flags, input, dict, last);
+    }));
+
+  m_input.clear();
+  m_input.reserve(ZSTREAM_PARALLEL_BLOCK_SIZE);
+}
+
+bool wxZlibParallelDeflater::WriteBlocks(wxOutputStream& out, size_t maxPending)
+{
+  if (!m_headerWritten) {
+    if (!WriteHeader(out))
+      return false;
+
+    m_headerWritten = true;
+  }
+
+  while (!m_pending.empty()) {
+    std::future<Block>& next = m_pending.front();
+    if (m_pending.size() <= maxPending &&
+        next.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      break;
+
+    const Block block = next.get();
+    m_pending.pop_front();
+
+    if (!block.ok || !WriteAll(out, block.output.data(), block.output.size()))
+      return false;
+
+    switch (m_flags) {
+      case wxZLIB_ZLIB:
+        m_check = adler32_combine(m_check, block.check, block.size);
+        break;
+
+      case wxZLIB_GZIP:
+        m_check = crc32_combine(m_check, block.check, block.size);
+        break;
+    }
+
+    // Gzip only stores the size modulo 2^32, so overflow is fine here.
+    m_totalSize += block.size;
+  }
+
+  return true;
+}
+
+bool wxZlibParallelDeflater::Write(wxOutputStream& out,
+                                   const unsigned char *data,
+                                   size_t size)
+{
+  while (size) {
+    const size_t len = std::min(size, ZSTREAM_PARALLEL_BLOCK_SIZE - m_input.size());
+    m_input.insert(m_input.end(), data, data + len);
+    data += len;
+    size -= len;
+
+    if (m_input.size() == ZSTREAM_PARALLEL_BLOCK_SIZE) {
+      SubmitBlock(false);
+
+      // Limit the amount of memory used by the blocks in flight by waiting
+      // for them if the output can't keep up with the input.
+      if (!WriteBlocks(out, 2 * m_pool.GetThreadCount()))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+bool wxZlibParallelDeflater::Flush(wxOutputStream& out, bool final)
+{
+  if (final || !m_input.empty())
+    SubmitBlock(final);
+
+  if (!WriteBlocks(out, 0))
+    return false;
+
+  return !final || WriteTrailer(out);
+}
+
+bool wxZlibParallelDeflater::WriteHeader(wxOutputStream& out) const
+{
+  switch (m_flags) {
+    case wxZLIB_ZLIB: {
+      // See RFC 1950: deflate with 32KiB window and the level hint.
+      const int level = m_level == Z_DEFAULT_COMPRESSION ? 6 : m_level;
+      const unsigned cmf = 0x78;
+      unsigned flg = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+      flg += 31 - (cmf * 256 + flg) % 31;
+
+      const unsigned char header[] = { cmf, static_cast<unsigned char>(flg) };
+      return WriteAll(out, header, sizeof(header));
+    }
+
+    case wxZLIB_GZIP: {
+      // See RFC 1952: no optional fields, no time stamp and unknown OS.
+      const unsigned char xfl = m_level == Z_BEST_COMPRESSION ? 2
+                              : m_level == Z_BEST_SPEED ? 4 : 0;
+      const unsigned char header[] = { 0x1f, 0x8b, Z_DEFLATED, 0,
+                                       0, 0, 0, 0,
+                                       xfl, 0xff };
+      return WriteAll(out, header, sizeof(header));
+    }
+  }
+
+  return true;
+}
+
+bool wxZlibParallelDeflater::WriteTrailer(wxOutputStream& out) const
+{
+  switch (m_flags) {
+    case wxZLIB_ZLIB: {
+      const unsigned char trailer[] = {
+        static_cast<unsigned char>(m_check >> 24),
+        static_cast<unsigned char>(m_check >> 16),
+        static_cast<unsigned char>(m_check >> 8),
+        static_cast<unsigned char>(m_check)
+      };
+      return WriteAll(out, trailer, sizeof(trailer));
+    }
+
+    case wxZLIB_GZIP: {
+      const unsigned char trailer[] = {
+        static_cast<unsigned char>(m_check),
+        static_cast<unsigned char>(m_check >> 8),
+        static_cast<unsigned char>(m_check >> 16),
+        static_cast<unsigned char>(m_check >> 24),
+        static_cast<unsigned char>(m_totalSize),
+        static_cast<unsigned char>(m_totalSize >> 8),
+        static_cast<unsigned char>(m_totalSize >> 16),
+        static_cast<unsigned char>(m_totalSize >> 24)
+      };
+      return WriteAll(out, trailer, sizeof(trailer));
+    }
+  }
+
+  return true;
+}
+
 //////////////////////
 // wxZlibOutputStream
 //////////////////////
@@ -287,10 +593,14 @@ wxZlibOutputStream::wxZlibOutputStream(wxOutputStream *stream,
 void wxZlibOutputStream::Init(int level, int flags)
 {
   m_deflate = nullptr;
+  m_parallel = nullptr;
   m_z_buffer = new unsigned char[ZSTREAM_BUFFER_SIZE];
   m_z_size = ZSTREAM_BUFFER_SIZE;
   m_pos = 0;
 
+  const bool parallel = (flags & wxZLIB_PARALLEL) != 0;
+  flags &= ~wxZLIB_PARALLEL;
+
   if ( level == -1 )
   {
     level = Z_DEFAULT_COMPRESSION;
@@ -307,7 +617,15 @@ void wxZlibOutputStream::Init(int level, int flags)
     return;
   }
 
-  if (m_z_buffer) {
+  if (parallel) {
+    if (flags == wxZLIB_NO_HEADER || flags == wxZLIB_ZLIB || flags == wxZLIB_GZIP) {
+      m_parallel = new wxZlibParallelDeflater(level, flags);
+      return;
+    }
+
+    wxFAIL_MSG("Invalid zlib flag");
+  }
+  else if (m_z_buffer) {
     m_deflate = new z_stream_s;
 
     if (m_deflate) {
@@ -339,6 +657,7 @@ bool wxZlibOutputStream::Close()
   DoFlush(true);
    deflateEnd(m_deflate);
    wxDELETE(m_deflate);
+   wxDELETE(m_parallel);
    wxDELETEA(m_z_buffer);
 
   return wxFilterOutputStream::Close() && IsOk();
@@ -346,6 +665,14 @@ bool wxZlibOutputStream::Close()
 
 void wxZlibOutputStream::DoFlush(bool final)
 {
+  if (m_parallel) {
+    if (IsOk() && !m_parallel->Flush(*m_parent_o_stream, final)) {
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+      wxLogDebug("wxZlibOutputStream: Error writing to underlying stream");
+    }
+    return;
+  }
+
   if (!m_deflate || !m_z_buffer)
     m_lasterror = wxSTREAM_WRITE_ERROR;
   if (!IsOk())
@@ -375,6 +702,21 @@ void wxZlibOutputStream::DoFlush(bool final)
 
 size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
 {
+  if (m_parallel) {
+    if (!IsOk() || !size)
+      return 0;
+
+    if (!m_parallel->Write(*m_parent_o_stream,
+                           static_cast<const unsigned char*>(buffer), size)) {
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+      wxLogDebug("wxZlibOutputStream: Error writing to underlying stream");
+      return 0;
+    }
+
+    m_pos += size;
+    return size;
+  }
+
   wxASSERT_MSG(m_deflate && m_z_buffer, "Deflate stream not open");
 
   if (!m_deflate || !m_z_buffer)
@@ -426,6 +768,9 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
 
 bool wxZlibOutputStream::SetDictionary(const char *data, size_t datalen)
 {
+    wxCHECK_MSG( !m_parallel, false,
+                 "dictionary can't be used with wxZLIB_PARALLEL" );
+
     return deflateSetDictionary(m_deflate, reinterpret_cast<const Bytef*>(data), datalen) == Z_OK;
 }
 
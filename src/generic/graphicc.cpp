@@ -30,9 +30,11 @@ bool wxCairoInit();
 #include "wx/dcclient.h"
 #include "wx/dcmemory.h"
 #include "wx/dcprint.h"
+#include "wx/log.h"
 #include "wx/window.h"
 
 #include "wx/private/graphics.h"
+#include "wx/private/parallel.h"
 #include "wx/rawbmp.h"
 #ifdef __WXMSW__
     #include "wx/msw/enhmeta.h"
@@ -485,6 +487,10 @@ public:
 
     void StrokePath( const wxGraphicsPath& p ) override;
     void FillPath( const wxGraphicsPath& p , wxPolygonFillMode fillStyle = wxPolygonFillMode::WindingRule ) override;
+
+    void StrokeBatch( const wxGraphicsBatch& batch ) override;
+    void FillBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle = wxPolygonFillMode::WindingRule ) override;
+    void DrawBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle = wxPolygonFillMode::WindingRule ) override;
     void ClearRectangle( double x, double y, double w, double h ) override;
     void DrawRectangle( double x, double y, double w, double h) override;
 
@@ -517,6 +523,12 @@ protected:
 
     void Init(cairo_t *context);
 
+    // Fill and/or stroke the batch, building its path only once.
+    void DoDrawBatch(const wxGraphicsBatch& batch,
+                     bool fill,
+                     bool stroke,
+                     wxPolygonFillMode fillStyle);
+
     enum ApplyTransformMode { Apply_directly, Apply_scaled_dev_origin };
     void ApplyTransformFromDC(const wxDC& dc, ApplyTransformMode mode = Apply_directly);
 
@@ -2641,6 +2653,103 @@ void wxCairoContext::FillPath( const wxGraphicsPath& path , wxPolygonFillMode fi
     }
 }
 
+namespace
+{
+
+// Sink for wxBuildGraphicsBatchPath() appending to the current Cairo path.
+class wxCairoBatchSink
+{
+public:
+    explicit wxCairoBatchSink(cairo_t* context) : m_context(context) { }
+
+    void MoveTo(float x, float y) { cairo_move_to(m_context, x, y); }
+    void LineTo(float x, float y) { cairo_line_to(m_context, x, y); }
+    void ClosePath() { cairo_close_path(m_context); }
+
+    void AddRectangle(float x, float y, float w, float h)
+    {
+        cairo_rectangle(m_context, x, y, w, h);
+    }
+
+    void AddEllipse(float x, float y, float w, float h)
+    {
+        const double rx = w / 2.0;
+        const double ry = h / 2.0;
+
+        cairo_new_sub_path(m_context);
+        if ( rx == ry )
+        {
+            // Avoid changing the transformation for the most common case of
+            // circles.
+            cairo_arc(m_context, x + rx, y + ry, rx, 0.0, 2*M_PI);
+        }
+        else
+        {
+            cairo_save(m_context);
+            cairo_translate(m_context, x + rx, y + ry);
+            cairo_scale(m_context, rx, ry);
+            cairo_arc(m_context, 0.0, 0.0, 1.0, 0.0, 2*M_PI);
+            cairo_restore(m_context);
+        }
+        cairo_close_path(m_context);
+    }
+
+private:
+    cairo_t* const m_context;
+};
+
+} // anonymous namespace
+
+void wxCairoContext::DoDrawBatch(const wxGraphicsBatch& batch,
+                                 bool fill,
+                                 bool stroke,
+                                 wxPolygonFillMode fillStyle)
+{
+    fill = fill && !m_brush.IsNull();
+    stroke = stroke && !m_pen.IsNull();
+    if ( batch.IsEmpty() || !(fill || stroke) )
+        return;
+
+    wxCairoOffsetHelper helper(m_context, GetContentScaleFactor(), ShouldOffset());
+
+    // Build the path directly in the context, without going through
+    // wxGraphicsPath, and use it for both filling and stroking.
+    cairo_new_path(m_context);
+    wxCairoBatchSink sink(m_context);
+    wxBuildGraphicsBatchPath(batch, sink);
+
+    if ( fill )
+    {
+        ((wxCairoBrushData*)m_brush.GetRefData())->Apply(this);
+        cairo_set_fill_rule(m_context,fillStyle==wxPolygonFillMode::OddEven ? CAIRO_FILL_RULE_EVEN_ODD : CAIRO_FILL_RULE_WINDING);
+        if ( stroke )
+            cairo_fill_preserve(m_context);
+        else
+            cairo_fill(m_context);
+    }
+
+    if ( stroke )
+    {
+        ((wxCairoPenData*)m_pen.GetRefData())->Apply(this);
+        cairo_stroke(m_context);
+    }
+}
+
+void wxCairoContext::StrokeBatch( const wxGraphicsBatch& batch )
+{
+    DoDrawBatch(batch, false, true, wxPolygonFillMode::WindingRule);
+}
+
+void wxCairoContext::FillBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle )
+{
+    DoDrawBatch(batch, true, false, fillStyle);
+}
+
+void wxCairoContext::DrawBatch( const wxGraphicsBatch& batch, wxPolygonFillMode fillStyle )
+{
+    DoDrawBatch(batch, true, true, fillStyle);
+}
+
 void wxCairoContext::ClearRectangle( double x, double y, double w, double h )
 {
     cairo_save(m_context);
@@ -3518,6 +3627,234 @@ wxGraphicsRenderer* wxGraphicsRenderer::GetCairoRenderer()
     return &gs_cairoGraphicsRenderer;
 }
 
+#if wxUSE_IMAGE
+
+//-----------------------------------------------------------------------------
+// wxGraphicsTiledRenderer implementation
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Context drawing into a single tile of a larger image.
+class wxCairoTileContext : public wxCairoContext
+{
+public:
+    wxCairoTileContext(wxGraphicsRenderer* renderer,
+                       cairo_t* context,
+                       const wxSize& imageSize)
+        : wxCairoContext(renderer, context)
+    {
+        m_width = imageSize.x;
+        m_height = imageSize.y;
+    }
+};
+
+} // anonymous namespace
+
+class wxGraphicsTiledRenderer::Impl
+{
+public:
+    Impl(const wxSize& tileSize, unsigned threads)
+        : m_tileSize(tileSize),
+          m_pool(threads ? threads : wxGetParallelism())
+    {
+    }
+
+    ~Impl()
+    {
+        for ( cairo_surface_t* surface : m_surfaces )
+        {
+            if ( surface )
+                cairo_surface_destroy(surface);
+        }
+    }
+
+    const wxSize& GetTileSize() const { return m_tileSize; }
+    unsigned GetThreadCount() const { return m_pool.GetThreadCount(); }
+
+    wxImage Render(const wxSize& size, const PaintFunction& paint);
+
+private:
+    // Render the tile with the given index and rectangle into the image.
+    bool RenderTile(size_t n,
+                    const wxRect& rect,
+                    const PaintFunction& paint,
+                    wxImage& image);
+
+    const wxSize m_tileSize;
+
+    // Surfaces of all the tiles, created on demand and reused afterwards.
+    std::vector<cairo_surface_t*> m_surfaces;
+
+    // The pool is only used from Render(), which waits for all its tasks to
+    // complete, so the surfaces are never used after being destroyed.
+    wxWorkerPool m_pool;
+};
+
+bool
+wxGraphicsTiledRenderer::Impl::RenderTile(size_t n,
+                                          const wxRect& rect,
+                                          const PaintFunction& paint,
+                                          wxImage& image)
+{
+    // All tiles use surfaces of the same size, even if the ones at the right
+    // and bottom edges don't need all of it, to be reusable for any image.
+    cairo_surface_t*& surface = m_surfaces[n];
+    if ( !surface )
+    {
+        surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                             m_tileSize.x, m_tileSize.y);
+    }
+
+    if ( cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS )
+        return false;
+
+    cairo_t* const cr = cairo_create(surface);
+
+    // Erase the previously rendered contents.
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    // Let the paint function use the coordinates of the entire image. As this
+    // translation is part of the initial context transformation, it is
+    // preserved even if the function resets the transformation matrix.
+    cairo_translate(cr, -rect.x, -rect.y);
+
+    {
+        wxCairoTileContext gc(&gs_cairoGraphicsRenderer, cr, image.GetSize());
+        paint(gc);
+    }
+
+    cairo_destroy(cr);
+
+    cairo_surface_flush(surface);
+
+    // Copy the tile into its part of the image, undoing the alpha
+    // pre-multiplication as in wxCairoBitmapData::ConvertToImage(). Tiles
+    // don't overlap, so this can be done concurrently for all of them.
+    const unsigned char* const data = cairo_image_surface_get_data(surface);
+    const int stride = cairo_image_surface_get_stride(surface);
+    const int imageWidth = image.GetWidth();
+
+    for ( int y = 0; y < rect.height; y++ )
+    {
+        const std::uint32_t* src =
+            reinterpret_cast<const std::uint32_t*>(data + y * stride);
+
+        const size_t offset = (rect.y + y) * static_cast<size_t>(imageWidth) + rect.x;
+        unsigned char* dst = image.GetData() + 3 * offset;
+        unsigned char* alpha = image.GetAlpha() + offset;
+
+        for ( int x = 0; x < rect.width; x++ )
+        {
+            const std::uint32_t argb = *src++;
+
+            const unsigned char a = argb >> 24;
+            *alpha++ = a;
+
+            *dst++ = Unpremultiply(a, argb >> 16);
+            *dst++ = Unpremultiply(a, argb >>  8);
+            *dst++ = Unpremultiply(a, argb);
+        }
+    }
+
+    return true;
+}
+
+wxImage
+wxGraphicsTiledRenderer::Impl::Render(const wxSize& size,
+                                      const PaintFunction& paint)
+{
+    ENSURE_LOADED_OR_RETURN(wxNullImage);
+
+    wxImage image(size, false /* don't clear */);
+    wxCHECK_MSG( image.IsOk(), wxNullImage, "Failed to create image" );
+    image.SetAlpha();
+
+    const int cols = (size.x + m_tileSize.x - 1) / m_tileSize.x;
+    const int rows = (size.y + m_tileSize.y - 1) / m_tileSize.y;
+    const size_t count = static_cast<size_t>(cols) * rows;
+
+    // Only grow the vector, the surfaces of the tiles not used for a smaller
+    // image are kept for the next one.
+    if ( m_surfaces.size() < count )
+        m_surfaces.resize(count, nullptr);
+
+    std::vector<std::future<bool>> results;
+    results.reserve(count);
+    for ( size_t n = 0; n < count; n++ )
+    {
+        const int col = n % cols;
+        const int row = n / cols;
+        const wxRect rect(col * m_tileSize.x,
+                          row * m_tileSize.y,
+                          std::min(m_tileSize.x, size.x - col * m_tileSize.x),
+                          std::min(m_tileSize.y, size.y - row * m_tileSize.y));
+
+        results.push_back(m_pool.Submit([this, n, rect, &paint, &image]()
+            {
+                return RenderTile(n, rect, paint, image);
+            }));
+    }
+
+    bool ok = true;
+    for ( auto& result : results )
+    {
+        if ( !result.get() )
+            ok = false;
+    }
+
+    // This is not a programming error, drawing may fail at run-time, e.g. if
+    // there is not enough memory for the tile surfaces.
+    if ( !ok )
+    {
+        wxLogError(_("Failed to render image tiles."));
+        return wxNullImage;
+    }
+
+    return image;
+}
+
+wxGraphicsTiledRenderer::wxGraphicsTiledRenderer(wxSize tileSize,
+                                                 unsigned threads)
+{
+    wxASSERT_MSG( tileSize.x > 0 && tileSize.y > 0, "Invalid tile size" );
+
+    m_impl = std::make_unique<Impl>(tileSize, threads);
+}
+
+wxGraphicsTiledRenderer::~wxGraphicsTiledRenderer() = default;
+
+wxSize wxGraphicsTiledRenderer::GetTileSize() const
+{
+    return m_impl->GetTileSize();
+}
+
+unsigned wxGraphicsTiledRenderer::GetThreadCount() const
+{
+    return m_impl->GetThreadCount();
+}
+
+wxImage
+wxGraphicsTiledRenderer::RenderToImage(wxSize size, const PaintFunction& paint)
+{
+    wxCHECK_MSG( size.x > 0 && size.y > 0, wxNullImage, "Invalid image size" );
+
+    return m_impl->Render(size, paint);
+}
+
+wxBitmap
+wxGraphicsTiledRenderer::RenderToBitmap(wxSize size, const PaintFunction& paint)
+{
+    const wxImage image = RenderToImage(size, paint);
+
+    return image.IsOk() ? wxBitmap(image) : wxNullBitmap;
+}
+
+#endif // wxUSE_IMAGE
+
 #else // !wxUSE_CAIRO
 
 wxGraphicsRenderer* wxGraphicsRenderer::GetCairoRenderer()
@@ -25,6 +25,7 @@
 #include "wx/renderer.h"
 #include "wx/generic/private/listctrl.h"
 #include "wx/generic/private/widthcalc.h"
+#include "wx/private/parallel.h"
 
 #ifdef __WXMAC__
     #include "wx/osx/private.h"
@@ -36,6 +37,11 @@ import WX.Cfg.Flags;
 
 import WX.Utils.Settings;
 
+import <cmath>;
+import <limits>;
+import <numeric>;
+import <tuple>;
+
 // NOTE: If using the wxListBox visual attributes works everywhere then this can
 // be removed, as well as the #else case below.
 #define _USE_VISATTR 0
@@ -1589,6 +1595,8 @@ void wxListMainWindow::Init()
 
     m_hasCheckBoxes = false;
     m_extendRulesAndAlternateColour = false;
+
+    m_findIndex = NULL;
 }
 
 wxListMainWindow::wxListMainWindow()
@@ -1646,6 +1654,7 @@ wxListMainWindow::~wxListMainWindow()
     delete m_highlightUnfocusedBrush;
     delete m_renameTimer;
     delete m_findTimer;
+    delete m_findIndex;
 }
 
 void wxListMainWindow::SetReportView(bool inReportView)
@@ -3547,9 +3556,28 @@ void wxListMainWindow::SetItem( wxListItem &item )
 
     if ( !IsVirtual() )
     {
+        InvalidateSortOrder(item);
+
         wxListLineData *line = GetLine((size_t)id);
+
+        wxListFindIndex* const findIndex = item.m_col == 0
+                                            ? GetValidFindIndex()
+                                            : NULL;
+        wxString oldText;
+        wxUIntPtr oldData = 0;
+        if ( findIndex )
+            GetFindIndexKey(line, &oldText, &oldData);
+
         line->SetItem( item.m_col, item );
 
+        if ( findIndex )
+        {
+            wxString newText;
+            wxUIntPtr newData;
+            GetFindIndexKey(line, &newText, &newData);
+            findIndex->OnChange(id, oldText, oldData, newText, newData);
+        }
+
         // Set item state if user wants
         if ( item.m_mask & wxLIST_MASK_STATE )
             SetItemState( item.m_itemId, item.m_state, item.m_state );
@@ -4313,6 +4341,14 @@ void wxListMainWindow::DeleteItem( long lindex )
     }
     else
     {
+        if ( wxListFindIndex* const findIndex = GetValidFindIndex() )
+        {
+            wxString text;
+            wxUIntPtr data;
+            GetFindIndexKey(m_lines[index], &text, &data);
+            findIndex->OnDelete(index, text, data);
+        }
+
         delete m_lines[index];
         m_lines.erase( m_lines.begin() + index );
     }
@@ -4340,6 +4376,9 @@ void wxListMainWindow::DeleteColumn( int col )
     delete node->GetData();
     m_columns.Erase( node );
 
+    m_sortState.Reset();
+    InvalidateFindIndex();
+
     if ( !IsVirtual() )
     {
         // update all the items
@@ -4415,6 +4454,8 @@ void wxListMainWindow::DoDeleteAllItems()
         ResetVisibleLinesRange();
 
     m_lines.Clear();
+
+    InvalidateFindIndex();
 }
 
 void wxListMainWindow::DeleteAllItems()
@@ -4459,6 +4500,9 @@ long wxListMainWindow::FindItem(long start, const wxString& str, bool partial )
     if (pos < 0)
         pos = 0;
 
+    if ( const wxListFindIndex* const index = GetFindIndex() )
+        return index->FindText(pos, str_upper, partial);
+
     size_t count = GetItemCount();
     for ( size_t i = (size_t)pos; i < count; i++ )
     {
@@ -4485,6 +4529,9 @@ long wxListMainWindow::FindItem(long start, wxUIntPtr data)
     if (pos < 0)
         pos = 0;
 
+    if ( const wxListFindIndex* const index = GetFindIndex() )
+        return index->FindData(pos, data);
+
     size_t count = GetItemCount();
     for (size_t i = (size_t)pos; i < count; i++)
     {
@@ -4551,6 +4598,13 @@ long wxListMainWindow::HitTest( int x, int y, int &flags ) const
 // ----------------------------------------------------------------------------
 
 void wxListMainWindow::InsertItem( wxListItem &item )
+{
+    m_sortState.Reset();
+
+    DoInsertItem(item);
+}
+
+void wxListMainWindow::DoInsertItem( wxListItem &item )
 {
     wxASSERT_MSG( !IsVirtual(), "can't be used with virtual control" );
 
@@ -4601,6 +4655,14 @@ void wxListMainWindow::InsertItem( wxListItem &item )
 
     m_lines.insert( m_lines.begin() + id, line );
 
+    if ( wxListFindIndex* const findIndex = GetValidFindIndex() )
+    {
+        wxString text;
+        wxUIntPtr data;
+        GetFindIndexKey(line, &text, &data);
+        findIndex->OnInsert(id, text, data);
+    }
+
     m_dirty = true;
 
     // If an item is selected at or below the point of insertion, we need to
@@ -4619,6 +4681,8 @@ long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
     long idx = -1;
 
     m_dirty = true;
+    m_sortState.Reset();
+    InvalidateFindIndex();
     if ( InReportView() )
     {
         wxListHeaderData *column = new wxListHeaderData( item );
@@ -4723,9 +4787,456 @@ void wxListMainWindow::SortItems( wxListCtrlCompare fn, wxIntPtr data )
 
     std::ranges::sort(m_lines, wxListLineComparator(fn, data));
 
+    m_sortState.Reset();
+    InvalidateFindIndex();
+
     m_dirty = true;
 }
 
+namespace
+{
+
+// The key of a single line extracted before sorting it.
+struct wxListSortKeyValue
+{
+    wxString text;
+    double number{0};
+};
+
+wxListSortKeyValue
+wxMakeListSortKey(const wxListSortState& state, wxListLineData* line)
+{
+    wxListSortKeyValue value;
+
+    const wxString text = line->GetText(state.col);
+    if ( state.func )
+    {
+        wxListItem item;
+        line->GetItem(0, item);
+        value.number = state.func(text, item.m_data);
+        return value;
+    }
+
+    switch ( state.key )
+    {
+        case wxListSortKey::Text:
+            value.text = text;
+            break;
+
+        case wxListSortKey::TextNoCase:
+            value.text = text.Lower();
+            break;
+
+        case wxListSortKey::Numeric:
+            // Items without a valid number sort after all the others.
+            if ( !text.ToCDouble(&value.number) )
+                value.number = NAN;
+            break;
+    }
+
+    return value;
+}
+
+// Returns true if the first key comes before the second one in the sort
+// order, which is ascending or descending depending on the state, except for
+// the invalid numeric keys which always come last.
+bool wxListSortKeyLess(const wxListSortState& state,
+                       const wxListSortKeyValue& key1,
+                       const wxListSortKeyValue& key2)
+{
+    int rc;
+    if ( state.func || state.key == wxListSortKey::Numeric )
+    {
+        const bool nan1 = std::isnan(key1.number),
+                   nan2 = std::isnan(key2.number);
+        if ( nan1 || nan2 )
+            return !nan1 && nan2;
+
+        rc = (key1.number > key2.number) - (key1.number < key2.number);
+    }
+    else
+    {
+        rc = key1.text.compare(key2.text);
+    }
+
+    return state.ascending ? rc < 0 : rc > 0;
+}
+
+} // anonymous namespace
+
+void wxListMainWindow::SortItemsByColumn( const wxListSortState& state )
+{
+    wxCHECK_RET( !IsVirtual(), "can't sort virtual control" );
+    wxCHECK_RET( state.col == 0 || (state.col > 0 && state.col < GetColumnCount()),
+                 "invalid column index" );
+
+    m_sortState = state;
+
+    // Extract all the keys once instead of doing it on every comparison.
+    const size_t count = m_lines.size();
+    std::vector<wxListSortKeyValue> keys;
+    keys.reserve(count);
+    for ( wxListLineData* const line : m_lines )
+        keys.push_back(wxMakeListSortKey(m_sortState, line));
+
+    // Sort the indices of the lines rather than the lines themselves to avoid
+    // moving the keys around.
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+
+    const wxListSortState& sortState = m_sortState;
+    wxParallelStableSort(order.begin(), order.end(),
+        [&keys, &sortState](size_t n1, size_t n2)
+        {
+            return wxListSortKeyLess(sortState, keys[n1], keys[n2]);
+        });
+
+    // The selection state is stored in the lines themselves, so it moves with
+    // them and we only need to update the current item index.
+    wxListLineDataArray sorted;
+    sorted.reserve(count);
+    size_t current = m_current,
+           anchor = m_anchor;
+    for ( size_t n = 0; n < count; n++ )
+    {
+        sorted.push_back(m_lines[order[n]]);
+        if ( order[n] == m_current )
+            current = n;
+        if ( order[n] == m_anchor )
+            anchor = n;
+    }
+
+    m_lines.swap(sorted);
+    // avoid deleting the lines now owned by m_lines
+    sorted.clear();
+
+    m_current = current;
+    m_anchor = anchor;
+
+    InvalidateFindIndex();
+
+    m_dirty = true;
+}
+
+long wxListMainWindow::InsertItemSorted( wxListItem &item )
+{
+    wxCHECK_MSG( m_sortState.IsSorted(), -1,
+                 "items must be sorted by column first" );
+    wxCHECK_MSG( item.m_col == m_sortState.col, -1,
+                 "the item must be in the column the items are sorted by" );
+
+    // Create a temporary line to compute the new item key exactly as it
+    // would be computed for the existing ones.
+    wxListLineData line(this);
+    line.SetItem(item.m_col, item);
+    if ( item.m_col != 0 )
+    {
+        wxListItem first;
+        first.m_mask = wxLIST_MASK_DATA;
+        first.m_data = item.m_data;
+        line.SetItem(0, first);
+    }
+
+    const wxListSortKeyValue key = wxMakeListSortKey(m_sortState, &line);
+
+    // Find the position after all the items which compare less or equal to
+    // the new one, in the sort direction.
+    const auto pos = std::upper_bound(m_lines.begin(), m_lines.end(), key,
+        [this](const wxListSortKeyValue& key1, wxListLineData* line2)
+        {
+            return wxListSortKeyLess(m_sortState, key1,
+                                     wxMakeListSortKey(m_sortState, line2));
+        });
+
+    item.m_itemId = pos - m_lines.begin();
+    DoInsertItem(item);
+
+    return item.m_itemId;
+}
+
+void wxListMainWindow::InvalidateSortOrder( const wxListItem &item )
+{
+    if ( !m_sortState.IsSorted() )
+        return;
+
+    if ( (item.m_col == m_sortState.col && (item.m_mask & wxLIST_MASK_TEXT)) ||
+            (m_sortState.func && (item.m_mask & wxLIST_MASK_DATA)) )
+        m_sortState.Reset();
+}
+
+// ----------------------------------------------------------------------------
+// find index
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Distance between the labels of the adjacent lines when they are assigned
+// from scratch, this allows inserting 32 lines at the same position before
+// having to relabel all of them.
+constexpr std::uint64_t wxLIST_FIND_LABEL_GAP = 1ULL << 32;
+
+} // anonymous namespace
+
+void wxListFindIndex::Invalidate()
+{
+    m_valid = false;
+    m_labels.clear();
+    m_upper.clear();
+    m_lower.clear();
+    m_data.clear();
+}
+
+void wxListFindIndex::Add(const wxString& text, wxUIntPtr data)
+{
+    const Label label = (m_labels.size() + 1) * wxLIST_FIND_LABEL_GAP;
+    m_labels.push_back(label);
+
+    InsertLine(label, text, data);
+}
+
+void wxListFindIndex::Finish()
+{
+    m_valid = true;
+}
+
+wxListFindIndex::Label wxListFindIndex::GetLabel(size_t line) const
+{
+    return line < m_labels.size() ? m_labels[line]
+                                  : std::numeric_limits<Label>::max();
+}
+
+long wxListFindIndex::GetLine(Label label) const
+{
+    const auto it = std::ranges::lower_bound(m_labels, label);
+    wxCHECK_MSG( it != m_labels.end() && *it == label, wxNOT_FOUND,
+                 "label missing from the find index" );
+
+    return it - m_labels.begin();
+}
+
+wxListFindIndex::Label wxListFindIndex::InsertLabel(size_t line)
+{
+    wxCHECK_MSG( line <= m_labels.size(), 0, "invalid line index" );
+
+    // appending lines, which is the most common case, never requires
+    // relabelling until we run out of 64 bit labels
+    const auto getBounds = [this, line]()
+        {
+            const Label prev = line ? m_labels[line - 1] : 0;
+            const Label next = line < m_labels.size()
+                                ? m_labels[line]
+                                : prev + 2*wxLIST_FIND_LABEL_GAP;
+            return std::make_pair(prev, next);
+        };
+
+    auto [prev, next] = getBounds();
+    if ( next - prev < 2 || next < prev )
+    {
+        Relabel();
+        std::tie(prev, next) = getBounds();
+    }
+
+    const Label label = prev + (next - prev) / 2;
+    m_labels.insert(m_labels.begin() + line, label);
+
+    return label;
+}
+
+void wxListFindIndex::Relabel()
+{
+    // the new labels are in the same order as the old ones, so they don't
+    // change the order of the text entries and can be updated in place
+    const auto newLabel = [this](Label label)
+        {
+            return (GetLine(label) + 1) * wxLIST_FIND_LABEL_GAP;
+        };
+
+    for ( const TextEntry& e : m_upper )
+        e.label = newLabel(e.label);
+
+    for ( const TextEntry& e : m_lower )
+        e.label = newLabel(e.label);
+
+    for ( auto& data : m_data )
+    {
+        std::set<Label> labels;
+        for ( const Label label : data.second )
+            labels.insert(labels.end(), newLabel(label));
+
+        data.second.swap(labels);
+    }
+
+    for ( size_t n = 0; n < m_labels.size(); n++ )
+        m_labels[n] = (n + 1) * wxLIST_FIND_LABEL_GAP;
+}
+
+void wxListFindIndex::InsertLine(Label label, const wxString& text, wxUIntPtr data)
+{
+    m_upper.insert(TextEntry{text.Upper(), label});
+    m_lower.insert(TextEntry{text.Lower(), label});
+    m_data[data].insert(label);
+}
+
+void wxListFindIndex::EraseLine(Label label, const wxString& text, wxUIntPtr data)
+{
+    wxCHECK_RET( m_upper.erase(TextEntry{text.Upper(), label}) &&
+                    m_lower.erase(TextEntry{text.Lower(), label}),
+                 "line missing from the find index" );
+
+    const auto it = m_data.find(data);
+    wxCHECK_RET( it != m_data.end() && it->second.erase(label),
+                 "data missing from the find index" );
+
+    if ( it->second.empty() )
+        m_data.erase(it);
+}
+
+void wxListFindIndex::OnInsert(size_t line, const wxString& text, wxUIntPtr data)
+{
+    if ( !m_valid )
+        return;
+
+    InsertLine(InsertLabel(line), text, data);
+}
+
+void wxListFindIndex::OnDelete(size_t line, const wxString& text, wxUIntPtr data)
+{
+    if ( !m_valid )
+        return;
+
+    wxCHECK_RET( line < m_labels.size(), "invalid line index" );
+
+    EraseLine(m_labels[line], text, data);
+    m_labels.erase(m_labels.begin() + line);
+}
+
+void wxListFindIndex::OnChange(size_t line,
+                               const wxString& oldText, wxUIntPtr oldData,
+                               const wxString& newText, wxUIntPtr newData)
+{
+    if ( !m_valid )
+        return;
+
+    wxCHECK_RET( line < m_labels.size(), "invalid line index" );
+
+    const Label label = m_labels[line];
+    if ( newText != oldText || newData != oldData )
+    {
+        EraseLine(label, oldText, oldData);
+        InsertLine(label, newText, newData);
+    }
+}
+
+long wxListFindIndex::FindText(size_t start,
+                               const wxString& textUpper,
+                               bool partial) const
+{
+    if ( partial )
+        return FindPrefixIn(m_upper, start, textUpper);
+
+    // the first entry with this text and the label not less than that of the
+    // start line is the answer if it has this text
+    const auto it = m_upper.lower_bound(TextEntry{textUpper, GetLabel(start)});
+    if ( it != m_upper.end() && it->text == textUpper )
+        return GetLine(it->label);
+
+    return wxNOT_FOUND;
+}
+
+long wxListFindIndex::FindPrefix(size_t start, const wxString& prefixLower) const
+{
+    return FindPrefixIn(m_lower, start, prefixLower);
+}
+
+long wxListFindIndex::FindPrefixIn(const TextEntries& entries,
+                                   size_t start,
+                                   const wxString& prefix) const
+{
+    const Label startLabel = GetLabel(start);
+
+    // all the entries starting with the given prefix follow the first one
+    // with the text not less than it, sorted by text and then by label, so
+    // find the first suitable line for each of the texts and then jump
+    // directly to the next text, without iterating over the lines with the
+    // same text
+    Label found = std::numeric_limits<Label>::max();
+    for ( auto it = entries.lower_bound(TextEntry{prefix, 0});
+          it != entries.end() && it->text.StartsWith(prefix); )
+    {
+        const wxString& text = it->text;
+
+        const auto match = entries.lower_bound(TextEntry{text, startLabel});
+        if ( match != entries.end() && match->text == text &&
+                match->label < found )
+            found = match->label;
+
+        it = entries.upper_bound(
+                TextEntry{text, std::numeric_limits<Label>::max()});
+    }
+
+    return found == std::numeric_limits<Label>::max() ? wxNOT_FOUND
+                                                     : GetLine(found);
+}
+
+long wxListFindIndex::FindData(size_t start, wxUIntPtr data) const
+{
+    const auto it = m_data.find(data);
+    if ( it == m_data.end() )
+        return wxNOT_FOUND;
+
+    const auto label = it->second.lower_bound(GetLabel(start));
+    return label == it->second.end() ? wxNOT_FOUND : GetLine(*label);
+}
+
+/* static */
+void wxListMainWindow::GetFindIndexKey(const wxListLineData *line,
+                                       wxString *text,
+                                       wxUIntPtr *data)
+{
+    wxListItem item;
+    line->GetItem(0, item);
+
+    *text = line->GetText(0);
+    *data = item.m_data;
+}
+
+void wxListMainWindow::EnableFindIndex( bool enable )
+{
+    wxCHECK_RET( !IsVirtual(), "can't index virtual control" );
+
+    if ( enable )
+    {
+        if ( !m_findIndex )
+            m_findIndex = new wxListFindIndex;
+    }
+    else
+    {
+        wxDELETE(m_findIndex);
+    }
+}
+
+const wxListFindIndex *wxListMainWindow::GetFindIndex() const
+{
+    if ( !m_findIndex || IsVirtual() )
+        return NULL;
+
+    if ( !m_findIndex->IsValid() )
+    {
+        wxString text;
+        wxUIntPtr data;
+        for ( const wxListLineData* const line : m_lines )
+        {
+            GetFindIndexKey(line, &text, &data);
+            m_findIndex->Add(text, data);
+        }
+
+        m_findIndex->Finish();
+    }
+
+    return m_findIndex;
+}
+
 // ----------------------------------------------------------------------------
 // scrolling
 // ----------------------------------------------------------------------------
@@ -4821,6 +5332,18 @@ wxListMainWindow::PrefixFindItem(size_t idParent,
         itemid += 1;
     }
 
+    if ( const wxListFindIndex* const index = GetFindIndex() )
+    {
+        long found = index->FindPrefix(itemid, prefix);
+
+        // if we haven't found anything, wrap to the beginning: as there are
+        // no matches after itemid, any match found now comes before it
+        if ( found == wxNOT_FOUND )
+            found = index->FindPrefix(0, prefix);
+
+        return found == wxNOT_FOUND ? (size_t)-1 : (size_t)found;
+    }
+
     // look for the item starting with the given prefix after it
     while ( ( itemid < (size_t)GetItemCount() ) &&
             !GetLine(itemid)->GetText(0).Lower().StartsWith(prefix) )
@@ -5604,6 +6127,53 @@ bool wxGenericListCtrl::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     return true;
 }
 
+bool wxGenericListCtrl::SortItemsByColumn( int col, wxListSortKey key, bool ascending )
+{
+    wxCHECK_MSG( col == 0 || (col > 0 && col < GetColumnCount()), false,
+                 "invalid column index" );
+
+    wxListSortState state;
+    state.col = col;
+    state.key = key;
+    state.ascending = ascending;
+    m_mainWin->SortItemsByColumn( state );
+    return true;
+}
+
+bool wxGenericListCtrl::SortItemsByColumn( int col, const wxListSortKeyFunc& key, bool ascending )
+{
+    wxCHECK_MSG( col == 0 || (col > 0 && col < GetColumnCount()), false,
+                 "invalid column index" );
+    wxCHECK_MSG( key, false, "invalid sort key function" );
+
+    wxListSortState state;
+    state.col = col;
+    state.func = key;
+    state.ascending = ascending;
+    m_mainWin->SortItemsByColumn( state );
+    return true;
+}
+
+long wxGenericListCtrl::InsertItemSorted( wxListItem& info )
+{
+    return m_mainWin->InsertItemSorted( info );
+}
+
+void wxGenericListCtrl::EnableFindIndex( bool enable )
+{
+    m_mainWin->EnableFindIndex( enable );
+}
+
+bool wxGenericListCtrl::IsFindIndexEnabled() const
+{
+    return m_mainWin->IsFindIndexEnabled();
+}
+
+bool wxGenericListCtrl::IsSortedByColumn() const
+{
+    return m_mainWin->IsSortedByColumn();
+}
+
 // ----------------------------------------------------------------------------
 // event handlers
 // ----------------------------------------------------------------------------
@@ -30,6 +30,7 @@
 
 import WX.Utils.Settings;
 
+import <algorithm>;
 import <numeric>;
 
 // -----------------------------------------------------------------------------
@@ -190,6 +191,25 @@ public:
     int GetHeight() const { return m_height; }
     int GetWidth() const { return m_width; }
 
+    // the extent of this item together with all its shown descendants, as
+    // computed by the last layout
+    int GetSubtreeBottom() const { return m_subtreeBottom; }
+    int GetSubtreeRight() const { return m_subtreeRight; }
+    void SetSubtreeExtent(int bottom, int right)
+        { m_subtreeBottom = bottom; m_subtreeRight = right; }
+
+    // update the subtree extent of this item and its parents after it became
+    // wider, e.g. because it was measured only when it was shown
+    void ExtendSubtreeRight(int right)
+    {
+        for ( wxGenericTreeItem *item = this;
+              item && item->m_subtreeRight < right;
+              item = item->m_parent )
+        {
+            item->m_subtreeRight = right;
+        }
+    }
+
     int GetTextHeight() const
     {
         wxASSERT_MSG( m_heightText != -1, "must call CalculateSize() first" );
@@ -242,8 +262,6 @@ public:
         { DoCalculateSize(control, dc, true /* dc uses normal font */); }
     void CalculateSize(wxGenericTreeCtrl *control);
 
-    void GetSize( int &x, int &y, const wxGenericTreeCtrl* );
-
     void ResetSize() { m_width = 0; }
     void ResetTextSize() { m_width = 0; m_widthText = -1; }
     void RecursiveResetSize();
@@ -331,12 +349,15 @@ private:
     // expanded+selected states
     int                 m_images[wxTreeItemIcon_Max];
 
-    int                 m_width{-1};        // width of this item
-    int                 m_height{-1};       // height of this item
+    int                 m_width{0};         // width of this item, 0 if unknown
+    int                 m_height{0};        // height of this item
 
     int                 m_widthText{ -1 };
     int                 m_heightText{ -1 };
 
+    int                 m_subtreeBottom{0}; // bottom of the last shown descendant
+    int                 m_subtreeRight{0};  // right edge of the widest one
+
     int                 m_state{ wxTREE_ITEMSTATE_NONE };        // item state
 
     bool        m_isCollapsed{true};
@@ -617,24 +638,6 @@ size_t wxGenericTreeItem::GetChildrenCount(bool recursively) const
         });
 }
 
-void wxGenericTreeItem::GetSize( int &x, int &y,
-                                 const wxGenericTreeCtrl *theButton )
-{
-    int bottomY=m_y+theButton->GetLineHeight(this);
-    if ( y < bottomY ) y = bottomY;
-    int width = m_x +  m_width;
-    if ( x < width ) x = width;
-
-    if (IsExpanded())
-    {
-        size_t count = m_children.size();
-        for ( size_t n = 0; n < count; ++n )
-        {
-            m_children[n]->GetSize( x, y, theButton );
-        }
-    }
-}
-
 wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
                                               const wxGenericTreeCtrl *theCtrl,
                                               unsigned int &flags,
@@ -647,6 +650,10 @@ wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
         int h = theCtrl->GetLineHeight(this);
         if ((point.y > m_y) && (point.y < m_y + h))
         {
+            // the size of the items is only computed lazily when using fixed
+            // row height, so make sure we know it before using m_width below
+            CalculateSize(const_cast<wxGenericTreeCtrl *>(theCtrl));
+
             int y_mid = m_y + h/2;
             if (point.y < y_mid )
                 flags |= wxTREE_HITTEST_ONITEMUPPERPART;
@@ -723,19 +730,18 @@ wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
         if (m_isCollapsed) return nullptr;
     }
 
-    // evaluate children
-    size_t count = m_children.size();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGenericTreeItem *res = m_children[n]->HitTest( point,
-                                                         theCtrl,
-                                                         flags,
-                                                         level + 1 );
-        if ( res != nullptr )
-            return res;
-    }
+    // evaluate children: as they're laid out from top to bottom, only the
+    // last one starting above the point can contain it
+    const auto child = std::ranges::upper_bound(m_children, point.y, {},
+        [](const wxGenericTreeItem* item) { return item->GetY(); });
+    if ( child == m_children.begin() )
+        return nullptr;
+
+    wxGenericTreeItem* const last = *(child - 1);
+    if ( point.y >= last->GetSubtreeBottom() )
+        return nullptr;
 
-    return nullptr;
+    return last->HitTest( point, theCtrl, flags, level + 1 );
 }
 
 int wxGenericTreeItem::GetCurrentImage() const
@@ -899,6 +905,10 @@ void wxGenericTreeCtrl::Init()
     m_select_me = nullptr;
     m_hasFocus = false;
     m_dirty = false;
+    m_scrollbarsDirty = false;
+
+    m_totalHeight = 0;
+    m_maxItemRight = 0;
 
     m_lineHeight = 10;
     m_indent = 15;
@@ -1852,7 +1862,8 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
     item->Expand();
     if ( !IsFrozen() )
     {
-        CalculatePositions();
+        // only the items below this one need to be moved
+        CalculatePositions(item);
 
         RefreshSubtree(item);
     }
@@ -1902,7 +1913,7 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
     }
 #endif
 
-    CalculatePositions();
+    CalculatePositions(item);
 
     RefreshSubtree(item);
 
@@ -2467,10 +2478,14 @@ void wxGenericTreeCtrl::AssignButtonsImageList(wxImageList *imageList)
 
 void wxGenericTreeCtrl::AdjustMyScrollbars()
 {
+    m_scrollbarsDirty = false;
+
     if (m_anchor)
     {
-        int x = 0, y = 0;
-        m_anchor->GetSize( x, y, this );
+        // use the extent computed by the last layout instead of walking all
+        // the items again, this matters for trees with many expanded items
+        int x = m_maxItemRight,
+            y = m_totalHeight;
         y += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         x += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         int x_pos = GetScrollPos( wxHORIZONTAL );
@@ -2496,7 +2511,28 @@ int wxGenericTreeCtrl::GetLineHeight(wxGenericTreeItem *item) const
 void wxGenericTreeCtrl::PaintItem(wxGenericTreeItem *item, wxDC& dc)
 {
     item->SetFont(this, dc);
-    item->CalculateSize(this, dc);
+
+    // the item may not have been measured yet if it had never been shown
+    if ( !item->GetWidth() )
+    {
+        const int lineHeight = m_lineHeight;
+        item->CalculateSize(this, dc);
+
+        // an item taller than all the previous ones changes the position of
+        // all the items below it, so the layout must be redone
+        if ( m_lineHeight != lineHeight )
+            m_dirty = true;
+    }
+
+    if ( item->GetX() + item->GetWidth() > item->GetSubtreeRight() )
+    {
+        item->ExtendSubtreeRight(item->GetX() + item->GetWidth());
+        if ( m_anchor->GetSubtreeRight() > m_maxItemRight )
+        {
+            m_maxItemRight = m_anchor->GetSubtreeRight();
+            m_scrollbarsDirty = true;
+        }
+    }
 
     wxCoord text_h = item->GetTextHeight();
 
@@ -2745,6 +2781,16 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
         return;
     }
 
+    // don't paint the subtrees entirely outside of the exposed area, their
+    // layout is already known if the item is at the expected position
+    if ( item->GetY() == y && item->GetSubtreeBottom() > y &&
+            !IsExposed(dc.LogicalToDeviceX(0), dc.LogicalToDeviceY(y),
+                       10000, item->GetSubtreeBottom() - y) )
+    {
+        y = item->GetSubtreeBottom();
+        return;
+    }
+
     item->SetX(x+m_spacing);
     item->SetY(y);
 
@@ -3439,6 +3485,8 @@ bool wxGenericTreeCtrl::GetBoundingRect(const wxTreeItemId& item,
 
     if ( textOnly )
     {
+        i->CalculateSize(const_cast<wxGenericTreeCtrl *>(this));
+
         int image_w = 0;
         int image = ((wxGenericTreeItem*) item.m_pItem)->GetCurrentImage();
         if ( image != NO_IMAGE && m_imageListNormal )
@@ -3943,6 +3991,8 @@ void wxGenericTreeCtrl::OnInternalIdle()
     // actually redraw the tree when everything is over
     if (m_dirty)
         DoDirtyProcessing();
+    else if (m_scrollbarsDirty && !IsFrozen())
+        AdjustMyScrollbars();
 }
 
 void
@@ -3952,36 +4002,41 @@ wxGenericTreeCtrl::CalculateLevel(wxGenericTreeItem *item,
                                   int &y )
 {
     int x = level*m_indent;
+    int right = 0;
     if (!HasFlag(wxTR_HIDE_ROOT))
     {
         x += m_indent;
     }
-    else if (level == 0)
+
+    // a hidden root is not evaluated, but its children are always calculated
+    const bool isHiddenRoot = HasFlag(wxTR_HIDE_ROOT) && level == 0;
+    if ( !isHiddenRoot )
     {
-        // a hidden root is not evaluated, but its
-        // children are always calculated
-        goto Recurse;
-    }
+        // with fixed row height the position of the items doesn't depend on
+        // their size, so don't measure them here: this is done when they're
+        // shown
+        if ( HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) )
+            item->CalculateSize(this, dc);
 
-    item->CalculateSize(this, dc);
+        // set its position
+        item->SetX( x+m_spacing );
+        item->SetY( y );
+        y += GetLineHeight(item);
 
-    // set its position
-    item->SetX( x+m_spacing );
-    item->SetY( y );
-    y += GetLineHeight(item);
+        right = x + m_spacing + item->GetWidth();
+    }
 
-    if ( !item->IsExpanded() )
+    // we don't need to calculate collapsed branches
+    if ( isHiddenRoot || item->IsExpanded() )
     {
-        // we don't need to calculate collapsed branches
-        return;
+        for ( wxGenericTreeItem* const child : item->GetChildren() )
+        {
+            CalculateLevel( child, dc, level + 1, y );  // recurse
+            right = std::max(right, child->GetSubtreeRight());
+        }
     }
 
-  Recurse:
-    wxArrayGenericTreeItems& children = item->GetChildren();
-    size_t n, count = children.size();
-    ++level;
-    for (n = 0; n < count; ++n )
-        CalculateLevel( children[n], dc, level, y );  // recurse
+    item->SetSubtreeExtent(y, right);
 }
 
 void wxGenericTreeCtrl::CalculatePositions()
@@ -3999,6 +4054,70 @@ void wxGenericTreeCtrl::CalculatePositions()
 
     int y = 2;
     CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+
+    m_totalHeight = y;
+    m_maxItemRight = m_anchor->GetSubtreeRight();
+}
+
+void wxGenericTreeCtrl::CalculatePositions(wxGenericTreeItem *item)
+{
+    // the position of the item itself must be up to date for an incremental
+    // update to be possible
+    if ( m_dirty || item == m_anchor )
+    {
+        CalculatePositions();
+        return;
+    }
+
+    // nothing to do if the item is not shown currently, but notice that the
+    // hidden root is always considered to be expanded
+    int level = 0;
+    for ( wxGenericTreeItem *parent = item->GetParent();
+          parent;
+          parent = parent->GetParent() )
+    {
+        if ( !parent->IsExpanded() &&
+                !(parent == m_anchor && HasFlag(wxTR_HIDE_ROOT)) )
+            return;
+
+        level++;
+    }
+
+    wxClientDC dc(this);
+    PrepareDC( dc );
+
+    dc.SetFont( m_normalFont );
+
+    // lay out the item subtree and then all the items following it, i.e. its
+    // next siblings and the next siblings of all of its parents, while the
+    // items above it are not affected by this change at all
+    int y = item->GetY();
+    CalculateLevel( item, dc, level, y );
+
+    for ( wxGenericTreeItem *parent = item->GetParent();
+          parent;
+          item = parent, parent = parent->GetParent(), level-- )
+    {
+        wxArrayGenericTreeItems& siblings = parent->GetChildren();
+        const auto it = std::ranges::find(siblings, item);
+        for ( auto next = it + 1; next != siblings.end(); ++next )
+            CalculateLevel( *next, dc, level, y );
+
+        // the subtree of the parent ends where its last child subtree does,
+        // but its width must be recomputed from scratch as it could have
+        // become smaller, e.g. if a wide branch was collapsed
+        int right = 0;
+        if ( parent != m_anchor || !HasFlag(wxTR_HIDE_ROOT) )
+            right = parent->GetX() + parent->GetWidth();
+        for ( const wxGenericTreeItem* const sibling : siblings )
+            right = std::max(right, sibling->GetSubtreeRight());
+
+        parent->SetSubtreeExtent(y, right);
+    }
+
+    m_totalHeight = y;
+    m_maxItemRight = m_anchor->GetSubtreeRight();
+    m_scrollbarsDirty = true;
 }
 
 void wxGenericTreeCtrl::Refresh(bool eraseBackground, const wxRect *rect)
@@ -4109,6 +4228,7 @@ void wxGenericTreeCtrl::OnGetToolTip( wxTreeEvent &event )
     const wxGenericTreeItem* const pItem = (wxGenericTreeItem*)itemId.m_pItem;
 
     // Check if the item fits into the client area:
+    const_cast<wxGenericTreeItem*>(pItem)->CalculateSize(this);
     if ( pItem->GetX() + pItem->GetWidth() > GetClientSize().x )
     {
         // If it doesn't, show its full text in the tooltip.
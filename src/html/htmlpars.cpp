@@ -21,6 +21,12 @@
 import Utils.Strings;
 import WX.Cmn.WFStream;
 
+import <algorithm>;
+import <array>;
+import <charconv>;
+import <cstdint>;
+import <new>;
+import <string_view>;
 import <vector>;
 
 // DLL options compatibility check:
@@ -52,6 +58,7 @@ struct wxHtmlParserState
 {
     wxHtmlTag         *m_curTag;
     wxHtmlTag         *m_tags;
+    wxHtmlTagsArena   *m_tagsArena;
     wxHtmlTextPieces  *m_textPieces;
     int                m_curTextPiece;
     const wxString    *m_source;
@@ -121,6 +128,7 @@ void wxHtmlParser::CreateDOMTree()
 {
     wxHtmlTagsCache cache(*m_Source);
     m_TextPieces = new wxHtmlTextPieces;
+    m_TagsArena = new wxHtmlTagsArena;
     CreateDOMSubTree(nullptr, m_Source->begin(), m_Source->end(), &cache);
     m_CurTextPiece = 0;
 }
@@ -147,6 +155,11 @@ void wxHtmlParser::CreateDOMSubTree(wxHtmlTag *cur,
         i = end_pos;
     }
 
+    // Top level tags are chained together, remember the last one to be able
+    // to append to it without walking the whole chain every time.
+    wxHtmlTag *lastRoot = cur == nullptr && m_Tags ? m_Tags->wxGetLastSibling()
+                                                  : nullptr;
+
     while (i < end_pos)
     {
         wxChar c;
@@ -167,14 +180,10 @@ void wxHtmlParser::CreateDOMSubTree(wxHtmlTag *cur,
             // add another tag to the tree:
             else if (i < end_pos-1 && *(i+1) != wxT('/'))
             {
-                wxHtmlTag *chd;
-                if (cur)
-                    chd = new wxHtmlTag(cur, m_Source,
-                                        i, end_pos, cache, m_entitiesParser);
-                else
+                wxHtmlTag *chd = new (m_TagsArena->Allocate())
+                    wxHtmlTag(cur, m_Source, i, end_pos, cache, m_entitiesParser);
+                if (!cur)
                 {
-                    chd = new wxHtmlTag(nullptr, m_Source,
-                                        i, end_pos, cache, m_entitiesParser);
                     if (!m_Tags)
                     {
                         // if this is the first tag to be created make the root
@@ -185,9 +194,10 @@ void wxHtmlParser::CreateDOMSubTree(wxHtmlTag *cur,
                     {
                         // if there is already a root tag add this tag as
                         // the last sibling:
-                        chd->m_Prev = m_Tags->wxGetLastSibling();
+                        chd->m_Prev = lastRoot;
                         chd->m_Prev->m_Next = chd;
                     }
+                    lastRoot = chd;
                 }
 
                 if (chd->HasEnding())
@@ -220,14 +230,8 @@ void wxHtmlParser::CreateDOMSubTree(wxHtmlTag *cur,
 
 void wxHtmlParser::DestroyDOMTree()
 {
-    wxHtmlTag *t1, *t2;
-    t1 = m_Tags;
-    while (t1)
-    {
-        t2 = t1->wxGetNextSibling();
-        delete t1;
-        t1 = t2;
-    }
+    // all the tags are owned by the arena
+    wxDELETE(m_TagsArena);
     m_Tags = m_CurTag = nullptr;
 
     wxDELETE(m_TextPieces);
@@ -355,6 +359,7 @@ void wxHtmlParser::SetSourceAndSaveState(const wxString& src)
 
     s->m_curTag = m_CurTag;
     s->m_tags = m_Tags;
+    s->m_tagsArena = m_TagsArena;
     s->m_textPieces = m_TextPieces;
     s->m_curTextPiece = m_CurTextPiece;
     s->m_source = m_Source;
@@ -364,6 +369,7 @@ void wxHtmlParser::SetSourceAndSaveState(const wxString& src)
 
     m_CurTag = nullptr;
     m_Tags = nullptr;
+    m_TagsArena = nullptr;
     m_TextPieces = nullptr;
     m_CurTextPiece = 0;
     m_Source = nullptr;
@@ -383,6 +389,7 @@ bool wxHtmlParser::RestoreState()
 
     m_CurTag = s->m_curTag;
     m_Tags = s->m_tags;
+    m_TagsArena = s->m_tagsArena;
     m_TextPieces = s->m_textPieces;
     m_CurTextPiece = s->m_curTextPiece;
     m_Source = s->m_source;
@@ -418,29 +425,430 @@ void wxHtmlTagHandler::ParseInnerSource(const wxString& source)
 
 wxIMPLEMENT_DYNAMIC_CLASS(wxHtmlEntitiesParser, wxObject);
 
+namespace
+{
+
+struct wxHtmlEntityInfo
+{
+    std::string_view name;
+    unsigned code;
+};
+
+constexpr wxHtmlEntityInfo wxHtmlEntities[] =
+{
+    { "AElig", 198 },
+    { "Aacute", 193 },
+    { "Acirc", 194 },
+    { "Agrave", 192 },
+    { "Alpha", 913 },
+    { "Aring", 197 },
+    { "Atilde", 195 },
+    { "Auml", 196 },
+    { "Beta", 914 },
+    { "Ccedil", 199 },
+    { "Chi", 935 },
+    { "Dagger", 8225 },
+    { "Delta", 916 },
+    { "ETH", 208 },
+    { "Eacute", 201 },
+    { "Ecirc", 202 },
+    { "Egrave", 200 },
+    { "Epsilon", 917 },
+    { "Eta", 919 },
+    { "Euml", 203 },
+    { "Gamma", 915 },
+    { "Iacute", 205 },
+    { "Icirc", 206 },
+    { "Igrave", 204 },
+    { "Iota", 921 },
+    { "Iuml", 207 },
+    { "Kappa", 922 },
+    { "Lambda", 923 },
+    { "Mu", 924 },
+    { "Ntilde", 209 },
+    { "Nu", 925 },
+    { "OElig", 338 },
+    { "Oacute", 211 },
+    { "Ocirc", 212 },
+    { "Ograve", 210 },
+    { "Omega", 937 },
+    { "Omicron", 927 },
+    { "Oslash", 216 },
+    { "Otilde", 213 },
+    { "Ouml", 214 },
+    { "Phi", 934 },
+    { "Pi", 928 },
+    { "Prime", 8243 },
+    { "Psi", 936 },
+    { "Rho", 929 },
+    { "Scaron", 352 },
+    { "Sigma", 931 },
+    { "THORN", 222 },
+    { "Tau", 932 },
+    { "Theta", 920 },
+    { "Uacute", 218 },
+    { "Ucirc", 219 },
+    { "Ugrave", 217 },
+    { "Upsilon", 933 },
+    { "Uuml", 220 },
+    { "Xi", 926 },
+    { "Yacute", 221 },
+    { "Yuml", 376 },
+    { "Zeta", 918 },
+    { "aacute", 225 },
+    { "acirc", 226 },
+    { "acute", 180 },
+    { "aelig", 230 },
+    { "agrave", 224 },
+    { "alefsym", 8501 },
+    { "alpha", 945 },
+    { "amp", 38 },
+    { "and", 8743 },
+    { "ang", 8736 },
+    { "apos", 39 },
+    { "aring", 229 },
+    { "asymp", 8776 },
+    { "atilde", 227 },
+    { "auml", 228 },
+    { "bdquo", 8222 },
+    { "beta", 946 },
+    { "brvbar", 166 },
+    { "bull", 8226 },
+    { "cap", 8745 },
+    { "ccedil", 231 },
+    { "cedil", 184 },
+    { "cent", 162 },
+    { "chi", 967 },
+    { "circ", 710 },
+    { "clubs", 9827 },
+    { "cong", 8773 },
+    { "copy", 169 },
+    { "crarr", 8629 },
+    { "cup", 8746 },
+    { "curren", 164 },
+    { "dArr", 8659 },
+    { "dagger", 8224 },
+    { "darr", 8595 },
+    { "deg", 176 },
+    { "delta", 948 },
+    { "diams", 9830 },
+    { "divide", 247 },
+    { "eacute", 233 },
+    { "ecirc", 234 },
+    { "egrave", 232 },
+    { "empty", 8709 },
+    { "emsp", 8195 },
+    { "ensp", 8194 },
+    { "epsilon", 949 },
+    { "equiv", 8801 },
+    { "eta", 951 },
+    { "eth", 240 },
+    { "euml", 235 },
+    { "euro", 8364 },
+    { "exist", 8707 },
+    { "fnof", 402 },
+    { "forall", 8704 },
+    { "frac12", 189 },
+    { "frac14", 188 },
+    { "frac34", 190 },
+    { "frasl", 8260 },
+    { "gamma", 947 },
+    { "ge", 8805 },
+    { "gt", 62 },
+    { "hArr", 8660 },
+    { "harr", 8596 },
+    { "hearts", 9829 },
+    { "hellip", 8230 },
+    { "iacute", 237 },
+    { "icirc", 238 },
+    { "iexcl", 161 },
+    { "igrave", 236 },
+    { "image", 8465 },
+    { "infin", 8734 },
+    { "int", 8747 },
+    { "iota", 953 },
+    { "iquest", 191 },
+    { "isin", 8712 },
+    { "iuml", 239 },
+    { "kappa", 954 },
+    { "lArr", 8656 },
+    { "lambda", 955 },
+    { "lang", 9001 },
+    { "laquo", 171 },
+    { "larr", 8592 },
+    { "lceil", 8968 },
+    { "ldquo", 8220 },
+    { "le", 8804 },
+    { "lfloor", 8970 },
+    { "lowast", 8727 },
+    { "loz", 9674 },
+    { "lrm", 8206 },
+    { "lsaquo", 8249 },
+    { "lsquo", 8216 },
+    { "lt", 60 },
+    { "macr", 175 },
+    { "mdash", 8212 },
+    { "micro", 181 },
+    { "middot", 183 },
+    { "minus", 8722 },
+    { "mu", 956 },
+    { "nabla", 8711 },
+    { "nbsp", 160 },
+    { "ndash", 8211 },
+    { "ne", 8800 },
+    { "ni", 8715 },
+    { "not", 172 },
+    { "notin", 8713 },
+    { "nsub", 8836 },
+    { "ntilde", 241 },
+    { "nu", 957 },
+    { "oacute", 243 },
+    { "ocirc", 244 },
+    { "oelig", 339 },
+    { "ograve", 242 },
+    { "oline", 8254 },
+    { "omega", 969 },
+    { "omicron", 959 },
+    { "oplus", 8853 },
+    { "or", 8744 },
+    { "ordf", 170 },
+    { "ordm", 186 },
+    { "oslash", 248 },
+    { "otilde", 245 },
+    { "otimes", 8855 },
+    { "ouml", 246 },
+    { "para", 182 },
+    { "part", 8706 },
+    { "permil", 8240 },
+    { "perp", 8869 },
+    { "phi", 966 },
+    { "pi", 960 },
+    { "piv", 982 },
+    { "plusmn", 177 },
+    { "pound", 163 },
+    { "prime", 8242 },
+    { "prod", 8719 },
+    { "prop", 8733 },
+    { "psi", 968 },
+    { "quot", 34 },
+    { "rArr", 8658 },
+    { "radic", 8730 },
+    { "rang", 9002 },
+    { "raquo", 187 },
+    { "rarr", 8594 },
+    { "rceil", 8969 },
+    { "rdquo", 8221 },
+    { "real", 8476 },
+    { "reg", 174 },
+    { "rfloor", 8971 },
+    { "rho", 961 },
+    { "rlm", 8207 },
+    { "rsaquo", 8250 },
+    { "rsquo", 8217 },
+    { "sbquo", 8218 },
+    { "scaron", 353 },
+    { "sdot", 8901 },
+    { "sect", 167 },
+    { "shy", 173 },
+    { "sigma", 963 },
+    { "sigmaf", 962 },
+    { "sim", 8764 },
+    { "spades", 9824 },
+    { "sub", 8834 },
+    { "sube", 8838 },
+    { "sum", 8721 },
+    { "sup", 8835 },
+    { "sup1", 185 },
+    { "sup2", 178 },
+    { "sup3", 179 },
+    { "supe", 8839 },
+    { "szlig", 223 },
+    { "tau", 964 },
+    { "there4", 8756 },
+    { "theta", 952 },
+    { "thetasym", 977 },
+    { "thinsp", 8201 },
+    { "thorn", 254 },
+    { "tilde", 732 },
+    { "times", 215 },
+    { "trade", 8482 },
+    { "uArr", 8657 },
+    { "uacute", 250 },
+    { "uarr", 8593 },
+    { "ucirc", 251 },
+    { "ugrave", 249 },
+    { "uml", 168 },
+    { "upsih", 978 },
+    { "upsilon", 965 },
+    { "uuml", 252 },
+    { "weierp", 8472 },
+    { "xi", 958 },
+    { "yacute", 253 },
+    { "yen", 165 },
+    { "yuml", 255 },
+    { "zeta", 950 },
+    { "zwj", 8205 },
+    { "zwnj", 8204 },
+};
+
+constexpr std::uint32_t wxHtmlEntityHash(std::string_view name, std::uint32_t seed)
+{
+    // FNV-1a, perturbed by the seed so that the same function can be used for
+    // both levels of the table below.
+    std::uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for ( const char c : name )
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+// Perfect hash table of the entities above, built entirely at compile time
+// using the "hash and displace" scheme: the names are distributed into
+// buckets by the first hash and each bucket gets its own seed chosen so that
+// all of its names land in distinct free slots. Looking up a name then costs
+// two hash computations and a single string comparison.
+class wxHtmlEntitiesTable
+{
+public:
+    consteval wxHtmlEntitiesTable()
+    {
+        constexpr std::size_t count = std::size(wxHtmlEntities);
+        static_assert(count < SlotsCount);
+
+        std::array<std::array<std::uint16_t, count>, BucketsCount> members{};
+        std::array<std::size_t, BucketsCount> sizes{};
+        for ( std::size_t n = 0; n < count; n++ )
+        {
+            const auto b = wxHtmlEntityHash(wxHtmlEntities[n].name, 0) % BucketsCount;
+            members[b][sizes[b]++] = static_cast<std::uint16_t>(n);
+        }
+
+        // Place the biggest buckets first, while there are still many free
+        // slots available for them.
+        std::array<std::size_t, BucketsCount> order{};
+        for ( std::size_t b = 0; b < BucketsCount; b++ )
+            order[b] = b;
+        std::ranges::sort(order, [&sizes](std::size_t b1, std::size_t b2)
+            { return sizes[b1] > sizes[b2]; });
+
+        for ( const std::size_t b : order )
+        {
+            if ( !sizes[b] )
+                break;
+
+            for ( std::uint32_t seed = 1; ; seed++ )
+            {
+                std::array<std::size_t, count> slots{};
+                bool ok = true;
+                for ( std::size_t k = 0; k < sizes[b] && ok; k++ )
+                {
+                    slots[k] = wxHtmlEntityHash(wxHtmlEntities[members[b][k]].name, seed) % SlotsCount;
+                    ok = m_slots[slots[k]] == 0;
+                    for ( std::size_t l = 0; l < k && ok; l++ )
+                        ok = slots[l] != slots[k];
+                }
+
+                if ( !ok )
+                    continue;
+
+                for ( std::size_t k = 0; k < sizes[b]; k++ )
+                    m_slots[slots[k]] = static_cast<std::uint16_t>(members[b][k] + 1);
+                m_seeds[b] = static_cast<std::uint16_t>(seed);
+                break;
+            }
+        }
+    }
+
+    // Returns the code of the given named entity or 0 if it's unknown.
+    constexpr unsigned Find(std::string_view name) const
+    {
+        const auto seed = m_seeds[wxHtmlEntityHash(name, 0) % BucketsCount];
+        const auto slot = m_slots[wxHtmlEntityHash(name, seed) % SlotsCount];
+        if ( !slot )
+            return 0;
+
+        const wxHtmlEntityInfo& info = wxHtmlEntities[slot - 1];
+        return info.name == name ? info.code : 0;
+    }
+
+private:
+    static constexpr std::size_t BucketsCount = 128;
+    static constexpr std::size_t SlotsCount = 512;
+
+    // Seed used for the second hash of the names in each bucket.
+    std::array<std::uint16_t, BucketsCount> m_seeds{};
+
+    // 1-based index into wxHtmlEntities or 0 for the unused slots.
+    std::array<std::uint16_t, SlotsCount> m_slots{};
+};
+
+constexpr wxHtmlEntitiesTable wxHtmlEntitiesIndex;
+
+static_assert(wxHtmlEntitiesIndex.Find("amp") == 38);
+static_assert(wxHtmlEntitiesIndex.Find("zwnj") == 8204);
+static_assert(wxHtmlEntitiesIndex.Find("AMP") == 0);
+
+// Longest entity reference we're going to try to decode: this is much longer
+// than any named entity but still allows for numeric ones with leading zeroes.
+constexpr std::size_t wxHTML_MAX_ENTITY_LEN = 32;
+
+// Returns the code of the entity with the given name, which can be either a
+// named entity or "#nnn" or "#xhhh" numeric reference, or 0 if it's invalid.
+unsigned wxGetHtmlEntityCode(std::string_view entity)
+{
+    if ( entity.empty() )
+        return 0; // invalid entity reference
+
+    if ( entity[0] != '#' )
+        return wxHtmlEntitiesIndex.Find(entity);
+
+    entity.remove_prefix(1);
+
+    int base = 10;
+    if ( !entity.empty() && (entity[0] == 'x' || entity[0] == 'X') )
+    {
+        base = 16;
+        entity.remove_prefix(1);
+    }
+
+    unsigned code = 0;
+    if ( std::from_chars(entity.data(), entity.data() + entity.size(),
+                         code, base).ec != std::errc{} )
+        return 0;
+
+    return code;
+}
+
+} // anonymous namespace
+
 wxString wxHtmlEntitiesParser::Parse(const wxString& input) const
 {
+    const wxString::const_iterator end(input.end());
+    wxString::const_iterator c(std::find(input.begin(), end, wxT('&')));
+    if ( c == end ) // common case: no entity
+        return input;
+
     wxString output;
+    output.reserve(input.length());
 
-    const wxString::const_iterator end(input.end());
-    wxString::const_iterator c(input.begin());
-    wxString::const_iterator last(c);
+    wxString::const_iterator last(input.begin());
 
     for ( ; c < end; ++c )
     {
         if (*c == wxT('&'))
         {
-            if ( output.empty() )
-                output.reserve(input.length());
-
             if (c - last > 0)
                 output.append(last, c);
             if ( ++c == end )
                 break;
 
-            wxString entity;
+            // All characters allowed in the entity name are ASCII, so collect
+            // them directly into a narrow buffer instead of a wxString.
+            char entity[wxHTML_MAX_ENTITY_LEN];
+            std::size_t entityLen = 0;
             const wxString::const_iterator ent_s = c;
-            wxChar entity_char;
 
             for ( ; c != end; ++c )
             {
@@ -450,349 +858,37 @@ wxString wxHtmlEntitiesParser::Parse(const wxString& input) const
                        (ch >= wxT('0') && ch <= wxT('9')) ||
                         ch == wxT('_') || ch == wxT('#')) )
                     break;
+
+                if ( entityLen < WXSIZEOF(entity) )
+                    entity[entityLen] = static_cast<char>(ch);
+                entityLen++;
             }
 
-            entity.append(ent_s, c);
             if (c == end || *c != wxT(';')) --c;
             last = c+1;
-            entity_char = GetEntityChar(entity);
-            if (entity_char)
-                output << entity_char;
+
+            const unsigned code = entityLen <= WXSIZEOF(entity)
+                                    ? wxGetHtmlEntityCode({entity, entityLen})
+                                    : 0;
+            if (code)
+                output << GetCharForCode(code);
             else
             {
                 output.append(ent_s-1, c+1);
                 wxLogTrace(wxTRACE_HTML_DEBUG,
                            "Unrecognized HTML entity: '%s'",
-                           entity);
+                           wxString(ent_s, ent_s + entityLen));
             }
         }
     }
-    if ( last == input.begin() ) // common case: no entity
-        return input;
     if ( last != end )
         output.append(last, end);
     return output;
 }
 
-struct wxHtmlEntityInfo
-{
-    const wxStringCharType *name;
-    unsigned code;
-};
-
-extern "C" {
-static int wxHtmlEntityCompare(const void *key, const void *item)
-{
-#if wxUSE_UNICODE_UTF8
-    return strcmp(static_cast<const char*>(key), static_cast<const wxHtmlEntityInfo*>(item)->name);
-#else
-    return wxStrcmp(static_cast<const wxChar*>(key), static_cast<const wxHtmlEntityInfo*>(item)->name);
-#endif
-}
-}
-
 wxChar wxHtmlEntitiesParser::GetEntityChar(const wxString& entity) const
 {
-    unsigned code = 0;
-
-    if (entity.empty())
-      return 0; // invalid entity reference
-
-    if (entity[0] == wxT('#'))
-    {
-        // NB: parsed value is a number, so it's OK to use wx_str(), internal
-        //     representation is the same for numbers
-        const wxStringCharType *ent_s = entity.wx_str();
-        wxString format;
-
-        if (ent_s[1] == wxS('x') || ent_s[1] == wxS('X'))
-        {
-            format = "%x";
-            ent_s++;
-        }
-        else
-            format = "%u";
-        ent_s++;
-
-        if (wxSscanf(ent_s, format.c_str(), &code) != 1)
-            code = 0;
-    }
-    else
-    {
-        // store the literals in wx's internal representation (either char*
-        // in UTF-8 or wchar_t*) for best performance:
-        #define ENTITY(name, code) { wxS(name), code }
-
-        static wxHtmlEntityInfo substitutions[] = {
-            ENTITY("AElig", 198),
-            ENTITY("Aacute", 193),
-            ENTITY("Acirc", 194),
-            ENTITY("Agrave", 192),
-            ENTITY("Alpha", 913),
-            ENTITY("Aring", 197),
-            ENTITY("Atilde", 195),
-            ENTITY("Auml", 196),
-            ENTITY("Beta", 914),
-            ENTITY("Ccedil", 199),
-            ENTITY("Chi", 935),
-            ENTITY("Dagger", 8225),
-            ENTITY("Delta", 916),
-            ENTITY("ETH", 208),
-            ENTITY("Eacute", 201),
-            ENTITY("Ecirc", 202),
-            ENTITY("Egrave", 200),
-            ENTITY("Epsilon", 917),
-            ENTITY("Eta", 919),
-            ENTITY("Euml", 203),
-            ENTITY("Gamma", 915),
-            ENTITY("Iacute", 205),
-            ENTITY("Icirc", 206),
-            ENTITY("Igrave", 204),
-            ENTITY("Iota", 921),
-            ENTITY("Iuml", 207),
-            ENTITY("Kappa", 922),
-            ENTITY("Lambda", 923),
-            ENTITY("Mu", 924),
-            ENTITY("Ntilde", 209),
-            ENTITY("Nu", 925),
-            ENTITY("OElig", 338),
-            ENTITY("Oacute", 211),
-            ENTITY("Ocirc", 212),
-            ENTITY("Ograve", 210),
-            ENTITY("Omega", 937),
-            ENTITY("Omicron", 927),
-            ENTITY("Oslash", 216),
-            ENTITY("Otilde", 213),
-            ENTITY("Ouml", 214),
-            ENTITY("Phi", 934),
-            ENTITY("Pi", 928),
-            ENTITY("Prime", 8243),
-            ENTITY("Psi", 936),
-            ENTITY("Rho", 929),
-            ENTITY("Scaron", 352),
-            ENTITY("Sigma", 931),
-            ENTITY("THORN", 222),
-            ENTITY("Tau", 932),
-            ENTITY("Theta", 920),
-            ENTITY("Uacute", 218),
-            ENTITY("Ucirc", 219),
-            ENTITY("Ugrave", 217),
-            ENTITY("Upsilon", 933),
-            ENTITY("Uuml", 220),
-            ENTITY("Xi", 926),
-            ENTITY("Yacute", 221),
-            ENTITY("Yuml", 376),
-            ENTITY("Zeta", 918),
-            ENTITY("aacute", 225),
-            ENTITY("acirc", 226),
-            ENTITY("acute", 180),
-            ENTITY("aelig", 230),
-            ENTITY("agrave", 224),
-            ENTITY("alefsym", 8501),
-            ENTITY("alpha", 945),
-            ENTITY("amp", 38),
-            ENTITY("and", 8743),
-            ENTITY("ang", 8736),
-            ENTITY("apos", 39),
-            ENTITY("aring", 229),
-            ENTITY("asymp", 8776),
-            ENTITY("atilde", 227),
-            ENTITY("auml", 228),
-            ENTITY("bdquo", 8222),
-            ENTITY("beta", 946),
-            ENTITY("brvbar", 166),
-            ENTITY("bull", 8226),
-            ENTITY("cap", 8745),
-            ENTITY("ccedil", 231),
-            ENTITY("cedil", 184),
-            ENTITY("cent", 162),
-            ENTITY("chi", 967),
-            ENTITY("circ", 710),
-            ENTITY("clubs", 9827),
-            ENTITY("cong", 8773),
-            ENTITY("copy", 169),
-            ENTITY("crarr", 8629),
-            ENTITY("cup", 8746),
-            ENTITY("curren", 164),
-            ENTITY("dArr", 8659),
-            ENTITY("dagger", 8224),
-            ENTITY("darr", 8595),
-            ENTITY("deg", 176),
-            ENTITY("delta", 948),
-            ENTITY("diams", 9830),
-            ENTITY("divide", 247),
-            ENTITY("eacute", 233),
-            ENTITY("ecirc", 234),
-            ENTITY("egrave", 232),
-            ENTITY("empty", 8709),
-            ENTITY("emsp", 8195),
-            ENTITY("ensp", 8194),
-            ENTITY("epsilon", 949),
-            ENTITY("equiv", 8801),
-            ENTITY("eta", 951),
-            ENTITY("eth", 240),
-            ENTITY("euml", 235),
-            ENTITY("euro", 8364),
-            ENTITY("exist", 8707),
-            ENTITY("fnof", 402),
-            ENTITY("forall", 8704),
-            ENTITY("frac12", 189),
-            ENTITY("frac14", 188),
-            ENTITY("frac34", 190),
-            ENTITY("frasl", 8260),
-            ENTITY("gamma", 947),
-            ENTITY("ge", 8805),
-            ENTITY("gt", 62),
-            ENTITY("hArr", 8660),
-            ENTITY("harr", 8596),
-            ENTITY("hearts", 9829),
-            ENTITY("hellip", 8230),
-            ENTITY("iacute", 237),
-            ENTITY("icirc", 238),
-            ENTITY("iexcl", 161),
-            ENTITY("igrave", 236),
-            ENTITY("image", 8465),
-            ENTITY("infin", 8734),
-            ENTITY("int", 8747),
-            ENTITY("iota", 953),
-            ENTITY("iquest", 191),
-            ENTITY("isin", 8712),
-            ENTITY("iuml", 239),
-            ENTITY("kappa", 954),
-            ENTITY("lArr", 8656),
-            ENTITY("lambda", 955),
-            ENTITY("lang", 9001),
-            ENTITY("laquo", 171),
-            ENTITY("larr", 8592),
-            ENTITY("lceil", 8968),
-            ENTITY("ldquo", 8220),
-            ENTITY("le", 8804),
-            ENTITY("lfloor", 8970),
-            ENTITY("lowast", 8727),
-            ENTITY("loz", 9674),
-            ENTITY("lrm", 8206),
-            ENTITY("lsaquo", 8249),
-            ENTITY("lsquo", 8216),
-            ENTITY("lt", 60),
-            ENTITY("macr", 175),
-            ENTITY("mdash", 8212),
-            ENTITY("micro", 181),
-            ENTITY("middot", 183),
-            ENTITY("minus", 8722),
-            ENTITY("mu", 956),
-            ENTITY("nabla", 8711),
-            ENTITY("nbsp", 160),
-            ENTITY("ndash", 8211),
-            ENTITY("ne", 8800),
-            ENTITY("ni", 8715),
-            ENTITY("not", 172),
-            ENTITY("notin", 8713),
-            ENTITY("nsub", 8836),
-            ENTITY("ntilde", 241),
-            ENTITY("nu", 957),
-            ENTITY("oacute", 243),
-            ENTITY("ocirc", 244),
-            ENTITY("oelig", 339),
-            ENTITY("ograve", 242),
-            ENTITY("oline", 8254),
-            ENTITY("omega", 969),
-            ENTITY("omicron", 959),
-            ENTITY("oplus", 8853),
-            ENTITY("or", 8744),
-            ENTITY("ordf", 170),
-            ENTITY("ordm", 186),
-            ENTITY("oslash", 248),
-            ENTITY("otilde", 245),
-            ENTITY("otimes", 8855),
-            ENTITY("ouml", 246),
-            ENTITY("para", 182),
-            ENTITY("part", 8706),
-            ENTITY("permil", 8240),
-            ENTITY("perp", 8869),
-            ENTITY("phi", 966),
-            ENTITY("pi", 960),
-            ENTITY("piv", 982),
-            ENTITY("plusmn", 177),
-            ENTITY("pound", 163),
-            ENTITY("prime", 8242),
-            ENTITY("prod", 8719),
-            ENTITY("prop", 8733),
-            ENTITY("psi", 968),
-            ENTITY("quot", 34),
-            ENTITY("rArr", 8658),
-            ENTITY("radic", 8730),
-            ENTITY("rang", 9002),
-            ENTITY("raquo", 187),
-            ENTITY("rarr", 8594),
-            ENTITY("rceil", 8969),
-            ENTITY("rdquo", 8221),
-            ENTITY("real", 8476),
-            ENTITY("reg", 174),
-            ENTITY("rfloor", 8971),
-            ENTITY("rho", 961),
-            ENTITY("rlm", 8207),
-            ENTITY("rsaquo", 8250),
-            ENTITY("rsquo", 8217),
-            ENTITY("sbquo", 8218),
-            ENTITY("scaron", 353),
-            ENTITY("sdot", 8901),
-            ENTITY("sect", 167),
-            ENTITY("shy", 173),
-            ENTITY("sigma", 963),
-            ENTITY("sigmaf", 962),
-            ENTITY("sim", 8764),
-            ENTITY("spades", 9824),
-            ENTITY("sub", 8834),
-            ENTITY("sube", 8838),
-            ENTITY("sum", 8721),
-            ENTITY("sup", 8835),
-            ENTITY("sup1", 185),
-            ENTITY("sup2", 178),
-            ENTITY("sup3", 179),
-            ENTITY("supe", 8839),
-            ENTITY("szlig", 223),
-            ENTITY("tau", 964),
-            ENTITY("there4", 8756),
-            ENTITY("theta", 952),
-            ENTITY("thetasym", 977),
-            ENTITY("thinsp", 8201),
-            ENTITY("thorn", 254),
-            ENTITY("tilde", 732),
-            ENTITY("times", 215),
-            ENTITY("trade", 8482),
-            ENTITY("uArr", 8657),
-            ENTITY("uacute", 250),
-            ENTITY("uarr", 8593),
-            ENTITY("ucirc", 251),
-            ENTITY("ugrave", 249),
-            ENTITY("uml", 168),
-            ENTITY("upsih", 978),
-            ENTITY("upsilon", 965),
-            ENTITY("uuml", 252),
-            ENTITY("weierp", 8472),
-            ENTITY("xi", 958),
-            ENTITY("yacute", 253),
-            ENTITY("yen", 165),
-            ENTITY("yuml", 255),
-            ENTITY("zeta", 950),
-            ENTITY("zwj", 8205),
-            ENTITY("zwnj", 8204),
-            {nullptr, 0}};
-        #undef ENTITY
-        static size_t substitutions_cnt = 0;
-
-        if (substitutions_cnt == 0)
-            while (substitutions[substitutions_cnt].code != 0)
-                substitutions_cnt++;
-
-        wxHtmlEntityInfo *info;
-        info = (wxHtmlEntityInfo*) bsearch(entity.wx_str(), substitutions,
-                                           substitutions_cnt,
-                                           sizeof(wxHtmlEntityInfo),
-                                           wxHtmlEntityCompare);
-        if (info)
-            code = info->code;
-    }
+    const unsigned code = wxGetHtmlEntityCode(entity.ToStdString());
 
     if (code == 0)
         return 0;
@@ -18,6 +18,8 @@
 
 import <cstdio>; // for vsscanf
 import <cstdarg>;
+import <string>;
+import <unordered_map>;
 import <vector>;
 
 //-----------------------------------------------------------------------------
@@ -44,9 +46,6 @@ struct wxHtmlCacheItem
     // end1 is '<' of ending tag,
     // end2 is '>' or both are
     wxString::const_iterator End1, End2;
-
-    // name of this tag
-    wxChar *Name;
 };
 
 // NB: this is an empty class and not typedef because of forward declaration
@@ -71,6 +70,11 @@ wxHtmlTagsCache::wxHtmlTagsCache(const wxString& source)
 {
     wxChar tagBuffer[256];
 
+    // Indices of the tags without matching ending tag found so far, indexed
+    // by the tag name: this allows to find the tag closed by an ending tag
+    // immediately instead of searching the entire cache backwards for it.
+    std::unordered_map<std::wstring, std::vector<size_t>> openTags;
+
     const wxString::const_iterator end = source.end();
     for ( wxString::const_iterator pos = source.begin(); pos < end; ++pos )
     {
@@ -114,27 +118,26 @@ wxHtmlTagsCache::wxHtmlTagsCache(const wxString& source)
         size_t tg = Cache().size();
         Cache().push_back(wxHtmlCacheItem());
         Cache()[tg].Key = stpos;
-        Cache()[tg].Name = new wxChar[i+1];
-        memcpy(Cache()[tg].Name, tagBuffer, (i+1)*sizeof(wxChar));
 
         if ((stpos+1) < end && *(stpos+1) == wxT('/')) // ending tag:
         {
             Cache()[tg].type = wxHtmlCacheItem::Type::EndingTag;
-            // find matching begin tag:
-            for (i = tg; i >= 0; i--)
+            // find matching begin tag, i.e. the last unclosed one:
+            const auto it = openTags.find(tagBuffer+1);
+            if ( it != openTags.end() && !it->second.empty() )
             {
-                if ((Cache()[i].type == wxHtmlCacheItem::Type::NoMatchingEndingTag) && (wxStrcmp(Cache()[i].Name, tagBuffer+1) == 0))
-                {
-                    Cache()[i].type = wxHtmlCacheItem::Type::Normal;
-                    Cache()[i].End1 = stpos;
-                    Cache()[i].End2 = pos + 1;
-                    break;
-                }
+                wxHtmlCacheItem& item = Cache()[it->second.back()];
+                it->second.pop_back();
+
+                item.type = wxHtmlCacheItem::Type::Normal;
+                item.End1 = stpos;
+                item.End2 = pos + 1;
             }
         }
         else
         {
             Cache()[tg].type = wxHtmlCacheItem::Type::NoMatchingEndingTag;
+            openTags[tagBuffer].push_back(tg);
 
             if (wxIsCDATAElement(tagBuffer))
             {
@@ -204,12 +207,6 @@ wxHtmlTagsCache::wxHtmlTagsCache(const wxString& source)
         }
     }
 
-    // ok, we're done, now we'll free .Name members of cache - we don't need it anymore:
-    for ( wxHtmlTagsCacheData::iterator i = Cache().begin();
-          i != Cache().end(); ++i )
-    {
-        wxDELETEA(i->Name);
-    }
 }
 
 wxHtmlTagsCache::~wxHtmlTagsCache()
@@ -466,57 +463,53 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
 
 wxHtmlTag::~wxHtmlTag()
 {
-    wxHtmlTag *t1, *t2;
-    t1 = m_FirstChild;
-    while (t1)
+    // Nothing to do, the children are owned by the same wxHtmlTagsArena.
+}
+
+int wxHtmlTag::FindParam(const wxString& par) const
+{
+    // Compare the names case-insensitively in place instead of making upper
+    // case copies of all of them on every lookup.
+    for ( size_t n = 0; n < m_ParamNames.size(); n++ )
     {
-        t2 = t1->wxGetNextSibling();
-        delete t1;
-        t1 = t2;
+        if ( m_ParamNames[n].IsSameAs(par, false) )
+            return static_cast<int>(n);
     }
+
+    return -1;
 }
 
 bool wxHtmlTag::HasParam(const wxString& par) const
-{        
-    const auto parUpper = wx::utils::ToUpperCopy(par);
-    auto paramMatch = std::ranges::find_if(m_ParamNames,
-        [parUpper](const auto& name){ return parUpper == wx::utils::ToUpperCopy(name); });
-
-    return paramMatch != m_ParamNames.end();
+{
+    return FindParam(par) != -1;
 }
 
 wxString wxHtmlTag::GetParam(const wxString& par, bool with_quotes) const
 {
-    const auto parUpper = wx::utils::ToUpperCopy(par);
-    auto paramMatch = std::ranges::find_if(m_ParamNames,
-        [parUpper](const auto& name){ return parUpper == wx::utils::ToUpperCopy(name); });
-    
-    if (paramMatch == m_ParamNames.end())
+    const int index = FindParam(par);
+    if (index == -1)
         return "";
 
     if (with_quotes)
     {
         // VS: backward compatibility, seems to be never used by wxHTML...
         wxString s;
-        s << wxT('"') << *paramMatch << wxT('"');
+        s << wxT('"') << m_ParamValues[index] << wxT('"');
         return s;
     }
     else
-        return *paramMatch;
+        return m_ParamValues[index];
 }
 
-// FIXME: Awful code that relies on indexing into another array with another one's index.
 bool wxHtmlTag::GetParamAsString(const wxString& par, wxString *str) const
 {
     wxCHECK_MSG( str, false, "NULL output string argument" );
 
-    const auto parUpper = wx::utils::ToUpperCopy(par);
-    auto paramMatch = std::find_if(m_ParamNames.begin(), m_ParamNames.end(), [parUpper](const auto& name){ return parUpper == wx::utils::ToUpperCopy(name); });
-    
-    if (paramMatch == m_ParamNames.end())
+    const int index = FindParam(par);
+    if (index == -1)
         return false;
 
-    *str = m_ParamValues[std::distance(m_ParamNames.begin(), paramMatch)];
+    *str = m_ParamValues[index];
 
     return true;
 }
@@ -647,6 +640,34 @@ wxString wxHtmlTag::GetAllParams() const
     return s;
 }
 
+//-----------------------------------------------------------------------------
+// wxHtmlTagsArena
+//-----------------------------------------------------------------------------
+
+wxHtmlTagsArena::~wxHtmlTagsArena()
+{
+    for ( size_t n = 0; n < m_blocks.size(); n++ )
+    {
+        wxHtmlTag* const tags = static_cast<wxHtmlTag*>(m_blocks[n]);
+        const size_t count = n == m_blocks.size() - 1 ? m_used : TagsPerBlock;
+        for ( size_t i = 0; i < count; i++ )
+            tags[i].~wxHtmlTag();
+
+        ::operator delete(m_blocks[n]);
+    }
+}
+
+void *wxHtmlTagsArena::Allocate()
+{
+    if ( m_used == TagsPerBlock )
+    {
+        m_blocks.push_back(::operator new(sizeof(wxHtmlTag) * TagsPerBlock));
+        m_used = 0;
+    }
+
+    return static_cast<wxHtmlTag*>(m_blocks.back()) + m_used++;
+}
+
 wxHtmlTag *wxHtmlTag::wxGetFirstSibling() const
 {
     if (m_Parent)
@@ -12,6 +12,7 @@
 #include "wx/intl.h"
 #include "wx/log.h"
 #include "wx/dir.h"
+#include "wx/filefn.h"          // for wxWildcardPattern
 
 import WX.WinDef;
 
@@ -52,34 +53,58 @@ const wxChar *GetNameFromFindData(const FIND_STRUCT* finddata)
     return finddata->cFileName;
 }
 
-// Helper function checking that the contents of the given FIND_STRUCT really
+// Helper class checking that the contents of the given FIND_STRUCT really
 // match our filter. We need to do it ourselves as native Windows functions
 // apply the filter to both the long and the short names of the file, so
 // something like "*.bar" matches "foo.bar.baz" too and not only "foo.bar", so
 // we have to double check that we have a real match.
-inline bool
-CheckFoundMatch(const FIND_STRUCT* finddata, const std::string& filter)
+class FindFilter
 {
-    // If there is no filter, the found file must be the one we really are
-    // looking for.
-    if ( filter.empty() )
-        return true;
+public:
+    FindFilter() = default;
+
+    // The filter is compiled once here instead of for every file found.
+    // Notice that we must match case-insensitively because the case of the
+    // file names is not supposed to matter under Windows. However if the
+    // filter contains only special characters (which is a common case), we
+    // can skip the case conversion.
+    explicit FindFilter(const std::string& filter)
+        : m_filter(filter),
+          m_upper(filter.find_first_not_of("*?.") != std::string::npos),
+          m_hasAny(filter.find('?') != std::string::npos),
+          m_pattern(m_upper ? wx::utils::ToUpperCopy(filter) : filter, false)
+    {
+    }
 
-    // Otherwise do check the match validity. Notice that we must do it
-    // case-insensitively because the case of the file names is not supposed to
-    // matter under Windows.
-    wxString fn = GetNameFromFindData(finddata);
+    bool Matches(const FIND_STRUCT* finddata) const
+    {
+        // If there is no filter, the found file must be the one we really are
+        // looking for.
+        if ( m_filter.empty() )
+            return true;
 
-    // However if the filter contains only special characters (which is a
-    // common case), we can skip the case conversion.
-    if ( filter.find_first_not_of("*?.") == std::string::npos )
-        return fn.Matches(filter);
+        wxString fn = GetNameFromFindData(finddata);
+        if ( m_upper )
+            fn.MakeUpper();
 
-    return fn.MakeUpper().Matches(wx::utils::ToUpperCopy(filter));
-}
+        // The compiled pattern works with bytes, so '?' wouldn't match a
+        // single non-ASCII character in it.
+        if ( m_hasAny && !fn.IsAscii() )
+            return fn.Matches(m_upper ? wx::utils::ToUpperCopy(m_filter)
+                                      : m_filter);
+
+        return m_pattern.Matches(fn.ToStdString());
+    }
+
+private:
+    std::string m_filter;
+    bool m_upper{false};
+    bool m_hasAny{false};
+    wxWildcardPattern m_pattern;
+};
 
 inline bool
-FindNext(FIND_DATA fd, const std::string& filter, FIND_STRUCT *finddata)
+FindNext(FIND_DATA fd, const FindFilter& filter, FIND_STRUCT *finddata)
 {
     for ( ;; )
     {
@@ -87,14 +112,14 @@ FindNext(FIND_DATA fd, const std::string& filter, FIND_STRUCT *finddata)
             return false;
 
         // If we did find something, check that it really matches.
-        if ( CheckFoundMatch(finddata, filter) )
+        if ( filter.Matches(finddata) )
             return true;
     }
 }
 
 inline FIND_DATA
 FindFirst(const std::string& spec,
-          const std::string& filter,
+          const FindFilter& filter,
           FIND_STRUCT *finddata)
 {
     boost::nowide::wstackstring stackSpec{spec.c_str()};
@@ -102,7 +127,7 @@ FindFirst(const std::string& spec,
 
     // As in FindNext() above, we need to check that the file name we found
     // really matches our filter and look for the next match if it doesn't.
-    if ( IsFindDataOk(fd) && !CheckFoundMatch(finddata, filter) )
+    if ( IsFindDataOk(fd) && !filter.Matches(finddata) )
     {
         if ( !FindNext(fd, filter, finddata) )
         {
@@ -155,7 +180,11 @@ public:
     wxDirData(const wxDirData&) = delete;
 	wxDirData& operator=(const wxDirData&) = delete;
 
-    void SetFileSpec(const std::string& filespec) { m_filespec = filespec; }
+    void SetFileSpec(const std::string& filespec)
+    {
+        m_filespec = filespec;
+        m_filter = FindFilter(filespec);
+    }
     void SetFlags(unsigned int flags) { m_flags = flags; }
 
     void Close();
@@ -167,6 +196,7 @@ public:
 private:
     std::string m_dirname;
     std::string m_filespec;
+    FindFilter m_filter;
 
     FIND_DATA m_finddata;
 
@@ -227,7 +257,7 @@ bool wxDirData::Read(std::string *filename)
         else
             filespec += m_filespec;
 
-        m_finddata = FindFirst(filespec, m_filespec, PTR_TO_FINDDATA);
+        m_finddata = FindFirst(filespec, m_filter, PTR_TO_FINDDATA);
 
         first = true;
     }
@@ -257,7 +287,7 @@ bool wxDirData::Read(std::string *filename)
         }
         else
         {
-            if ( !FindNext(m_finddata, m_filespec, PTR_TO_FINDDATA) )
+            if ( !FindNext(m_finddata, m_filter, PTR_TO_FINDDATA) )
             {
                 const WXDWORD err = ::GetLastError();
 
@@ -357,7 +357,7 @@ void wxIOCPThread::ProcessNativeEvents(std::vector<wxEventProcessingData>& event
             // form...need to account for that!
             wxFileName path = GetEventPath(*watch, e);
             // For files, check that it matches any filespec
-            if ( m_service->MatchesFilespec(path, watch->GetFilespec()) )
+            if ( m_service->MatchesFilespec(path, *watch) )
             {
                 wxFileSystemWatcherEvent event(flags, path, path);
                 SendEvent(event);
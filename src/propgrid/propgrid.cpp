@@ -1821,8 +1821,7 @@ wxPGProperty* wxPropertyGrid::DoGetItemAtY( int y ) const
     if ( y < 0 )
         return nullptr;
 
-    unsigned int a = 0;
-    return m_pState->DoGetRoot()->GetItemAtY(y, m_lineHeight, &a);
+    return m_pState->DoGetItemAtY(y);
 }
 
 // -----------------------------------------------------------------------
@@ -2091,29 +2090,21 @@ int wxPropertyGrid::DoDrawItems( wxDC& dc,
 
     dc.SetFont(normalFont);
 
-    wxPropertyGridConstIterator it( state, wxPG_ITERATE_VISIBLE, firstItem );
     int endScanBottomY = lastItemBottomY + lh;
     int y = firstItemTopY;
 
     //
-    // Pre-generate list of visible properties.
-    std::vector<wxPGProperty*> visPropArray;
-    visPropArray.reserve((m_height/m_lineHeight)+6);
-
-    for ( ; !it.AtEnd(); it.Next() )
-    {
-        const wxPGProperty* p = *it;
-
-        if ( !p->HasFlag(wxPG_PROP_HIDDEN) )
-        {
-            visPropArray.push_back(const_cast<wxPGProperty*>(p));
-
-            if ( y > endScanBottomY )
-                break;
-
-            y += lh;
-        }
-    }
+    // Pre-generate list of visible properties: they're just a slice of all
+    // the visible rows starting with the first one.
+    const std::vector<wxPGProperty*>& rows = state->GetVisibleRows();
+    // Both ends of the slice must be clamped, as the area being drawn may
+    // extend beyond the last row.
+    const size_t firstRow = std::min(rows.size(), (size_t)(firstItemTopY / lh));
+    const size_t endRow = std::min(rows.size(),
+                                   firstRow + (endScanBottomY - firstItemTopY) / lh + 2);
+
+    std::vector<wxPGProperty*> visPropArray(rows.begin() + firstRow,
+                                            rows.begin() + endRow);
 
     visPropArray.push_back(NULL);
 
@@ -2364,7 +2355,8 @@ int wxPropertyGrid::DoDrawItems( wxDC& dc,
             int cellRenderFlags = renderFlags;
 
             // Tree Item Button (must be drawn before clipping is set up)
-            if ( ci == 0 && !HasFlag(wxPG_HIDE_MARGIN) && p->HasVisibleChildren() )
+            if ( ci == 0 && !HasFlag(wxPG_HIDE_MARGIN) &&
+                    (p->HasVisibleChildren() || state->HasChildrenProvider(p)) )
                 DrawExpanderButton( dc, butRect, p );
 
             // Background
@@ -4754,7 +4746,7 @@ bool wxPropertyGrid::HandleMouseClick( int x, unsigned int y, wxMouseEvent &even
 
                 m_iFlags &= ~(wxPG_FL_ACTIVATION_BY_CLICK);
 
-                if ( p->GetChildCount() && !p->IsCategory() )
+                if ( m_pState->IsExpandable(p) && !p->IsCategory() )
                     // On double-click, expand/collapse.
                     if ( event.ButtonDClick() && !(m_windowStyle & wxPG_HIDE_MARGIN) )
                     {
@@ -4835,7 +4827,7 @@ bool wxPropertyGrid::HandleMouseClick( int x, unsigned int y, wxMouseEvent &even
         else
         {
         // Click on margin.
-            if ( p->GetChildCount() )
+            if ( m_pState->IsExpandable(p) )
             {
                 int nx = x + m_marginWidth - marginEnds; // Normalize x.
 
@@ -5659,7 +5651,7 @@ void wxPropertyGrid::HandleKeyEvent( wxKeyEvent &event, bool fromChild )
         // Travel and expand/collapse
         int selectDir = -2;
 
-        if ( p->GetChildCount() )
+        if ( m_pState->IsExpandable(p) )
         {
             if ( action == wxPG_ACTION_COLLAPSE_PROPERTY || secondAction == wxPG_ACTION_COLLAPSE_PROPERTY )
             {
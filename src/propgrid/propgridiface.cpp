@@ -297,6 +297,10 @@ bool wxPropertyGridInterface::ExpandAll( bool doExpand )
         pg->DoClearSelection();
     }
 
+    // Rebuild the visible rows once at the end rather than updating them
+    // for every property.
+    state->VirtualHeightChanged();
+
     wxPGVIterator it;
 
     for ( it = GetVIterator( wxPG_ITERATE_ALL ); !it.AtEnd(); it.Next() )
@@ -605,6 +609,23 @@ void wxPropertyGridInterface::Sort( int flags )
 
 // -----------------------------------------------------------------------
 
+void wxPropertyGridInterface::SetPropertyChildrenProvider( wxPGPropArg id,
+                                                           wxPGChildrenProvider provider )
+{
+    wxPG_PROP_ARG_CALL_PROLOG()
+
+    p->GetParentState()->SetChildrenProvider(p, std::move(provider));
+
+    wxPropertyGrid* pg = p->GetGridIfDisplayed();
+    if ( pg )
+    {
+        pg->RecalculateVirtualSize();
+        pg->RefreshProperty(p);
+    }
+}
+
+// -----------------------------------------------------------------------
+
 void wxPropertyGridInterface::SetPropertyLabel( wxPGPropArg id, const wxString& newproplabel )
 {
     wxPG_PROP_ARG_CALL_PROLOG()
@@ -23,6 +23,8 @@
 #include "wx/propgrid/propgridpagestate.h"
 #include "wx/propgrid/propgrid.h"
 
+import <algorithm>;
+
 // -----------------------------------------------------------------------
 // wxPropertyGridIterator
 // -----------------------------------------------------------------------
@@ -285,7 +287,14 @@ void wxPropertyGridPageState::DoClear()
 
         m_virtualHeight = 0;
         m_vhCalcPending = false;
+
+        m_visibleRows.clear();
+        m_visibleRowsValid = false;
+        m_visibleRowIndex.clear();
+        m_visibleRowIndexEnd = 0;
     }
+
+    m_childrenProviders.clear();
 }
 
 // -----------------------------------------------------------------------
@@ -624,6 +633,8 @@ void wxPropertyGridPageState::DoSortChildren( wxPGProperty* p,
     // Fix indices
     p->FixIndicesOfChildren();
 
+    m_visibleRowsValid = false;
+
     if ( flags & wxPG_RECURSE )
     {
         // Apply sort recursively
@@ -669,8 +680,78 @@ wxPGProperty* wxPropertyGridPageState::DoGetItemAtY( int y ) const
     if ( y < 0 )
         return nullptr;
 
-    unsigned int a = 0;
-    return m_properties->GetItemAtY(y, GetGrid()->GetRowHeight(), &a);
+    // All rows have the same height, so the row can be found directly.
+    const std::vector<wxPGProperty*>& rows = GetVisibleRows();
+    const size_t row = y / GetGrid()->GetRowHeight();
+
+    return row < rows.size() ? rows[row] : nullptr;
+}
+
+// -----------------------------------------------------------------------
+
+/* static */
+void wxPropertyGridPageState::AppendVisibleRows( const wxPGProperty* parent,
+                                                 std::vector<wxPGProperty*>& rows )
+{
+    // This must be kept in sync with wxPGProperty::GetItemAtY().
+    for ( unsigned int i = 0; i < parent->GetChildCount(); i++ )
+    {
+        wxPGProperty* p = parent->Item(i);
+
+        if ( p->HasFlag(wxPG_PROP_HIDDEN) )
+            continue;
+
+        rows.push_back(p);
+
+        if ( p->IsExpanded() && p->GetChildCount() > 0 )
+            AppendVisibleRows(p, rows);
+    }
+}
+
+const std::vector<wxPGProperty*>& wxPropertyGridPageState::GetVisibleRows() const
+{
+    if ( !m_visibleRowsValid )
+    {
+        m_visibleRows.clear();
+        AppendVisibleRows(m_properties, m_visibleRows);
+        m_visibleRowsValid = true;
+
+        // The positions are filled in by FindVisibleRow() when needed.
+        m_visibleRowIndex.clear();
+        m_visibleRowIndexEnd = 0;
+    }
+
+    return m_visibleRows;
+}
+
+int wxPropertyGridPageState::FindVisibleRow( const wxPGProperty* p ) const
+{
+    wxASSERT( m_visibleRowsValid );
+
+    auto it = m_visibleRowIndex.find(p);
+    if ( it != m_visibleRowIndex.end() && it->second < m_visibleRowIndexEnd )
+        return it->second;
+
+    // Renumber the rows whose positions could have changed, this is done at
+    // most once after each modification of the cache.
+    if ( m_visibleRowIndexEnd < m_visibleRows.size() )
+    {
+        for ( size_t n = m_visibleRowIndexEnd; n < m_visibleRows.size(); n++ )
+            m_visibleRowIndex[m_visibleRows[n]] = n;
+
+        m_visibleRowIndexEnd = m_visibleRows.size();
+
+        it = m_visibleRowIndex.find(p);
+    }
+
+    // Only the shown properties are present in the index, see DoCollapse().
+    return it != m_visibleRowIndex.end() ? static_cast<int>(it->second)
+                                         : wxNOT_FOUND;
+}
+
+void wxPropertyGridPageState::RecalculateVirtualHeight()
+{
+    m_virtualHeight = GetVisibleRows().size() * GetGrid()->GetRowHeight();
 }
 
 // -----------------------------------------------------------------------
@@ -1263,9 +1344,28 @@ bool wxPropertyGridPageState::DoCollapse( wxPGProperty* p )
 
     if ( !p->IsExpanded() ) return false;
 
+    // Remove the rows of the children from the visible rows cache, if the
+    // property itself is shown, instead of rebuilding it entirely.
+    if ( m_visibleRowsValid )
+    {
+        const int row = FindVisibleRow(p);
+        if ( row != wxNOT_FOUND )
+        {
+            std::vector<wxPGProperty*> rows;
+            AppendVisibleRows(p, rows);
+            for ( const wxPGProperty* child : rows )
+                m_visibleRowIndex.erase(child);
+
+            const auto first = m_visibleRows.begin() + row + 1;
+            m_visibleRows.erase(first, first + rows.size());
+            m_visibleRowIndexEnd = std::min(m_visibleRowIndexEnd,
+                                            static_cast<size_t>(row + 1));
+        }
+    }
+
     p->SetExpanded(false);
 
-    VirtualHeightChanged();
+    m_vhCalcPending = true;
 
     return true;
 }
@@ -1276,19 +1376,67 @@ bool wxPropertyGridPageState::DoExpand( wxPGProperty* p )
 {
     wxCHECK_MSG( p, false, "invalid property id" );
 
+    // Let the provider create the children, if it hadn't been done yet.
+    const auto itProvider = m_childrenProviders.find(p);
+    if ( itProvider != m_childrenProviders.end() )
+    {
+        const wxPGChildrenProvider provider = std::move(itProvider->second);
+        m_childrenProviders.erase(itProvider);
+
+        provider(p);
+    }
+
     if ( !p->GetChildCount() ) return false;
 
     if ( p->IsExpanded() ) return false;
 
     p->SetExpanded(true);
 
-    VirtualHeightChanged();
+    // Insert the rows of the children into the visible rows cache, see
+    // DoCollapse().
+    if ( m_visibleRowsValid )
+    {
+        const int row = FindVisibleRow(p);
+        if ( row != wxNOT_FOUND )
+        {
+            std::vector<wxPGProperty*> rows;
+            AppendVisibleRows(p, rows);
+            m_visibleRows.insert(m_visibleRows.begin() + row + 1,
+                                 rows.begin(), rows.end());
+            m_visibleRowIndexEnd = std::min(m_visibleRowIndexEnd,
+                                            static_cast<size_t>(row + 1));
+        }
+    }
+
+    m_vhCalcPending = true;
 
     return true;
 }
 
 // -----------------------------------------------------------------------
 
+void wxPropertyGridPageState::SetChildrenProvider( wxPGProperty* p,
+                                                   wxPGChildrenProvider provider )
+{
+    wxCHECK_RET( p, "invalid property id" );
+    wxCHECK_RET( !p->GetChildCount(), "property already has children" );
+
+    if ( provider )
+    {
+        // Children are only created when the property is expanded.
+        p->SetExpanded(false);
+        m_childrenProviders[p] = std::move(provider);
+    }
+    else
+    {
+        m_childrenProviders.erase(p);
+    }
+
+    VirtualHeightChanged();
+}
+
+// -----------------------------------------------------------------------
+
 bool wxPropertyGridPageState::DoSelectProperty( wxPGProperty* p, unsigned int flags )
 {
     if ( IsDisplayed() )
@@ -1821,6 +1969,12 @@ void wxPropertyGridPageState::DoDelete( wxPGProperty* item, bool doDelete )
 
     wxPropertyGrid* pg = GetGrid();
 
+    // Forget about the children providers of the property and its children.
+    std::erase_if(m_childrenProviders, [item](const auto& kv)
+        {
+            return kv.first == item || kv.first->IsSomeParent(item);
+        });
+
     // Try to unselect property and its sub-properties.
     if ( DoIsPropertySelected(item) )
     {
@@ -17,7 +17,7 @@
 #endif // PCH
 
 #include "wx/dir.h"
-#include "wx/filefn.h"          // for wxMatchWild
+#include "wx/filefn.h"          // for wxWildcardPattern
 #include "wx/filename.h"
 
 #include <sys/types.h>
@@ -45,8 +45,8 @@ public:
 
     bool IsOk() const { return m_dir != NULL; }
 
-    void SetFileSpec(const wxString& filespec) { m_filespec = filespec; }
-    void SetFlags(int flags) { m_flags = flags; }
+    void SetFileSpec(const wxString& filespec) { m_filespec = filespec; UpdatePattern(); }
+    void SetFlags(int flags) { m_flags = flags; UpdatePattern(); }
 
     void Rewind() { rewinddir(m_dir); }
     bool Read(wxString *filename);
@@ -54,12 +54,20 @@ public:
     const wxString& GetName() const { return m_dirname; }
 
 private:
+    // Compile the file spec only once instead of doing it for every entry.
+    void UpdatePattern()
+    {
+        m_pattern = wxWildcardPattern(m_filespec.ToStdString(),
+                                      !(m_flags & wxDIR_HIDDEN));
+    }
+
     DIR     *m_dir;
 
     wxString m_dirname;
     wxString m_filespec;
+    wxWildcardPattern m_pattern;
 
-    int      m_flags;
+    int      m_flags{0};
 };
 
 // ============================================================================
@@ -160,8 +168,7 @@ bool wxDirData::Read(wxString *filename)
         else
         {
             // test against the pattern
-            matches = wxMatchWild(m_filespec, de_d_name,
-                                  !(m_flags & wxDIR_HIDDEN));
+            matches = m_pattern.Matches(de_d_name.ToStdString());
         }
     }
 
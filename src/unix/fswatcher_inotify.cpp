@@ -18,7 +18,19 @@
 
 #include <sys/inotify.h>
 #include <unistd.h>
+#include <cerrno>
+#include <climits>
 #include "wx/private/fswatcher.h"
+#include "wx/private/parallel.h"
+#include "wx/dir.h"
+#include "wx/timer.h"
+
+import <algorithm>;
+import <atomic>;
+import <memory>;
+import <string>;
+import <unordered_map>;
+import <vector>;
 
 // ============================================================================
 // wxFSWatcherImpl implementation & helper wxFSWSourceHandler implementation
@@ -32,6 +44,23 @@ WX_DECLARE_HASH_MAP(int, wxFSWatchEntry*, wxIntegerHash, wxIntegerEqual,
 WX_DECLARE_HASH_MAP(int, inotify_event*, wxIntegerHash, wxIntegerEqual,
                                                       wxInotifyCookies);
 
+class wxFSWatcherImplUnix;
+
+// Timer used for sending the coalesced modification events.
+class wxFSWCoalesceTimer : public wxTimer
+{
+public:
+    explicit wxFSWCoalesceTimer(wxFSWatcherImplUnix* service)
+        : m_service(service)
+    {
+    }
+
+    void Notify() override;
+
+private:
+    wxFSWatcherImplUnix* const m_service;
+};
+
 /**
  * Helper class encapsulating inotify mechanism
  */
@@ -64,7 +93,9 @@ public:
         wxEventLoopBase *loop = wxEventLoopBase::GetActive();
         wxCHECK_MSG( loop, false, "File system watcher needs an event loop" );
 
-        m_ifd = inotify_init();
+        // Use non-blocking descriptor to be able to read all the available
+        // events at once, without knowing how many of them there are.
+        m_ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
         if ( m_ifd == -1 )
         {
             wxLogSysError( _("Unable to create inotify instance") );
@@ -169,36 +200,67 @@ public:
         wxCHECK_MSG( IsOk(), -1,
                     "Inotify not initialized or invalid inotify descriptor" );
 
-        // read events
-        // TODO differentiate depending on params
-        char buf[128 * sizeof(inotify_event)];
-        int left = ReadEventsToBuf(buf, sizeof(buf));
-        if (left == -1)
-            return -1;
+        // The buffer must be big enough for at least one event with the
+        // longest possible name, otherwise read() fails.
+        const size_t bufSize = std::max(m_watcher->GetReadBufferSize(),
+                                        sizeof(inotify_event) + NAME_MAX + 1);
+        if ( m_buffer.size() != bufSize )
+            m_buffer.resize(bufSize);
+
+        // Read everything available, but not indefinitely, to avoid blocking
+        // the event loop if the events keep coming: we'll be called again if
+        // there are any left.
+        static const int MAX_READS = 16;
 
-        // left > 0, we have events
-        char* memory = buf;
         int event_count = 0;
-        while (left > 0) // OPT checking 'memory' would suffice
+        for ( int n = 0; n < MAX_READS; n++ )
         {
-            event_count++;
-            inotify_event* e = (inotify_event*)memory;
+            int left = ReadEventsToBuf(m_buffer.data(), m_buffer.size());
+            if (left == -1)
+                return -1;
+
+            if (left == 0)
+                break;
+
+            char* memory = m_buffer.data();
+            while (left > 0) // OPT checking 'memory' would suffice
+            {
+                event_count++;
+                inotify_event* e = (inotify_event*)memory;
 
-            // process one inotify_event
-            ProcessNativeEvent(*e);
+                // process one inotify_event
+                ProcessNativeEvent(*e);
 
-            int offset = sizeof(inotify_event) + e->len;
-            left -= offset;
-            memory += offset;
+                int offset = sizeof(inotify_event) + e->len;
+                left -= offset;
+                memory += offset;
+            }
         }
 
         // take care of unmatched renames
         ProcessRenames();
 
+        SendBatch();
+
         wxLogTrace(wxTRACE_FSWATCHER, "We had %d native events", event_count);
         return event_count;
     }
 
+    // Called by the timer when the coalescing interval expires.
+    void OnCoalesceTimer()
+    {
+        for ( const auto& path : m_modified )
+        {
+            if ( path )
+                DeliverEvent(wxFSW_EVENT_MODIFY, *path, *path);
+        }
+
+        m_modified.clear();
+        m_modifiedIndex.clear();
+
+        SendBatch();
+    }
+
     bool IsOk() const
     {
         return m_source != NULL;
@@ -485,7 +547,7 @@ protected:
         {
             wxFileName path = GetEventPath(watch, inevt);
             // For files, check that it matches any filespec
-            if ( MatchesFilespec(path, watch.GetFilespec()) )
+            if ( MatchesFilespec(path, watch) )
             {
                 wxFileSystemWatcherEvent event(flags, path, path);
                 SendEvent(event);
@@ -537,17 +599,121 @@ protected:
     void SendEvent(wxFileSystemWatcherEvent& evt)
     {
         wxLogTrace(wxTRACE_FSWATCHER, evt.ToString());
+
+        if ( evt.IsError() )
+        {
+            // Don't reorder the errors with the changes preceding them.
+            SendBatch();
+            m_watcher->GetOwner()->ProcessEvent(evt);
+            return;
+        }
+
+        const int changeType = evt.GetChangeType();
+        if ( m_watcher->GetCoalesceInterval().count() > 0 )
+        {
+            if ( changeType == wxFSW_EVENT_MODIFY )
+            {
+                QueueModify(evt.GetPath());
+                return;
+            }
+
+            // Any other change must come after the modifications of the same
+            // path which happened before it.
+            SendModify(evt.GetPath());
+            if ( evt.GetNewPath() != evt.GetPath() )
+                SendModify(evt.GetNewPath());
+        }
+
+        if ( m_watcher->AreBatchEventsEnabled() )
+        {
+            m_batch.push_back({changeType, evt.GetPath(), evt.GetNewPath()});
+            return;
+        }
+
         m_watcher->GetOwner()->ProcessEvent(evt);
     }
 
+    void DeliverEvent(int changeType,
+                      const wxFileName& path,
+                      const wxFileName& newPath)
+    {
+        if ( m_watcher->AreBatchEventsEnabled() )
+        {
+            m_batch.push_back({changeType, path, newPath});
+        }
+        else
+        {
+            wxFileSystemWatcherEvent event(changeType, path, newPath);
+            m_watcher->GetOwner()->ProcessEvent(event);
+        }
+    }
+
+    void SendBatch()
+    {
+        if ( m_batch.empty() )
+            return;
+
+        wxLogTrace(wxTRACE_FSWATCHER, "Sending %zu changes at once",
+                   m_batch.size());
+
+        wxFileSystemWatcherBatchEvent event(std::move(m_batch));
+        m_batch.clear();
+
+        m_watcher->GetOwner()->ProcessEvent(event);
+    }
+
+    // Remember that the file was modified, to report it when the coalescing
+    // interval expires, unless it's already pending.
+    void QueueModify(const wxFileName& path)
+    {
+        const auto res = m_modifiedIndex.try_emplace(path.GetFullPath(),
+                                                     m_modified.size());
+        if ( !res.second )
+            return;
+
+        m_modified.push_back(std::make_unique<wxFileName>(path));
+
+        if ( !m_timer )
+            m_timer = std::make_unique<wxFSWCoalesceTimer>(this);
+
+        if ( !m_timer->IsRunning() )
+        {
+            m_timer->StartOnce(static_cast<int>(
+                m_watcher->GetCoalesceInterval().count()));
+        }
+    }
+
+    // Report the pending modification of this path right now, if any.
+    void SendModify(const wxFileName& path)
+    {
+        if ( m_modifiedIndex.empty() )
+            return;
+
+        const auto it = m_modifiedIndex.find(path.GetFullPath());
+        if ( it == m_modifiedIndex.end() )
+            return;
+
+        // Don't remove it from the vector, as this would invalidate the other
+        // indices, just forget about it.
+        auto& modified = m_modified[it->second];
+        DeliverEvent(wxFSW_EVENT_MODIFY, *modified, *modified);
+        modified.reset();
+
+        m_modifiedIndex.erase(it);
+    }
+
     int ReadEventsToBuf(char* buf, int size)
     {
         wxCHECK_MSG( IsOk(), false,
                     "Inotify not initialized or invalid inotify descriptor" );
 
-        memset(buf, 0, size);
         ssize_t left = read(m_ifd, buf, size);
-        if (left == -1)
+        if (left == -1 && (errno == EAGAIN || errno == EINTR))
+        {
+            // No more events for now.
+            return 0;
+        }
+        else if (left == -1)
         {
             wxLogSysError(_("Unable to read from inotify descriptor"));
             return -1;
@@ -656,11 +822,27 @@ protected:
     wxInotifyCookies m_cookies;           // map to track renames
     wxEventLoopSource* m_source;          // our event loop source
 
+    std::vector<char> m_buffer;           // buffer for reading the events
+
+    // changes waiting to be sent in a single batch event
+    std::vector<wxFileSystemWatcherChange> m_batch;
+
+    // modified paths waiting for the end of the coalescing interval, in the
+    // order of modification (null if already reported), and their indices
+    std::vector<std::unique_ptr<wxFileName>> m_modified;
+    std::unordered_map<std::string, size_t> m_modifiedIndex;
+    std::unique_ptr<wxFSWCoalesceTimer> m_timer;
+
     // file descriptor created by inotify_init()
     int m_ifd;
 };
 
 
+void wxFSWCoalesceTimer::Notify()
+{
+    m_service->OnCoalesceTimer();
+}
+
 // ============================================================================
 // wxFSWSourceHandler implementation
 // ============================================================================
@@ -687,6 +869,27 @@ void wxFSWSourceHandler::OnExceptionWaiting()
 // wxInotifyFileSystemWatcher implementation
 // ============================================================================
 
+struct wxInotifyFileSystemWatcher::AsyncTrees
+{
+    struct Tree
+    {
+        wxFileName path;
+        std::string canonical;
+        int events;
+        std::string filespec;
+    };
+
+    // The trees whose subdirectories are still being read, by their ids.
+    std::unordered_map<unsigned, Tree> pending;
+    unsigned lastId{0};
+
+    // Set when the watcher is destroyed to abandon the scans in progress.
+    std::atomic<bool> stop{false};
+
+    // Declared last to be destroyed first, waiting for the running scans.
+    wxWorkerPool pool{1};
+};
+
 wxInotifyFileSystemWatcher::wxInotifyFileSystemWatcher()
     : wxFileSystemWatcherBase()
 {
@@ -708,6 +911,148 @@ wxInotifyFileSystemWatcher::wxInotifyFileSystemWatcher(const wxFileName& path,
 
 wxInotifyFileSystemWatcher::~wxInotifyFileSystemWatcher()
 {
+    if ( m_asyncTrees )
+    {
+        m_asyncTrees->stop = true;
+        m_asyncTrees.reset();
+    }
+}
+
+bool wxInotifyFileSystemWatcher::AddTree(const wxFileName& path, int events,
+                                         const std::string& filespec)
+{
+    if ( !IsAsyncAddTreeEnabled() )
+        return wxFileSystemWatcherBase::AddTree(path, events, filespec);
+
+    if ( !path.DirExists() )
+        return false;
+
+    // Watch the root immediately, its subdirectories are watched only when
+    // they have all been read.
+    if ( !AddAny(path.GetFullPath(), events, wxFSWPathType::Tree, filespec) )
+        return false;
+
+    if ( !m_asyncTrees )
+        m_asyncTrees = std::make_unique<AsyncTrees>();
+
+    const unsigned id = ++m_asyncTrees->lastId;
+    m_asyncTrees->pending[id] = { path, GetCanonicalPath(path), events, filespec };
+
+    // As in the base class version, prevent infinite loops with symlinks.
+    int flags = wxDIR_DIRS;
+    if ( !path.ShouldFollowLink() )
+        flags |= wxDIR_NO_FOLLOW;
+
+    class Collector : public wxDirTraverser
+    {
+    public:
+        Collector(std::vector<std::string>& dirs, const std::atomic<bool>& stop)
+            : m_dirs(dirs), m_stop(stop)
+        {
+        }
+
+        wxDirTraverseResult OnFile([[maybe_unused]] const std::string& filename) override
+        {
+            return wxDirTraverseResult::Continue;
+        }
+
+        wxDirTraverseResult OnDir(const std::string& dirname) override
+        {
+            if ( m_stop )
+                return wxDirTraverseResult::Stop;
+
+            m_dirs.push_back(dirname);
+            return wxDirTraverseResult::Continue;
+        }
+
+    private:
+        std::vector<std::string>& m_dirs;
+        const std::atomic<bool>& m_stop;
+    };
+
+    // The task must not use m_asyncTrees, which is already null when the
+    // destructor waits for the task to finish, but the object itself remains
+    // alive until then.
+    AsyncTrees* const trees = m_asyncTrees.get();
+    trees->pool.Submit([this, trees, id, root = path.GetFullPath(), filespec, flags]()
+    {
+        std::vector<std::string> dirs;
+
+        wxDir dir(root);
+        if ( dir.IsOpened() )
+        {
+            Collector collector(dirs, trees->stop);
+            dir.TraverseParallel(collector, filespec, flags);
+        }
+
+        if ( trees->stop )
+            return;
+
+        CallAfter([this, id, dirs = std::move(dirs)]()
+        {
+            OnTreeScanned(id, dirs);
+        });
+    });
+
+    return true;
+}
+
+void wxInotifyFileSystemWatcher::OnTreeScanned(unsigned id,
+                                               const std::vector<std::string>& dirs)
+{
+    // The tree could have been removed while it was being read.
+    const auto it = m_asyncTrees->pending.find(id);
+    if ( it == m_asyncTrees->pending.end() )
+        return;
+
+    const AsyncTrees::Tree tree = std::move(it->second);
+    m_asyncTrees->pending.erase(it);
+
+    for ( const std::string& dirname : dirs )
+    {
+        if ( AddAny(wxFileName::DirName(dirname),
+                    tree.events, wxFSWPathType::Tree, tree.filespec) )
+        {
+            wxLogTrace(wxTRACE_FSWATCHER,
+                       "--- AddTree adding directory '%s' ---", dirname);
+        }
+    }
+
+    wxFileSystemWatcherEvent event(0, tree.path, tree.path);
+    event.SetEventType(wxEVT_FSWATCHER_TREE_ADDED);
+    GetOwner()->ProcessEvent(event);
+}
+
+bool wxInotifyFileSystemWatcher::RemoveTree(const wxFileName& path)
+{
+    // If the tree is still being read, only its root is watched yet.
+    if ( m_asyncTrees )
+    {
+        const std::string canonical = GetCanonicalPath(path);
+
+        auto& pending = m_asyncTrees->pending;
+        const auto it = std::ranges::find_if(pending, [&canonical](const auto& p)
+        {
+            return p.second.canonical == canonical;
+        });
+
+        if ( it != pending.end() )
+        {
+            pending.erase(it);
+            return Remove(path);
+        }
+    }
+
+    return wxFileSystemWatcherBase::RemoveTree(path);
+}
+
+bool wxInotifyFileSystemWatcher::RemoveAll()
+{
+    // The trees being read are not going to be watched any more.
+    if ( m_asyncTrees )
+        m_asyncTrees->pending.clear();
+
+    return wxFileSystemWatcherBase::RemoveAll();
 }
 
 bool wxInotifyFileSystemWatcher::Init()
@@ -389,6 +389,8 @@
 #include <wx/xtixml.h>
 #include <wx/zipstrm.h>
 #include <wx/zstream.h>
+#include <wx/zstdstream.h>
+#include <wx/zstdstream.h>
 
 #if defined(WX_WINDOWS)
 #include <wx/dde.h>
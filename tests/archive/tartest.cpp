@@ -1,11 +1,13 @@
 ///////////////////////////////////////////////////////////////////////////////
-// Name:        tests/tartest.cpp
+// Name:        tests/archive/tartest.cpp
 // Purpose:     Test the tar classes
 // Author:      Mike Wetherell
 // Copyright:   (c) 2004 Mike Wetherell
 // Licence:     wxWindows licence
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "doctest.h"
+
 #include "testprec.h"
 
 #ifndef WX_PRECOMP
@@ -16,6 +18,8 @@
 #include "archivetest.h"
 #include "wx/tarstrm.h"
 
+import WX.Cmn.MemStream;
+
 using std::string;
 
 
@@ -68,4 +72,173 @@ CppUnit::Test *tartest::makeTest(
 CPPUNIT_TEST_SUITE_REGISTRATION(tartest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(tartest, "archive/tar");
 
+
+///////////////////////////////////////////////////////////////////////////////
+// wxTarIndex tests
+
+namespace
+{
+
+// Returns all the remaining data of the stream.
+string ReadAll(wxInputStream& in)
+{
+    string data;
+    char buf[4096];
+
+    while ( in.Read(buf, sizeof(buf)).LastRead() > 0 )
+        data.append(buf, in.LastRead());
+
+    return data;
+}
+
+// Appends a header block in the old GNU format, which wxTarOutputStream
+// doesn't create, to the given output stream.
+void WriteGnuHeader(wxOutputStream& out,
+                    const string& name,
+                    char type,
+                    size_t size)
+{
+    char block[512] = {};
+
+    name.copy(block, 99);
+    snprintf(block + 100, 8, "%07o", 0644u);
+    snprintf(block + 108, 8, "%07o", 0u);
+    snprintf(block + 116, 8, "%07o", 0u);
+    snprintf(block + 124, 12, "%011llo", static_cast<unsigned long long>(size));
+    snprintf(block + 136, 12, "%011o", 0u);
+    block[156] = type;
+    memcpy(block + 257, "ustar  ", 8);
+
+    memset(block + 148, ' ', 8);
+    unsigned sum = 0;
+    for ( unsigned char c : block )
+        sum += c;
+    snprintf(block + 148, 8, "%06o", sum);
+
+    out.Write(block, sizeof(block));
+}
+
+// Appends the data padded to a whole number of blocks.
+void WriteGnuData(wxOutputStream& out, const string& data)
+{
+    out.Write(data.data(), data.size());
+
+    const string padding((512 - data.size() % 512) % 512, '\0');
+    out.Write(padding.data(), padding.size());
+}
+
+// Appends an entry with a name which doesn't fit into the header block, in
+// the way GNU tar does it.
+void WriteGnuLongNameEntry(wxOutputStream& out,
+                           const string& name,
+                           const string& data)
+{
+    const string longName = name + '\0';
+    WriteGnuHeader(out, "././@LongLink", 'L', longName.size());
+    WriteGnuData(out, longName);
+
+    WriteGnuHeader(out, name, '0', data.size());
+    WriteGnuData(out, data);
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxTarIndex")
+{
+    const string gnuName = "gnu/" + string(120, 'g') + ".txt";
+    const string gnuData = "Entry with a GNU long name";
+    const string paxName = "pax/" + string(120, 'p') + ".txt";
+    const string paxData(3000, 'x');
+
+    struct TestEntry
+    {
+        string name;
+        string data;
+    };
+
+    const TestEntry entries[] =
+    {
+        { "short.txt",          "Short name"                },
+        { gnuName,              gnuData                     },
+        { "gnu/after.txt",      "After the GNU long name"   },
+        { paxName,              paxData                     },
+        { "dir/last.txt",       "Last entry"                },
+    };
+
+    // The first entries are written in the GNU format by hand, and the rest
+    // by wxTarOutputStream, which uses pax headers for the long names.
+    wxMemoryOutputStream out;
+    WriteGnuHeader(out, entries[0].name, '0', entries[0].data.size());
+    WriteGnuData(out, entries[0].data);
+    WriteGnuLongNameEntry(out, entries[1].name, entries[1].data);
+    WriteGnuHeader(out, entries[2].name, '0', entries[2].data.size());
+    WriteGnuData(out, entries[2].data);
+    {
+        wxTarOutputStream tar(out);
+        for ( size_t n = 3; n < WXSIZEOF(entries); n++ )
+        {
+            REQUIRE( tar.PutNextEntry(entries[n].name) );
+            tar.Write(entries[n].data.data(), entries[n].data.size());
+        }
+        REQUIRE( tar.Close() );
+    }
+
+    wxMemoryInputStream in(out);
+    wxTarInputStream tar(in);
+
+    wxTarIndex index;
+    REQUIRE( index.Build(tar) );
+    REQUIRE( index.GetCount() == WXSIZEOF(entries) );
+
+    CHECK( !index.FindEntry("missing.txt") );
+    CHECK( !index.FindEntry("././@LongLink") );
+
+    SUBCASE("OpenByName")
+    {
+        // Open the entries in the reverse order, to check that they don't
+        // depend on the preceding ones having been read.
+        for ( size_t n = WXSIZEOF(entries); n > 0; n-- )
+        {
+            const TestEntry& test = entries[n - 1];
+            INFO("Entry \"" << test.name << "\"");
+
+            const wxTarIndex::Entry* const found =
+                index.FindEntry(test.name, wxPATH_UNIX);
+            REQUIRE( found );
+            CHECK( found == &index.GetEntry(n - 1) );
+            CHECK( found->size == static_cast<wxFileOffset>(test.data.size()) );
+
+            std::unique_ptr<wxTarEntry> entry(index.OpenEntry(tar, *found));
+            REQUIRE( entry );
+            CHECK( entry->GetName(wxPATH_UNIX) == test.name );
+            CHECK( entry->GetOffset() == found->dataOffset );
+            CHECK( ReadAll(tar) == test.data );
+        }
+    }
+
+    SUBCASE("SaveLoad")
+    {
+        wxMemoryOutputStream saved;
+        REQUIRE( index.Save(saved) );
+
+        wxMemoryInputStream savedIn(saved);
+        wxTarIndex loaded;
+        REQUIRE( loaded.Load(savedIn) );
+        REQUIRE( loaded.GetCount() == index.GetCount() );
+
+        for ( const TestEntry& test : entries )
+        {
+            INFO("Entry \"" << test.name << "\"");
+
+            const wxTarIndex::Entry* const found =
+                loaded.FindEntry(test.name, wxPATH_UNIX);
+            REQUIRE( found );
+
+            std::unique_ptr<wxTarEntry> entry(loaded.OpenEntry(tar, *found));
+            REQUIRE( entry );
+            CHECK( ReadAll(tar) == test.data );
+        }
+    }
+}
+
 #endif // wxUSE_STREAMS
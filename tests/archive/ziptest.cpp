@@ -6,6 +6,8 @@
 // Licence:     wxWindows licence
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "doctest.h"
+
 #include "testprec.h"
 
 #ifndef WX_PRECOMP
@@ -14,7 +16,13 @@
 #if wxUSE_STREAMS && wxUSE_ZIPSTREAM
 
 #include "archivetest.h"
+#include "testfile.h"
+#include "wx/filesys.h"
+
 import WX.Cmn.ZipStream;
+import WX.Cmn.MemStream;
+import WX.Cmn.WFStream;
+import WX.FileSys.Arc;
 
 using std::string;
 
@@ -247,4 +255,234 @@ CppUnit::Test *ziptest::makeTest(
 CPPUNIT_TEST_SUITE_REGISTRATION(ziptest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ziptest, "archive/zip");
 
+
+///////////////////////////////////////////////////////////////////////////////
+// wxZipReader tests
+
+namespace
+{
+
+// Returns all the remaining data of the stream.
+string ReadAll(wxInputStream& in)
+{
+    string data;
+    char buf[4096];
+
+    while ( in.Read(buf, sizeof(buf)).LastRead() > 0 )
+        data.append(buf, in.LastRead());
+
+    return data;
+}
+
+// Writes a zip with a stored and a deflated entry to the given file.
+void CreateTestZip(const wxString& filename,
+                   const string& stored,
+                   const string& deflated)
+{
+    wxFileOutputStream out(filename);
+    wxZipOutputStream zip(out);
+
+    wxZipEntry *entry = new wxZipEntry("stored.txt");
+    entry->SetMethod(wxZIP_METHOD_STORE);
+    REQUIRE( zip.PutNextEntry(entry) );
+    zip.Write(stored.data(), stored.size());
+
+    REQUIRE( zip.PutNextEntry("dir/deflated.txt") );
+    zip.Write(deflated.data(), deflated.size());
+
+    REQUIRE( zip.Close() );
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxZipReader")
+{
+    TempFile tmp("wxzipreader.zip");
+
+    const string stored = "Stored without compression";
+    string deflated;
+    for ( int n = 0; n < 1000; n++ )
+        deflated += "Deflated line " + std::to_string(n) + "\n";
+
+    CreateTestZip(tmp.GetName(), stored, deflated);
+
+    wxZipReader reader(tmp.GetName().ToStdString());
+    REQUIRE( reader.IsOk() );
+    CHECK( reader.GetCount() == 2 );
+
+    CHECK( !reader.FindEntry("missing.txt") );
+
+    SUBCASE("Stored")
+    {
+        const wxZipEntry* const entry = reader.FindEntry("stored.txt");
+        REQUIRE( entry );
+        CHECK( entry->GetMethod() == wxZIP_METHOD_STORE );
+
+        std::unique_ptr<wxInputStream> in(reader.OpenEntry(*entry));
+        REQUIRE( in );
+        CHECK( ReadAll(*in) == stored );
+
+        const std::span<const std::byte> data = reader.GetStoredData(*entry);
+        REQUIRE( data.size() == stored.size() );
+        CHECK( memcmp(data.data(), stored.data(), stored.size()) == 0 );
+    }
+
+    SUBCASE("Deflated")
+    {
+        const wxZipEntry* const entry = reader.FindEntry("dir/deflated.txt");
+        REQUIRE( entry );
+        CHECK( entry->GetMethod() == wxZIP_METHOD_DEFLATE );
+        CHECK( entry->GetSize() == static_cast<wxFileOffset>(deflated.size()) );
+
+        // The compressed data can't be returned directly.
+        CHECK( reader.GetStoredData(*entry).empty() );
+
+        // Entries can be opened in any order and several times.
+        std::unique_ptr<wxInputStream> in1(reader.OpenEntry(*entry));
+        std::unique_ptr<wxInputStream> in2(reader.OpenEntry(*entry));
+        REQUIRE( in1 );
+        REQUIRE( in2 );
+        CHECK( ReadAll(*in2) == deflated );
+        CHECK( ReadAll(*in1) == deflated );
+    }
+
+    SUBCASE("ByIndex")
+    {
+        CHECK( reader.GetEntry(0)->GetName(wxPATH_UNIX) == "stored.txt" );
+        CHECK( reader.GetEntry(1)->GetName(wxPATH_UNIX) == "dir/deflated.txt" );
+        CHECK( !reader.GetEntry(2) );
+    }
+}
+
+TEST_CASE("wxArchiveFSHandler::OpenFile")
+{
+    TempFile tmp("wxzipfs.zip");
+
+    const string stored = "Stored entry";
+    const string deflated(10000, 'x');
+
+    CreateTestZip(tmp.GetName(), stored, deflated);
+
+    const string url = wxFileSystem::FileNameToURL(wxFileName(tmp.GetName()));
+
+    wxArchiveFSHandler handler;
+    wxFileSystem fs;
+
+    // Entries of local zip files are opened through wxZipReader.
+    std::unique_ptr<wxFSFile> file(handler.OpenFile(fs, url + "#zip:dir/deflated.txt"));
+    REQUIRE( file );
+    CHECK( ReadAll(*file->GetStream()) == deflated );
+
+    file.reset(handler.OpenFile(fs, url + "#zip:stored.txt"));
+    REQUIRE( file );
+    CHECK( ReadAll(*file->GetStream()) == stored );
+
+    // And the same reader is reused for the other entries.
+    file.reset(handler.OpenFile(fs, url + "#zip:dir/deflated.txt"));
+    REQUIRE( file );
+    CHECK( ReadAll(*file->GetStream()) == deflated );
+
+    CHECK( !handler.OpenFile(fs, url + "#zip:missing.txt") );
+}
+
+TEST_CASE("wxZipOutputStream::EnableParallelCompression")
+{
+    // The data of all the entries, in the order they're written.
+    const string small = "Deflated data, deflated data, deflated data";
+    string large(5 * 1024 * 1024, '\0');
+    for ( size_t n = 0; n < large.size(); n++ )
+        large[n] = static_cast<char>((n * n + n / 4096) % 251);
+
+    struct TestEntry
+    {
+        string name;
+        string data;
+        bool stored;
+    };
+
+    const TestEntry entries[] =
+    {
+        { "stored.txt",   "Stored without compression",  true  },
+        { "deflated.txt", small,                         false },
+        { "copied.txt",   small + small,                 false },
+        { "tiny.txt",     "tiny!!",                      false },
+        { "empty.txt",    "",                            false },
+        // Bigger than 4MiB, so written directly after the preceding ones.
+        { "large.bin",    large,                         false },
+        { "after.txt",    small,                         false },
+        { "tiny2.txt",    "x",                           true  },
+    };
+
+    // The entry to copy comes from another archive.
+    wxMemoryOutputStream copySource;
+    {
+        wxZipOutputStream zip(copySource);
+        REQUIRE( zip.PutNextEntry("copied.txt") );
+        zip.Write(entries[2].data.data(), entries[2].data.size());
+    }
+
+    // Create the same archive with and without parallel compression.
+    const auto createArchive = [&](wxMemoryOutputStream& out, bool parallel)
+    {
+        wxMemoryInputStream copyIn(copySource);
+        wxZipInputStream copyZip(copyIn);
+
+        wxZipOutputStream zip(out);
+        zip.EnableParallelCompression(parallel);
+
+        for ( const TestEntry& e : entries )
+        {
+            if ( e.name == "copied.txt" )
+            {
+                wxZipEntry* const entry = copyZip.GetNextEntry();
+                REQUIRE( entry );
+                REQUIRE( zip.CopyEntry(entry, copyZip) );
+                continue;
+            }
+
+            wxZipEntry* const entry = new wxZipEntry(e.name);
+            if ( e.stored )
+                entry->SetMethod(wxZIP_METHOD_STORE);
+            REQUIRE( zip.PutNextEntry(entry) );
+            zip.Write(e.data.data(), e.data.size());
+        }
+
+        REQUIRE( zip.Close() );
+    };
+
+    wxMemoryOutputStream serialOut, parallelOut;
+    createArchive(serialOut, false);
+    createArchive(parallelOut, true);
+
+    wxMemoryInputStream serialIn(serialOut);
+    wxZipInputStream serialZip(serialIn);
+
+    wxMemoryInputStream parallelIn(parallelOut);
+    wxZipInputStream parallelZip(parallelIn);
+
+    for ( const TestEntry& e : entries )
+    {
+        INFO( "entry " << e.name );
+
+        std::unique_ptr<wxZipEntry> serial(serialZip.GetNextEntry());
+        std::unique_ptr<wxZipEntry> parallel(parallelZip.GetNextEntry());
+        REQUIRE( serial );
+        REQUIRE( parallel );
+
+        // The entries must be in the original order, with the same method,
+        // crc and size as when compressing them serially.
+        CHECK( parallel->GetName(wxPATH_UNIX) == e.name );
+        CHECK( parallel->GetMethod() == serial->GetMethod() );
+        CHECK( parallel->GetCrc() == serial->GetCrc() );
+        CHECK( parallel->GetSize() == static_cast<wxFileOffset>(e.data.size()) );
+
+        // Reading the data until the end checks its crc too.
+        CHECK( ReadAll(parallelZip) == e.data );
+        CHECK( parallelZip.GetLastError() == wxSTREAM_EOF );
+    }
+
+    CHECK( !parallelZip.GetNextEntry() );
+    CHECK( parallelZip.GetTotalEntries() == static_cast<int>(WXSIZEOF(entries)) );
+}
+
 #endif // wxUSE_STREAMS && wxUSE_ZIPSTREAM
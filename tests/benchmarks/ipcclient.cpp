@@ -22,7 +22,7 @@ namespace
 class PokeAdviseConn : public wxConnection
 {
 public:
-    PokeAdviseConn() { m_gotAdvised = false; }
+    PokeAdviseConn() { m_gotAdvised = false; m_numAdvised = 0; }
 
     bool GotAdvised()
     {
@@ -34,6 +34,15 @@ public:
         return true;
     }
 
+    // return the number of notifications received since the last call
+    size_t TakeNumAdvised()
+    {
+        const size_t num = m_numAdvised;
+        m_numAdvised = 0;
+        m_gotAdvised = false;
+        return num;
+    }
+
     const wxString& GetItem() const { return m_item; }
 
     virtual bool OnAdvise(const wxString& topic,
@@ -43,6 +52,7 @@ public:
                           wxIPCFormat format)
     {
         m_gotAdvised = true;
+        m_numAdvised++;
 
         if ( topic != IPC_BENCHMARK_TOPIC ||
                 item != IPC_BENCHMARK_ITEM ||
@@ -60,6 +70,7 @@ public:
 private:
     wxString m_item;
     bool m_gotAdvised;
+    size_t m_numAdvised;
 
     PokeAdviseConn(const PokeAdviseConn&) = delete;
 	PokeAdviseConn& operator=(const PokeAdviseConn&) = delete;
@@ -170,3 +181,63 @@ BENCHMARK_FUNC_WITH_INIT(IPCPokeAdvise, ConnInit, ConnDone)
 
     return true;
 }
+
+BENCHMARK_FUNC_WITH_INIT(IPCPokeAdviseBatch, ConnInit, ConnDone)
+{
+    wxEventLoop loop;
+
+    PokeAdviseConn * const conn = theConnection->Get();
+
+    const wxString s(1024, '@');
+
+    // Send all the pokes in a single write and wait for all the replies.
+    static constexpr size_t NUM_POKES = 16;
+
+    conn->BeginBatch();
+    for ( size_t n = 0; n < NUM_POKES; n++ )
+    {
+        if ( !conn->Poke(IPC_BENCHMARK_ITEM, s) )
+        {
+            conn->EndBatch();
+            return false;
+        }
+    }
+    conn->EndBatch();
+
+    size_t numAdvised = 0;
+    while ( numAdvised < NUM_POKES )
+    {
+        loop.Dispatch();
+        numAdvised += conn->TakeNumAdvised();
+    }
+
+    if ( conn->GetItem() != s )
+        return false;
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(IPCRequestPipelined, ConnInit, ConnDone)
+{
+    PokeAdviseConn * const conn = theConnection->Get();
+
+    // Send all the requests before waiting for the first reply.
+    static constexpr size_t NUM_REQUESTS = 16;
+
+    std::uint32_t ids[NUM_REQUESTS];
+    for ( auto& id : ids )
+    {
+        id = conn->RequestAsync(IPC_BENCHMARK_ITEM, wxIPC_UTF8TEXT);
+        if ( !id )
+            return false;
+    }
+
+    for ( const auto id : ids )
+    {
+        size_t size = 0;
+        if ( !conn->GetReply(id, &size) )
+            return false;
+    }
+
+    return true;
+}
@@ -76,3 +76,60 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+// ----------------------------------------------------------------------------
+// UTF-8 benchmarks
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// long mostly ASCII text with some other characters, as is typical for real
+// documents
+const wxCharBuffer& GetUTF8TestString()
+{
+    static wxCharBuffer buf;
+    if ( !buf )
+    {
+        wxString s;
+        for ( int n = 0; n < 100; n++ )
+        {
+            s += TEST_STRING;
+            s += wxString::FromUTF8("\xC3\xA9t\xC3\xA9 \xE2\x82\xAC ");
+        }
+
+        buf = s.utf8_str();
+    }
+
+    return buf;
+}
+
+const wxWCharBuffer& GetWideTestString()
+{
+    static wxWCharBuffer wbuf;
+    if ( !wbuf )
+        wbuf = wxConvUTF8.cMB2WC(GetUTF8TestString());
+
+    return wbuf;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(UTF8LenWX)
+{
+    const wxCharBuffer& buf = GetUTF8TestString();
+    return wxConvUTF8.ToWChar(nullptr, 0, buf.data(), buf.length())
+            != wxCONV_FAILED;
+}
+
+BENCHMARK_FUNC(UTF8ToWCharWX)
+{
+    const wxCharBuffer& buf = GetUTF8TestString();
+    return wxConvUTF8.cMB2WC(buf.data(), buf.length(), nullptr).length() != 0;
+}
+
+BENCHMARK_FUNC(UTF8FromWCharWX)
+{
+    const wxWCharBuffer& wbuf = GetWideTestString();
+    return wxConvUTF8.cWC2MB(wbuf.data(), wbuf.length(), nullptr).length() != 0;
+}
@@ -18,6 +18,8 @@
 #include "wx/imaglist.h"
 #include "wx/uiaction.h"
 
+#include "wx/generic/listctrl.h"
+
 #include "listbasetest.h"
 #include "testableframe.h"
 
@@ -144,4 +146,206 @@ TEST_CASE_FIXTURE(ListCtrlTest, "List control test")
 #endif // wxUSE_UIACTIONSIMULATOR
 }
 
+TEST_CASE("wxGenericListCtrl::SortItemsByColumn")
+{
+    std::unique_ptr<wxGenericListCtrl> list(
+        new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                              wxDefaultPosition, wxDefaultSize, wxLC_REPORT));
+
+    list->InsertColumn(0, "Name");
+    list->InsertColumn(1, "Size");
+
+    const char* const names[] = { "beta", "Alpha", "gamma", "delta" };
+    const char* const sizes[] = { "10", "9", "x", "100" };
+    for ( int i = 0; i < 4; i++ )
+    {
+        list->InsertItem(i, names[i]);
+        list->SetItem(i, 1, sizes[i]);
+        list->SetItemData(i, i);
+    }
+
+    list->SetItemState(0, ListStates::Selected, ListStates::Selected);
+
+    SUBCASE("Text")
+    {
+        list->SortItemsByColumn(0, wxListSortKey::Text);
+        CHECK( list->GetItemText(0) == "Alpha" );
+        CHECK( list->GetItemText(1) == "beta" );
+        CHECK( list->GetItemText(3) == "gamma" );
+
+        // The selection moves together with the item.
+        CHECK( list->GetItemState(1, ListStates::Selected) == ListStates::Selected );
+        CHECK( list->GetSelectedItemCount() == 1 );
+    }
+
+    SUBCASE("TextNoCase")
+    {
+        list->SortItemsByColumn(0, wxListSortKey::TextNoCase, false);
+        CHECK( list->GetItemText(0) == "gamma" );
+        CHECK( list->GetItemText(3) == "Alpha" );
+    }
+
+    SUBCASE("Numeric")
+    {
+        list->SortItemsByColumn(1, wxListSortKey::Numeric);
+        CHECK( list->GetItemText(0, 1) == "9" );
+        CHECK( list->GetItemText(1, 1) == "10" );
+        CHECK( list->GetItemText(2, 1) == "100" );
+        CHECK( list->GetItemText(3, 1) == "x" );
+    }
+
+    SUBCASE("NumericDescending")
+    {
+        // The invalid numbers still sort last.
+        list->SortItemsByColumn(1, wxListSortKey::Numeric, false);
+        CHECK( list->GetItemText(0, 1) == "100" );
+        CHECK( list->GetItemText(1, 1) == "10" );
+        CHECK( list->GetItemText(2, 1) == "9" );
+        CHECK( list->GetItemText(3, 1) == "x" );
+    }
+
+    SUBCASE("KeyFunc")
+    {
+        list->SortItemsByColumn(0,
+            [](const wxString&, wxUIntPtr data) { return -static_cast<double>(data); });
+        CHECK( list->GetItemText(0) == "delta" );
+        CHECK( list->GetItemText(3) == "beta" );
+    }
+
+    SUBCASE("InsertSorted")
+    {
+        list->SortItemsByColumn(0, wxListSortKey::TextNoCase);
+        CHECK( list->IsSortedByColumn() );
+
+        wxListItem item;
+        item.SetColumn(0);
+        item.SetText("charlie");
+        CHECK( list->InsertItemSorted(item) == 2 );
+        CHECK( list->GetItemText(2) == "charlie" );
+        CHECK( list->GetItemCount() == 5 );
+
+        item.SetText("zulu");
+        CHECK( list->InsertItemSorted(item) == 5 );
+
+        // Changing the text of the sort column forgets the order.
+        list->SetItem(0, 0, "omega");
+        CHECK( !list->IsSortedByColumn() );
+    }
+}
+
+TEST_CASE("wxGenericListCtrl::EnableFindIndex")
+{
+    std::unique_ptr<wxGenericListCtrl> list(
+        new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                              wxDefaultPosition, wxDefaultSize, wxLC_REPORT));
+
+    list->InsertColumn(0, "Name");
+    list->EnableFindIndex();
+    CHECK( list->IsFindIndexEnabled() );
+
+    const char* const names[] = { "apple", "Banana", "apricot", "APPLE", "cherry" };
+    for ( int i = 0; i < 5; i++ )
+    {
+        list->InsertItem(i, names[i]);
+        list->SetItemData(i, 100 + i % 2);
+    }
+
+    CHECK( list->FindItem(0, "apple") == 0 );
+    CHECK( list->FindItem(1, "apple") == 3 );
+    CHECK( list->FindItem(4, "apple") == wxNOT_FOUND );
+    CHECK( list->FindItem(0, "ap", true) == 0 );
+    CHECK( list->FindItem(1, "ap", true) == 2 );
+    CHECK( list->FindItem(0, "banana") == 1 );
+    CHECK( list->FindItem(0, "ban") == wxNOT_FOUND );
+
+    CHECK( list->FindItem(0, (wxUIntPtr)101) == 1 );
+    CHECK( list->FindItem(2, (wxUIntPtr)101) == 3 );
+    CHECK( list->FindItem(0, (wxUIntPtr)102) == wxNOT_FOUND );
+
+    // The index must be updated after the items change.
+    list->DeleteItem(0);
+    CHECK( list->FindItem(0, "apple") == 2 );
+
+    list->SetItemText(3, "date");
+    CHECK( list->FindItem(0, "cherry") == wxNOT_FOUND );
+    CHECK( list->FindItem(0, "date") == 3 );
+
+    list->SetItemData(1, 7);
+    CHECK( list->FindItem(0, (wxUIntPtr)7) == 1 );
+
+    // Inserting items shifts the indices of the following ones.
+    list->InsertItem(0, "date");
+    CHECK( list->FindItem(0, "date") == 0 );
+    CHECK( list->FindItem(1, "date") == 4 );
+    CHECK( list->FindItem(0, (wxUIntPtr)7) == 2 );
+    CHECK( list->FindItem(0, "apricot") == 2 );
+
+    list->DeleteItem(0);
+    CHECK( list->FindItem(0, "date") == 3 );
+    CHECK( list->FindItem(0, (wxUIntPtr)7) == 1 );
+
+    list->SortItemsByColumn(0, wxListSortKey::TextNoCase);
+    CHECK( list->FindItem(0, "apple") == 0 );
+    CHECK( list->FindItem(0, "date") == 3 );
+}
+
+TEST_CASE("wxGenericListCtrl::PrefixFindItem")
+{
+    std::unique_ptr<wxGenericListCtrl> list(
+        new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                              wxDefaultPosition, wxDefaultSize, wxLC_REPORT));
+
+    list->InsertColumn(0, "Name");
+    list->EnableFindIndex();
+
+    // Inserting many items at the same position exercises relabelling the
+    // lines in the index: the line with index n contains "x(49-n)".
+    for ( int i = 0; i < 50; i++ )
+        list->InsertItem(0, wxString::Format("x%02d", i));
+
+    list->InsertItem(50, "y");
+
+    CHECK( list->FindItem(0, "x", true) == 0 );
+    CHECK( list->FindItem(0, "x07", true) == 42 );
+    CHECK( list->FindItem(0, "x4", true) == 0 );
+    CHECK( list->FindItem(10, "x4", true) == wxNOT_FOUND );
+    CHECK( list->FindItem(0, "y", true) == 50 );
+    CHECK( list->FindItem(51, "x", true) == wxNOT_FOUND );
+
+    SUBCASE("Insert")
+    {
+        list->InsertItem(25, "y");
+        CHECK( list->FindItem(25, "x", true) == 26 );
+        CHECK( list->FindItem(0, "x07", true) == 43 );
+        CHECK( list->FindItem(0, "y", true) == 25 );
+        CHECK( list->FindItem(26, "y", true) == 51 );
+    }
+
+    SUBCASE("Delete")
+    {
+        list->InsertItem(25, "y");
+        list->DeleteItem(0);
+        list->DeleteItem(24);
+        CHECK( list->FindItem(0, "x48", true) == 0 );
+        CHECK( list->FindItem(24, "x", true) == 24 );
+        CHECK( list->FindItem(0, "x07", true) == 41 );
+        CHECK( list->FindItem(0, "y", true) == 49 );
+        CHECK( list->FindItem(0, "x49", true) == wxNOT_FOUND );
+    }
+
+    SUBCASE("Sort")
+    {
+        list->SortItemsByColumn(0, wxListSortKey::TextNoCase);
+        CHECK( list->FindItem(0, "x4", true) == 40 );
+        CHECK( list->FindItem(45, "x4", true) == 45 );
+        CHECK( list->FindItem(0, "x5", true) == wxNOT_FOUND );
+        CHECK( list->FindItem(0, "y", true) == 50 );
+
+        list->InsertItem(0, "x99");
+        CHECK( list->FindItem(0, "x9", true) == 0 );
+        CHECK( list->FindItem(1, "x9", true) == wxNOT_FOUND );
+        CHECK( list->FindItem(1, "x", true) == 1 );
+    }
+}
+
 #endif // wxUSE_LISTCTRL
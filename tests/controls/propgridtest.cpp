@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/controls/propgridtest.cpp
+// Purpose:     wxPropertyGrid unit test
+// Copyright:   (c) 2026 wxWidgets development team
+///////////////////////////////////////////////////////////////////////////////
+
+#include "doctest.h"
+
+#if wxUSE_PROPGRID
+
+#include "wx/app.h"
+#include "wx/propgrid/propgrid.h"
+#include "wx/propgrid/props.h"
+
+import WX.Test.Prec;
+
+namespace
+{
+
+// Check that the visible rows are the expected ones and that they're found
+// at the right positions.
+void CheckRows(const wxPropertyGrid& pg,
+               const std::vector<wxPGProperty*>& expected)
+{
+    CHECK( pg.GetState()->GetVisibleRows() == expected );
+
+    const int lh = pg.GetRowHeight();
+    for ( size_t n = 0; n < expected.size(); n++ )
+        CHECK_EQ( expected[n], pg.GetItemAtY(n*lh + lh/2) );
+
+    CHECK( !pg.GetItemAtY(expected.size()*lh + lh/2) );
+}
+
+} // anonymous namespace
+
+TEST_CASE("Property grid test")
+{
+    auto pg = std::make_unique<wxPropertyGrid>(wxTheApp->GetTopWindow(),
+                                               wxID_ANY,
+                                               wxDefaultPosition,
+                                               wxSize(400, 200));
+
+    wxPGProperty* const p1 = pg->Append(new wxStringProperty("p1"));
+    wxPGProperty* const c11 = pg->AppendIn(p1, new wxStringProperty("c11"));
+    wxPGProperty* const c12 = pg->AppendIn(p1, new wxStringProperty("c12"));
+    wxPGProperty* const g121 = pg->AppendIn(c12, new wxStringProperty("g121"));
+    wxPGProperty* const p2 = pg->Append(new wxStringProperty("p2"));
+    wxPGProperty* const c21 = pg->AppendIn(p2, new wxStringProperty("c21"));
+    wxPGProperty* const p3 = pg->Append(new wxStringProperty("p3"));
+
+    pg->ExpandAll();
+
+    CheckRows(*pg, {p1, c11, c12, g121, p2, c21, p3});
+
+    SUBCASE("CollapseExpand")
+    {
+        pg->Collapse(p1);
+        CheckRows(*pg, {p1, p2, c21, p3});
+
+        // Properties after the collapsed one must still be found.
+        pg->Collapse(p2);
+        CheckRows(*pg, {p1, p2, p3});
+
+        pg->Expand(p1);
+        CheckRows(*pg, {p1, c11, c12, g121, p2, p3});
+
+        // Expanding a nested property after its parent moved.
+        pg->Collapse(c12);
+        CheckRows(*pg, {p1, c11, c12, p2, p3});
+
+        pg->Expand(p2);
+        pg->Expand(c12);
+        CheckRows(*pg, {p1, c11, c12, g121, p2, c21, p3});
+    }
+
+    SUBCASE("ExpandHidden")
+    {
+        // Changing the state of a property inside a collapsed one doesn't
+        // change the visible rows.
+        pg->Collapse(p1);
+        pg->Collapse(c12);
+        CheckRows(*pg, {p1, p2, c21, p3});
+
+        pg->Expand(p1);
+        CheckRows(*pg, {p1, c11, c12, p2, c21, p3});
+    }
+
+    SUBCASE("Hide")
+    {
+        pg->HideProperty(c11);
+        CheckRows(*pg, {p1, c12, g121, p2, c21, p3});
+
+        pg->Collapse(c12);
+        CheckRows(*pg, {p1, c12, p2, c21, p3});
+
+        pg->HideProperty(c11, false);
+        pg->Expand(c12);
+        CheckRows(*pg, {p1, c11, c12, g121, p2, c21, p3});
+    }
+
+    SUBCASE("CollapseAll")
+    {
+        pg->CollapseAll();
+        CheckRows(*pg, {p1, p2, p3});
+
+        pg->Expand(p2);
+        CheckRows(*pg, {p1, p2, c21, p3});
+    }
+
+    SUBCASE("ChildrenProvider")
+    {
+        wxPGProperty* const p4 = pg->Append(new wxStringProperty("p4"));
+        wxPGProperty* c41 = nullptr;
+        pg->SetPropertyChildrenProvider(p4, [&](wxPGProperty* p)
+            {
+                c41 = pg->AppendIn(p, new wxStringProperty("c41"));
+            });
+
+        pg->Collapse(p1);
+        CheckRows(*pg, {p1, p2, c21, p3, p4});
+
+        pg->Expand(p4);
+        REQUIRE( c41 );
+        CheckRows(*pg, {p1, p2, c21, p3, p4, c41});
+    }
+}
+
+#endif // wxUSE_PROPGRID
@@ -523,6 +523,78 @@ TEST_CASE("Tree control test")
         CHECK_EQ(zitem, m_tree->GetNextChild(m_root, cookie));
     }
 
+#ifdef wxHAS_GENERIC_TREECTRL
+    SUBCASE("VirtualWidthAfterCollapse")
+    {
+        wxTreeItemId wide = m_tree->AppendItem(m_grandchild,
+                                               wxString('W', 500));
+        m_tree->ExpandAll();
+        m_tree->Refresh();
+        m_tree->Update();
+        wxYield();
+
+        const int widthExpanded = m_tree->GetVirtualSize().x;
+        CHECK( widthExpanded > 400 );
+
+        // collapsing the branch with the wide item must shrink the virtual
+        // width again instead of keeping its maximum
+        m_tree->Collapse(m_child1);
+        m_tree->Refresh();
+        m_tree->Update();
+        wxYield();
+
+        CHECK( m_tree->GetVirtualSize().x < widthExpanded );
+
+        m_tree->ExpandAll();
+        m_tree->Refresh();
+        m_tree->Update();
+        wxYield();
+
+        CHECK_EQ( widthExpanded, m_tree->GetVirtualSize().x );
+
+        // and so must deleting it
+        m_tree->Delete(wide);
+        m_tree->Refresh();
+        m_tree->Update();
+        wxYield();
+
+        CHECK( m_tree->GetVirtualSize().x < widthExpanded );
+    }
+
+    SUBCASE("HitTestAfterCollapse")
+    {
+        wxRect rect;
+        REQUIRE( m_tree->GetBoundingRect(m_child2, rect, true) );
+
+        int flags = 0;
+        CHECK_EQ( m_child2, m_tree->HitTest(rect.GetPosition() + wxPoint(1, 1),
+                                            flags) );
+
+        // child2 moves up when child1 is collapsed and must still be found
+        m_tree->Collapse(m_child1);
+        m_tree->Refresh();
+        m_tree->Update();
+        wxYield();
+
+        wxRect rectCollapsed;
+        REQUIRE( m_tree->GetBoundingRect(m_child2, rectCollapsed, true) );
+        CHECK( rectCollapsed.y < rect.y );
+
+        CHECK_EQ( m_child2,
+                  m_tree->HitTest(rectCollapsed.GetPosition() + wxPoint(1, 1),
+                                  flags) );
+        CHECK_EQ( m_child1,
+                  m_tree->HitTest(wxPoint(rectCollapsed.x + 1,
+                                          rectCollapsed.y - 2),
+                                  flags) );
+
+        // nothing is below the last item
+        CHECK( !m_tree->HitTest(wxPoint(rectCollapsed.x + 1,
+                                        rectCollapsed.GetBottom() + 50),
+                                flags).IsOk() );
+    }
+#endif // wxHAS_GENERIC_TREECTRL
+
     SUBCASE("KeyNavigation")
     {
     #if wxUSE_UIACTIONSIMULATOR
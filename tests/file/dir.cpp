@@ -134,6 +134,48 @@ TEST_CASE("Directory Tests")
         CHECK_EQ(6, traverser.dirs.size());
     }
 
+    SUBCASE("TraverseParallel")
+    {
+        wxDir dir(DIRTEST_FOLDER);
+
+        TestDirTraverser traverser;
+        CHECK_EQ(0, dir.TraverseParallel(traverser, {}, wxDIR_DIRS | wxDIR_HIDDEN));
+        CHECK_EQ(6, traverser.dirs.size());
+
+        std::vector<std::string> files;
+        CHECK_EQ(4, wxDir::GetAllFiles(DIRTEST_FOLDER, &files, {},
+                                       wxDIR_DEFAULT, 0));
+
+        // The sorted order is the same as used by Traverse(), but with the
+        // entries of each directory sorted.
+        std::vector<std::string> expected
+        {
+            "folder1/subfolder2/dummy",
+            "folder3/subfolder1/dummy.foo",
+            "folder3/subfolder1/dummy.foo.bar",
+            "dummy"
+        };
+
+        for ( auto& file : expected )
+        {
+            wxString path = DIRTEST_FOLDER + SEP + file;
+            path.Replace("/", SEP);
+            file = path.ToStdString();
+        }
+
+        CHECK( files == expected );
+
+        files.clear();
+        CHECK_EQ(1, wxDir::GetAllFiles(DIRTEST_FOLDER, &files, "*.foo",
+                                       wxDIR_DEFAULT, 2));
+
+        // Check that the order doesn't affect the results.
+        TestDirTraverser traverserAny;
+        CHECK_EQ(4, dir.TraverseParallel(traverserAny, {}, wxDIR_DEFAULT,
+                                         wxDirTraverseOrder::Any, 2));
+        CHECK_EQ(6, traverserAny.dirs.size());
+    }
+
     SUBCASE("DirExists")
     {
         struct
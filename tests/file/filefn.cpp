@@ -443,6 +443,59 @@ TEST_CASE("File Functions")
         wxRemoveFile(m_fileNameWork);
     }
 }
+TEST_CASE("wxWildcardPattern")
+{
+    // The compiled pattern must give exactly the same results as wxMatchWild()
+    // for all combinations of these patterns and texts.
+    const char* const patterns[] =
+    {
+        "", "*", "**", "?", "??", "?*", "*?", "*.*", "*.", ".*",
+        "*.txt", "a*", "*a", "a**b", "a*b*c", "a?c*", "*a*a", "*abc*abd",
+        "\\*", "a\\",
+        // '|' is not special for wxMatchWild(), unlike in wxFileDialog
+        // wildcards, so it must be matched literally.
+        "*.txt|*.cpp", "a|b", "*|*",
+    };
+
+    const char* const texts[] =
+    {
+        "", "a", "aa", "ab", "abc", "acbc", "abbbc", "aXa", "abcabd", "abcabc",
+        ".", "..", ".hidden", ".hidden.txt",
+        "file", "file.txt", "file.cpp", "a.b.c", "txt", "*",
+        "a|b", "x.txt|y.cpp", "file.txt|",
+    };
+
+    for ( const char* pattern : patterns )
+    {
+        for ( bool dotSpecial : { true, false } )
+        {
+            const wxWildcardPattern compiled(pattern, dotSpecial);
+
+            for ( const char* text : texts )
+            {
+                INFO("Pattern \"" << pattern << "\", text \"" << text
+                     << "\", dot special " << dotSpecial);
+
+                CHECK( compiled.Matches(text) ==
+                        wxMatchWild(pattern, text, dotSpecial) );
+            }
+        }
+    }
+
+    // Also check some of the results explicitly.
+    CHECK( wxWildcardPattern("*").Matches("file") );
+    CHECK( !wxWildcardPattern("*").Matches(".hidden") );
+    CHECK( wxWildcardPattern("*", false).Matches(".hidden") );
+    CHECK( !wxWildcardPattern("*.*").Matches("file") );
+    CHECK( wxWildcardPattern("file.*").Matches("file.") );
+    CHECK( wxWildcardPattern("?.txt").Matches("a.txt") );
+    CHECK( !wxWildcardPattern("?.txt").Matches(".txt") );
+    CHECK( wxWildcardPattern("").Matches("") );
+    CHECK( !wxWildcardPattern("").Matches("file") );
+    CHECK( wxWildcardPattern().Matches("") );
+    CHECK( !wxWildcardPattern("*.txt|*.cpp").Matches("file.cpp") );
+}
+
 /*
     TODO: other file functions to test:
 
@@ -451,8 +504,6 @@ wxString wxFileNameFromPath(const wxString& path);
 
 bool wxIsWild(const wxString& pattern);
 
-bool wxMatchWild(const wxString& pattern,  const wxString& text, bool dot_special = true);
-
 bool wxSetWorkingDirectory(const wxString& d);
 
 wxFileKind wxGetFileKind(int fd);
@@ -604,6 +604,233 @@ TEST_CASE_FIXTURE(FileSystemWatcherTestCase,
     EventTester tester;
     tester.Run();
 }
+
+// ----------------------------------------------------------------------------
+// TestBatchEvents: repeated modifications are reported once, in a batch
+// ----------------------------------------------------------------------------
+
+TEST_CASE_FIXTURE(FileSystemWatcherTestCase,
+                 "wxFileSystemWatcher::BatchEvents")
+{
+    class EventTester : public FSWTesterBase
+    {
+    public:
+        EventTester() : FSWTesterBase(wxFSW_EVENT_MODIFY)
+        {
+            Bind(wxEVT_FSWATCHER_BATCH, &EventTester::OnBatchEvent, this);
+        }
+
+        bool Init() override
+        {
+            if ( !FSWTesterBase::Init() )
+                return false;
+
+            m_watcher->EnableBatchEvents();
+            m_watcher->SetCoalesceInterval(std::chrono::milliseconds(200));
+
+            return true;
+        }
+
+        void GenerateEvent() override
+        {
+            CHECK(eg.ModifyFile());
+            CHECK(eg.ModifyFile());
+            CHECK(eg.ModifyFile());
+        }
+
+        wxFileSystemWatcherEvent ExpectedEvent() override
+        {
+            wxFileSystemWatcherEvent event(wxFSW_EVENT_MODIFY);
+            event.SetPath(eg.m_file);
+            event.SetNewPath(eg.m_file);
+            return event;
+        }
+
+        void CheckResult() override
+        {
+            CHECK( m_events.empty() );
+
+            REQUIRE( m_changes.size() == 1 );
+            CHECK( m_changes[0].changeType == wxFSW_EVENT_MODIFY );
+            CHECK( m_changes[0].path == eg.m_file );
+        }
+
+    private:
+        void OnBatchEvent(wxFileSystemWatcherBatchEvent& event)
+        {
+            const auto& changes = event.GetChanges();
+            m_changes.insert(m_changes.end(), changes.begin(), changes.end());
+
+            SendIdle();
+        }
+
+        std::vector<wxFileSystemWatcherChange> m_changes;
+    };
+
+    // we need to create a file to modify
+    EventGenerator::Get().CreateFile();
+
+    EventTester tester;
+    tester.Run();
+}
+
+// ----------------------------------------------------------------------------
+// TestAsyncAddTree: subdirectories are watched after the completion event
+// ----------------------------------------------------------------------------
+
+TEST_CASE_FIXTURE(FileSystemWatcherTestCase,
+                 "wxFileSystemWatcher::AsyncAddTree")
+{
+    // This doesn't use FSWTesterBase as it checks the result on the first
+    // idle event, which may come before the tree is read.
+    class TreeTester : public wxEvtHandler
+    {
+    public:
+        TreeTester()
+        {
+            m_root = EventGenerator::GetWatchDir();
+            m_root.AppendDir("asynctree");
+
+            wxFileName dir(m_root);
+            for ( unsigned n = 0; n < SUBDIRS; n++ )
+            {
+                dir.AppendDir(wxString::Format("subdir%u", n + 1));
+                REQUIRE(dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL));
+            }
+
+            Bind(wxEVT_FSWATCHER_TREE_ADDED, &TreeTester::OnTreeAdded, this);
+
+            // As in FSWTesterBase, the watcher needs a running event loop.
+            CallAfter(&TreeTester::OnInit);
+        }
+
+        ~TreeTester()
+        {
+            m_root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+        }
+
+        void Run()
+        {
+            m_loop.Run();
+        }
+
+    private:
+        void OnInit()
+        {
+            m_watcher = std::make_unique<wxFileSystemWatcher>();
+            m_watcher->SetOwner(this);
+            m_watcher->EnableAsyncAddTree();
+
+            if ( !m_watcher->AddTree(m_root) )
+            {
+                FAIL_CHECK("AddTree() failed");
+                m_loop.Exit();
+                return;
+            }
+
+            // Only the root is watched until the tree is read.
+            CHECK( m_watcher->GetWatchedPathsCount() == 1 );
+        }
+
+        void OnTreeAdded(wxFileSystemWatcherEvent& event)
+        {
+            CHECK( event.GetPath() == m_root );
+            CHECK( m_watcher->GetWatchedPathsCount() == 1 + SUBDIRS );
+
+            CHECK( m_watcher->RemoveTree(m_root) );
+            CHECK( m_watcher->GetWatchedPathsCount() == 0 );
+
+            m_loop.Exit();
+        }
+
+        static constexpr unsigned SUBDIRS = 3;
+
+        wxEventLoop m_loop;
+        std::unique_ptr<wxFileSystemWatcher> m_watcher;
+        wxFileName m_root;
+    };
+
+    TreeTester tester;
+    tester.Run();
+}
+
+// ----------------------------------------------------------------------------
+// TestAsyncAddTreeDestroy: watcher is destroyed while the tree is being read
+// ----------------------------------------------------------------------------
+
+TEST_CASE_FIXTURE(FileSystemWatcherTestCase,
+                 "wxFileSystemWatcher::AsyncAddTreeDestroy")
+{
+    class TreeTester : public wxEvtHandler
+    {
+    public:
+        TreeTester()
+        {
+            m_root = EventGenerator::GetWatchDir();
+            m_root.AppendDir("asynctreedestroy");
+
+            // Create enough directories for reading them to take a while.
+            for ( unsigned n = 0; n < SUBDIRS; n++ )
+            {
+                wxFileName dir(m_root);
+                dir.AppendDir(wxString::Format("subdir%u", n + 1));
+                for ( unsigned m = 0; m < SUBDIRS; m++ )
+                {
+                    dir.AppendDir(wxString::Format("subdir%u", m + 1));
+                    REQUIRE(dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL));
+                    dir.RemoveLastDir();
+                }
+            }
+
+            Bind(wxEVT_FSWATCHER_TREE_ADDED, &TreeTester::OnTreeAdded, this);
+
+            CallAfter(&TreeTester::OnInit);
+        }
+
+        ~TreeTester()
+        {
+            m_root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+        }
+
+        void Run()
+        {
+            m_loop.Run();
+
+            CHECK( !m_treeAdded );
+        }
+
+    private:
+        void OnInit()
+        {
+            auto watcher = std::make_unique<wxFileSystemWatcher>();
+            watcher->SetOwner(this);
+            watcher->EnableAsyncAddTree();
+
+            CHECK( watcher->AddTree(m_root) );
+
+            // Destroying the watcher must abandon the scan in progress.
+            watcher.reset();
+
+            // Give any events which could have been queued a chance to be
+            // (wrongly) processed.
+            CallAfter([this]() { m_loop.Exit(); });
+        }
+
+        void OnTreeAdded([[maybe_unused]] wxFileSystemWatcherEvent& event)
+        {
+            m_treeAdded = true;
+        }
+
+        static constexpr unsigned SUBDIRS = 50;
+
+        wxEventLoop m_loop;
+        wxFileName m_root;
+        bool m_treeAdded{false};
+    };
+
+    TreeTester tester;
+    tester.Run();
+}
 #endif // wxHAS_INOTIFY
 
 // ----------------------------------------------------------------------------
@@ -13,6 +13,7 @@ module;
 #include "wx/bitmap.h"
 #include "wx/dcmemory.h"
 #include "wx/dcgraph.h"
+#include "wx/font.h"
 
 #include <fmt/core.h>
 
@@ -22,8 +23,12 @@ export module WX.Test.GraphPath;
 
 import WX.Test.Prec;
 import WX.MetaTest;
+import WX.Image;
 
+import <algorithm>;
 import <numbers>;
+import <span>;
+import <string_view>;
 
 // For MSW we have individual test cases for each graphics renderer
 // so we don't need to execute tests with default renderer.
@@ -45,8 +50,106 @@ TEST_CASE("GraphicsPathTestCaseCairo", "[path][cairo]")
     std::unique_ptr<wxGraphicsContext> gc(wxGraphicsRenderer::GetCairoRenderer()->CreateContext(mdc));
     REQUIRE(gc);
 }
+
+TEST_CASE("GraphicsTiledRendererCairo")
+{
+    // Use small tiles to make sure the rectangle spans several of them.
+    wxGraphicsTiledRenderer renderer(wxSize{64, 64}, 4);
+    CHECK(renderer.GetThreadCount() == 4);
+
+    const wxSize size{200, 150};
+
+    wxImage image = renderer.RenderToImage(size, [](wxGraphicsContext& gc)
+        {
+            gc.SetBrush(wxBrush(wxColour(255, 0, 0)));
+            gc.DrawRectangle(50.0F, 40.0F, 100.0F, 70.0F);
+        });
+
+    REQUIRE(image.IsOk());
+    CHECK(image.GetSize() == size);
+    CHECK(image.HasAlpha());
+
+    CHECK(image.GetAlpha(10, 10) == 0);
+    CHECK(image.GetAlpha(60, 50) == 255);
+    CHECK(image.GetRed(60, 50) == 255);
+    CHECK(image.GetAlpha(140, 100) == 255);
+    CHECK(image.GetRed(140, 100) == 255);
+    CHECK(image.GetAlpha(160, 120) == 0);
+
+    // The tiles are reused, but must not keep the previous contents.
+    image = renderer.RenderToImage(size, [](wxGraphicsContext&) { });
+
+    REQUIRE(image.IsOk());
+    CHECK(image.GetAlpha(60, 50) == 0);
+    CHECK(image.GetAlpha(140, 100) == 0);
+}
 #endif // wxUSE_CAIRO
 
+TEST_CASE("GraphicsContext::DrawTexts")
+{
+    wxGraphicsRenderer* const renderer = wxGraphicsRenderer::GetDefaultRenderer();
+    REQUIRE(renderer);
+
+    const std::string_view texts[] = { "Hello", "", "wxWidgets", "Hello" };
+    const wxPoint2DFloat positions[] =
+    {
+        { 10.0F, 10.0F },
+        { 50.0F, 10.0F },
+        { 10.0F, 40.0F },
+        { 80.0F, 70.0F },
+    };
+    static_assert(std::size(texts) == std::size(positions));
+
+    const wxFont font(12, wxFontFamily::Default, wxFontStyle::Normal, wxFONTWEIGHT_NORMAL);
+
+    // Draw the texts using the given function on a white background.
+    const auto draw = [&](const auto& drawTexts)
+    {
+        wxImage image(200, 100);
+        image.SetRGB(wxRect(0, 0, 200, 100), 255, 255, 255);
+
+        {
+            std::unique_ptr<wxGraphicsContext> gc = renderer->CreateContextFromImage(image);
+            REQUIRE(gc);
+
+            gc->SetFont(font, *wxBLACK);
+            drawTexts(*gc);
+        }
+
+        return image;
+    };
+
+    const wxImage imageOneByOne = draw([&](wxGraphicsContext& gc)
+        {
+            for ( size_t n = 0; n < std::size(texts); n++ )
+                gc.wxDrawText(texts[n], positions[n].x, positions[n].y);
+        });
+
+    const wxImage imageAll = draw([&](wxGraphicsContext& gc)
+        {
+            gc.DrawTexts(std::size(texts), texts, positions);
+        });
+
+    // Something must have been drawn...
+    const unsigned char* const dataAll = imageAll.GetData();
+    const size_t size = 200 * 100 * 3;
+    CHECK(std::any_of(dataAll, dataAll + size,
+                      [](unsigned char c) { return c != 255; }));
+
+    // ...and it must be the same as when drawing the texts one by one.
+    CHECK(memcmp(dataAll, imageOneByOne.GetData(), size) == 0);
+
+    // Drawing nothing is allowed too.
+    const wxImage imageNone = draw([](wxGraphicsContext& gc)
+        {
+            gc.DrawTexts(0, nullptr, nullptr);
+        });
+
+    const unsigned char* const dataNone = imageNone.GetData();
+    CHECK(std::all_of(dataNone, dataNone + size,
+                      [](unsigned char c) { return c == 255; }));
+}
+
 namespace ut = boost::ut;
 
 ut::suite GraphPathsTest = []
@@ -476,6 +579,50 @@ ut::suite GraphPathsTest = []
             TestPointProximity(cp, cp2, 1E-3);
         };
     };
+
+    "Batch"_test = [&]
+    {
+        wxGraphicsBatch batch;
+        expect(batch.IsEmpty());
+
+        const wxPoint2DFloat points[] = { {10.0F, 10.0F}, {20.0F, 30.0F}, {40.0F, 15.0F} };
+
+        should("Merge marker runs") = [&]
+        {
+            batch.AddMarkers(points, wxGraphicsMarker::Circle, 5.0F);
+            batch.AddMarkers(std::span{points}.first(1), wxGraphicsMarker::Circle, 5.0F);
+            expect(batch.GetMarkers().size() == 1);
+            expect(batch.GetMarkers()[0].count == 4);
+
+            batch.AddMarkers(points, wxGraphicsMarker::Square, 5.0F);
+            expect(batch.GetMarkers().size() == 2);
+            expect(batch.GetPoints().size() == 7);
+        };
+
+        should("Polylines and shapes") = [&]
+        {
+            batch.AddLines(points);
+            batch.AddPolygon(points);
+            batch.AddRectangle(100.0F, 100.0F, 20.0F, 10.0F);
+            batch.AddCircle(200.0F, 200.0F, 10.0F);
+
+            expect(batch.GetPolylines().size() == 2);
+            expect(batch.GetPolylines()[1].closed);
+            expect(batch.GetRectangles().size() == 1);
+            expect(batch.GetEllipses().size() == 1);
+        };
+
+        should("Draw and clear") = [&]
+        {
+            gc->SetPen(*wxBLACK_PEN);
+            gc->SetBrush(*wxRED_BRUSH);
+            gc->DrawBatch(batch);
+
+            batch.Clear();
+            expect(batch.IsEmpty());
+            expect(batch.GetPoints().empty());
+        };
+    };
 };
 
 // FIXME: Templatize for running Cairo / other renderers.
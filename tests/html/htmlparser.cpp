@@ -35,6 +35,58 @@ TEST_CASE("wxHtmlParser::ParseInvalid")
     delete p.Parse("<!---");
 }
 
+TEST_CASE("wxHtmlEntitiesParser::Parse")
+{
+    wxHtmlEntitiesParser p;
+
+    CHECK( p.Parse("no entities") == "no entities" );
+    CHECK( p.Parse("&lt;b&gt;") == "<b>" );
+    CHECK( p.Parse("x &amp y") == "x & y" );
+    CHECK( p.Parse("&#65;&#x42;&#X43;") == "ABC" );
+    CHECK( p.Parse("&zwnj;") == wxString(wxUniChar(8204)) );
+    CHECK( p.Parse("&AElig;&aelig;") == wxString(wxUniChar(198)) + wxUniChar(230) );
+    CHECK( p.Parse("&nosuchentity;") == "&nosuchentity;" );
+    CHECK( p.Parse("&AMP;") == "&AMP;" );
+    CHECK( p.Parse("trailing &") == "trailing &" );
+
+    CHECK( p.GetEntityChar("quot") == '"' );
+    CHECK( p.GetEntityChar("#x20") == ' ' );
+    CHECK( p.GetEntityChar("") == 0 );
+    CHECK( p.GetEntityChar("#") == 0 );
+}
+
+TEST_CASE("wxHtmlTag::GetParam")
+{
+    class TagsParser : public wxHtmlWinParser
+    {
+    public:
+        wxString m_align, m_src;
+        bool m_hasBorder{false};
+
+    protected:
+        void AddText([[maybe_unused]] const wxString& txt) override { }
+
+        void AddTag(const wxHtmlTag& tag) override
+        {
+            if ( tag.GetName() == "IMG" )
+            {
+                m_align = tag.GetParam("align");
+                m_src = tag.GetParam("SRC");
+                m_hasBorder = tag.HasParam("Border");
+            }
+        }
+    };
+
+    TagsParser p;
+    wxMemoryDC dc;
+    p.SetDC(&dc);
+
+    delete p.Parse("<IMG src=\"Some&amp;Image.png\" Align=right border>");
+    CHECK( p.m_align == "RIGHT" );
+    CHECK( p.m_src == "Some&Image.png" );
+    CHECK( p.m_hasBorder );
+}
+
 TEST_CASE("wxHtmlCell::Detach")
 {
     wxMemoryDC dc;
@@ -1356,3 +1356,120 @@ TEST_CASE("UTF8 tests")
     SUBCASE("UTF8Octal_backslash245") { UTF8Octal("\\245", L"\\245"); }
 }
 #endif // HAVE_WCHAR_H
+
+namespace
+{
+
+// Check that the strict UTF-8 converter converts the given text, which must
+// contain more than one character, in both directions, with and without the
+// explicit length and into the buffers of the right size and one too small.
+void CheckStrictUTF8(const std::string& utf8, const std::wstring& wide)
+{
+    wxMBConvStrictUTF8 conv;
+
+    CHECK( conv.ToWChar(nullptr, 0, utf8.data(), utf8.size()) == wide.size() );
+
+    std::wstring wout(wide.size(), L'\0');
+    CHECK( conv.ToWChar(&wout[0], wout.size(), utf8.data(), utf8.size()) == wide.size() );
+    CHECK( wout == wide );
+    CHECK( conv.ToWChar(&wout[0], wout.size() - 1, utf8.data(), utf8.size()) == wxCONV_FAILED );
+
+    std::wstring woutz(wide.size() + 1, L'\1');
+    CHECK( conv.ToWChar(&woutz[0], woutz.size(), utf8.c_str()) == woutz.size() );
+    CHECK( std::wstring(woutz.c_str()) == wide );
+    CHECK( conv.ToWChar(&woutz[0], woutz.size() - 1, utf8.c_str()) == wxCONV_FAILED );
+
+    CHECK( conv.FromWChar(nullptr, 0, wide.data(), wide.size()) == utf8.size() );
+
+    std::string out(utf8.size(), '\0');
+    CHECK( conv.FromWChar(&out[0], out.size(), wide.data(), wide.size()) == utf8.size() );
+    CHECK( out == utf8 );
+    CHECK( conv.FromWChar(&out[0], out.size() - 1, wide.data(), wide.size()) == wxCONV_FAILED );
+
+    std::string outz(utf8.size() + 1, '\1');
+    CHECK( conv.FromWChar(&outz[0], outz.size(), wide.c_str()) == outz.size() );
+    CHECK( std::string(outz.c_str()) == utf8 );
+    CHECK( conv.FromWChar(&outz[0], outz.size() - 1, wide.c_str()) == wxCONV_FAILED );
+
+    size_t len = 0;
+    const wxWCharBuffer buf = conv.cMB2WC(utf8.data(), utf8.size(), &len);
+    REQUIRE( len == wide.size() );
+    CHECK( std::wstring(buf.data(), len) == wide );
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxMBConvStrictUTF8::ASCII")
+{
+    // ASCII characters are converted in blocks of 16, so check the text
+    // around the boundaries of these blocks.
+    SUBCASE("ASCIIOnly")
+    {
+        for ( size_t len : { 15, 16, 17, 31, 32, 33 } )
+        {
+            INFO("Length " << len);
+
+            std::string utf8;
+            std::wstring wide;
+            for ( size_t n = 0; n < len; n++ )
+            {
+                utf8 += static_cast<char>('a' + n % 26);
+                wide += static_cast<wchar_t>(L'a' + n % 26);
+            }
+
+            CheckStrictUTF8(utf8, wide);
+        }
+    }
+
+    SUBCASE("NonASCII")
+    {
+        for ( size_t pos : { 15, 16, 17 } )
+        {
+            INFO("Position " << pos);
+
+            std::string utf8(40, 'x');
+            utf8.replace(pos, 1, "\xc3\xa9");
+            std::wstring wide(40, L'x');
+            wide[pos] = 0xe9;
+
+            CheckStrictUTF8(utf8, wide);
+
+            std::string invalid(40, 'x');
+            invalid[pos] = '\x80';
+
+            wxMBConvStrictUTF8 conv;
+            CHECK( conv.ToWChar(nullptr, 0, invalid.data(), invalid.size()) == wxCONV_FAILED );
+
+            std::wstring wout(invalid.size(), L'\0');
+            CHECK( conv.ToWChar(&wout[0], wout.size(), invalid.data(), invalid.size()) == wxCONV_FAILED );
+        }
+    }
+
+    SUBCASE("AfterASCII")
+    {
+        // U+10000 is a surrogate pair if wchar_t is 16 bits
+        const struct
+        {
+            const char* utf8;
+            const wchar_t* wide;
+        } sequences[] =
+        {
+            { "\xe2\x98\xa0",       u2620  },
+            { "\xf0\x90\x80\x80",   u10000 },
+            { "\xf4\x8f\xbf\xbd",   u10fffd },
+        };
+
+        for ( const auto& seq : sequences )
+        {
+            for ( size_t len : { 16, 31, 32, 33 } )
+            {
+                INFO("Length " << len);
+
+                const std::string utf8 = std::string(len, 'a') + seq.utf8 + "b";
+                const std::wstring wide = std::wstring(len, L'a') + seq.wide + L"b";
+
+                CheckStrictUTF8(utf8, wide);
+            }
+        }
+    }
+}
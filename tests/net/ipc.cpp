@@ -6,6 +6,8 @@
 // Licence:     wxWindows licence
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "doctest.h"
+
 #include "testprec.h"
 
 // FIXME: this tests currently sometimes hangs in Connect() for unknown reason
@@ -261,3 +263,360 @@ void IPCTestCase::Disconnect()
 #endif // wxUSE_THREADS
 
 #endif // !WX_WINDOWS
+
+// ----------------------------------------------------------------------------
+// tests of the optional protocol features of wxTCPConnection
+// ----------------------------------------------------------------------------
+
+#include "wx/ipc.h"
+
+#if !wxUSE_DDE_FOR_IPC
+
+#include "wx/evtloop.h"
+
+import WX.File.Filename;
+
+import <random>;
+import <string>;
+import <vector>;
+
+namespace
+{
+
+constexpr char IPC_FEATURES_TEST_PORT[] = "4243";
+constexpr char IPC_FEATURES_TEST_TOPIC[] = "IPC FEATURES TEST";
+
+// The server connection uses the buffer of this size provided by the test, so
+// that it can check whether the data was read from the socket into it or was
+// passed via shared memory.
+constexpr size_t IPC_TEST_BUFFER_SIZE = 4*1024*1024;
+
+bool IsInBuffer(const std::vector<char>& buffer, const void *data)
+{
+    const auto p = reinterpret_cast<std::uintptr_t>(data);
+    const auto start = reinterpret_cast<std::uintptr_t>(buffer.data());
+
+    return p >= start && p < start + buffer.size();
+}
+
+// Connection on the server side remembering the data poked into it and
+// returning it back when the "data" item is requested. For all the other
+// items except "fail" it just returns their names.
+class IPCEchoConnection : public wxTCPConnection
+{
+public:
+    explicit IPCEchoConnection(std::vector<char>& buffer)
+        : wxTCPConnection(buffer.data(), buffer.size()),
+          m_buffer(buffer)
+    {
+    }
+
+    bool OnPoke([[maybe_unused]] const wxString& topic,
+                const wxString& item,
+                const void *data,
+                size_t size,
+                [[maybe_unused]] wxIPCFormat format) override
+    {
+        // Send the data back in the same way as we received it.
+        Compress(item == "compressed");
+
+        m_pokeWasShared = !IsInBuffer(m_buffer, data);
+
+        const auto p = static_cast<const char *>(data);
+        m_data.assign(p, p + size);
+        return true;
+    }
+
+    // true if the data of the last OnPoke() was passed via shared memory
+    bool m_pokeWasShared{false};
+
+    const void *OnRequest([[maybe_unused]] const wxString& topic,
+                          const wxString& item,
+                          size_t *size,
+                          [[maybe_unused]] wxIPCFormat format) override
+    {
+        if ( item == "fail" )
+            return nullptr;
+
+        if ( item == "data" )
+        {
+            *size = m_data.size();
+            return m_data.data();
+        }
+
+        m_reply = item.utf8_string();
+        *size = m_reply.length() + 1;
+        return m_reply.c_str();
+    }
+
+private:
+    const std::vector<char>& m_buffer;
+    std::vector<char> m_data;
+    std::string m_reply;
+};
+
+class IPCEchoServer : public wxTCPServer
+{
+public:
+    wxConnectionBase *OnAcceptConnection(const wxString& topic) override
+    {
+        if ( topic != IPC_FEATURES_TEST_TOPIC )
+            return nullptr;
+
+        m_conn = new IPCEchoConnection(m_buffer);
+        return m_conn;
+    }
+
+    std::vector<char> m_buffer = std::vector<char>(IPC_TEST_BUFFER_SIZE);
+
+    // the last accepted connection, it deletes itself when disconnected
+    IPCEchoConnection *m_conn{nullptr};
+};
+
+// Unlike the test above, this one runs both the client and the server in the
+// main thread: the client dispatches the events, and so lets the server
+// handle them, while it waits for the socket data.
+class IPCFeaturesFixture
+{
+public:
+    IPCFeaturesFixture()
+        : m_activator(&m_loop)
+    {
+    }
+
+    ~IPCFeaturesFixture()
+    {
+        delete m_conn;
+    }
+
+    // Create the server, optionally supporting no protocol features at all,
+    // and connect to it.
+    bool Connect(const wxString& host, const wxString& service, bool features)
+    {
+        if ( !features )
+            m_server.DisableFeatures();
+
+        if ( !m_server.Create(service) )
+            return false;
+
+        wxTCPClient client;
+        m_conn = static_cast<wxTCPConnection *>(
+                    client.MakeConnection(host, service, IPC_FEATURES_TEST_TOPIC));
+
+        return m_conn != nullptr;
+    }
+
+    // Return the string returned by GetReply() or "NULL" if it failed.
+    std::string GetReplyString(std::uint32_t id)
+    {
+        const void * const data = m_conn->GetReply(id);
+
+        return data ? static_cast<const char *>(data) : "NULL";
+    }
+
+    // Poke the data and request it back, checking that it's unchanged.
+    void CheckRoundTrip(const wxString& item, const std::vector<char>& data)
+    {
+        REQUIRE( m_conn->Poke(item, data.data(), data.size(), wxIPC_PRIVATE) );
+
+        size_t size = 0;
+        const void * const
+            reply = m_conn->Request("data", &size, wxIPC_PRIVATE);
+        REQUIRE( reply );
+        REQUIRE( size == data.size() );
+        CHECK( memcmp(reply, data.data(), size) == 0 );
+    }
+
+    // Check if the data poked by the last round trip was passed via shared
+    // memory. Notice that we can't check this for the reply, as the replies
+    // to the pipelined requests are always copied.
+    bool PokeWasShared() const
+    {
+        return m_server.m_conn->m_pokeWasShared;
+    }
+
+    wxEventLoop m_loop;
+    wxEventLoopActivator m_activator;
+
+    IPCEchoServer m_server;
+    wxTCPConnection *m_conn{nullptr};
+};
+
+// Return easily compressible data if "random" is false, or data which can't
+// be compressed at all otherwise.
+std::vector<char> MakeTestData(size_t size, bool random)
+{
+    std::vector<char> data(size);
+
+    std::minstd_rand rng;
+    for ( size_t n = 0; n < size; n++ )
+        data[n] = static_cast<char>(random ? rng() : n % 7);
+
+    return data;
+}
+
+} // anonymous namespace
+
+TEST_CASE_FIXTURE(IPCFeaturesFixture, "wxTCPConnection::Features")
+{
+    // All the checks below must work in the same way whether the server
+    // supports the optional features or replies with IPC_FAIL when asked
+    // about them, as the old versions did.
+    bool features = true;
+    SUBCASE("Supported") { }
+    SUBCASE("Unsupported") { features = false; }
+
+    INFO("Server features are " << (features ? "enabled" : "disabled"));
+
+    REQUIRE( Connect("localhost", IPC_FEATURES_TEST_PORT, features) );
+
+    SUBCASE("Request")
+    {
+        const void * const data = m_conn->Request("hello");
+        REQUIRE( data );
+        CHECK( std::string(static_cast<const char *>(data)) == "hello" );
+
+        CHECK( !m_conn->Request("fail") );
+
+        // The connection must still be usable after a failed request.
+        CHECK( m_conn->Request("again") );
+    }
+
+    SUBCASE("OutOfOrder")
+    {
+        const std::uint32_t id1 = m_conn->RequestAsync("first");
+        const std::uint32_t id2 = m_conn->RequestAsync("second");
+        const std::uint32_t idFail = m_conn->RequestAsync("fail");
+        const std::uint32_t id3 = m_conn->RequestAsync("third");
+
+        REQUIRE( id1 );
+        REQUIRE( id2 );
+        REQUIRE( idFail );
+        REQUIRE( id3 );
+
+        CHECK( GetReplyString(id3) == "third" );
+        CHECK( GetReplyString(idFail) == "NULL" );
+        CHECK( GetReplyString(id1) == "first" );
+        CHECK( GetReplyString(id2) == "second" );
+    }
+
+    SUBCASE("Many")
+    {
+        // Send more requests than can be outstanding at once, so that the
+        // replies to the first ones must be read while sending the others.
+        const int count = 1000;
+
+        std::vector<std::uint32_t> ids;
+        m_conn->BeginBatch();
+        for ( int n = 0; n < count; n++ )
+        {
+            const std::uint32_t id = m_conn->RequestAsync(wxString::Format("%d", n));
+            REQUIRE( id );
+            ids.push_back(id);
+        }
+        m_conn->EndBatch();
+
+        for ( int n = count - 1; n >= 0; n-- )
+        {
+            INFO("Request #" << n);
+            CHECK( GetReplyString(ids[n]) == std::to_string(n) );
+        }
+    }
+
+    SUBCASE("Compressed")
+    {
+        m_conn->Compress(true);
+
+        CheckRoundTrip("compressed", MakeTestData(100000, false));
+        CheckRoundTrip("compressed", MakeTestData(100000, true));
+
+        // Too small to be compressed.
+        CheckRoundTrip("compressed", MakeTestData(100, false));
+
+        // Compression can be turned off again.
+        m_conn->Compress(false);
+        CheckRoundTrip("uncompressed", MakeTestData(100000, false));
+    }
+}
+
+// Shared memory is only used under Unix, for the connections over Unix
+// domain sockets, which are used when the server name is a path.
+#if defined(__UNIX__) && !defined(__WINE__)
+
+namespace
+{
+
+// This must be the same as IPC_SHARED_SIZE in src/common/sckipc.cpp.
+constexpr size_t IPC_TEST_SHARED_SIZE = 64*1024*1024;
+
+} // anonymous namespace
+
+TEST_CASE_FIXTURE(IPCFeaturesFixture, "wxTCPConnection::SharedMemory")
+{
+    // The server removes this file before creating the socket with the same
+    // name and when it's destroyed.
+    const wxString name = wxFileName::CreateTempFileName("wxipc");
+    REQUIRE( !name.empty() );
+
+    SUBCASE("Large")
+    {
+        REQUIRE( Connect("localhost", name, true) );
+
+        CheckRoundTrip("large", MakeTestData(1024*1024, true));
+        CHECK( PokeWasShared() );
+
+        // The small blocks are still sent over the socket.
+        CheckRoundTrip("small", MakeTestData(1000, true));
+        CHECK( !PokeWasShared() );
+    }
+
+    SUBCASE("Wrap")
+    {
+        REQUIRE( Connect("localhost", name, true) );
+
+        // Send more data than fits into the shared buffer, this only works if
+        // the memory used by the blocks already read is reused. Notice that
+        // the block size is chosen so that the buffer size is not a multiple
+        // of it, to check that the blocks don't wrap around its end.
+        const size_t blockSize = 3*1024*1024;
+        const size_t count = 2*IPC_TEST_SHARED_SIZE / blockSize;
+
+        std::vector<char> data = MakeTestData(blockSize, false);
+        for ( size_t n = 0; n < count; n++ )
+        {
+            INFO("Block #" << n);
+
+            // Make each block different to detect reading a stale one.
+            data.front() = data.back() = static_cast<char>(n);
+
+            CheckRoundTrip("block", data);
+            CHECK( PokeWasShared() );
+        }
+    }
+
+    SUBCASE("NoFeatures")
+    {
+        REQUIRE( Connect("localhost", name, false) );
+
+        CheckRoundTrip("large", MakeTestData(1024*1024, true));
+        CHECK( !PokeWasShared() );
+    }
+
+    SUBCASE("OpenFailure")
+    {
+        // Opening the client buffer fails on the server side, and both sides
+        // must fall back to using the socket.
+        m_server.SimulateSharedMemoryFailure();
+        REQUIRE( Connect("localhost", name, true) );
+
+        CheckRoundTrip("large", MakeTestData(1024*1024, true));
+        CHECK( !PokeWasShared() );
+
+        CheckRoundTrip("small", MakeTestData(1000, true));
+        CHECK( !PokeWasShared() );
+    }
+}
+
+#endif // __UNIX__ && !__WINE__
+
+#endif // !wxUSE_DDE_FOR_IPC
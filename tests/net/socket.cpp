@@ -56,6 +56,7 @@ private:
         CPPUNIT_TEST( ReadNowait ); \
         CPPUNIT_TEST( ReadWaitall ); \
         CPPUNIT_TEST( ReadAnotherThread ); \
+        CPPUNIT_TEST( ReadAhead ); \
         CPPUNIT_TEST( UrlTest )
 
     CPPUNIT_TEST_SUITE( SocketTestCase );
@@ -101,6 +102,7 @@ private:
     void ReadNowait();
     void ReadWaitall();
     void ReadAnotherThread();
+    void ReadAhead();
 
     void UrlTest();
 
@@ -286,6 +288,54 @@ void SocketTestCase::ReadAnotherThread()
     CHECK( thr.Wait() == NULL );
 }
 
+void SocketTestCase::ReadAhead()
+{
+    SocketTestEventLoop loop(ms_useLoop);
+
+    wxSockAddressPtr addr(GetServer());
+    if ( !addr.get() )
+        return;
+
+    wxSocketClient sock(wxSOCKET_WAITALL | wxSOCKET_READAHEAD);
+    sock.SetTimeout(1);
+    CHECK( sock.Connect(*addr) );
+
+    // Send the request in pieces, but in a single system call.
+    const wxCharBuffer host = gs_serverHost.ToAscii();
+    const char get[] = "GET / HTTP/1.1\r\nHost: ";
+    const char end[] = "\r\n\r\n";
+    const wxSocketIOVec request[] =
+    {
+        { get, sizeof(get) - 1 },
+        { host.data(), static_cast<std::uint32_t>(host.length()) },
+        { end, sizeof(end) - 1 },
+    };
+
+    sock.WriteV(request);
+    CHECK_EQ( wxSocketError::None, sock.LastError() );
+    CHECK_EQ( sizeof(get) + host.length() + sizeof(end) - 2,
+              (size_t)sock.LastWriteCount() );
+
+    // Read the reply in small pieces, all of them except the first one
+    // should be taken from the read-ahead buffer.
+    char status[5];
+    sock.Read(status, WXSIZEOF(status));
+    CHECK_EQ( wxSocketError::None, sock.LastError() );
+    CHECK_EQ( WXSIZEOF(status), (size_t)sock.LastReadCount() );
+    CHECK( memcmp(status, "HTTP/", WXSIZEOF(status)) == 0 );
+
+    CHECK( sock.IsData() );
+
+    char peek[3];
+    sock.Peek(peek, WXSIZEOF(peek));
+    CHECK_EQ( WXSIZEOF(peek), (size_t)sock.LastCount() );
+
+    char version[3];
+    sock.Read(version, WXSIZEOF(version));
+    CHECK_EQ( WXSIZEOF(version), (size_t)sock.LastReadCount() );
+    CHECK( memcmp(peek, version, WXSIZEOF(version)) == 0 );
+}
+
 void SocketTestCase::UrlTest()
 {
     if ( gs_serverHost.empty() )
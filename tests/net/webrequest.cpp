@@ -16,6 +16,7 @@
 #if wxUSE_WEBREQUEST
 
 #include "wx/webrequest.h"
+#include "wx/dir.h"
 
 import WX.Cmn.WFStream;
 import WX.File.Filename;
@@ -451,6 +452,120 @@ TEST_CASE_METHOD(RequestFixture,
     CHECK( responseStringFromEvent == "Still alive!" );
 }
 
+TEST_CASE_METHOD(RequestFixture,
+                 "WebRequest::Get::Consumer", "[net][webrequest][get]")
+{
+    if ( !InitBaseURL() )
+        return;
+
+    int processingSize = 99 * 1024;
+    Create(wxString::Format("/bytes/%d", processingSize));
+    request.SetStorage(wxWebRequest::Storage_None);
+
+    std::int64_t consumedSize = 0;
+    request.SetDataConsumer([&consumedSize](const void*, size_t size)
+        {
+            consumedSize += size;
+            return true;
+        });
+
+    Run();
+    CHECK( request.GetBytesReceived() == processingSize );
+    CHECK( consumedSize == processingSize );
+
+    // No data events should be generated when using a consumer.
+    CHECK( dataSize == 0 );
+}
+
+TEST_CASE_METHOD(RequestFixture,
+                 "WebRequest::Session::Concurrency", "[net][webrequest]")
+{
+    if ( !InitBaseURL() )
+        return;
+
+    // Only libcurl backend schedules the requests itself.
+    if ( !wxWebSession::IsBackendAvailable(wxWebSessionBackendCURL) )
+        return;
+
+    wxWebSession session = wxWebSession::New(wxWebSessionBackendCURL);
+    REQUIRE( session.IsOpened() );
+
+    session.SetMaxConcurrency(1);
+    CHECK( session.GetMaxConcurrency() == 1 );
+
+    std::vector<int> completed;
+    Bind(wxEVT_WEBREQUEST_STATE, [&](wxWebRequestEvent& evt)
+        {
+            if ( evt.GetState() == wxWebRequest::State_Active )
+                return;
+
+            CHECK( evt.GetState() == wxWebRequest::State_Completed );
+            completed.push_back(evt.GetId());
+            if ( completed.size() == 3 )
+                loop.Exit();
+        });
+
+    // The first request starts immediately, while the other ones are queued
+    // and must be started in the order of their priorities.
+    std::vector<wxWebRequest> requests;
+    const int priorities[] = { 0, 0, 10 };
+    for ( int n = 0; n < 3; n++ )
+    {
+        wxWebRequest r = session.CreateRequest(this, baseURL + "/bytes/100", n);
+        r.SetPriority(priorities[n]);
+        r.Start();
+        requests.push_back(r);
+    }
+
+    RunLoopWithTimeout();
+
+    REQUIRE( completed.size() == 3 );
+    CHECK( completed[0] == 0 );
+    CHECK( completed[1] == 2 );
+    CHECK( completed[2] == 1 );
+}
+
+TEST_CASE_METHOD(RequestFixture,
+                 "WebRequest::Session::Cache", "[net][webrequest]")
+{
+    if ( !InitBaseURL() )
+        return;
+
+    wxWebSession session = wxWebSession::New();
+    REQUIRE( session.IsOpened() );
+
+    // Start with an empty cache, even if a previous run left something in it.
+    const std::string cacheDir = wxFileName::GetTempDir() +
+                                    wxFILE_SEP_PATH + "wxwebcache_test";
+    if ( wxDir::Exists(cacheDir) )
+        REQUIRE( wxDir::Remove(cacheDir, wxPATH_RMDIR_RECURSIVE) );
+
+    REQUIRE( session.EnableCache(cacheDir) );
+    CHECK( session.IsCacheEnabled() );
+
+    const auto runIsFromCache = [&](const wxString& subURL)
+    {
+        request = session.CreateRequest(this, baseURL + subURL);
+        Run();
+        return request.GetResponse().IsFromCache();
+    };
+
+    // This response can be reused without asking the server for a minute.
+    CHECK( !runIsFromCache("/cache/60") );
+    const wxString body = responseStringFromEvent;
+    CHECK( runIsFromCache("/cache/60") );
+    CHECK( responseStringFromEvent == body );
+
+    // And this one must be revalidated every time, but is still taken from
+    // the cache when the server confirms that it didn't change.
+    CHECK( !runIsFromCache("/etag/wxtest") );
+    CHECK( runIsFromCache("/etag/wxtest") );
+
+    request = wxWebRequest();
+    session.Close();
+    wxDir::Remove(cacheDir, wxPATH_RMDIR_RECURSIVE);
+}
+
 // This test is not run by default and has to be explicitly selected to run.
 TEST_CASE_METHOD(RequestFixture,
                  "WebRequest::Manual", "[.]")
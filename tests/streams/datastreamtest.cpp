@@ -67,6 +67,8 @@ private:
         {
             wxFileOutputStream FileOutput( f.GetName() );
             wxDataOutputStream DataOutput( FileOutput );
+            if ( ms_useBigEndianFormat )
+                DataOutput.BigEndianOrdered(true);
 
             (DataOutput.*pfnWriter)(Values, Size);
         }
@@ -74,6 +76,8 @@ private:
         {
             wxFileInputStream FileInput( f.GetName() );
             wxDataInputStream DataInput( FileInput );
+            if ( ms_useBigEndianFormat )
+                DataInput.BigEndianOrdered(true);
 
             (DataInput.*pfnReader)(&*InValues.begin(), InValues.size());
         }
@@ -209,6 +213,56 @@ TEST_CASE("Int64RW")
 }
 #endif
 
+TEST_CASE("BulkRW")
+{
+    // Use enough values to exercise both the vectorized and scalar code.
+    TestMultiRW<std::uint16_t>::ValueArray Values16;
+    TestMultiRW<std::uint32_t>::ValueArray Values32;
+    TestMultiRW<double>::ValueArray ValuesDouble;
+    for ( unsigned n = 0; n < 1027; n++ )
+    {
+        Values16.push_back(static_cast<std::uint16_t>(n * 0x0102u));
+        Values32.push_back(n * 0x01020304u);
+        ValuesDouble.push_back(n * 1.5 - 100);
+    }
+
+    // Check both the native and swapped byte orders.
+    for ( const bool bigEndian : { false, true } )
+    {
+        ms_useBigEndianFormat = bigEndian;
+
+        CHECK( TestMultiRW<std::uint16_t>(Values16, &wxDataOutputStream::Write16, &wxDataInputStream::Read16).IsOk() );
+        CHECK( TestMultiRW<std::uint32_t>(Values32, &wxDataOutputStream::Write32, &wxDataInputStream::Read32).IsOk() );
+        CHECK( TestMultiRW<double>(ValuesDouble, &wxDataOutputStream::WriteDouble, &wxDataInputStream::ReadDouble).IsOk() );
+    }
+
+    ms_useBigEndianFormat = false;
+}
+
+TEST_CASE("ConvertByteOrder")
+{
+    TempFile f("mytext.dat");
+
+    std::vector<std::uint32_t> values{0x01020304, 0xa1b2c3d4, 0, 0xffffffff, 5};
+    {
+        wxFileOutputStream fileOutput( f.GetName() );
+        wxDataOutputStream dataOutput( fileOutput );
+        dataOutput.BigEndianOrdered(true);
+        dataOutput.Write32(values.data(), values.size());
+    }
+
+    // Read the raw data and convert it ourselves.
+    wxFileInputStream fileInput( f.GetName() );
+    std::vector<std::uint32_t> raw(values.size());
+    REQUIRE( fileInput.ReadAll(raw.data(), raw.size() * sizeof(raw[0])) );
+    CHECK( reinterpret_cast<unsigned char*>(raw.data())[0] == 0x01 );
+
+    wxDataInputStream dataInput( fileInput );
+    dataInput.BigEndianOrdered(true);
+    dataInput.ConvertByteOrder(raw);
+    CHECK( raw == values );
+}
+
 //void DataStreamTestCase::NaNRW()
 //{
 //    //TODO?
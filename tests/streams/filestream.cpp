@@ -6,11 +6,19 @@
 // Licence:     wxWindows licence
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "doctest.h"
+
 #include "testprec.h"
 
 #include "bstream.h"
+#include "testfile.h"
 
 import WX.Cmn.WFStream;
+import WX.File.Flags;
+
+import <string>;
+import <string_view>;
+import <vector>;
 
 constexpr unsigned int DATABUFFER_SIZE =     1024;
 
@@ -136,3 +144,228 @@ wxString fileStream::GetInFileName() const
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(fileStream)
+
+TEST_CASE("wxMappedFileInputStream")
+{
+    TempFile tmp("mappedinstream.test");
+    {
+        wxFileOutputStream out(tmp.GetName());
+        out.Write("0123456789", 10);
+    }
+
+    wxMappedFileInputStream in(tmp.GetName().ToStdString());
+    REQUIRE( in.IsOk() );
+    CHECK( in.GetLength() == 10 );
+
+    in.Advise(wxFileAccessHint::Sequential);
+
+    const auto remaining = [&in]()
+    {
+        const std::span<const std::byte> buf = in.GetRemainingBuffer();
+        return std::string_view(reinterpret_cast<const char*>(buf.data()),
+                                buf.size());
+    };
+
+    CHECK( remaining() == "0123456789" );
+
+    // Consuming the data directly behaves as reading it.
+    in.Consume(3);
+    CHECK( in.LastRead() == 3 );
+    CHECK( in.TellI() == 3 );
+    CHECK( remaining() == "3456789" );
+
+    char buf[2];
+    CHECK( in.Read(buf, 2).LastRead() == 2 );
+    CHECK( remaining() == "56789" );
+
+    // The data put back must be read before the remaining buffer is used.
+    CHECK( in.Ungetch("XY", 2) == 2 );
+    CHECK( remaining().empty() );
+
+    CHECK( in.GetC() == 'X' );
+    CHECK( remaining().empty() );
+    CHECK( in.GetC() == 'Y' );
+    CHECK( remaining() == "56789" );
+
+    in.Consume(5);
+    CHECK( in.LastRead() == 5 );
+    CHECK( !in.Eof() );
+    CHECK( remaining().empty() );
+
+    in.Consume(0);
+    CHECK( in.LastRead() == 0 );
+    CHECK( in.Eof() );
+}
+
+namespace
+{
+
+// Returns the contents of the given file.
+std::string ReadFileContents(const wxString& name)
+{
+    wxFileInputStream in(name);
+    std::string data(static_cast<size_t>(in.GetLength()), '\0');
+    in.Read(data.data(), data.size());
+    return data;
+}
+
+// Returns the test data used by the tests below.
+std::string MakeTestData(size_t size)
+{
+    std::string data(size, '\0');
+    for ( size_t n = 0; n < size; n++ )
+        data[n] = static_cast<char>('a' + (n * 7 + n / 26) % 26);
+    return data;
+}
+
+// This stream transforms the data it reads, so it must not be bypassed by
+// copying the data directly between the descriptors.
+class UpperCaseFileInputStream : public wxFileInputStream
+{
+public:
+    using wxFileInputStream::wxFileInputStream;
+
+protected:
+    size_t OnSysRead(void *buffer, size_t size) override
+    {
+        const size_t count = wxFileInputStream::OnSysRead(buffer, size);
+        char* const p = static_cast<char*>(buffer);
+        for ( size_t n = 0; n < count; n++ )
+            p[n] = static_cast<char>(toupper(p[n]));
+        return count;
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxFileStream::ReadV-WriteV")
+{
+    TempFile tmp("filestreamv.test");
+
+    // Use more buffers than can be passed to the system at once, and some
+    // empty ones.
+    const std::string data = MakeTestData(1000);
+    const size_t chunk = 7;
+
+    std::vector<wxStreamConstIOVec> out;
+    for ( size_t pos = 0; pos < data.size(); pos += chunk )
+    {
+        out.push_back({data.data() + pos, std::min(chunk, data.size() - pos)});
+        out.push_back({data.data(), 0});
+    }
+
+    {
+        wxFileOutputStream fout(tmp.GetName());
+        CHECK( fout.WriteV(out).LastWrite() == data.size() );
+        CHECK( fout.IsOk() );
+    }
+
+    CHECK( ReadFileContents(tmp.GetName()) == data );
+
+    wxFileInputStream fin(tmp.GetName());
+
+    // The data put back must be returned first.
+    CHECK( fin.GetC() == data[0] );
+    CHECK( fin.Ungetch(data[0]) );
+
+    std::string result(data.size() + 10, '\0');
+    std::vector<wxStreamIOVec> in;
+    for ( size_t pos = 0; pos < result.size(); pos += chunk )
+        in.push_back({result.data() + pos, std::min(chunk, result.size() - pos)});
+
+    CHECK( fin.ReadV(in).LastRead() == data.size() );
+    result.resize(data.size());
+    CHECK( result == data );
+
+    // Nothing left to read.
+    CHECK( fin.ReadV(in).LastRead() == 0 );
+    CHECK( fin.Eof() );
+}
+
+TEST_CASE("wxBufferedInputStream::ReadDirectly")
+{
+    TempFile tmp("filestreamdirect.test");
+
+    const std::string data = MakeTestData(1000);
+    {
+        wxFileOutputStream fout(tmp.GetName());
+        fout.Write(data.data(), data.size());
+    }
+
+    wxFileInputStream fin(tmp.GetName());
+    wxBufferedInputStream in(fin, 16);
+
+    char buf[4];
+    CHECK( in.Read(buf, sizeof(buf)).LastRead() == sizeof(buf) );
+    CHECK( std::string_view(buf, sizeof(buf)) == data.substr(0, 4) );
+
+    // Read more than the buffer size, so that most of the data is read
+    // directly, with some data put back before it.
+    CHECK( in.Ungetch("XY", 2) == 2 );
+
+    std::string result(500, '\0');
+    CHECK( in.Read(result.data(), result.size()).LastRead() == result.size() );
+    CHECK( result == "XY" + data.substr(4, 498) );
+
+    // Seeking back into the data read directly must work too.
+    CHECK( in.SeekI(-4, wxSeekMode::FromCurrent) == 498 );
+    CHECK( in.Read(buf, sizeof(buf)).LastRead() == sizeof(buf) );
+    CHECK( std::string_view(buf, sizeof(buf)) == data.substr(498, 4) );
+
+    // And reading the rest.
+    result.assign(data.size(), '\0');
+    CHECK( in.Read(result.data(), result.size()).LastRead() == data.size() - 502 );
+    result.resize(data.size() - 502);
+    CHECK( result == data.substr(502) );
+}
+
+TEST_CASE("wxInputStream::Read(wxOutputStream)")
+{
+    TempFile tmpIn("filestreamcopyin.test");
+    TempFile tmpOut("filestreamcopyout.test");
+
+    const std::string data = MakeTestData(300000);
+    {
+        wxFileOutputStream fout(tmpIn.GetName());
+        fout.Write(data.data(), data.size());
+    }
+
+    SUBCASE("Direct")
+    {
+        wxFileInputStream fin(tmpIn.GetName());
+        {
+            wxFileOutputStream fout(tmpOut.GetName());
+            CHECK( fin.Read(fout).LastRead() == data.size() );
+            CHECK( fout.IsOk() );
+        }
+
+        CHECK( ReadFileContents(tmpOut.GetName()) == data );
+    }
+
+    SUBCASE("AfterUngetch")
+    {
+        wxFileInputStream fin(tmpIn.GetName());
+        CHECK( fin.Ungetch("XYZ", 3) == 3 );
+        {
+            wxFileOutputStream fout(tmpOut.GetName());
+            CHECK( fin.Read(fout).LastRead() == data.size() + 3 );
+        }
+
+        CHECK( ReadFileContents(tmpOut.GetName()) == "XYZ" + data );
+    }
+
+    SUBCASE("DerivedStream")
+    {
+        UpperCaseFileInputStream fin(tmpIn.GetName());
+        {
+            wxFileOutputStream fout(tmpOut.GetName());
+            CHECK( fin.Read(fout).LastRead() == data.size() );
+        }
+
+        std::string upper = data;
+        for ( char& c : upper )
+            c = static_cast<char>(toupper(c));
+
+        CHECK( ReadFileContents(tmpOut.GetName()) == upper );
+    }
+}
@@ -69,6 +69,8 @@ public:
         CPPUNIT_TEST(TestStream_GZip_BestComp);
         CPPUNIT_TEST(TestStream_GZip_Dictionary);
         CPPUNIT_TEST(TestStream_ZLibGZip);
+        CPPUNIT_TEST(TestStream_Parallel);
+        CPPUNIT_TEST(TestStream_ParallelFactory);
         CPPUNIT_TEST(Decompress_BadData);
         CPPUNIT_TEST(Decompress_wx251_zlib114_Data_NoHeader);
         CPPUNIT_TEST(Decompress_wx251_zlib114_Data_ZLib);
@@ -92,6 +94,10 @@ protected:
     void TestStream_GZip_BestComp();
     void TestStream_GZip_Dictionary();
     void TestStream_ZLibGZip();
+    // Test wxZLIB_PARALLEL with all output formats.
+    void TestStream_Parallel();
+    // Test gzip factory created with wxZLIB_PARALLEL.
+    void TestStream_ParallelFactory();
     // Try to decompress bad data.
     void Decompress_BadData();
     // Decompress data that was compress by an external app.
@@ -105,6 +111,7 @@ private:
     const char *GetDataBuffer();
     const unsigned char *GetCompressedData();
     void doTestStreamData(int input_flag, int output_flag, int compress_level, const wxMemoryBuffer *buf = NULL);
+    void doTestParallel(int flag, size_t size, size_t sync_pos);
     void doDecompress_ExternalData(const unsigned char *data, const char *value, size_t data_size, size_t value_size, int flag = wxZLIB_AUTO);
 
 private:
@@ -231,6 +238,60 @@ void zlibStream::TestStream_ZLibGZip()
     doTestStreamData(wxZLIB_AUTO, wxZLIB_GZIP, wxZ_DEFAULT_COMPRESSION);
 }
 
+void zlibStream::TestStream_Parallel()
+{
+    const int flags[] = { wxZLIB_NO_HEADER, wxZLIB_ZLIB, wxZLIB_GZIP };
+
+    for (size_t i = 0; i < WXSIZEOF(flags); i++)
+    {
+        // Empty input.
+        doTestParallel(flags[i], 0, 0);
+        // Input smaller than a single block, with and without flushing it.
+        doTestParallel(flags[i], 1000, 0);
+        doTestParallel(flags[i], 1000, 500);
+        // Input spanning several blocks, flushed in the middle of one.
+        doTestParallel(flags[i], 300 * 1024 + 17, 200 * 1024 + 3);
+    }
+}
+
+void zlibStream::TestStream_ParallelFactory()
+{
+    const wxGzipClassFactory factory(wxZLIB_PARALLEL);
+
+    // Only the default factory is registered.
+    const wxFilterClassFactory *registered = wxFilterClassFactory::Find("gzip");
+    CPPUNIT_ASSERT(registered != NULL);
+    CPPUNIT_ASSERT(registered != &factory);
+
+    string data(300 * 1024 + 17, '\0');
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (char)((i * i + i / 1000) % 251);
+
+    wxMemoryOutputStream memstream_out;
+    {
+        std::unique_ptr<wxFilterOutputStream>
+            zstream_out(factory.NewStream(memstream_out));
+        CPPUNIT_ASSERT(zstream_out->IsOk());
+
+        zstream_out->Write(data.data(), data.size());
+        CPPUNIT_ASSERT(zstream_out->Close());
+    }
+
+    // The output is a normal gzip stream which the default factory reads.
+    wxMemoryInputStream memstream_in(memstream_out);
+    std::unique_ptr<wxFilterInputStream>
+        zstream_in(registered->NewStream(memstream_in));
+    CPPUNIT_ASSERT(zstream_in->IsOk());
+
+    string result;
+    char buf[4096];
+    while (zstream_in->Read(buf, sizeof(buf)).LastRead() > 0)
+        result.append(buf, zstream_in->LastRead());
+
+    CPPUNIT_ASSERT(zstream_in->Eof());
+    CPPUNIT_ASSERT(result == data);
+}
+
 void zlibStream::Decompress_BadData()
 {
     // Setup the bad data stream and the zlib stream.
@@ -308,6 +369,46 @@ const unsigned char *zlibStream::GetCompressedData()
     return m_pCompressedData;
 }
 
+void zlibStream::doTestParallel(int flag, size_t size, size_t sync_pos)
+{
+    const std::string msg = fmt::format("flag {}, size {}, sync at {}",
+                                        flag, size, sync_pos);
+
+    string data(size, '\0');
+    for (size_t i = 0; i < size; i++)
+        data[i] = (char)((i * i + i / 1000) % 251);
+
+    wxMemoryOutputStream memstream_out;
+    {
+        wxZlibOutputStream zstream_out(memstream_out, wxZ_DEFAULT_COMPRESSION,
+                                       flag | wxZLIB_PARALLEL);
+        CPPUNIT_ASSERT_MESSAGE(msg, zstream_out.IsOk());
+
+        if (sync_pos)
+        {
+            zstream_out.Write(data.data(), sync_pos);
+            zstream_out.Sync();
+            CPPUNIT_ASSERT_MESSAGE(msg, zstream_out.IsOk());
+        }
+
+        zstream_out.Write(data.data() + sync_pos, size - sync_pos);
+        CPPUNIT_ASSERT_MESSAGE(msg, zstream_out.Close());
+    }
+
+    // The result must be a standard stream, readable by the usual decoder.
+    wxMemoryInputStream memstream_in(memstream_out);
+    wxZlibInputStream zstream_in(memstream_in, flag);
+    CPPUNIT_ASSERT_MESSAGE(msg, zstream_in.IsOk());
+
+    string result;
+    char buf[4096];
+    while (zstream_in.Read(buf, sizeof(buf)).LastRead() > 0)
+        result.append(buf, zstream_in.LastRead());
+
+    CPPUNIT_ASSERT_MESSAGE(msg, zstream_in.Eof());
+    CPPUNIT_ASSERT_MESSAGE(msg, result == data);
+}
+
 void zlibStream::doTestStreamData(int input_flag, int output_flag, int compress_level, const wxMemoryBuffer *buf)
 {
     size_t fail_pos;
@@ -0,0 +1,305 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/streams/zstdstream.cpp
+// Purpose:     Unit tests for Zstandard stream classes
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "testprec.h"
+
+
+#if wxUSE_ZSTD && wxUSE_STREAMS
+
+#include "wx/log.h"
+#include "wx/zstdstream.h"
+
+#include "bstream.h"
+
+import WX.Cmn.MemStream;
+
+class ZstdStream : public BaseStreamTestCase<wxZstdInputStream, wxZstdOutputStream>
+{
+public:
+    ZstdStream();
+
+    CPPUNIT_TEST_SUITE(ZstdStream);
+        // Base class stream tests.
+        CPPUNIT_TEST(Input_GetSizeFail);
+        CPPUNIT_TEST(Input_GetC);
+        CPPUNIT_TEST(Input_Read);
+        CPPUNIT_TEST(Input_Eof);
+        CPPUNIT_TEST(Input_LastRead);
+        CPPUNIT_TEST(Input_CanRead);
+        CPPUNIT_TEST(Input_SeekIFail);
+        CPPUNIT_TEST(Input_TellI);
+        CPPUNIT_TEST(Input_Peek);
+        CPPUNIT_TEST(Input_Ungetch);
+
+        CPPUNIT_TEST(Output_PutC);
+        CPPUNIT_TEST(Output_Write);
+        CPPUNIT_TEST(Output_LastWrite);
+        CPPUNIT_TEST(Output_SeekOFail);
+        CPPUNIT_TEST(Output_TellO);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    wxZstdInputStream *DoCreateInStream() override;
+    wxZstdOutputStream *DoCreateOutStream() override;
+
+private:
+    ZstdStream(const ZstdStream&) = delete;
+	ZstdStream& operator=(const ZstdStream&) = delete;
+};
+
+STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(ZstdStream)
+
+ZstdStream::ZstdStream()
+{
+    // Disable TellI() and TellO() tests in the base class which don't work
+    // with the compressed streams.
+    m_bSimpleTellITest =
+    m_bSimpleTellOTest = true;
+}
+
+wxZstdInputStream *ZstdStream::DoCreateInStream()
+{
+    // Compress some data.
+    const char data[] = "This is just some test data for Zstandard streams unit test";
+    const size_t len = sizeof(data);
+
+    wxMemoryOutputStream outmem;
+    wxZstdOutputStream outz(outmem);
+    outz.Write(data, len);
+    REQUIRE( outz.LastWrite() == len );
+    REQUIRE( outz.Close() );
+
+    wxMemoryInputStream* const inmem = new wxMemoryInputStream(outmem);
+    REQUIRE( inmem->IsOk() );
+
+    // Give ownership of the memory input stream to the Zstandard stream.
+    return new wxZstdInputStream(inmem);
+}
+
+wxZstdOutputStream *ZstdStream::DoCreateOutStream()
+{
+    return new wxZstdOutputStream(new wxMemoryOutputStream());
+}
+
+namespace
+{
+
+using Bytes = std::vector<std::uint8_t>;
+
+// Return a small record similar to the ones used as dictionary samples.
+std::string MakeRecord(int n)
+{
+    return wxString::Format(R"({"id": %d, "name": "user%d", "email": )"
+                            R"("user%d@example.com", "active": %s, )"
+                            R"("groups": ["staff", "group%d"]})",
+                            n, n * 7, n * 7, n % 3 ? "true" : "false",
+                            n % 5).utf8_string();
+}
+
+// Return large compressible data.
+std::string MakeLargeData(size_t size)
+{
+    std::string data;
+    data.reserve(size);
+    for ( int n = 0; data.size() < size; n++ )
+        data += MakeRecord(n);
+
+    data.resize(size);
+    return data;
+}
+
+Bytes TrainDictionary()
+{
+    std::vector<Bytes> samples;
+    for ( int n = 0; n < 1000; n++ )
+    {
+        const std::string record = MakeRecord(n);
+        samples.emplace_back(record.begin(), record.end());
+    }
+
+    return wxZstdTrainDictionary(samples, 4096);
+}
+
+void Compress(wxOutputStream& out,
+              const std::string& data,
+              const Bytes* dict = nullptr,
+              unsigned threads = 0)
+{
+    wxZstdOutputStream outz(out, -1, threads);
+    REQUIRE( outz.IsOk() );
+
+    if ( dict )
+        REQUIRE( outz.SetDictionary(dict->data(), dict->size()) );
+
+    outz.Write(data.data(), data.size());
+    REQUIRE( outz.LastWrite() == data.size() );
+    REQUIRE( outz.Close() );
+}
+
+// Decompress all the data in the stream, return false on error.
+bool Decompress(wxZstdInputStream& inz, std::string& data)
+{
+    data.clear();
+
+    char buf[4096];
+    while ( inz.Read(buf, sizeof(buf)).LastRead() > 0 )
+        data.append(buf, inz.LastRead());
+
+    return inz.GetLastError() == wxSTREAM_EOF;
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxZstdTrainDictionary")
+{
+    const Bytes dict = TrainDictionary();
+    CHECK( !dict.empty() );
+    CHECK( dict.size() <= 4096 );
+
+    wxLogNull noLog;
+    CHECK( wxZstdTrainDictionary({}).empty() );
+}
+
+TEST_CASE("wxZstdStream::Dictionary")
+{
+    const Bytes dict = TrainDictionary();
+    REQUIRE( !dict.empty() );
+
+    const std::string data = MakeRecord(12345);
+
+    wxMemoryOutputStream outPlain;
+    Compress(outPlain, data);
+
+    wxMemoryOutputStream outDict;
+    Compress(outDict, data, &dict);
+
+    // Using the dictionary is the whole point for such small inputs.
+    CHECK( outDict.GetLength() < outPlain.GetLength() );
+
+    SUBCASE("WithDictionary")
+    {
+        wxMemoryInputStream inmem(outDict);
+        wxZstdInputStream inz(inmem);
+        REQUIRE( inz.SetDictionary(dict.data(), dict.size()) );
+
+        std::string result;
+        CHECK( Decompress(inz, result) );
+        CHECK( result == data );
+    }
+
+    SUBCASE("WithoutDictionary")
+    {
+        wxLogNull noLog;
+
+        wxMemoryInputStream inmem(outDict);
+        wxZstdInputStream inz(inmem);
+
+        std::string result;
+        CHECK( !Decompress(inz, result) );
+        CHECK( inz.GetLastError() == wxSTREAM_READ_ERROR );
+    }
+}
+
+TEST_CASE("wxZstdDecompressionContext")
+{
+    const Bytes dict = TrainDictionary();
+    REQUIRE( !dict.empty() );
+
+    wxZstdDecompressionContext context;
+    REQUIRE( context.IsOk() );
+    REQUIRE( context.LoadDictionary(dict.data(), dict.size()) );
+
+    // Decompress several streams one after another using the same context,
+    // the dictionary must be kept between them.
+    for ( int n = 0; n < 5; n++ )
+    {
+        INFO( "stream #" << n );
+
+        const std::string data = MakeRecord(n + 2000);
+
+        wxMemoryOutputStream outmem;
+        Compress(outmem, data, &dict);
+
+        wxMemoryInputStream inmem(outmem);
+        wxZstdInputStream inz(inmem, &context);
+
+        std::string result;
+        CHECK( Decompress(inz, result) );
+        CHECK( result == data );
+    }
+
+    // A stream which was abandoned in the middle of a frame must not affect
+    // the next one.
+    const std::string data = MakeLargeData(100000);
+
+    wxMemoryOutputStream outmem;
+    Compress(outmem, data, &dict);
+
+    {
+        wxMemoryInputStream inmem(outmem);
+        wxZstdInputStream inz(inmem, &context);
+
+        char buf[100];
+        CHECK( inz.Read(buf, sizeof(buf)).LastRead() == sizeof(buf) );
+    }
+
+    wxMemoryInputStream inmem(outmem);
+    wxZstdInputStream inz(inmem, &context);
+
+    std::string result;
+    CHECK( Decompress(inz, result) );
+    CHECK( result == data );
+}
+
+TEST_CASE("wxZstdStream::Concatenated")
+{
+    const std::string data1 = MakeLargeData(10000);
+    const std::string data2 = "Second frame";
+
+    wxMemoryOutputStream outmem;
+    Compress(outmem, data1);
+    Compress(outmem, data2);
+
+    wxMemoryInputStream inmem(outmem);
+    wxZstdInputStream inz(inmem);
+
+    std::string result;
+    CHECK( Decompress(inz, result) );
+    CHECK( result == data1 + data2 );
+
+    SUBCASE("Truncated")
+    {
+        // Cutting off the end of the last frame must be detected, even if
+        // the first one is complete.
+        wxLogNull noLog;
+
+        wxMemoryInputStream inmemCut(outmem.GetOutputStreamBuffer()->GetBufferStart(),
+                                     outmem.GetLength() - 1);
+        wxZstdInputStream inzCut(inmemCut);
+
+        CHECK( !Decompress(inzCut, result) );
+        CHECK( inzCut.GetLastError() == wxSTREAM_READ_ERROR );
+    }
+}
+
+TEST_CASE("wxZstdStream::Threads")
+{
+    // Use enough data for it to be split between several worker threads.
+    const std::string data = MakeLargeData(8*1024*1024 + 123);
+
+    wxMemoryOutputStream outmem;
+    Compress(outmem, data, nullptr, 4);
+
+    wxMemoryInputStream inmem(outmem);
+    wxZstdInputStream inz(inmem);
+
+    std::string result;
+    CHECK( Decompress(inz, result) );
+    CHECK( result == data );
+}
+
+#endif // wxUSE_ZSTD && wxUSE_STREAMS